@@ -2,13 +2,215 @@
 
 #include <irrlicht.h>
 
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
 #include "irr/core/alloc/address_allocator_traits.h"
 #include "irr/core/alloc/LinearAddressAllocator.h"
 #include "irr/core/alloc/StackAddressAllocator.h"
+#include "irr/core/alloc/LockFreePoolAddressAllocator.h"
+#include "irr/core/alloc/GeneralpurposeAddressAllocator.h"
 
 using namespace irr;
 
 
+//! CPU-only stress test, every thread grabs a batch of blocks, marks them as owned, checks nobody else owns them and gives them back
+template<class AddressAlloc>
+void contentionTest(const char* name, uint32_t threadCount)
+{
+	using traits = core::address_allocator_traits<AddressAlloc>;
+	using size_type = typename AddressAlloc::size_type;
+
+	constexpr size_type blockSize = 64u;
+	constexpr size_type blockCount = 1u<<16u;
+	constexpr uint32_t batchSize = 32u;
+	constexpr uint32_t iterations = 20000u;
+
+	const size_type bufSz = blockSize*blockCount;
+	const size_type reservedSz = traits::reserved_size(blockSize,bufSz,blockSize);
+	void* reserved = _IRR_ALIGNED_MALLOC(reservedSz,_IRR_SIMD_ALIGNMENT);
+	AddressAlloc alloc(reserved,0u,0u,blockSize,bufSz,blockSize);
+
+	core::vector<std::atomic<uint32_t> > owners(blockCount);
+	for (auto& owner : owners)
+		owner = 0u;
+	std::atomic<uint32_t> failures(0u);
+
+	auto work = [&](uint32_t threadID)
+	{
+		size_type addresses[batchSize];
+		size_type sizes[batchSize];
+		size_type alignments[batchSize];
+		std::fill(sizes,sizes+batchSize,blockSize);
+		std::fill(alignments,alignments+batchSize,blockSize);
+		for (uint32_t i=0u; i<iterations; i++)
+		{
+			std::fill(addresses,addresses+batchSize,AddressAlloc::invalid_address);
+			traits::multi_alloc_addr(alloc,batchSize,addresses,sizes,alignments);
+			for (uint32_t j=0u; j<batchSize; j++)
+			{
+				if (addresses[j]==AddressAlloc::invalid_address)
+					continue;
+				uint32_t expected = 0u;
+				if (!owners[addresses[j]/blockSize].compare_exchange_strong(expected,threadID+1u))
+					failures++;
+			}
+			for (uint32_t j=0u; j<batchSize; j++)
+			{
+				if (addresses[j]!=AddressAlloc::invalid_address)
+					owners[addresses[j]/blockSize] = 0u;
+			}
+			traits::multi_free_addr(alloc,batchSize,addresses,sizes);
+		}
+	};
+
+	auto start = std::chrono::high_resolution_clock::now();
+	core::vector<std::thread> threads;
+	for (uint32_t i=0u; i<threadCount; i++)
+		threads.emplace_back(work,i);
+	for (auto& thread : threads)
+		thread.join();
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()-start).count();
+
+	printf("%s with %d threads: %lld us, %d double allocations\n",name,threadCount,static_cast<long long>(elapsed),failures.load());
+
+	_IRR_ALIGNED_FREE(reserved);
+}
+
+
+//! Stand-in cache for allocators which have none, so the same test can drive both
+struct NoThreadCache
+{
+	template<class AddressAlloc>
+	NoThreadCache(AddressAlloc*) {}
+};
+
+template<class AddressAlloc>
+void allocBatch(AddressAlloc& alloc, NoThreadCache&, uint32_t count, typename AddressAlloc::size_type* addresses, const typename AddressAlloc::size_type* sizes, const typename AddressAlloc::size_type* alignments)
+{
+	core::address_allocator_traits<AddressAlloc>::multi_alloc_addr(alloc,count,addresses,sizes,alignments);
+}
+template<class AddressAlloc>
+void allocBatch(AddressAlloc& alloc, typename AddressAlloc::ThreadCache& cache, uint32_t count, typename AddressAlloc::size_type* addresses, const typename AddressAlloc::size_type* sizes, const typename AddressAlloc::size_type* alignments)
+{
+	alloc.multi_alloc_addr(cache,count,addresses,sizes,alignments);
+}
+template<class AddressAlloc>
+void freeBatch(AddressAlloc& alloc, NoThreadCache&, uint32_t count, const typename AddressAlloc::size_type* addresses, const typename AddressAlloc::size_type* sizes)
+{
+	core::address_allocator_traits<AddressAlloc>::multi_free_addr(alloc,count,addresses,sizes);
+}
+template<class AddressAlloc>
+void freeBatch(AddressAlloc& alloc, typename AddressAlloc::ThreadCache& cache, uint32_t count, const typename AddressAlloc::size_type* addresses, const typename AddressAlloc::size_type* sizes)
+{
+	alloc.multi_free_addr(cache,count,addresses,sizes);
+}
+
+//! Like contentionTest but with mixed small sizes, every thread optionally having its own cache
+/** @returns false if a block got handed out twice or did not make it back into the allocator.*/
+template<class AddressAlloc, class ThreadCache>
+bool mixedSizeContentionTest(const char* name, uint32_t threadCount)
+{
+	using traits = core::address_allocator_traits<AddressAlloc>;
+	using size_type = typename AddressAlloc::size_type;
+
+	constexpr size_type minBlockSize = 64u;
+	constexpr size_type granuleCount = 1u<<18u;
+	constexpr uint32_t batchSize = 32u;
+	constexpr uint32_t iterations = 20000u;
+
+	const size_type bufSz = minBlockSize*granuleCount;
+	const size_type reservedSz = traits::reserved_size(minBlockSize,bufSz,minBlockSize);
+	void* reserved = _IRR_ALIGNED_MALLOC(reservedSz,_IRR_SIMD_ALIGNMENT);
+	AddressAlloc* alloc = new AddressAlloc(reserved,0u,0u,minBlockSize,bufSz,minBlockSize);
+
+	core::vector<std::atomic<uint32_t> > owners(granuleCount);
+	for (auto& owner : owners)
+		owner = 0u;
+	std::atomic<uint32_t> failures(0u);
+
+	auto work = [&](uint32_t threadID)
+	{
+		ThreadCache cache(alloc);
+		std::mt19937 rng(threadID);
+		size_type addresses[batchSize];
+		size_type sizes[batchSize];
+		size_type alignments[batchSize];
+		std::fill(alignments,alignments+batchSize,minBlockSize);
+		for (uint32_t i=0u; i<iterations; i++)
+		{
+			std::fill(addresses,addresses+batchSize,AddressAlloc::invalid_address);
+			for (uint32_t j=0u; j<batchSize; j++)
+				sizes[j] = minBlockSize<<size_type(rng()%3u);
+			allocBatch(*alloc,cache,batchSize,addresses,sizes,alignments);
+			for (uint32_t j=0u; j<batchSize; j++)
+			{
+				if (addresses[j]==AddressAlloc::invalid_address)
+					continue;
+				for (size_type g=addresses[j]/minBlockSize; g<(addresses[j]+sizes[j])/minBlockSize; g++)
+				{
+					uint32_t expected = 0u;
+					if (!owners[g].compare_exchange_strong(expected,threadID+1u))
+						failures++;
+				}
+			}
+			for (uint32_t j=0u; j<batchSize; j++)
+			{
+				if (addresses[j]==AddressAlloc::invalid_address)
+					continue;
+				for (size_type g=addresses[j]/minBlockSize; g<(addresses[j]+sizes[j])/minBlockSize; g++)
+					owners[g] = 0u;
+			}
+			freeBatch(*alloc,cache,batchSize,addresses,sizes);
+		}
+	};
+
+	auto start = std::chrono::high_resolution_clock::now();
+	core::vector<std::thread> threads;
+	for (uint32_t i=0u; i<threadCount; i++)
+		threads.emplace_back(work,i);
+	for (auto& thread : threads)
+		thread.join();
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now()-start).count();
+
+	// every block got freed, and every cache gave its blocks back when its thread ended
+	const bool leaked = traits::get_free_size(*alloc)!=bufSz;
+	printf("%s with %d threads: %lld us, %d double allocations%s\n",name,threadCount,static_cast<long long>(elapsed),failures.load(),leaked ? ", LEAKED BLOCKS":"");
+
+	delete alloc;
+	_IRR_ALIGNED_FREE(reserved);
+	return !leaked && failures==0u;
+}
+
+//! A cache outliving its allocator, like a thread_local one of a worker thread would, must not touch the allocator when destroyed
+void threadCacheOutlivesAllocatorTest()
+{
+	using AddressAlloc = core::GeneralpurposeAddressAllocatorThreadCached<uint32_t,std::recursive_mutex>;
+	using traits = core::address_allocator_traits<AddressAlloc>;
+
+	constexpr uint32_t minBlockSize = 64u;
+	constexpr uint32_t bufSz = minBlockSize<<12u;
+	void* reserved = _IRR_ALIGNED_MALLOC(traits::reserved_size(minBlockSize,bufSz,minBlockSize),_IRR_SIMD_ALIGNMENT);
+	AddressAlloc* alloc = new AddressAlloc(reserved,0u,0u,minBlockSize,bufSz,minBlockSize);
+	AddressAlloc::ThreadCache* cache = new AddressAlloc::ThreadCache(alloc);
+
+	uint32_t addresses[4] = {AddressAlloc::invalid_address,AddressAlloc::invalid_address,AddressAlloc::invalid_address,AddressAlloc::invalid_address};
+	const uint32_t sizes[4] = {minBlockSize,minBlockSize,minBlockSize*2u,minBlockSize*4u};
+	const uint32_t alignments[4] = {minBlockSize,minBlockSize,minBlockSize,minBlockSize};
+	alloc->multi_alloc_addr(*cache,4u,addresses,sizes,alignments);
+	alloc->multi_free_addr(*cache,4u,addresses,sizes);
+	printf("Cached bytes before the allocator goes away: %d\n",cache->get_cached_size());
+
+	delete alloc;
+	_IRR_ALIGNED_FREE(reserved);
+	// must neither crash nor touch the freed allocator
+	delete cache;
+	printf("Thread cache outliving its allocator: OK\n");
+}
+
+
 int main()
 {
     printf("SINGLE THREADED======================================================\n");
@@ -28,10 +230,29 @@ int main()
 	irr::core::address_allocator_traits<core::LinearAddressAllocatorMT<uint32_t,std::recursive_mutex> >::printDebugInfo();
 	printf("Pool \n");
 	irr::core::address_allocator_traits<core::PoolAddressAllocatorMT<uint32_t,std::recursive_mutex> >::printDebugInfo();
+	printf("Lock-free Pool \n");
+	irr::core::address_allocator_traits<core::LockFreePoolAddressAllocator<uint32_t> >::printDebugInfo();
 	printf("Cont \n");
 	irr::core::address_allocator_traits<core::ContiguousPoolAddressAllocatorMT<uint32_t,std::recursive_mutex> >::printDebugInfo();
 	printf("General \n");
 	irr::core::address_allocator_traits<core::GeneralpurposeAddressAllocatorMT<uint32_t,std::recursive_mutex> >::printDebugInfo();
-
-	return 0;
+
+	printf("CONTENTION===========================================================\n");
+	const uint32_t maxThreads = std::max(std::thread::hardware_concurrency(),2u);
+	for (uint32_t threadCount=1u; threadCount<=maxThreads; threadCount*=2u)
+	{
+		contentionTest<core::PoolAddressAllocatorMT<uint32_t,std::recursive_mutex> >("Pool",threadCount);
+		contentionTest<core::LockFreePoolAddressAllocator<uint32_t> >("Lock-free Pool",threadCount);
+	}
+	bool passed = true;
+	for (uint32_t threadCount=1u; threadCount<=maxThreads; threadCount*=2u)
+	{
+		using GeneralMT = core::GeneralpurposeAddressAllocatorMT<uint32_t,std::recursive_mutex>;
+		using GeneralThreadCached = core::GeneralpurposeAddressAllocatorThreadCached<uint32_t,std::recursive_mutex>;
+		passed = mixedSizeContentionTest<GeneralMT,NoThreadCache>("General",threadCount) && passed;
+		passed = mixedSizeContentionTest<GeneralThreadCached,GeneralThreadCached::ThreadCache>("Thread-cached General",threadCount) && passed;
+	}
+	threadCacheOutlivesAllocatorTest();
+
+	return passed ? 0:1;
 }
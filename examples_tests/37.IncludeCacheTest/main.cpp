@@ -0,0 +1,114 @@
+#define _IRR_STATIC_LIB_
+#include <irrlicht.h>
+#include "../common/TestChecks.h"
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+// TODO: remove dependency
+#include "../src/irr/asset/CFilesystemIncluder.h"
+
+using namespace irr;
+
+
+//! Serves one include out of memory and counts how often the cache had to ask it for anything
+class CCountingIncluder : public asset::IIncluder
+{
+	public:
+		mutable std::atomic<uint32_t> fetches;
+
+		CCountingIncluder() : fetches(0u) {}
+
+	protected:
+		std::string getInclude_internal(const std::string& _path) const override
+		{
+			fetches++;
+			if (_path=="/dir1/a.glsl")
+				return "#define A 1\n";
+			return {};
+		}
+};
+
+static void writeFile(const char* path, const char* contents)
+{
+	std::ofstream file(path,std::ios_base::binary|std::ios_base::trunc);
+	file << contents;
+}
+
+
+int main()
+{
+	TestChecks check;
+
+	{
+		auto includer = core::make_smart_refctd_ptr<CCountingIncluder>();
+		includer->addSearchDirectory("/dir1/");
+
+		bool allFound = true;
+		for (uint32_t i=0u; i<100u; i++)
+			allFound = allFound && includer->getIncludeStandard("a.glsl")=="#define A 1\n";
+		check(allFound,"Standard include resolves through the search directories");
+		// one miss in the default "" search directory, one hit in /dir1/, the rest is memoized
+		check(includer->fetches==2u,"Repeated standard include is memoized");
+
+		asset::IIncluder::include_hash_t memoizedHash, expectedHash;
+		includer->getIncludeStandard("a.glsl",&memoizedHash);
+		const char expected[] = "#define A 1\n";
+		core::XXHash_256(expected,sizeof(expected)-1u,expectedHash.data());
+		check(memoizedHash==expectedHash,"Memoized include hands out the hash of its contents");
+
+		includer->clearCache();
+		includer->getIncludeStandard("a.glsl");
+		check(includer->fetches==4u,"clearCache() forgets memoized includes");
+
+		// adding search directories while other threads resolve includes
+		std::atomic<bool> done(false);
+		std::atomic<uint32_t> wrongResults(0u);
+		core::vector<std::thread> readers;
+		for (uint32_t i=0u; i<4u; i++)
+			readers.emplace_back([&]()
+			{
+				while (!done)
+				{
+					if (includer->getIncludeStandard("a.glsl")!="#define A 1\n")
+						wrongResults++;
+				}
+			});
+		for (uint32_t i=0u; i<1000u; i++)
+			includer->addSearchDirectory("/dir"+std::to_string(i+2u)+"/");
+		done = true;
+		for (auto& reader : readers)
+			reader.join();
+		check(wrongResults==0u,"Concurrent addSearchDirectory() and getIncludeStandard()");
+	}
+
+	{
+		irr::SIrrlichtCreationParameters params;
+		params.DriverType = video::EDT_NULL;
+		IrrlichtDevice* device = createDeviceEx(params);
+		if (!device)
+			return 1;
+
+		io::IFileSystem* fs = device->getFileSystem();
+		auto includer = core::make_smart_refctd_ptr<asset::CFilesystemIncluder>(fs);
+		const std::string workingDir = std::string(fs->getWorkingDirectory().c_str())+"/";
+
+		const char* path = "includeCacheTest.glsl";
+		writeFile(path,"#define B 1\n");
+		check(includer->getIncludeRelative(path,workingDir)=="#define B 1\n","Include from disk");
+		// edits within the same second as the first read must still be picked up
+		writeFile(path,"#define B 22\n");
+		check(includer->getIncludeRelative(path,workingDir)=="#define B 22\n","Edit changing the size is detected");
+		asset::IIncluder::include_hash_t hashBefore, hashAfter;
+		includer->getIncludeRelative(path,workingDir,&hashBefore);
+		writeFile(path,"#define B 33\n");
+		check(includer->getIncludeRelative(path,workingDir,&hashAfter)=="#define B 33\n","Edit keeping the size is detected");
+		check(hashBefore!=hashAfter,"Edit changes the hash of the include");
+		remove(path);
+
+		device->drop();
+	}
+
+	return check.finish();
+}
@@ -0,0 +1,56 @@
+#define _IRR_STATIC_LIB_
+#include <irrlicht.h>
+#include "../common/TestChecks.h"
+
+#include <string>
+
+using namespace irr;
+
+
+//! Loads `_contents` as an OBJ file and returns how many triangles came out of it
+static uint32_t loadTriangleCount(IrrlichtDevice* device, const char* name, const std::string& contents)
+{
+	io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(contents.data(),contents.size(),name);
+	asset::IAssetLoader::SAssetLoadParams params;
+	auto bundle = device->getAssetManager()->getAsset(file,name,params);
+	file->drop();
+	if (bundle.isEmpty())
+		return 0u;
+
+	auto* mesh = static_cast<asset::ICPUMesh*>(bundle.getContents().first->get());
+	uint32_t indexCount = 0u;
+	for (uint32_t i=0u; i<mesh->getMeshBufferCount(); i++)
+		indexCount += mesh->getMeshBuffer(i)->getIndexCount();
+	return indexCount/3u;
+}
+
+
+int main()
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return 1;
+
+	TestChecks check;
+
+	const std::string vertices = "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nvt 0 0\nvn 0 0 1\n";
+	// every file gets its own name, so none of them come out of the asset cache
+	check(loadTriangleCount(device,"plain.obj",vertices+"f 1 2 3\n")==1u,"Plain face");
+	check(loadTriangleCount(device,"quad.obj",vertices+"f 1/1/1 2/1/1 4/1/1 3/1/1\n")==2u,"Quad gets triangulated");
+	// used to never finish, '\v' and '\f' did not count as spaces between corners
+	check(loadTriangleCount(device,"vtab.obj",vertices+"f 1 2\v3\n")==1u,"Vertical tab between corners");
+	check(loadTriangleCount(device,"formfeed.obj",vertices+"f\f1 2 3\f\n")==1u,"Form feed between corners");
+	// used to make a corner out of the comment and drop the face for it
+	check(loadTriangleCount(device,"comment.obj",vertices+"f 1 2 3 # a comment\n")==1u,"Trailing comment");
+	check(loadTriangleCount(device,"commentnospace.obj",vertices+"f 1 2 3#a comment\n")==1u,"Trailing comment without a space");
+	check(loadTriangleCount(device,"crlf.obj",vertices+"f 1 2 3\r\nf 2 4 3\r\n")==2u,"CRLF line endings");
+	check(loadTriangleCount(device,"noeol.obj",vertices+"f 1 2 3")==1u,"No line break at the end of the file");
+	check(loadTriangleCount(device,"relative.obj",vertices+"f -4 -3 -2\n")==1u,"Relative indices");
+	check(loadTriangleCount(device,"outofrange.obj",vertices+"f 1 2 9\nf 1 2 3\n")==1u,"Face with a nonexistent vertex is dropped");
+
+	device->drop();
+
+	return check.finish();
+}
@@ -0,0 +1,137 @@
+#define _IRR_STATIC_LIB_
+#include <irrlicht.h>
+#include "../common/TestChecks.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+using namespace irr;
+
+
+constexpr uint32_t Extent = 512u;
+constexpr uint32_t MipTailExtent = 64u;
+// RGBA8, every level is a quarter of the one before it
+constexpr size_t LevelBytes[] = {Extent*Extent*4u,Extent*Extent,Extent*Extent/4u,Extent*Extent/16u};
+constexpr uint32_t TailBase = 3u;
+constexpr size_t TailBytes = 16384u+4096u+1024u+256u+64u+16u+4u;
+
+//! Writes a 2D RGBA8 texture with a full mip chain as KTX2
+static bool writeTexture(asset::IAssetManager* am, const char* name)
+{
+	core::vector<asset::CImageData*> levels;
+	for (uint32_t level=0u, extent=Extent; extent; level++, extent>>=1u)
+	{
+		const uint32_t minCoord[3] = {0u,0u,0u};
+		const uint32_t maxCoord[3] = {extent,extent,1u};
+		auto* image = new asset::CImageData(nullptr,minCoord,maxCoord,level,asset::EF_R8G8B8A8_UNORM);
+		memset(image->getData(),level*16u,image->getImageDataSizeInBytes());
+		levels.push_back(image);
+	}
+	auto texture = core::smart_refctd_ptr<asset::ICPUTexture>(asset::ICPUTexture::create(levels,name,video::ITexture::ETT_2D),core::dont_grab);
+	for (auto level : levels)
+		level->drop();
+	return texture && am->writeAsset(name,asset::IAssetWriter::SAssetWriteParams(texture.get()));
+}
+
+//! Runs frames until `_done` holds, `_frame` makes the requests of every frame
+static bool streamUntil(asset::CTextureStreamingManager* manager, const std::function<void()>& _frame, const std::function<bool()>& _done)
+{
+	for (uint32_t i=0u; i<5000u; i++)
+	{
+		_frame();
+		manager->update();
+		if (_done())
+			return true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return false;
+}
+
+
+int main()
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return 1;
+
+	TestChecks check;
+
+	asset::IAssetManager* am = device->getAssetManager();
+	if (!writeTexture(am,"streamingTestA.ktx2") || !writeTexture(am,"streamingTestB.ktx2"))
+	{
+		printf("Could not write the test textures\n");
+		device->drop();
+		return 1;
+	}
+
+	asset::CTextureStreamingManager::SCreationParams managerParams;
+	managerParams.mipTailExtent = MipTailExtent;
+	managerParams.threadCount = 2u;
+
+	// residency, levels get streamed in one at a time up to the smallest one covering the screen extent
+	{
+		auto manager = core::make_smart_refctd_ptr<asset::CTextureStreamingManager>(core::smart_refctd_ptr<io::IFileSystem>(device->getFileSystem()),managerParams);
+		auto texture = manager->addTexture("streamingTestA.ktx2");
+		check(texture && texture->getResidentBaseLevel()==TailBase && texture->getLevelCount()==10u,"Only the mip tail is resident after addTexture()");
+		check(manager->getResidentBytes()==TailBytes,"Resident bytes count the mip tail");
+		check(texture->getTexture() && texture->getTexture()->getSize()[0]==(Extent>>TailBase),"Texture is usable right away");
+
+		const uint32_t firstVersion = texture->getVersion();
+		check(streamUntil(manager.get(),[&]() { texture->requestScreenExtent(200.f); },[&]() { return texture->getResidentBaseLevel()==1u; }),"Streams in up to the level covering the screen extent");
+		check(texture->getVersion()==firstVersion+2u && texture->getTexture()->getSize()[0]==(Extent>>1u),"Every streamed in level makes a new texture");
+		// nothing more should get requested for the same extent
+		for (uint32_t i=0u; i<20u; i++)
+		{
+			texture->requestScreenExtent(200.f);
+			manager->update();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		check(texture->getResidentBaseLevel()==1u,"No level past the one covering the screen extent");
+		check(manager->getResidentBytes()==TailBytes+LevelBytes[2]+LevelBytes[1],"Resident bytes count streamed in levels");
+
+		manager->setMemoryBudget(0u);
+		manager->update();
+		check(texture->getResidentBaseLevel()==TailBase && manager->getResidentBytes()==TailBytes,"Lowered budget evicts everything but the mip tail");
+
+		texture = nullptr;
+		manager->update();
+		check(manager->getResidentBytes()==0u,"Textures nothing references anymore get released");
+	}
+
+	// priority and eviction, the budget fits the mip tails and one level 2
+	{
+		managerParams.memoryBudget = TailBytes*2u+LevelBytes[2];
+		auto manager = core::make_smart_refctd_ptr<asset::CTextureStreamingManager>(core::smart_refctd_ptr<io::IFileSystem>(device->getFileSystem()),managerParams);
+		auto a = manager->addTexture("streamingTestA.ktx2");
+		auto b = manager->addTexture("streamingTestB.ktx2");
+
+		// a is undersampled 4x and b only 2x, so a gets the space
+		auto both = [&]() { a->requestScreenExtent(256.f); b->requestScreenExtent(128.f); };
+		check(streamUntil(manager.get(),both,[&]() { return a->getResidentBaseLevel()==2u; }),"Most undersampled texture streams in first");
+		for (uint32_t i=0u; i<20u; i++)
+		{
+			both();
+			manager->update();
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		check(a->getResidentBaseLevel()==2u && b->getResidentBaseLevel()==TailBase,"Less undersampled texture does not evict a more undersampled one");
+		check(manager->getResidentBytes()<=manager->getMemoryBudget(),"Budget holds");
+
+		// once a stops being used, its level goes to b
+		const uint32_t aVersion = a->getVersion();
+		check(streamUntil(manager.get(),[&]() { b->requestScreenExtent(128.f); },[&]() { return b->getResidentBaseLevel()==2u; }),"Unused texture gets evicted for a used one");
+		check(a->getResidentBaseLevel()==TailBase && a->getVersion()==aVersion+1u,"Eviction makes a new texture");
+		check(manager->getResidentBytes()<=manager->getMemoryBudget(),"Budget holds after eviction");
+	}
+
+	remove("streamingTestA.ktx2");
+	remove("streamingTestB.ktx2");
+	device->drop();
+
+	return check.finish();
+}
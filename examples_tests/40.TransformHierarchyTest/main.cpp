@@ -0,0 +1,134 @@
+#define _IRR_STATIC_LIB_
+#include <irrlicht.h>
+#include "../common/TestChecks.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace irr;
+using namespace scene;
+
+
+//! World transforms recomputed the slow way, walking up the parents of every node
+static bool matchesReference(const CTransformHierarchy* hierarchy, const core::vector<CTransformHierarchy::node_t>& nodes)
+{
+	for (const auto node : nodes)
+	{
+		core::matrix3x4SIMD expected = hierarchy->getLocalTransform(node);
+		for (auto ancestor=hierarchy->getParent(node); ancestor!=CTransformHierarchy::invalid_node; ancestor=hierarchy->getParent(ancestor))
+			expected = core::concatenateBFollowedByA(hierarchy->getLocalTransform(ancestor),expected);
+		const core::matrix3x4SIMD& actual = hierarchy->getWorldTransform(node);
+		for (uint32_t r=0u; r<3u; r++)
+		for (uint32_t c=0u; c<4u; c++)
+		if (std::abs(actual.rows[r].pointer[c]-expected.rows[r].pointer[c])>0.001f*(1.f+std::abs(expected.rows[r].pointer[c])))
+			return false;
+	}
+	return true;
+}
+
+static core::matrix3x4SIMD randomTransform(std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> translation(-10.f,10.f);
+	std::uniform_real_distribution<float> scale(0.9f,1.1f);
+	core::matrix3x4SIMD retval;
+	retval.setScale(core::vectorSIMDf(scale(rng),scale(rng),scale(rng)));
+	retval.setTranslation(core::vectorSIMDf(translation(rng),translation(rng),translation(rng)));
+	return retval;
+}
+
+//! Random forest of `count` nodes, the first `rootCount` are roots and every other node's parent is a random node added before it
+static core::vector<CTransformHierarchy::node_t> buildForest(CTransformHierarchy* hierarchy, uint32_t count, uint32_t rootCount, std::mt19937& rng)
+{
+	core::vector<CTransformHierarchy::node_t> nodes;
+	nodes.reserve(count);
+	for (uint32_t i=0u; i<count; i++)
+	{
+		CTransformHierarchy::node_t parent = CTransformHierarchy::invalid_node;
+		if (i>=rootCount)
+			parent = nodes[std::uniform_int_distribution<uint32_t>(0u,i-1u)(rng)];
+		nodes.push_back(hierarchy->addNode(parent,randomTransform(rng)));
+	}
+	return nodes;
+}
+
+static double benchmarkUpdate(CTransformHierarchy* hierarchy, const core::vector<CTransformHierarchy::node_t>& roots, uint32_t iterations)
+{
+	double total = 0.0;
+	for (uint32_t i=0u; i<iterations; i++)
+	{
+		for (const auto root : roots)
+			hierarchy->setLocalTransform(root,hierarchy->getLocalTransform(root));
+		const auto start = std::chrono::high_resolution_clock::now();
+		hierarchy->update();
+		total += std::chrono::duration<double,std::micro>(std::chrono::high_resolution_clock::now()-start).count();
+	}
+	return total/double(iterations);
+}
+
+
+int main()
+{
+	TestChecks check;
+
+	std::mt19937 rng(42u);
+	{
+		auto hierarchy = core::make_smart_refctd_ptr<CTransformHierarchy>();
+		auto nodes = buildForest(hierarchy.get(),20000u,100u,rng);
+
+		check(hierarchy->update()==nodes.size(),"First update computes every node");
+		check(matchesReference(hierarchy.get(),nodes),"World transforms match walking up the parents");
+		check(hierarchy->update()==0u,"Update without changes computes nothing");
+
+		// a leaf changing only updates itself, its parent changing updates all of the parent's subtree
+		const auto leaf = hierarchy->addNode(nodes[500],randomTransform(rng));
+		nodes.push_back(leaf);
+		hierarchy->update();
+		hierarchy->setLocalTransform(leaf,randomTransform(rng));
+		check(hierarchy->update()==1u && hierarchy->wasUpdated(leaf) && !hierarchy->wasUpdated(nodes[500]),"Only changed branches get recomputed");
+		hierarchy->setLocalTransform(nodes[500],randomTransform(rng));
+		hierarchy->update();
+		check(hierarchy->wasUpdated(leaf) && matchesReference(hierarchy.get(),nodes),"Changed parent moves its children");
+
+		check(!hierarchy->setParent(nodes[500],leaf),"Cycles get refused");
+		check(hierarchy->setParent(leaf,nodes[0]) && hierarchy->getParent(leaf)==nodes[0],"Parent changes");
+		hierarchy->removeNode(nodes[500]);
+		nodes.erase(nodes.begin()+500);
+		hierarchy->update();
+		check(matchesReference(hierarchy.get(),nodes) && hierarchy->getNodeCount()==nodes.size(),"Layout rebuilt after reparenting and removal");
+
+		// a handle freed by a removal is only reused after an update
+		const auto reused = hierarchy->addNode();
+		check(reused==500u,"Removed node's handle gets reused");
+		hierarchy->update();
+		nodes.push_back(reused);
+		check(matchesReference(hierarchy.get(),nodes),"Reused handle is a root");
+	}
+
+	// the same scene moved every frame, updated on the calling thread and on the thread pool
+	{
+		constexpr uint32_t nodeCount = 200000u;
+		auto serial = core::make_smart_refctd_ptr<CTransformHierarchy>(1u);
+		auto parallel = core::make_smart_refctd_ptr<CTransformHierarchy>();
+		std::mt19937 rngSerial(7u), rngParallel(7u);
+		const auto serialNodes = buildForest(serial.get(),nodeCount,1000u,rngSerial);
+		const auto parallelNodes = buildForest(parallel.get(),nodeCount,1000u,rngParallel);
+		serial->update();
+		parallel->update();
+
+		const core::vector<CTransformHierarchy::node_t> serialRoots(serialNodes.begin(),serialNodes.begin()+1000u);
+		const core::vector<CTransformHierarchy::node_t> parallelRoots(parallelNodes.begin(),parallelNodes.begin()+1000u);
+		const double serialTime = benchmarkUpdate(serial.get(),serialRoots,20u);
+		const double parallelTime = benchmarkUpdate(parallel.get(),parallelRoots,20u);
+		printf("update() of %u nodes in %u levels: %.1fus on one thread, %.1fus on %u threads\n",nodeCount,serial->getDepth(),serialTime,parallelTime,core::getDefaultThreadCount());
+		check(matchesReference(parallel.get(),parallelNodes),"Parallel update matches walking up the parents");
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (uint32_t i=0u; i<100u; i++)
+			parallel->update();
+		printf("update() without changes: %.1fus\n",std::chrono::duration<double,std::micro>(std::chrono::high_resolution_clock::now()-start).count()/100.0);
+	}
+
+	return check.finish();
+}
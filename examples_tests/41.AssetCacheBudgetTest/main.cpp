@@ -0,0 +1,118 @@
+#define _IRR_STATIC_LIB_
+#include <irrlicht.h>
+#include "../common/TestChecks.h"
+
+using namespace irr;
+using namespace asset;
+
+
+//! Caches a buffer of `size` bytes under `key`, the cache holds the only reference unless `keep` takes one
+static void cacheBuffer(IAssetManager* am, const char* key, size_t size, core::smart_refctd_ptr<ICPUBuffer>* keep=nullptr)
+{
+	auto buffer = core::make_smart_refctd_ptr<ICPUBuffer>(size);
+	SAssetBundle bundle({core::smart_refctd_ptr<IAsset>(buffer)});
+	am->changeAssetKey(bundle,key);
+	am->insertAssetIntoCache(bundle);
+	if (keep)
+		*keep = std::move(buffer);
+}
+
+//! Looks the buffer up the way loaders do, which counts as a use
+static void useBuffer(IAssetManager* am, const char* key)
+{
+	am->getAsset(key,IAssetLoader::SAssetLoadParams());
+}
+
+static bool isCached(IAssetManager* am, const char* key)
+{
+	const IAsset::E_TYPE types[] = {IAsset::ET_BUFFER,static_cast<IAsset::E_TYPE>(0u)};
+	return !am->findAssets(key,types).empty();
+}
+
+static bool isDemoted(IAssetManager* am, const char* key)
+{
+	const IAsset::E_TYPE types[] = {IAsset::ET_BUFFER,static_cast<IAsset::E_TYPE>(0u)};
+	auto found = am->findAssets(key,types);
+	return !found.empty() && (*found.front().getContents().first)->isADummyObjectForCache();
+}
+
+//! Empties the buffer cache and gives it a new budget
+static void resetCache(IAssetManager* am, size_t maxBytes, IAssetManager::E_CACHE_EVICTION_POLICY policy, bool demote=false)
+{
+	am->clearAllAssetCache(IAsset::ET_BUFFER);
+	am->resetAssetCacheStatistics();
+	IAssetManager::SAssetCacheBudget budget;
+	budget.maxBytes = maxBytes;
+	budget.policy = policy;
+	budget.demoteInsteadOfRemove = demote;
+	am->setAssetCacheBudget(IAsset::ET_BUFFER,budget);
+}
+
+
+int main()
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return 1;
+
+	TestChecks check;
+
+	IAssetManager* am = device->getAssetManager();
+
+	// least recently used goes first, a lookup makes the oldest buffer the newest
+	{
+		resetCache(am,3000u,IAssetManager::ECEP_LRU);
+		cacheBuffer(am,"lruA",1000u);
+		cacheBuffer(am,"lruB",1000u);
+		cacheBuffer(am,"lruC",1000u);
+		useBuffer(am,"lruA");
+		cacheBuffer(am,"lruD",1000u);
+		check(isCached(am,"lruA") && !isCached(am,"lruB") && isCached(am,"lruC") && isCached(am,"lruD"),"LRU evicts the least recently used buffer");
+		const auto stats = am->getAssetCacheStatistics(IAsset::ET_BUFFER);
+		check(stats.hits==1u && stats.evictions==1u && stats.residentBytes==3000u,"LRU statistics");
+	}
+
+	// size times age, so one big buffer goes before two small older ones which LRU would evict instead
+	{
+		resetCache(am,3000u,IAssetManager::ECEP_COST_AWARE);
+		cacheBuffer(am,"costSmallA",500u);
+		cacheBuffer(am,"costSmallB",500u);
+		cacheBuffer(am,"costBig",2000u);
+		cacheBuffer(am,"costNew",1000u);
+		check(!isCached(am,"costBig") && isCached(am,"costSmallA") && isCached(am,"costSmallB") && isCached(am,"costNew"),"Cost aware evicts the big buffer");
+		const auto stats = am->getAssetCacheStatistics(IAsset::ET_BUFFER);
+		check(stats.evictions==1u && stats.residentBytes==2000u,"Cost aware statistics");
+	}
+
+	// demoted buffers keep their keys but lose their data
+	{
+		resetCache(am,1500u,IAssetManager::ECEP_LRU,true);
+		cacheBuffer(am,"demoteA",1000u);
+		cacheBuffer(am,"demoteB",1000u);
+		check(isDemoted(am,"demoteA") && isCached(am,"demoteB") && !isDemoted(am,"demoteB"),"Demotion turns the buffer into a dummy");
+		const auto stats = am->getAssetCacheStatistics(IAsset::ET_BUFFER);
+		check(stats.demotions==1u && stats.evictions==0u && stats.residentBytes==1000u,"Demotion statistics");
+	}
+
+	// the oldest buffer is still used by the application, so the one after it has to go
+	{
+		resetCache(am,1500u,IAssetManager::ECEP_LRU);
+		core::smart_refctd_ptr<ICPUBuffer> held;
+		cacheBuffer(am,"heldA",1000u,&held);
+		cacheBuffer(am,"heldB",1000u);
+		cacheBuffer(am,"heldC",1000u);
+		check(isCached(am,"heldA") && !isCached(am,"heldB") && isCached(am,"heldC") && held->getPointer(),"Referenced buffer is never evicted");
+		check(am->getAssetCacheStatistics(IAsset::ET_BUFFER).residentBytes==2000u,"Cache stays over budget while nothing else can go");
+
+		held = nullptr;
+		am->enforceAssetCacheBudgets(IAsset::ET_BUFFER);
+		check(!isCached(am,"heldA") && isCached(am,"heldC") && am->getAssetCacheStatistics(IAsset::ET_BUFFER).residentBytes==1000u,"Released buffer gets evicted");
+	}
+
+	am->clearAllAssetCache(IAsset::ET_BUFFER);
+	device->drop();
+
+	return check.finish();
+}
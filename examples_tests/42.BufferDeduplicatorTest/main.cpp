@@ -0,0 +1,125 @@
+#define _IRR_STATIC_LIB_
+#include <irrlicht.h>
+#include "../common/TestChecks.h"
+
+#include <cstring>
+
+using namespace irr;
+using namespace asset;
+
+
+//! Buffer of `size` bytes counting up from `first`
+static core::smart_refctd_ptr<ICPUBuffer> createBuffer(size_t size, uint8_t first)
+{
+	auto buffer = core::make_smart_refctd_ptr<ICPUBuffer>(size);
+	for (size_t i=0u; i<size; i++)
+		reinterpret_cast<uint8_t*>(buffer->getPointer())[i] = uint8_t(first+i);
+	return buffer;
+}
+
+//! Positions and UVs interleaved in one buffer, and an index buffer, the same contents every time
+static core::smart_refctd_ptr<ICPUMeshBuffer> createMeshBuffer()
+{
+	constexpr size_t VertexSize = 5u*sizeof(float);
+	float vertexData[4u*5u];
+	for (uint32_t i=0u; i<4u*5u; i++)
+		vertexData[i] = float(i);
+	auto vertices = core::make_smart_refctd_ptr<ICPUBuffer>(sizeof(vertexData));
+	memcpy(vertices->getPointer(),vertexData,sizeof(vertexData));
+
+	const uint16_t indexData[6] = {0u,1u,2u,2u,1u,3u};
+	auto indices = core::make_smart_refctd_ptr<ICPUBuffer>(sizeof(indexData));
+	memcpy(indices->getPointer(),indexData,sizeof(indexData));
+
+	auto desc = core::make_smart_refctd_ptr<ICPUMeshDataFormatDesc>();
+	desc->setVertexAttrBuffer(core::smart_refctd_ptr(vertices),EVAI_ATTR0,EF_R32G32B32_SFLOAT,VertexSize,0u);
+	desc->setVertexAttrBuffer(core::smart_refctd_ptr(vertices),EVAI_ATTR2,EF_R32G32_SFLOAT,VertexSize,3u*sizeof(float));
+	desc->setIndexBuffer(std::move(indices));
+
+	auto meshbuffer = core::make_smart_refctd_ptr<ICPUMeshBuffer>();
+	meshbuffer->setMeshDataAndFormat(std::move(desc));
+	return meshbuffer;
+}
+
+
+int main()
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return 1;
+
+	TestChecks check;
+
+	// identical contents get substituted, different ones and modified registered buffers do not
+	{
+		auto deduplicator = core::make_smart_refctd_ptr<CCPUBufferDeduplicator>();
+		auto a = createBuffer(1000u,0u);
+		auto b = createBuffer(1000u,0u);
+		auto c = createBuffer(1000u,1u);
+		check(deduplicator->deduplicate(a.get()).get()==a.get() && deduplicator->isRegistered(a.get()),"First buffer gets registered");
+		check(deduplicator->deduplicate(b.get()).get()==a.get(),"Identical buffer gets substituted");
+		check(deduplicator->deduplicate(c.get()).get()==c.get(),"Different buffer is kept");
+		auto stats = deduplicator->getStatistics();
+		check(stats.buffersSubstituted==1u && stats.bytesSaved==1000u && stats.registeredBuffers==2u,"Substitution statistics");
+
+		// `a` changes in place, so it must not stand in for its old contents anymore
+		reinterpret_cast<uint8_t*>(a->getPointer())[0] = 0xffu;
+		check(deduplicator->deduplicate(b.get()).get()==b.get() && deduplicator->isRegistered(b.get()) && !deduplicator->isRegistered(a.get()),"Modified buffer gets replaced in the registry");
+
+		b = nullptr;
+		c = nullptr;
+		deduplicator->prune();
+		check(deduplicator->getStatistics().registeredBuffers==0u,"Prune forgets buffers only the registry references");
+	}
+
+	// the interleaved buffer of both attributes is one buffer, deduplicated once
+	{
+		auto deduplicator = core::make_smart_refctd_ptr<CCPUBufferDeduplicator>();
+		auto first = createMeshBuffer();
+		auto second = createMeshBuffer();
+		check(deduplicator->deduplicate(first.get())==0u,"Nothing to substitute in the first mesh buffer");
+		check(deduplicator->deduplicate(second.get())==2u,"Vertex and index buffers get substituted");
+
+		const auto* firstDesc = first->getMeshDataAndFormat();
+		const auto* secondDesc = second->getMeshDataAndFormat();
+		check(secondDesc->getMappedBuffer(EVAI_ATTR0)==firstDesc->getMappedBuffer(EVAI_ATTR0) && secondDesc->getMappedBuffer(EVAI_ATTR2)==firstDesc->getMappedBuffer(EVAI_ATTR0) &&
+			secondDesc->getIndexBuffer()==firstDesc->getIndexBuffer(),"Mesh buffers share their buffers");
+		check(secondDesc->getMappedBufferStride(EVAI_ATTR2)==5u*sizeof(float) && secondDesc->getMappedBufferOffset(EVAI_ATTR2)==3u*sizeof(float),"Strides and offsets stay");
+		check(deduplicator->getStatistics().buffersVisited==4u,"Every distinct buffer is visited once");
+	}
+
+	// the asset manager prunes its registry when the cache lets go of assets
+	{
+		IAssetManager* am = device->getAssetManager();
+		CCPUBufferDeduplicator* deduplicator = am->getBufferDeduplicator();
+		deduplicator->clear();
+
+		auto buffer = createBuffer(1000u,0u);
+		SAssetBundle bundle({core::smart_refctd_ptr<IAsset>(buffer)});
+		am->changeAssetKey(bundle,"deduplicatedBuffer");
+		am->insertAssetIntoCache(bundle);
+		deduplicator->deduplicate(bundle);
+		bundle = SAssetBundle();
+		buffer = nullptr;
+		check(deduplicator->getStatistics().registeredBuffers==1u,"Cached buffer gets registered");
+
+		// the registry's reference does not keep the buffer from being evicted
+		IAssetManager::SAssetCacheBudget budget;
+		budget.maxBytes = 500u;
+		am->setAssetCacheBudget(IAsset::ET_BUFFER,budget);
+		check(am->getAssetCacheStatistics(IAsset::ET_BUFFER).evictions==1u && deduplicator->getStatistics().registeredBuffers==0u,"Eviction prunes the registry");
+		am->setAssetCacheBudget(IAsset::ET_BUFFER,IAssetManager::SAssetCacheBudget());
+
+		buffer = createBuffer(1000u,0u);
+		deduplicator->deduplicate(buffer.get());
+		buffer = nullptr;
+		am->clearAllAssetCache();
+		check(deduplicator->getStatistics().registeredBuffers==0u,"Clearing the cache prunes the registry");
+	}
+
+	device->drop();
+
+	return check.finish();
+}
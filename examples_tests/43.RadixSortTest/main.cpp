@@ -0,0 +1,102 @@
+#define _IRR_STATIC_LIB_
+#include <irrlicht.h>
+#include "../common/TestChecks.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+
+using namespace irr;
+
+
+//! Remembers where it was before sorting, so the order of equal keys can be checked
+struct SElement
+{
+	uint64_t key;
+	uint32_t originalIx;
+};
+
+//! Every key in `pool` several times over, in random order
+static core::vector<SElement> createElements(size_t count, const core::vector<uint64_t>& pool, std::mt19937& rng)
+{
+	std::uniform_int_distribution<size_t> pick(0u,pool.size()-1u);
+	core::vector<SElement> elements(count);
+	for (size_t i=0u; i<count; i++)
+		elements[i] = {pool[pick(rng)],static_cast<uint32_t>(i)};
+	return elements;
+}
+
+//! Sorts a copy of `elements` with core::radix_sort and with std::stable_sort
+/** @returns true if both put every element at the same place, which for duplicate keys only holds if the radix sort is stable.
+@param outKeyReads if not null, receives how many times the radix sort read a key. */
+static bool matchesStableSort(const core::vector<SElement>& elements, uint32_t threadCount, size_t parallelThreshold, size_t* outKeyReads=nullptr)
+{
+	core::vector<SElement> expected(elements);
+	std::stable_sort(expected.begin(),expected.end(),[](const SElement& a, const SElement& b) { return a.key<b.key; });
+
+	core::vector<SElement> sorted(elements);
+	core::vector<SElement> scratch(elements.size());
+	std::atomic<size_t> keyReads(0u);
+	core::radix_sort(sorted.data(),scratch.data(),sorted.size(),[&keyReads](const SElement& e) -> uint64_t { keyReads++; return e.key; },threadCount,parallelThreshold);
+	if (outKeyReads)
+		*outKeyReads = keyReads;
+
+	for (size_t i=0u; i<sorted.size(); i++)
+	{
+		if (sorted[i].key!=expected[i].key || sorted[i].originalIx!=expected[i].originalIx)
+			return false;
+	}
+	return true;
+}
+
+
+int main()
+{
+	TestChecks check;
+	std::mt19937 rng(42u);
+	std::uniform_int_distribution<uint64_t> anyKey;
+
+	// above the default threshold of 0x10000, so the sort gets split into chunks with their own histograms
+	constexpr size_t Count = 0x30000u;
+	constexpr size_t DefaultThreshold = 0x10000u;
+
+	// full 64 bit keys, a thousand distinct ones so every key shows up many times
+	{
+		core::vector<uint64_t> pool(1000u);
+		for (auto& key : pool)
+			key = anyKey(rng);
+		const auto elements = createElements(Count,pool,rng);
+
+		check(matchesStableSort(elements,4u,DefaultThreshold),"Chunked sort of duplicate 64 bit keys matches std::stable_sort");
+		check(matchesStableSort(elements,0u,DefaultThreshold),"Chunked sort with the default thread count matches std::stable_sort");
+		check(matchesStableSort(elements,4u,~size_t(0u)),"Single threaded sort of duplicate 64 bit keys matches std::stable_sort");
+		// uneven chunks, the last one is shorter than the rest
+		const core::vector<SElement> odd(elements.begin(),elements.begin()+DefaultThreshold+7u);
+		check(matchesStableSort(odd,3u,DefaultThreshold),"Chunked sort with a short last chunk matches std::stable_sort");
+	}
+
+	// keys only differing in their third and sixth byte, every other byte must not get a pass
+	{
+		core::vector<uint64_t> pool(200u);
+		for (auto& key : pool)
+			key = 0x0123000067000089ull|((anyKey(rng)&0xffull)<<16u)|((anyKey(rng)&0xffull)<<40u);
+		const auto elements = createElements(Count,pool,rng);
+
+		size_t keyReads = 0u;
+		check(matchesStableSort(elements,4u,DefaultThreshold,&keyReads),"Chunked sort of keys differing in 2 bytes matches std::stable_sort");
+		// one read per element to find the bytes which differ, then a histogram and a scatter read per element for each of the 2 passes
+		check(keyReads==Count*5u,"Bytes equal in every key get no pass in the chunked sort");
+		check(matchesStableSort(elements,1u,DefaultThreshold,&keyReads),"Single threaded sort of keys differing in 2 bytes matches std::stable_sort");
+		check(keyReads==Count*5u,"Bytes equal in every key get no pass in the single threaded sort");
+	}
+
+	// all keys the same, nothing to do past finding that out
+	{
+		const auto elements = createElements(Count,core::vector<uint64_t>(1u,0xdeadbeefull),rng);
+		size_t keyReads = 0u;
+		check(matchesStableSort(elements,4u,DefaultThreshold,&keyReads),"Sort of equal keys keeps the original order");
+		check(keyReads==Count,"Equal keys get no pass at all");
+	}
+
+	return check.finish();
+}
@@ -0,0 +1,168 @@
+#define _IRR_STATIC_LIB_
+#include <irrlicht.h>
+#include "../common/TestChecks.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace irr;
+using namespace asset;
+
+// The fixtures in media/hdr_exr_loader_test all hold the patterns below, every file in a different encoding.
+
+
+//! RGBE texel of the .hdr fixtures, 40x6 with the first texel black and a run of 12 equal texels in every row
+static void hdrTexel(uint32_t x, uint32_t y, uint8_t* out)
+{
+	if (x==0u && y==0u)
+	{
+		memset(out,0,4u);
+		return;
+	}
+	if (x>=8u && x<20u)
+	{
+		const uint8_t run[4] = {0x80u,0x40u,0x20u,0x85u};
+		memcpy(out,run,4u);
+		return;
+	}
+	for (uint32_t c=0u; c<3u; c++)
+		out[c] = uint8_t(x*7u+y*13u+c*29u);
+	out[3] = uint8_t(20u+(x*11u+y*53u)%236u);
+}
+
+//! Scalar RGBE to float, the exponents in the fixtures are large enough to give no denormals
+static float rgbeToFloat(uint8_t mantissa, uint8_t exponent)
+{
+	return exponent ? std::ldexp(float(mantissa)+0.5f,int32_t(exponent)-136):0.f;
+}
+
+//! Half bits of channel `c` (RGBA order) of the .exr fixtures, 19x40 with a run of 7 equal values in the middle of every row
+static uint16_t exrHalf(uint32_t x, uint32_t y, uint32_t c, const uint16_t* values)
+{
+	if (x>=5u && x<12u)
+		return values[(y+c)%16u];
+	return values[(x*3u+y*7u+c*5u)%16u];
+}
+//! Close together, so the PIZ bitmap stays small and the blocks actually get compressed
+static const uint16_t NarrowHalfs[16] = {0x3c00u,0x3c11u,0x3c22u,0x3c33u,0x3c44u,0x3c55u,0x3c66u,0x3c77u,0x3c88u,0x3c99u,0x3caau,0x3cbbu,0x3cccu,0x3cddu,0x3ceeu,0x3cffu};
+//! Zero, denormals, negatives and the largest finite halfs for the half to float conversion
+static const uint16_t WideHalfs[16] = {0x0000u,0x8000u,0x0001u,0x03ffu,0x0400u,0x3555u,0x3c00u,0xbc00u,0x4248u,0xc0a0u,0x7bffu,0xfbffu,0x5640u,0x2e66u,0x1234u,0x9abcu};
+
+static core::smart_refctd_ptr<ICPUTexture> load(IAssetManager* am, const char* name)
+{
+	IAssetLoader::SAssetLoadParams lparams;
+	auto bundle = am->getAsset(std::string("../../media/hdr_exr_loader_test/")+name,lparams);
+	if (bundle.isEmpty())
+		return nullptr;
+	return core::smart_refctd_ptr_static_cast<ICPUTexture>(*bundle.getContents().first);
+}
+
+//! Whether the texture is a single `width`x`height` level of `format`, @returns its texel data or nullptr
+static const CImageData* getImage(const ICPUTexture* texture, E_FORMAT format, uint32_t width, uint32_t height)
+{
+	if (!texture || texture->getColorFormat()!=format || texture->getRanges().size()!=1u)
+		return nullptr;
+	const CImageData* image = texture->getRanges().front();
+	if (image->getSize().X!=width || image->getSize().Y!=height)
+		return nullptr;
+	return image;
+}
+
+static bool matchesRGBE(const ICPUTexture* texture)
+{
+	constexpr uint32_t Width = 40u;
+	constexpr uint32_t Height = 6u;
+	const CImageData* image = getImage(texture,EF_R32G32B32A32_SFLOAT,Width,Height);
+	if (!image)
+		return false;
+
+	for (uint32_t y=0u; y<Height; y++)
+	{
+		const float* row = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(image->getData())+y*image->getPitchIncludingAlignment());
+		for (uint32_t x=0u; x<Width; x++)
+		{
+			uint8_t rgbe[4];
+			hdrTexel(x,y,rgbe);
+			const float expected[4] = {rgbeToFloat(rgbe[0],rgbe[3]),rgbeToFloat(rgbe[1],rgbe[3]),rgbeToFloat(rgbe[2],rgbe[3]),1.f};
+			if (memcmp(row+4u*x,expected,sizeof(expected))!=0)
+				return false;
+		}
+	}
+	return true;
+}
+
+//! All-half files are loaded without any conversion, so the bits have to match exactly
+static bool matchesHalfRGBA(const ICPUTexture* texture)
+{
+	constexpr uint32_t Width = 19u;
+	constexpr uint32_t Height = 40u;
+	const CImageData* image = getImage(texture,EF_R16G16B16A16_SFLOAT,Width,Height);
+	if (!image)
+		return false;
+
+	for (uint32_t y=0u; y<Height; y++)
+	{
+		const uint16_t* row = reinterpret_cast<const uint16_t*>(reinterpret_cast<const uint8_t*>(image->getData())+y*image->getPitchIncludingAlignment());
+		for (uint32_t x=0u; x<Width; x++)
+		for (uint32_t c=0u; c<4u; c++)
+		{
+			if (row[4u*x+c]!=exrHalf(x,y,c,NarrowHalfs))
+				return false;
+		}
+	}
+	return true;
+}
+
+//! Half RGB and a float A channel get loaded as floats, the halfs have to convert like the scalar Float16Compressor does
+static bool matchesHalfRGBFloatA(const ICPUTexture* texture)
+{
+	constexpr uint32_t Width = 19u;
+	constexpr uint32_t Height = 40u;
+	const CImageData* image = getImage(texture,EF_R32G32B32A32_SFLOAT,Width,Height);
+	if (!image)
+		return false;
+
+	for (uint32_t y=0u; y<Height; y++)
+	{
+		const float* row = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(image->getData())+y*image->getPitchIncludingAlignment());
+		for (uint32_t x=0u; x<Width; x++)
+		{
+			float expected[4];
+			for (uint32_t c=0u; c<3u; c++)
+				expected[c] = core::Float16Compressor::decompress(exrHalf(x,y,c,WideHalfs));
+			expected[3] = float(x)*0.25f-float(y);
+			if (memcmp(row+4u*x,expected,sizeof(expected))!=0)
+				return false;
+		}
+	}
+	return true;
+}
+
+
+int main()
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return 1;
+
+	TestChecks check;
+
+	IAssetManager* am = device->getAssetManager();
+
+	check(matchesRGBE(load(am,"flat.hdr").get()),"Flat RGBE texels");
+	check(matchesRGBE(load(am,"rle.hdr").get()),"Per channel run length encoded RGBE");
+	check(matchesRGBE(load(am,"old_rle.hdr").get()),"Repeated texel run length encoded RGBE");
+	check(matchesRGBE(load(am,"bottom_up.hdr").get()),"RGBE stored bottom row first");
+
+	check(matchesHalfRGBA(load(am,"rgba_half_none.exr").get()),"Uncompressed EXR");
+	check(matchesHalfRGBA(load(am,"rgba_half_rle.exr").get()),"RLE compressed EXR");
+	check(matchesHalfRGBA(load(am,"rgba_half_zips.exr").get()),"ZIPS compressed EXR");
+	check(matchesHalfRGBA(load(am,"rgba_half_zip.exr").get()),"ZIP compressed EXR");
+	check(matchesHalfRGBA(load(am,"rgba_half_piz.exr").get()),"PIZ compressed EXR");
+	check(matchesHalfRGBFloatA(load(am,"rgb_half_a_float_zip.exr").get()),"EXR with half and float channels");
+
+	device->drop();
+	return check.finish();
+}
@@ -0,0 +1,870 @@
+#define _IRR_STATIC_LIB_
+#include <irrlicht.h>
+#include "../common/TestChecks.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+using namespace irr;
+using namespace asset;
+
+
+// Known answer vectors, the BC6H and BC7 blocks hold random fields laid out by the bit tables of the format specifications
+// and the texels are what the reference decoding process of the specifications gives for them.
+
+//! Hex of the block, then the half float RGB texels in row order, once decoded as UFLOAT and once as SFLOAT
+struct SBC6HVector
+{
+	const char* block;
+	const char* unsignedTexels;
+	const char* signedTexels;
+};
+//! Hex of the block, then the RGBA8 texels in row order
+struct SBC7Vector
+{
+	const char* block;
+	const char* texels;
+};
+
+static const SBC6HVector BC6HVectors[] = {
+	// mode 1, 2 regions, 10 bit endpoints, 5 bit deltas
+	{"0c9f7feafd8552add52789b6dc13f146",
+		"1e0e 1e87 5b86 1e17 1ef0 5bba 1fbc 1df0 5bf9 1fbc 1df0 5bf9 "
+		"1e01 1de5 5b34 1fa7 1dcd 5bda 1f8e 1da7 5bb9 1fe8 1e36 5c36 "
+		"1f63 1d61 5b7c 1f63 1d61 5b7c 1f79 1d84 5b9a 1fa7 1dcd 5bda "
+		"1fe8 1e36 5c36 1fd2 1e13 5c17 1f4d 1d3e 5b5d 1f63 1d61 5b7c",
+		"3c1d 3d0f c131 3c2f 3de1 c0c9 3f79 3be1 c04b 3f79 3be1 c04b "
+		"3c02 3bca c1d4 3f4e 3b9b c088 3f1d 3b4e c0cb 3fd1 3c6d bfd1 "
+		"3ec6 3ac2 c145 3ec6 3ac2 c145 3ef2 3b08 c108 3f4e 3b9b c088 "
+		"3fd1 3c6d bfd1 3fa5 3c27 c00e 3e9b 3a7d c183 3ec6 3ac2 c145"},
+	// mode 2, 2 regions, 7 bit endpoints, 6 bit deltas
+	{"b5b054e7356eaf8b10f918ae1857a811",
+		"06f6 26d7 5348 0625 2785 6196 08b0 2567 3515 07c7 2628 44fa "
+		"0981 24b8 26c7 0554 2834 6fe4 07c7 2628 44fa 4871 1567 2be1 "
+		"07c7 2628 44fa 0981 24b8 26c7 0d14 1f7c 54c4 29f5 1a94 40e0 "
+		"0981 24b8 26c7 1b84 1d08 4ad2 29f5 1a94 40e0 0d14 1f7c 54c4",
+		"0ded 4dae 8d14 0c4a 4f0b 939e 1160 4ace 00ba 0f8f 4c51 868a "
+		"1303 4971 0744 0aa8 5068 9a28 0f8f 4c51 868a 0064 2ace 91ae "
+		"0f8f 4c51 868a 1303 4971 0744 1a28 3ef8 d068 0d9f 3529 b1e4 "
+		"1303 4971 0744 13e3 3a10 c126 0d9f 3529 b1e4 1a28 3ef8 d068"},
+	// mode 3, 2 regions, 11 bit endpoints, 5/4/4 bit deltas
+	{"2264b90e5d8ee9dcfb7bcb49b89de48e",
+		"30b7 165d 6515 30ea 164a 64f5 3031 1699 6515 3022 1681 6515 "
+		"30ea 164a 64f5 3058 16db 6515 3008 1656 6515 3101 1642 64e6 "
+		"3101 1642 64e6 3031 1699 6515 303e 16af 6515 30b7 165d 6515 "
+		"3008 1656 6515 3015 166b 6515 30cf 1654 6506 30ea 164a 64f5",
+		"616e 2cba adf3 61d4 2c95 ae33 6063 2d33 adf4 6045 2d03 adf4 "
+		"61d4 2c95 ae33 60b1 2db6 adf4 6011 2cac adf4 6203 2c84 ae52 "
+		"6203 2c84 ae52 6063 2d33 adf4 607d 2d5f adf4 616e 2cba adf3 "
+		"6011 2cac adf4 602b 2cd7 adf4 619e 2ca9 ae11 61d4 2c95 ae33"},
+	// mode 4, 2 regions, 11 bit endpoints, 4/5/4 bit deltas
+	{"e6cbb64d4b8ac07ba39896e22bf411f2",
+		"24b9 3529 57a4 24b9 3529 57a4 24d7 34a0 5747 24d7 34a0 5747 "
+		"246b 3556 57f2 245b 355f 5801 24a9 3532 57b3 24d7 34a0 5747 "
+		"2489 3545 57d3 246b 3556 57f2 245b 355f 5801 24c8 3521 5794 "
+		"24b9 3529 57a4 2489 3545 57d3 2489 3545 57d3 245b 355f 5801",
+		"4972 6a53 c8d6 4972 6a53 c8d6 49af 6940 c990 49af 6940 c990 "
+		"48d6 6aad c83a 48b7 6abe c81c 4953 6a65 c8b8 49af 6940 c990 "
+		"4913 6a8a c877 48d6 6aad c83a 48b7 6abe c81c 4990 6a42 c8f5 "
+		"4972 6a53 c8d6 4913 6a8a c877 4913 6a8a c877 48b7 6abe c81c"},
+	// mode 5, 2 regions, 11 bit endpoints, 4/4/5 bit deltas
+	{"eac555157bf534d6c3a50c2535937175",
+		"21d9 2990 5631 21e0 2962 55e2 21d5 2939 55e2 21e2 291f 55d3 "
+		"21de 2971 55fc 21ac 298a 5611 219f 29a5 5621 21b9 2970 5602 "
+		"21de 2971 55fc 21e2 291f 55d3 21c8 2953 55f1 21b9 2970 5602 "
+		"21c8 2953 55f1 21ac 298a 5611 219f 29a5 5621 21e2 291f 55d3",
+		"43b3 5320 cbbc 43c0 52c4 cc59 43ab 5273 cc5a 43c5 523e cc78 "
+		"43bc 52e3 cc25 4359 5315 cbfb 433f 534a cbdc 4373 52e1 cc19 "
+		"43bc 52e3 cc25 43c5 523e cc78 4391 52a7 cc3b 4373 52e1 cc19 "
+		"4391 52a7 cc3b 4359 5315 cbfb 433f 534a cbdc 43c5 523e cc78"},
+	// mode 6, 2 regions, 9 bit endpoints, 5 bit deltas
+	{"2e903d0926a0eaa15d1ee07ae4d38011",
+		"1f5d 1de9 3f17 2032 1b9e 3fb6 1f9e 1f15 3f47 1f01 2012 3eb3 "
+		"1fc5 1cc9 3f65 1fec 1c5e 3f82 203b 1e18 3fdb 1e65 210f 3e1f "
+		"1f7f 1d89 3f31 200f 1bfe 3f9c 2224 1b05 41a8 22c1 1a09 423d "
+		"1fec 1c5e 3f82 1f7f 1d89 3f31 2187 1c02 4114 22c1 1a09 423d",
+		"3eba 3bd2 fa4e 4064 373d f90e 3f3d 3e2a f9bf 3e03 4024 fadf "
+		"3f8b 3992 f9b1 3fd8 38bd f976 4077 3c30 f89f 3cca 421e fbff "
+		"3eff 3b12 fa19 401e 37fd f942 4448 360b f521 4582 3412 f402 "
+		"3fd8 38bd f976 3eff 3b12 fa19 430e 3805 f641 4582 3412 f402"},
+	// mode 7, 2 regions, 8 bit endpoints, 6/5/5 bit deltas
+	{"72413eadbd4597fd9a1ec1f67b00992d",
+		"0592 3c4e 67e6 030c 3a9f 667f 026f 3a37 6628 026f 3a37 6628 "
+		"0136 3966 657a 03bb 3b14 66e0 0136 3966 657a 04f5 3be5 678e "
+		"0592 3c4e 67e6 0592 3c4e 67e6 0458 3b7c 6737 0535 3c2f 61df "
+		"030c 3a9f 667f 026f 3a37 6628 064c 3b18 6225 0bde 3586 638a",
+		"0b24 789c a92c 0619 753f abf8 04df 746e aca7 04df 746e aca7 "
+		"026c 72cc ae04 0776 7628 ab37 026c 72cc ae04 09ea 77ca a9da "
+		"0b24 789c a92c 0b24 789c a92c 08b0 76f9 aa88 0a6a 785e b538 "
+		"0619 753f abf8 04df 746e aca7 0c98 7630 b4ad 17bc 6b0c b1e4"},
+	// mode 8, 2 regions, 8 bit endpoints, 5/6/5 bit deltas
+	{"d6e433952d0a80448c7bdf8960ffdcec",
+		"13ab 3222 63ec 1463 3222 6538 127d 3803 5cbc 115a 366c 5d43 "
+		"12a6 3222 6216 1488 3adf 5bc8 158e 3c4e 5b4e 13ab 3222 63ec "
+		"1512 3222 6672 0e4a 3222 5eb2 127d 3803 5cbc 14ba 3222 65d5 "
+		"1055 34fe 5dbd 1488 3adf 5bc8 13ab 3222 63ec 1512 3222 6672",
+		"2757 6444 b11e 28c7 6444 ae87 24fa 7006 bf7f 22b5 6cd9 be70 "
+		"254c 6444 b4cc 2910 75bf c167 2b1c 789c c25c 2757 6444 b11e "
+		"2a24 6444 ac14 1c94 6444 bb94 24fa 7006 bf7f 2975 6444 ad4d "
+		"20aa 69fc bd7c 2910 75bf c167 2757 6444 b11e 2a24 6444 ac14"},
+	// mode 9, 2 regions, 8 bit endpoints, 5/5/6 bit deltas
+	{"fa48262a8b99424225267fe5afb0ce1a",
+		"1f91 229a 493b 1b5e 1f3e 4a5a 2096 236b 48f5 219c 243c 48af "
+		"2872 212e 38ea 1b5e 1f3e 4a5a 1d69 20e0 49ce 2096 236b 48f5 "
+		"1bda 2ade 5502 1c63 200f 4a14 2096 236b 48f5 1b5e 1f3e 4a5a "
+		"2321 2544 44c4 24e7 23e7 40d0 1c63 200f 4a14 22a2 250e 486a",
+		"3f22 4534 e681 36bc 3e7c e444 412d 46d7 e70d 4338 4879 e798 "
+		"50e4 425c 71d4 36bc 3e7c e444 3ad2 41c1 e55b 412d 46d7 e70d "
+		"37b4 55bc cef4 38c7 401e e4cf 412d 46d7 e70d 36bc 3e7c e444 "
+		"4643 4a88 207f 49ce 47cf 3b9b 38c7 401e e4cf 4544 4a1c e824"},
+	// mode 10, 2 regions, 6 bit endpoints, no transform
+	{"9e39885075222823890e698bc327a89f",
+		"194f 17cb 3bf1 1b8c 06fe 15db 1b8c 06fe 15db 194f 17cb 3bf1 "
+		"1a75 0f2a 2862 19da 13b5 32ad 1838 1ff8 4e78 1c18 02e8 0c98 "
+		"19da 13b5 32ad 194f 17cb 3bf1 1838 1ff8 4e78 1657 0dce 1e65 "
+		"1b01 0b14 1f1f 1c18 02e8 0c98 1d27 1341 2463 1657 0dce 1e65",
+		"329e 2f97 bd27 3719 0dfc 084b 3719 0dfc 084b 329e 2f97 bd27 "
+		"34eb 1e55 997d 33b5 276a ac42 3070 3ff0 def0 3830 05d0 1930 "
+		"33b5 276a ac42 329e 2f97 bd27 3070 3ff0 def0 2caf 1b9c 3d55 "
+		"3602 1629 8899 3830 05d0 1930 3a4e 2682 4998 2caf 1b9c 3d55"},
+	// mode 11, 1 region, 10 bit endpoints, no transform
+	{"03b99186ac41bb461c25e63c7164d1a2",
+		"2374 2c4d 30a0 343a 24af 42db 2744 2a91 34c5 306a 266a 3eb7 "
+		"2374 2c4d 30a0 0987 3812 1473 1064 34f5 1be8 2d5d 27cc 3b66 "
+		"343a 24af 42db 2067 2daf 2d4f 2a51 292f 3815 2374 2c4d 30a0 "
+		"343a 24af 42db 0d57 3657 1897 306a 266a 3eb7 167d 3230 2289",
+		"46e8 589a b223 6875 495e e302 4e88 5523 bd3f 60d5 4cd4 d7e7 "
+		"46e8 589a b223 130e 7025 1962 20c8 69ea 0564 5abb 4f99 cf04 "
+		"6875 495e e302 40ce 5b5f a941 54a2 525e c621 46e8 589a b223 "
+		"6875 495e e302 1aae 6caf 0e47 60d5 4cd4 d7e7 2cfb 6460 8c60"},
+	// mode 12, 1 region, 11 bit endpoints, 9 bit deltas
+	{"c7a34f03954db6188751696de989ae4f",
+		"1063 27b2 6571 0ed6 2625 666a 110d 285c 6506 0fcc 271b 65d0 "
+		"0e8a 25da 669a 0f6d 26bd 660b 0d49 2499 6764 0f6d 26bd 660b "
+		"0e8a 25da 669a 0ceb 243a 679f 0e8a 25da 669a 0ed6 2625 666a "
+		"0ceb 243a 679f 0e2c 257b 66d5 0c9f 23ef 67ce 1017 2767 65a1",
+		"20c6 4f65 ad3b 1dac 4c4b ab49 221a 50b9 ae11 1f98 4e37 ac7d "
+		"1d15 4bb4 aaea 1edb 4d7a ac07 1a93 4932 a956 1edb 4d7a ac07 "
+		"1d15 4bb4 aaea 19d6 4875 a8e0 1d15 4bb4 aaea 1dac 4c4b ab49 "
+		"19d6 4875 a8e0 1c58 4af7 aa73 193f 47de a881 202f 4ece acdc"},
+	// mode 13, 1 region, 12 bit endpoints, 8 bit deltas
+	{"2b6847fd6d13148e0b30331e07f50eb5",
+		"3950 12dc 747b 383b 13d0 7434 383b 13d0 7434 38e7 1339 7460 "
+		"38e7 1339 7460 38e7 1339 7460 3b53 1116 74ff 3870 13a1 7441 "
+		"39c7 1273 749a 383b 13d0 7434 3950 12dc 747b 3b88 10e8 750d "
+		"3b53 1116 74ff 383b 13d0 7434 3950 12dc 747b 3aa8 11ae 74d3",
+		"72a1 25b8 8f18 7077 27a0 8fa6 7077 27a0 8fa6 71ce 2672 8f4e "
+		"71ce 2672 8f4e 71ce 2672 8f4e 76a7 222d 8e0f 70e0 2743 8f8b "
+		"738f 24e7 8edb 7077 27a0 8fa6 72a1 25b8 8f18 7710 21d0 8df4 "
+		"76a7 222d 8e0f 7077 27a0 8fa6 72a1 25b8 8f18 7550 235c 8e68"},
+	// mode 14, 1 region, 16 bit endpoints, 4 bit deltas
+	{"2f61f8894198ccedc687d9d13d1341ba",
+		"0747 3258 597e 0745 3259 597d 0746 3259 597d 0746 3259 597d "
+		"0745 3259 597d 0744 3259 597d 0748 3258 597e 0744 3259 597d "
+		"0744 3259 597d 0747 3258 597e 0747 3258 597e 0748 3258 597e "
+		"0748 3258 597e 0747 3258 597e 0745 3259 597d 0745 3259 597d",
+		"0e8e 64b1 c503 0e8a 64b3 c506 0e8c 64b2 c504 0e8c 64b2 c505 "
+		"0e8b 64b2 c505 0e89 64b3 c506 0e90 64b0 c502 0e89 64b3 c506 "
+		"0e89 64b3 c506 0e8e 64b1 c503 0e8e 64b1 c503 0e90 64b0 c502 "
+		"0e90 64b0 c502 0e8e 64b1 c503 0e8b 64b3 c505 0e8a 64b3 c506"},
+};
+static const SBC7Vector BC7Vectors[] = {
+	// mode 0
+	{"f501a55f146936ca14b30450a261c184",
+		"ff2918ff ff2918ff ff2918ff b74c28ff "
+		"7d8273ff 7d8273ff 6e777bff 304c9dff "
+		"d63184ff f9a999ff e2588bff d63184ff "
+		"f9a999ff ee8292ff d63184ff e2588bff"},
+	// mode 1
+	{"267fc76071eda0a98da9f5e89a42c713",
+		"ecc9aeff 76d7dbff 37476aff 3e5675ff "
+		"76d7dbff 3e5675ff 44647fff 3e5675ff "
+		"37476aff 4c758aff 59929fff 37476aff "
+		"59929fff 44647fff 3e5675ff 303860ff"},
+	// mode 2
+	{"745e0168439d81997436aded3940e16b",
+		"60d38cff 29ce6bff 0000d6ff 0000d6ff "
+		"7bd69cff 0000d6ff 2c21d6ff a2a262ff "
+		"0000d6ff 0000d6ff 84a539ff 84a539ff "
+		"1610d6ff c09f8cff 84a539ff de9cb5ff"},
+	// mode 3
+	{"787b4ff7e95e2f4af5bc6331e3c504fc",
+		"bcf67aff bcf67aff d74ac6ff a753c5ff "
+		"d74ac6ff 98f590ff bcf67aff a753c5ff "
+		"ef45c7ff d74ac6ff bcf67aff bcf67aff "
+		"bcf67aff a753c5ff a753c5ff 4ef4bcff"},
+	// mode 4
+	{"706bbf3d6432dfd63a0b3e67b583c33e",
+		"859b6c41 dedecf94 b3be876b 859b6c41 "
+		"dedeb794 b3be546b b3be9f6b 859b9f41 "
+		"859b6c41 dede2494 859bb741 b3be3c6b "
+		"859b8741 859b9f41 5a7bcf18 5a7b3c18"},
+	// mode 5
+	{"604d2e106e12fc53fad6ac95d952c0ab",
+		"ff814c9b b7e104b9 dce104b9 94a134a5 "
+		"b7e104b9 ffc21caf dcc21caf dca134a5 "
+		"ffc21caf ffa134a5 ffa134a5 94e104b9 "
+		"94c21caf b7c21caf b7814c9b b7e104b9"},
+	// mode 6
+	{"409fd4e639adbb965999400f7f4ceb3b",
+		"88607395 8a5d7c8c 9551a067 9551a067 "
+		"7d6d4fbb 88607395 a53dd72d 7d6d4fbb "
+		"a53dd72d 90578f78 9d47bb4a 88607395 "
+		"9a4ab353 a340cf36 9a4ab353 85636b9e"},
+	// mode 7
+	{"807e069efcfa8f0c09b99d8eac77cf91",
+		"8ae26695 8ae26695 aebb4643 45c738bb "
+		"04ae0cdf 8ae26695 20384138 8ae26695 "
+		"20384138 20384138 f3fb4949 04ae0cdf "
+		"aebb4643 f3fb4949 aebb4643 45c738bb"},
+};
+
+static void hexToBytes(const char* hex, uint8_t* out, size_t count)
+{
+	for (size_t i=0u; i<count; i++)
+	{
+		const char byte[3] = {hex[2u*i],hex[2u*i+1u],0};
+		out[i] = static_cast<uint8_t>(strtoul(byte,nullptr,16));
+	}
+}
+
+//! Parses whitespace separated hex numbers
+static core::vector<uint32_t> hexWords(const char* str)
+{
+	core::vector<uint32_t> words;
+	for (char* end; ; str=end)
+	{
+		const uint32_t word = static_cast<uint32_t>(strtoul(str,&end,16));
+		if (end==str)
+			break;
+		words.push_back(word);
+	}
+	return words;
+}
+
+//! Decodes through the public entry point, the result has to match to the last bit
+static bool decodesTo(E_FORMAT format, const void* block, const double expected[16][4])
+{
+	double texels[16][4];
+	if (!video::decodeBlock(format,block,texels))
+		return false;
+	return memcmp(texels,expected,sizeof(texels))==0;
+}
+
+static bool matchesBC6HVector(E_FORMAT format, const char* blockHex, const char* texelsHex)
+{
+	uint8_t block[16];
+	hexToBytes(blockHex,block,16u);
+	const auto halfs = hexWords(texelsHex);
+	if (halfs.size()!=48u)
+		return false;
+	double expected[16][4];
+	for (uint32_t i=0u; i<16u; i++)
+	{
+		for (uint32_t c=0u; c<3u; c++)
+			expected[i][c] = core::Float16Compressor::decompress(static_cast<uint16_t>(halfs[3u*i+c]));
+		expected[i][3] = 1.;
+	}
+	return decodesTo(format,block,expected);
+}
+
+static bool matchesBC7Vector(const SBC7Vector& vector)
+{
+	uint8_t block[16];
+	hexToBytes(vector.block,block,16u);
+	const auto texels = hexWords(vector.texels);
+	if (texels.size()!=16u)
+		return false;
+	double expected[16][4];
+	for (uint32_t i=0u; i<16u; i++)
+	for (uint32_t c=0u; c<4u; c++)
+		expected[i][c] = ((texels[i]>>(24u-8u*c))&0xffu)/255.;
+	return decodesTo(EF_BC7_UNORM_BLOCK,block,expected);
+}
+
+//! Expected texels of the 8 byte blocks, every texel takes entry `indices[i]` of an RGBA8 palette
+static bool matchesPalette(E_FORMAT format, const uint8_t* block, const uint8_t palette[][4], const uint32_t indices[16])
+{
+	double expected[16][4];
+	for (uint32_t i=0u; i<16u; i++)
+	for (uint32_t c=0u; c<4u; c++)
+		expected[i][c] = palette[indices[i]][c]/255.;
+	return decodesTo(format,block,expected);
+}
+
+//! Expected texels of the signed BC4 blocks, red from a palette of [-127,127] values
+static bool matchesSignedPalette(const uint8_t* block, const int8_t palette[8], const uint32_t indices[16])
+{
+	double expected[16][4];
+	for (uint32_t i=0u; i<16u; i++)
+	{
+		expected[i][0] = palette[indices[i]]/127.;
+		expected[i][1] = expected[i][2] = 0.;
+		expected[i][3] = 1.;
+	}
+	return decodesTo(EF_BC4_SNORM_BLOCK,block,expected);
+}
+
+//! Blocks worked out by hand from the BC1-BC5 palette rules, every endpoint order and both BC4 palette sizes
+static void checkPaletteBlocks(TestChecks& check)
+{
+	uint32_t fourColorIndices[16], eightValueIndices[16], reverseEightValueIndices[16];
+	for (uint32_t i=0u; i<16u; i++)
+	{
+		fourColorIndices[i] = i%4u;
+		eightValueIndices[i] = i%8u;
+		reverseEightValueIndices[i] = 7u-i%8u;
+	}
+	// 2 bit indices 0,1,2,3 in every row, and 3 bit indices 0..7 twice over
+	const uint8_t fourColorLUT[4] = {0xe4u,0xe4u,0xe4u,0xe4u};
+	const uint8_t eightValueLUT[6] = {0x88u,0xc6u,0xfau,0x88u,0xc6u,0xfau};
+	const uint8_t reverseEightValueLUT[6] = {0x77u,0x39u,0x05u,0x77u,0x39u,0x05u};
+
+	// red 0xf800 above blue 0x001f, the 4 color palette with thirds rounded to nearest
+	const uint8_t redBlue[8] = {0x00u,0xf8u,0x1fu,0x00u,0xe4u,0xe4u,0xe4u,0xe4u};
+	const uint8_t redBluePalette[4][4] = {{255,0,0,255},{0,0,255,255},{170,0,85,255},{85,0,170,255}};
+	check(matchesPalette(EF_BC1_RGB_UNORM_BLOCK,redBlue,redBluePalette,fourColorIndices),"BC1 4 color block");
+	check(matchesPalette(EF_BC1_RGBA_UNORM_BLOCK,redBlue,redBluePalette,fourColorIndices),"BC1 RGBA 4 color block is opaque");
+
+	// blue not above red, 3 colors with the midpoint rounded up and index 3 transparent black
+	const uint8_t blueRed[8] = {0x1fu,0x00u,0x00u,0xf8u,0xe4u,0xe4u,0xe4u,0xe4u};
+	const uint8_t blueRedRGBAPalette[4][4] = {{0,0,255,255},{255,0,0,255},{128,0,128,255},{0,0,0,0}};
+	const uint8_t blueRedRGBPalette[4][4] = {{0,0,255,255},{255,0,0,255},{128,0,128,255},{0,0,0,255}};
+	check(matchesPalette(EF_BC1_RGBA_UNORM_BLOCK,blueRed,blueRedRGBAPalette,fourColorIndices),"BC1 RGBA 3 color block with transparent texels");
+	check(matchesPalette(EF_BC1_RGB_UNORM_BLOCK,blueRed,blueRedRGBPalette,fourColorIndices),"BC1 RGB 3 color block with black texels");
+
+	// 0x8410 is 16,32,16 which expands to 132,130,132 by repeating the top bits
+	const uint8_t expansion[8] = {0x10u,0x84u,0x00u,0x00u,0x00u,0x00u,0x00u,0x00u};
+	const uint8_t expansionPalette[1][4] = {{132,130,132,255}};
+	const uint32_t zeroIndices[16] = {};
+	check(matchesPalette(EF_BC1_RGB_UNORM_BLOCK,expansion,expansionPalette,zeroIndices),"BC1 565 endpoint expansion");
+
+	// sRGB variants decode the same bytes and then linearize
+	{
+		double expected[16][4];
+		for (uint32_t i=0u; i<16u; i++)
+		{
+			for (uint32_t c=0u; c<3u; c++)
+			{
+				const double encoded = redBluePalette[fourColorIndices[i]][c]/255.;
+				expected[i][c] = encoded<=0.04045 ? encoded/12.92:std::pow((encoded+0.055)/1.055,2.4);
+			}
+			expected[i][3] = 1.;
+		}
+		double texels[16][4];
+		bool close = video::decodeBlock(EF_BC1_RGB_SRGB_BLOCK,redBlue,texels);
+		for (uint32_t i=0u; i<16u; i++)
+		for (uint32_t c=0u; c<4u; c++)
+			close = close && std::abs(texels[i][c]-expected[i][c])<1e-12;
+		check(close,"BC1 sRGB block decodes to linear");
+	}
+
+	// BC2 alpha nibbles 0..15 in texel order, the color half always has 4 colors even with blue not above red
+	{
+		uint8_t block[16] = {0x10u,0x32u,0x54u,0x76u,0x98u,0xbau,0xdcu,0xfeu};
+		memcpy(block+8,blueRed,8u);
+		const uint8_t colors[4][3] = {{0,0,255},{255,0,0},{85,0,170},{170,0,85}};
+		double expected[16][4];
+		for (uint32_t i=0u; i<16u; i++)
+		{
+			for (uint32_t c=0u; c<3u; c++)
+				expected[i][c] = colors[fourColorIndices[i]][c]/255.;
+			expected[i][3] = (i*17u)/255.;
+		}
+		check(decodesTo(EF_BC2_UNORM_BLOCK,block,expected),"BC2 explicit alpha with 4 colors regardless of endpoint order");
+	}
+
+	// BC3 alpha 255 above 0, 8 values with sevenths rounded to nearest
+	{
+		uint8_t block[16] = {0xffu,0x00u};
+		memcpy(block+2,eightValueLUT,6u);
+		memcpy(block+8,redBlue,8u);
+		const uint8_t alphas[8] = {255,0,219,182,146,109,73,36};
+		double expected[16][4];
+		for (uint32_t i=0u; i<16u; i++)
+		{
+			for (uint32_t c=0u; c<3u; c++)
+				expected[i][c] = redBluePalette[fourColorIndices[i]][c]/255.;
+			expected[i][3] = alphas[eightValueIndices[i]]/255.;
+		}
+		check(decodesTo(EF_BC3_UNORM_BLOCK,block,expected),"BC3 8 value alpha");
+	}
+
+	// BC4 0 not above 200, 6 values in fifths plus 0 and 255
+	const uint8_t sixValues[8] = {0x00u,0xc8u,0x88u,0xc6u,0xfau,0x88u,0xc6u,0xfau};
+	const uint8_t sixValuePalette[8][4] = {{0,0,0,255},{200,0,0,255},{40,0,0,255},{80,0,0,255},{120,0,0,255},{160,0,0,255},{0,0,0,255},{255,0,0,255}};
+	check(matchesPalette(EF_BC4_UNORM_BLOCK,sixValues,sixValuePalette,eightValueIndices),"BC4 6 value block");
+
+	// BC5 is two BC4 halves, red with 8 values and green with 6 in reverse order
+	{
+		uint8_t block[16] = {0xffu,0x00u};
+		memcpy(block+2,eightValueLUT,6u);
+		block[8] = 0x00u;
+		block[9] = 0xc8u;
+		memcpy(block+10,reverseEightValueLUT,6u);
+		const uint8_t reds[8] = {255,0,219,182,146,109,73,36};
+		double expected[16][4];
+		for (uint32_t i=0u; i<16u; i++)
+		{
+			expected[i][0] = reds[eightValueIndices[i]]/255.;
+			expected[i][1] = sixValuePalette[reverseEightValueIndices[i]][0]/255.;
+			expected[i][2] = 0.;
+			expected[i][3] = 1.;
+		}
+		check(decodesTo(EF_BC5_UNORM_BLOCK,block,expected),"BC5 block with both palette sizes");
+	}
+
+	// signed BC4, 100 above -100 gives 8 values, -128 reads as -127 and with 127 gives 6 values plus -127 and 127
+	{
+		uint8_t block[8] = {0x64u,0x9cu};
+		memcpy(block+2,eightValueLUT,6u);
+		const int8_t palette[8] = {100,-100,71,43,14,-14,-43,-71};
+		check(matchesSignedPalette(block,palette,eightValueIndices),"Signed BC4 8 value block");
+	}
+	{
+		uint8_t block[8] = {0x80u,0x7fu};
+		memcpy(block+2,eightValueLUT,6u);
+		const int8_t palette[8] = {-127,127,-76,-25,25,76,-127,127};
+		check(matchesSignedPalette(block,palette,eightValueIndices),"Signed BC4 6 value block with -128 clamped");
+	}
+}
+
+static void checkKnownAnswers(TestChecks& check)
+{
+	checkPaletteBlocks(check);
+
+	char what[64];
+	for (uint32_t i=0u; i<sizeof(BC6HVectors)/sizeof(SBC6HVector); i++)
+	{
+		sprintf(what,"BC6H mode %u unsigned known answer",i+1u);
+		check(matchesBC6HVector(EF_BC6H_UFLOAT_BLOCK,BC6HVectors[i].block,BC6HVectors[i].unsignedTexels),what);
+		sprintf(what,"BC6H mode %u signed known answer",i+1u);
+		check(matchesBC6HVector(EF_BC6H_SFLOAT_BLOCK,BC6HVectors[i].block,BC6HVectors[i].signedTexels),what);
+	}
+	for (uint32_t i=0u; i<sizeof(BC7Vectors)/sizeof(SBC7Vector); i++)
+	{
+		sprintf(what,"BC7 mode %u known answer",i);
+		check(matchesBC7Vector(BC7Vectors[i]),what);
+	}
+
+	// reserved modes decode to zero instead of garbage, BC6H mode 10011 and a BC7 block without a mode bit
+	{
+		uint8_t block[16];
+		hexToBytes("13c5a7e9010203040506070809fafbfc",block,16u);
+		double expected[16][4] = {};
+		for (auto& texel : expected)
+			texel[3] = 1.;
+		check(decodesTo(EF_BC6H_UFLOAT_BLOCK,block,expected),"Reserved BC6H mode decodes to black");
+		block[0] = 0x00u;
+		memset(expected,0,sizeof(expected));
+		check(decodesTo(EF_BC7_UNORM_BLOCK,block,expected),"Reserved BC7 mode decodes to transparent black");
+	}
+
+	// a row of blocks has to put every block's texels in the right place of the 4 rows
+	{
+		uint8_t blocks[32];
+		hexToBytes(BC7Vectors[1].block,blocks,16u);
+		hexToBytes(BC7Vectors[6].block,blocks+16,16u);
+		double row[4][8][4];
+		double first[16][4], second[16][4];
+		bool matches = video::decodeBlockRow(EF_BC7_UNORM_BLOCK,blocks,2u,&row[0][0][0]);
+		video::decodeBlock(EF_BC7_UNORM_BLOCK,blocks,first);
+		video::decodeBlock(EF_BC7_UNORM_BLOCK,blocks+16,second);
+		for (uint32_t y=0u; y<4u; y++)
+		{
+			matches = matches && memcmp(row[y][0],first[4u*y],sizeof(double)*16u)==0;
+			matches = matches && memcmp(row[y][4],second[4u*y],sizeof(double)*16u)==0;
+		}
+		check(matches,"decodeBlockRow lays out blocks side by side");
+	}
+}
+
+
+//! Texels on `steps` evenly spaced points of a line between two random colors, with a little noise off the line
+/** That is what the encoders are built for, the palettes of the formats have 4, 8 or 16 entries on such a line.*/
+static void createGradientBlock(std::mt19937& rng, uint32_t steps, double texels[16][4])
+{
+	std::uniform_real_distribution<double> unit(0.,1.);
+	std::uniform_real_distribution<double> noise(-1./255.,1./255.);
+	double ends[2][4];
+	for (auto& end : ends)
+	for (uint32_t c=0u; c<4u; c++)
+		end[c] = unit(rng);
+	for (uint32_t i=0u; i<16u; i++)
+	{
+		const double t = double(rng()%steps)/double(steps-1u);
+		for (uint32_t c=0u; c<4u; c++)
+			texels[i][c] = core::clamp(ends[0][c]+(ends[1][c]-ends[0][c])*t+noise(rng),0.,1.);
+	}
+}
+
+//! Largest difference over the channels the format stores, after an encode and decode round trip
+static double roundTripError(E_FORMAT format, uint32_t channels, const double texels[16][4], video::E_BLOCK_ENCODE_QUALITY quality, double* sumOfSquares=nullptr)
+{
+	uint8_t block[16];
+	double decoded[16][4];
+	if (!video::encodeBlock(format,texels,block,quality) || !video::decodeBlock(format,block,decoded))
+		return 1.;
+	double maxError = 0.;
+	for (uint32_t i=0u; i<16u; i++)
+	for (uint32_t c=0u; c<channels; c++)
+	{
+		const double error = std::abs(decoded[i][c]-texels[i][c]);
+		maxError = std::max(maxError,error);
+		if (sumOfSquares)
+			*sumOfSquares += error*error;
+	}
+	return maxError;
+}
+
+static void checkEncoders(TestChecks& check)
+{
+	// error bounds over gradient blocks with as many steps as the smallest palette of the format, the fast quality gets more slack
+	// and the sRGB variants get linear gradients, which do not fall on their evenly spaced encoded palettes
+	struct SEncodedFormat
+	{
+		E_FORMAT format;
+		const char* name;
+		uint32_t channels;
+		uint32_t steps;
+		double fastBound;
+		double bound;
+	};
+	const SEncodedFormat formats[] = {
+		{EF_BC1_RGB_UNORM_BLOCK,"BC1 RGB",3u,4u,0.08,0.06},
+		{EF_BC1_RGB_SRGB_BLOCK,"BC1 RGB sRGB",3u,4u,0.28,0.24},
+		{EF_BC2_UNORM_BLOCK,"BC2",4u,4u,0.1,0.08},
+		{EF_BC3_UNORM_BLOCK,"BC3",4u,4u,0.12,0.09},
+		{EF_BC4_UNORM_BLOCK,"BC4",1u,8u,0.05,0.045},
+		{EF_BC5_UNORM_BLOCK,"BC5",2u,8u,0.055,0.05},
+		{EF_BC7_UNORM_BLOCK,"BC7",4u,4u,0.02,0.015},
+		{EF_BC7_SRGB_BLOCK,"BC7 sRGB",4u,4u,0.22,0.21}
+	};
+	constexpr uint32_t BlockCount = 256u;
+	std::mt19937 rng(34u);
+	core::vector<double> gradients(BlockCount*64u);
+
+	char what[128];
+	for (const auto& format : formats)
+	{
+		sprintf(what,"%s is encodable",format.name);
+		check(video::isBlockEncodable(format.format),what);
+		for (uint32_t i=0u; i<BlockCount; i++)
+			createGradientBlock(rng,format.steps,reinterpret_cast<double(*)[4]>(gradients.data()+i*64u));
+		double maxError[3] = {};
+		double sumOfSquares[3] = {};
+		for (uint32_t i=0u; i<BlockCount; i++)
+		for (uint32_t q=video::EBEQ_FAST; q<=video::EBEQ_BEST; q++)
+		{
+			const auto texels = reinterpret_cast<const double(*)[4]>(gradients.data()+i*64u);
+			maxError[q] = std::max(maxError[q],roundTripError(format.format,format.channels,texels,static_cast<video::E_BLOCK_ENCODE_QUALITY>(q),sumOfSquares+q));
+		}
+		sprintf(what,"%s fast round trip error within %.3f",format.name,format.fastBound);
+		check(maxError[video::EBEQ_FAST]<=format.fastBound,what);
+		sprintf(what,"%s round trip error within %.3f",format.name,format.bound);
+		check(maxError[video::EBEQ_NORMAL]<=format.bound && maxError[video::EBEQ_BEST]<=format.bound,what);
+		sprintf(what,"%s higher qualities do not add error",format.name);
+		check(sumOfSquares[video::EBEQ_BEST]<=sumOfSquares[video::EBEQ_NORMAL] && sumOfSquares[video::EBEQ_NORMAL]<=sumOfSquares[video::EBEQ_FAST],what);
+	}
+
+	// flat blocks of a representable value must come back exactly
+	{
+		bool exact = true;
+		for (uint32_t i=0u; i<64u && exact; i++)
+		{
+			// random 565 color, expanded the way the decoder does it
+			const uint32_t r = rng()%32u, g = rng()%64u, b = rng()%32u;
+			double texels[16][4];
+			for (auto& texel : texels)
+			{
+				texel[0] = ((r<<3u)|(r>>2u))/255.;
+				texel[1] = ((g<<2u)|(g>>4u))/255.;
+				texel[2] = ((b<<3u)|(b>>2u))/255.;
+				texel[3] = 1.;
+			}
+			for (uint32_t q=video::EBEQ_FAST; q<=video::EBEQ_BEST; q++)
+				exact = exact && roundTripError(EF_BC1_RGB_UNORM_BLOCK,3u,texels,static_cast<video::E_BLOCK_ENCODE_QUALITY>(q))==0.;
+		}
+		check(exact,"BC1 flat 565 colors round trip exactly");
+	}
+	{
+		bool exact = true;
+		for (uint32_t value=0u; value<256u && exact; value++)
+		{
+			double texels[16][4];
+			for (auto& texel : texels)
+			{
+				texel[0] = value/255.;
+				texel[1] = (255u-value)/255.;
+				texel[2] = 0.;
+				texel[3] = 1.;
+			}
+			for (uint32_t q=video::EBEQ_FAST; q<=video::EBEQ_BEST; q++)
+				exact = exact && roundTripError(EF_BC5_UNORM_BLOCK,2u,texels,static_cast<video::E_BLOCK_ENCODE_QUALITY>(q))==0.;
+		}
+		check(exact,"BC4 and BC5 flat values round trip exactly");
+	}
+	{
+		double worst = 0.;
+		for (uint32_t i=0u; i<64u; i++)
+		{
+			double texels[16][4];
+			double color[4];
+			for (auto& c : color)
+				c = (rng()%256u)/255.;
+			for (auto& texel : texels)
+				memcpy(texel,color,sizeof(color));
+			for (uint32_t q=video::EBEQ_FAST; q<=video::EBEQ_BEST; q++)
+				worst = std::max(worst,roundTripError(EF_BC7_UNORM_BLOCK,4u,texels,static_cast<video::E_BLOCK_ENCODE_QUALITY>(q)));
+		}
+		// one 8 bit step, with room for the rounding of the division
+		check(worst<=1.5/255.,"BC7 flat colors round trip within one step");
+	}
+
+	// BC1 with alpha punches through every texel below one half
+	{
+		bool punched = true;
+		for (uint32_t i=0u; i<BlockCount && punched; i++)
+		{
+			double texels[16][4];
+			memcpy(texels,gradients.data()+i*64u,sizeof(texels));
+			for (uint32_t j=0u; j<16u; j++)
+				texels[j][3] = (rng()%2u) ? 0.75:0.25;
+			uint8_t block[8];
+			double decoded[16][4];
+			video::encodeBlock(EF_BC1_RGBA_UNORM_BLOCK,texels,block);
+			video::decodeBlock(EF_BC1_RGBA_UNORM_BLOCK,block,decoded);
+			for (uint32_t j=0u; j<16u; j++)
+				punched = punched && decoded[j][3]==(texels[j][3]>0.5 ? 1.:0.);
+		}
+		check(punched,"BC1 RGBA alpha is transparent exactly below one half");
+	}
+
+	// nothing to encode signed or HDR formats with
+	{
+		double texels[16][4] = {};
+		uint8_t block[16];
+		const E_FORMAT notEncodable[] = {EF_BC4_SNORM_BLOCK,EF_BC5_SNORM_BLOCK,EF_BC6H_UFLOAT_BLOCK,EF_BC6H_SFLOAT_BLOCK,EF_R8G8B8A8_UNORM};
+		bool rejected = true;
+		for (auto format : notEncodable)
+			rejected = rejected && !video::isBlockEncodable(format) && !video::encodeBlock(format,texels,block);
+		check(rejected,"Signed, HDR and uncompressed formats are not encodable");
+	}
+}
+
+
+//! RGBA8 texel of level `level` of the DDS source texture
+static void sourceTexel(uint32_t level, uint32_t x, uint32_t y, uint8_t out[4])
+{
+	out[0] = uint8_t(x*13u+y*3u+level*40u);
+	out[1] = uint8_t(x*2u+y*17u);
+	out[2] = uint8_t(255u-x*9u-level*20u);
+	out[3] = uint8_t(128u+y*7u);
+}
+
+//! 20x12 with all 5 levels, so the edge blocks of the smaller levels are ragged
+static core::smart_refctd_ptr<ICPUTexture> createSourceTexture()
+{
+	core::vector<CImageData*> levels;
+	for (uint32_t level=0u; level<5u; level++)
+	{
+		const uint32_t minCoord[3] = {0u,0u,0u};
+		const uint32_t maxCoord[3] = {std::max(20u>>level,1u),std::max(12u>>level,1u),1u};
+		auto* image = new CImageData(nullptr,minCoord,maxCoord,level,EF_R8G8B8A8_UNORM);
+		uint8_t* data = reinterpret_cast<uint8_t*>(image->getData());
+		for (uint32_t y=0u; y<maxCoord[1]; y++)
+		for (uint32_t x=0u; x<maxCoord[0]; x++)
+			sourceTexel(level,x,y,data+y*image->getPitchIncludingAlignment()+x*4u);
+		levels.push_back(image);
+	}
+	auto texture = core::smart_refctd_ptr<ICPUTexture>(ICPUTexture::create(levels,"bcSource",video::ITexture::ETT_2D),core::dont_grab);
+	for (auto level : levels)
+		level->drop();
+	return texture;
+}
+
+//! Every block of the compressed texture has to be what encodeBlock() makes of the source texels, edge texels repeated
+static bool matchesBlockwiseEncode(const ICPUTexture* texture, E_FORMAT format)
+{
+	if (!texture || texture->getColorFormat()!=format || texture->getHighestMip()!=4u)
+		return false;
+	const uint32_t blockSize = getTexelOrBlockBytesize(format);
+	for (uint32_t level=0u; level<5u; level++)
+	{
+		const auto range = texture->getMipMap(level);
+		if (range.second-range.first!=1)
+			return false;
+		const CImageData* image = *range.first;
+		const auto size = image->getSize();
+		const uint8_t* block = reinterpret_cast<const uint8_t*>(image->getData());
+		for (uint32_t by=0u; by<(size.Y+3u)/4u; by++)
+		for (uint32_t bx=0u; bx<(size.X+3u)/4u; bx++, block+=blockSize)
+		{
+			double texels[16][4];
+			for (uint32_t i=0u; i<16u; i++)
+			{
+				uint8_t texel[4];
+				sourceTexel(level,std::min(bx*4u+i%4u,size.X-1u),std::min(by*4u+i/4u,size.Y-1u),texel);
+				for (uint32_t c=0u; c<4u; c++)
+					texels[i][c] = texel[c]/255.;
+			}
+			uint8_t expected[16];
+			video::encodeBlock(format,texels,expected,video::EBEQ_FAST);
+			if (memcmp(block,expected,blockSize)!=0)
+				return false;
+		}
+	}
+	return true;
+}
+
+//! A single level BC6H texture straight from the known answer blocks, the encoder cannot make those
+static core::smart_refctd_ptr<ICPUTexture> createBC6HTexture()
+{
+	const uint32_t minCoord[3] = {0u,0u,0u};
+	const uint32_t maxCoord[3] = {8u,8u,1u};
+	auto* image = new CImageData(nullptr,minCoord,maxCoord,0u,EF_BC6H_SFLOAT_BLOCK);
+	for (uint32_t i=0u; i<4u; i++)
+		hexToBytes(BC6HVectors[i*3u].block,reinterpret_cast<uint8_t*>(image->getData())+i*16u,16u);
+	core::vector<CImageData*> levels = {image};
+	auto texture = core::smart_refctd_ptr<ICPUTexture>(ICPUTexture::create(levels,"bc6hSource",video::ITexture::ETT_2D),core::dont_grab);
+	image->drop();
+	return texture;
+}
+
+static uint32_t readU32(const core::vector<uint8_t>& file, size_t offset)
+{
+	uint32_t value = 0u;
+	if (offset+4u<=file.size())
+		memcpy(&value,file.data()+offset,4u);
+	return value;
+}
+
+//! Writes `texture` as DDS, checks the header field by field and the payload, then loads it back and compares the levels
+static bool roundTripsThroughDDS(IrrlichtDevice* device, const ICPUTexture* texture, const char* name, uint32_t dxgiFormat)
+{
+	if (!texture)
+		return false;
+	IAssetManager* am = device->getAssetManager();
+	if (!am->writeAsset(name,IAssetWriter::SAssetWriteParams(const_cast<ICPUTexture*>(texture))))
+		return false;
+
+	core::vector<uint8_t> file;
+	{
+		io::IReadFile* readFile = device->getFileSystem()->createAndOpenFile(name);
+		if (!readFile)
+			return false;
+		file.resize(readFile->getSize());
+		const bool readAll = readFile->read(file.data(),static_cast<uint32_t>(file.size()))==static_cast<int32_t>(file.size());
+		readFile->drop();
+		if (!readAll)
+			return false;
+	}
+
+	const uint32_t levelCount = texture->getHighestMip()+1u;
+	const CImageData* base = *texture->getMipMap(0u).first;
+	constexpr size_t HeaderSize = 4u+124u+20u;
+	size_t payloadSize = 0u;
+	for (uint32_t level=0u; level<levelCount; level++)
+		payloadSize += (*texture->getMipMap(level).first)->getImageDataSizeInBytes();
+
+	// DDSD_CAPS|DDSD_HEIGHT|DDSD_WIDTH|DDSD_PIXELFORMAT|DDSD_LINEARSIZE, plus DDSD_MIPMAPCOUNT and DDSCAPS_COMPLEX|DDSCAPS_MIPMAP with a mip chain
+	const uint32_t flags = 0x1u|0x2u|0x4u|0x1000u|0x80000u|(levelCount>1u ? 0x20000u:0u);
+	const uint32_t caps = 0x1000u|(levelCount>1u ? 0x8u|0x400000u:0u);
+	if (file.size()!=HeaderSize+payloadSize || memcmp(file.data(),"DDS ",4u)!=0 || memcmp(file.data()+84u,"DX10",4u)!=0)
+		return false;
+	if (readU32(file,4u)!=124u || readU32(file,8u)!=flags || readU32(file,12u)!=base->getSize().Y || readU32(file,16u)!=base->getSize().X)
+		return false;
+	if (readU32(file,20u)!=base->getImageDataSizeInBytes() || (levelCount>1u && readU32(file,28u)!=levelCount))
+		return false;
+	// pixel format size and DDPF_FOURCC, then the caps
+	if (readU32(file,76u)!=32u || readU32(file,80u)!=0x4u || readU32(file,108u)!=caps)
+		return false;
+	// the extended header, a single 2D texture
+	if (readU32(file,128u)!=dxgiFormat || readU32(file,132u)!=3u || readU32(file,136u)!=0u || readU32(file,140u)!=1u)
+		return false;
+	size_t offset = HeaderSize;
+	for (uint32_t level=0u; level<levelCount; level++)
+	{
+		const CImageData* image = *texture->getMipMap(level).first;
+		if (memcmp(file.data()+offset,image->getData(),image->getImageDataSizeInBytes())!=0)
+			return false;
+		offset += image->getImageDataSizeInBytes();
+	}
+
+	IAssetLoader::SAssetLoadParams lparams;
+	auto bundle = am->getAsset(name,lparams);
+	if (bundle.isEmpty())
+		return false;
+	auto loaded = core::smart_refctd_ptr_static_cast<ICPUTexture>(*bundle.getContents().first);
+	if (loaded->getColorFormat()!=texture->getColorFormat() || loaded->getHighestMip()!=texture->getHighestMip())
+		return false;
+	for (uint32_t level=0u; level<levelCount; level++)
+	{
+		const auto range = loaded->getMipMap(level);
+		if (range.second-range.first!=1)
+			return false;
+		const CImageData* image = *range.first;
+		const CImageData* original = *texture->getMipMap(level).first;
+		const auto size = image->getSize();
+		const auto originalSize = original->getSize();
+		if (size.X!=originalSize.X || size.Y!=originalSize.Y || size.Z!=originalSize.Z || image->getImageDataSizeInBytes()!=original->getImageDataSizeInBytes())
+			return false;
+		if (memcmp(image->getData(),original->getData(),image->getImageDataSizeInBytes())!=0)
+			return false;
+	}
+	return true;
+}
+
+static void checkDDSWriter(TestChecks& check, IrrlichtDevice* device)
+{
+	const auto source = createSourceTexture();
+
+	// BC1 RGB shares its DXGI format with RGBA and loads back as the latter, so it is not part of the list
+	struct SWrittenFormat
+	{
+		E_FORMAT format;
+		const char* file;
+		uint32_t dxgiFormat;
+	};
+	const SWrittenFormat formats[] = {
+		{EF_BC1_RGBA_UNORM_BLOCK,"bcTestBC1.dds",71u},
+		{EF_BC2_UNORM_BLOCK,"bcTestBC2.dds",74u},
+		{EF_BC3_SRGB_BLOCK,"bcTestBC3.dds",78u},
+		{EF_BC4_UNORM_BLOCK,"bcTestBC4.dds",80u},
+		{EF_BC5_UNORM_BLOCK,"bcTestBC5.dds",83u},
+		{EF_BC7_UNORM_BLOCK,"bcTestBC7.dds",98u}
+	};
+	char what[128];
+	for (const auto& format : formats)
+	{
+		auto compressed = core::smart_refctd_ptr<ICPUTexture>(createBlockCompressedTexture(source.get(),format.format,video::EBEQ_FAST,3u),core::dont_grab);
+		sprintf(what,"%s compressed texture matches the blockwise encode",format.file);
+		check(matchesBlockwiseEncode(compressed.get(),format.format),what);
+		sprintf(what,"%s header, payload and reloaded levels",format.file);
+		check(roundTripsThroughDDS(device,compressed.get(),format.file,format.dxgiFormat),what);
+	}
+
+	const auto bc6h = createBC6HTexture();
+	check(roundTripsThroughDDS(device,bc6h.get(),"bcTestBC6H.dds",96u),"bcTestBC6H.dds header, payload and reloaded levels");
+}
+
+
+int main()
+{
+	irr::SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_NULL;
+	IrrlichtDevice* device = createDeviceEx(params);
+	if (!device)
+		return 1;
+
+	TestChecks check;
+
+	checkKnownAnswers(check);
+	checkEncoders(check);
+	checkDDSWriter(check,device);
+
+	device->drop();
+	return check.finish();
+}
@@ -0,0 +1,37 @@
+#ifndef __TEST_CHECKS_H__INCLUDED__
+#define __TEST_CHECKS_H__INCLUDED__
+
+#include <cstdint>
+#include <cstdio>
+
+//! Prints and counts the checks of the test examples, main() returns finish() so a script running the tests can tell they failed
+class TestChecks
+{
+	public:
+		TestChecks() : failures(0u)
+		{
+		}
+
+		//! Prints whether `condition` held, @returns `condition`
+		inline bool operator()(bool condition, const char* what)
+		{
+			printf("%s: %s\n",what,condition ? "OK":"FAILED");
+			if (!condition)
+				failures++;
+			return condition;
+		}
+
+		inline uint32_t getFailureCount() const { return failures; }
+
+		//! Prints the number of failed checks, @returns the exit code of the test
+		inline int finish() const
+		{
+			printf("%u failures\n",failures);
+			return failures ? 1:0;
+		}
+
+	private:
+		uint32_t failures;
+};
+
+#endif
@@ -77,6 +77,7 @@ const char** CMitsubaLoader::getAssociatedFileExtensions() const
 
 asset::SAssetBundle CMitsubaLoader::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
+	IRR_PROFILE_ZONE("CMitsubaLoader::loadAsset");
 	ParserManager parserManager(manager->getFileSystem(),_override);
 	if (!parserManager.parse(_file))
 		return {};
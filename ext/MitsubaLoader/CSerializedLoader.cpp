@@ -40,6 +40,7 @@ struct alignas(PAGE_SIZE) Page_t
 //! creates/loads an animated mesh from the file.
 asset::SAssetBundle CSerializedLoader::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
+	IRR_PROFILE_ZONE("CSerializedLoader::loadAsset");
 	if (!_file)
         return {};
 
@@ -1,6 +1,8 @@
 #ifndef _IRR_EXT_SCREEN_SHOT_INCLUDED_
 #define _IRR_EXT_SCREEN_SHOT_INCLUDED_
 
+#include <future>
+
 #include "irrlicht.h"
 
 #include "../source/Irrlicht/COpenGLBuffer.h"
@@ -52,8 +54,8 @@ core::smart_refctd_ptr<video::IDriverFence> createScreenShot(video::IDriver* dri
 	return driver->placeFence(implicitflush);
 }
 
-template<typename PathOrFile>
-void writeBufferAsImageToFile(asset::IAssetManager* mgr, const PathOrFile& _outFile, core::vector2d<uint32_t> _size, asset::E_FORMAT _format, video::IGPUBuffer* buff, size_t offset=0ull, bool flipY=true)
+//! Copies the mapped contents of a buffer filled by createScreenShot() into a new image
+inline core::smart_refctd_ptr<asset::CImageData> createImageFromBuffer(core::vector2d<uint32_t> _size, asset::E_FORMAT _format, video::IGPUBuffer* buff, size_t offset=0ull, bool flipY=true)
 {
 	const uint32_t zero[3] = { 0,0,0 };
 	const uint32_t sizeArray[3] = { _size.X,_size.Y,1u };
@@ -62,7 +64,7 @@ void writeBufferAsImageToFile(asset::IAssetManager* mgr, const PathOrFile& _outF
 	//! Wonder if we'll need it after Vulkan ?
 	const auto rowSize = (img->getBytesPerPixel()*sizeArray[0]).getRoundedUpInteger();
 	const auto imagePitch = img->getPitchIncludingAlignment();
-	const uint8_t* inData = reinterpret_cast<const uint8_t*>(buff->getBoundMemory()->getMappedPointer());
+	const uint8_t* inData = reinterpret_cast<const uint8_t*>(buff->getBoundMemory()->getMappedPointer())+offset;
 	uint8_t* outData = reinterpret_cast<uint8_t*>(img->getData())+imagePitch*(flipY ? (sizeArray[1]-1u):0u);
 	for (uint32_t y=0u; y<sizeArray[1]; y++)
 	{
@@ -73,11 +75,34 @@ void writeBufferAsImageToFile(asset::IAssetManager* mgr, const PathOrFile& _outF
 		else
 			outData += imagePitch;
 	}
+	return img;
+}
+
+template<typename PathOrFile>
+void writeBufferAsImageToFile(asset::IAssetManager* mgr, const PathOrFile& _outFile, core::vector2d<uint32_t> _size, asset::E_FORMAT _format, video::IGPUBuffer* buff, size_t offset=0ull, bool flipY=true)
+{
+	auto img = createImageFromBuffer(_size, _format, buff, offset, flipY);
 
 	asset::IAssetWriter::SAssetWriteParams wparams(img.get());
 	mgr->writeAsset(_outFile, wparams);
 }
 
+//! Like writeBufferAsImageToFile() but only the copy out of the buffer happens on the calling thread, encoding and writing happen on a new one
+/** The buffer can be reused as soon as this returns. The future's destructor waits for the write, so keep it around (e.g. in a list of pending screenshots)
+and poll it instead of letting it go out of scope right away. `_params` are passed on with the image as the root asset, e.g. with
+CImageWriterPNG::SWriteProperties as user data, which (like a file passed as `_outFile`) has to stay alive until the write is done.*/
+template<typename PathOrFile>
+std::future<bool> writeBufferAsImageToFileAsync(asset::IAssetManager* mgr, const PathOrFile& _outFile, core::vector2d<uint32_t> _size, asset::E_FORMAT _format, video::IGPUBuffer* buff, size_t offset=0ull, bool flipY=true, asset::IAssetWriter::SAssetWriteParams _params=asset::IAssetWriter::SAssetWriteParams(nullptr))
+{
+	auto img = createImageFromBuffer(_size, _format, buff, offset, flipY);
+	return std::async(std::launch::async, [mgr,_outFile,_params](core::smart_refctd_ptr<asset::CImageData>&& _img) -> bool
+	{
+		asset::IAssetWriter::SAssetWriteParams wparams(_params);
+		wparams.rootAsset = _img.get();
+		return mgr->writeAsset(_outFile, wparams);
+	}, std::move(img));
+}
+
 
 template<typename PathOrFile>
 void dirtyCPUStallingScreenshot(video::IVideoDriver* driver, asset::IAssetManager* assetManager, const PathOrFile& _outFile, core::rect<uint32_t> sourceRect, asset::E_FORMAT _format, bool flipY=true)
@@ -11,6 +11,7 @@
 #include "irr/video/alloc/ResizableBufferingAllocator.h"
 #include "irr/video/CGPUMesh.h"
 #include "ISceneNode.h"
+#include "irr/scene/CTransformHierarchy.h"
 
 namespace irr
 {
@@ -88,6 +89,12 @@ class IMeshSceneNodeInstanced : public ISceneNode
 
         virtual core::matrix3x4SIMD getInstanceTransform(const uint32_t& instanceID) = 0;
 
+        //! Makes the instance take the world transform of `node` in ISceneManager::getTransformHierarchy() as its transform
+        /** The transform is taken right away and then in every OnRegisterSceneNode() after an update of the hierarchy recomputed it,
+        so the hierarchy's world space is this node's space. CTransformHierarchy::invalid_node makes the instance keep its transform as it is.
+        Removing the instance unbinds it, the hierarchy node must not be removed while an instance is bound to it.*/
+        virtual void setInstanceTransformNode(const uint32_t& instanceID, CTransformHierarchy::node_t node) = 0;
+
         virtual void setInstanceVisible(const uint32_t& instanceID, const bool& visible) = 0;
 
         virtual void setInstanceData(const uint32_t& instanceID, const void* data) = 0;
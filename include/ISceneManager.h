@@ -82,6 +82,9 @@ namespace scene
 
 	class IAnimatedMeshSceneNode;
 	class ICameraSceneNode;
+	class COcclusionCuller;
+	class CTransformHierarchy;
+	class CSceneNodeSpatialIndex;
 	class IDummyTransformationSceneNode;
 	class ILightSceneNode;
 	class IMeshLoader;
@@ -402,7 +405,8 @@ namespace scene
 		\param pass: Specifies when the node wants to be drawn in relation to the other nodes.
 		For example, if the node is a shadow, it usually wants to be drawn after all other nodes
 		and will use ESNRP_SHADOW for this. See scene::E_SCENE_NODE_RENDER_PASS for details.
-		\return scene will be rendered ( passed culling ) */
+		\return 0 if the node was rejected, nodes registered for the solid and transparent passes
+		are frustum culled later, all at once, by drawAll() so 1 does not mean the node passed culling */
 		virtual uint32_t registerNodeForRendering(ISceneNode* node,
 			E_SCENE_NODE_RENDER_PASS pass = ESNRP_AUTOMATIC) = 0;
 
@@ -525,6 +529,50 @@ namespace scene
 		\return True if node is not visible in the current scene, else
 		false. */
 		virtual bool isCulled(ISceneNode* node) const =0;
+
+		//! Sets the occlusion culler nodes get tested against before being drawn
+		/** drawAll() renders the culler's occluders from the active camera every frame and skips the solid and
+		transparent nodes with automatic culling enabled which are hidden behind them.
+		\param culler The culler, grabbed by the scene manager, or 0 to turn occlusion culling off. */
+		virtual void setOcclusionCuller(COcclusionCuller* culler) =0;
+
+		//! Gets the occlusion culler set with setOcclusionCuller()
+		virtual COcclusionCuller* getOcclusionCuller() const =0;
+
+		//! Sets the spatial index drawAll() frustum culls the nodes in it with
+		/** drawAll() updates the index after OnAnimate() and marks the nodes in the active camera's frustum with it before
+		the nodes get registered, nodes of the index outside of the frustum then get culled when they register without
+		their boxes being transformed or tested. isCulled() uses it the same way. The index is only read by the scene manager,
+		nodes are added to and removed from it by the user.
+		\param index The index, grabbed by the scene manager, or 0 to cull every node on its own. */
+		virtual void setSpatialIndex(CSceneNodeSpatialIndex* index) =0;
+
+		//! Gets the spatial index set with setSpatialIndex()
+		virtual CSceneNodeSpatialIndex* getSpatialIndex() const =0;
+
+		//! Sets how many threads drawAll() animates the scene and registers its nodes with
+		/** With more than 1 thread the subtrees under the root node are split between the threads, for the OnAnimate() as well as
+		the OnRegisterSceneNode() traversal. Every thread collects the nodes registered by its subtrees in lists of its own,
+		which get merged in the order of the subtrees, so the nodes end up drawn the same as with a single thread.
+
+		The animators and the OnAnimate() and OnRegisterSceneNode() of nodes in different top level subtrees then run at the same time,
+		which is only safe for scenes where they:
+		- only change the subtree they are in, and read nothing another subtree changes,
+		- do not add or remove top level nodes, a node removes itself through addToDeletionQueue() which is thread safe (as CSceneNodeAnimatorDelete does),
+		- do not use the video driver or state shared between subtrees, like CMeshSceneNodeInstanced culling its instances
+		on the GPU and skinned mesh nodes sharing a skinning state do.
+		registerNodeForRendering() and isCulled() can be called from the OnRegisterSceneNode() of the nodes on all of the threads,
+		registerNodeForRendering() must not be called from OnAnimate() as nodes registered then go to lists shared by the threads.
+		\param threadCount 1 (the default) traverses the scene on the calling thread only, 0 means as many threads as the hardware has. */
+		virtual void setTraversalThreadCount(uint32_t threadCount) =0;
+
+		//! Gets the thread count set with setTraversalThreadCount()
+		virtual uint32_t getTraversalThreadCount() const =0;
+
+		//! Gets the transform hierarchy drawAll() updates every frame, after OnAnimate() and before the nodes get registered
+		/** Scenes with very many transforms can keep them in the hierarchy instead of in scene nodes, see CTransformHierarchy.
+		Instances of a IMeshSceneNodeInstanced can follow its nodes, see IMeshSceneNodeInstanced::setInstanceTransformNode().*/
+		virtual CTransformHierarchy* getTransformHierarchy() =0;
 	};
 
 
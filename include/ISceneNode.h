@@ -23,6 +23,7 @@ namespace scene
 {
 	class ISceneManager;
     class ISceneNode;
+	class CSceneNodeSpatialIndex;
 
 
 
@@ -47,7 +48,8 @@ namespace scene
                 SceneManager(mgr), renderFence(0), fenceBehaviour(EFRB_SKIP_DRAW),
                 ID(id), AutomaticCullingState(EAC_FRUSTUM_BOX),
                 DebugDataVisible(EDS_OFF), mobid(0), mobtype(0), IsVisible(true),
-                IsDebugObject(false), staticmeshid(0),blockposX(0),blockposY(0),blockposZ(0), renderPriority(0x80000000u)
+                IsDebugObject(false), staticmeshid(0),blockposX(0),blockposY(0),blockposZ(0), renderPriority(0x80000000u),
+                SpatialIndex(nullptr), SpatialIndexEntry(0u), SpatialIndexDirty(false)
 		{
 		}
 
@@ -171,6 +173,29 @@ namespace scene
 			return box;
 		}
 
+		//! Updates the absolute position based on the relative and the parents position
+		/** Same as IDummyTransformationSceneNode::updateAbsolutePosition(), a recomputed transformation also calls markBoundsChanged().*/
+		inline virtual void updateAbsolutePosition()
+		{
+			const uint64_t lastRecompute = lastTimeRelativeTransRead[3];
+			const uint64_t lastParentRecompute = lastTimeRelativeTransRead[4];
+			IDummyTransformationSceneNode::updateAbsolutePosition();
+			if (lastTimeRelativeTransRead[3]!=lastRecompute||lastTimeRelativeTransRead[4]!=lastParentRecompute)
+				markBoundsChanged();
+		}
+
+		//! Gets the CSceneNodeSpatialIndex the node is in, 0 if none
+		inline CSceneNodeSpatialIndex* getSpatialIndex() const {return SpatialIndex;}
+
+		//! Makes the CSceneNodeSpatialIndex the node is in read its transformed bounding box again on its next update()
+		/** Called when the absolute transformation gets recomputed, nodes whose getBoundingBox() changes call it themselves.
+		Safe to call from the threads of a parallel traversal, see ISceneManager::setTraversalThreadCount().*/
+		inline void markBoundsChanged()
+		{
+			if (SpatialIndex && !SpatialIndexDirty)
+				queueSpatialIndexUpdate();
+		}
+
 		inline const uint32_t& getRenderPriorityScore() const {return renderPriority;}
 
 		inline void setRenderPriorityScore(const uint32_t& nice) {renderPriority = nice;}
@@ -462,7 +487,8 @@ namespace scene
                 }
 			}
 		}
-    private:
+    protected:
+        //! also used by the scene manager to register the top level subtrees on several threads
         static void OnRegisterSceneNode_static(IDummyTransformationSceneNode* node) // could be pushed up to IDummyTransformationSceneNode
         {
             ISceneNode* tmp = static_cast<ISceneNode*>(node);
@@ -486,6 +512,19 @@ namespace scene
 			}
         }
 
+    private:
+        friend class CSceneNodeSpatialIndex;
+
+		//! sets SpatialIndexDirty and puts the node on the dirty list of SpatialIndex, defined with CSceneNodeSpatialIndex
+		void queueSpatialIndexUpdate();
+
+		//! index the node is in, only changed by the index
+		CSceneNodeSpatialIndex* SpatialIndex;
+		//! position of the node's entry in SpatialIndex
+		size_t SpatialIndexEntry;
+		//! whether the node is on the dirty list of SpatialIndex
+		bool SpatialIndexDirty;
+
         static bool isTrulyVisible_static(const IDummyTransformationSceneNode* node)
 		{
             const ISceneNode* tmp = static_cast<const ISceneNode*>(node);
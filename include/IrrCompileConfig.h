@@ -224,6 +224,21 @@ the engine will no longer read .png images. */
 #ifdef NO_IRR_COMPILE_WITH_DDS_LOADER_
 #undef _IRR_COMPILE_WITH_DDS_LOADER_
 #endif
+//! Define _IRR_COMPILE_WITH_KTX2_LOADER_ if you want to load .ktx2 files
+#define _IRR_COMPILE_WITH_KTX2_LOADER_
+#ifdef NO_IRR_COMPILE_WITH_KTX2_LOADER_
+#undef _IRR_COMPILE_WITH_KTX2_LOADER_
+#endif
+//! Define _IRR_COMPILE_WITH_HDR_LOADER_ if you want to load Radiance .hdr files
+#define _IRR_COMPILE_WITH_HDR_LOADER_
+#ifdef NO_IRR_COMPILE_WITH_HDR_LOADER_
+#undef _IRR_COMPILE_WITH_HDR_LOADER_
+#endif
+//! Define _IRR_COMPILE_WITH_EXR_LOADER_ if you want to load OpenEXR .exr files
+#define _IRR_COMPILE_WITH_EXR_LOADER_
+#ifdef NO_IRR_COMPILE_WITH_EXR_LOADER_
+#undef _IRR_COMPILE_WITH_EXR_LOADER_
+#endif
 //! Define _IRR_COMPILE_WITH_TGA_LOADER_ if you want to load .tga files
 #define _IRR_COMPILE_WITH_TGA_LOADER_
 #ifdef NO_IRR_COMPILE_WITH_TGA_LOADER_
@@ -245,6 +260,16 @@ the engine will no longer read .png images. */
 #ifdef NO_IRR_COMPILE_WITH_TGA_WRITER_
 #undef _IRR_COMPILE_WITH_TGA_WRITER_
 #endif
+//! Define _IRR_COMPILE_WITH_DDS_WRITER_ if you want to write .dds files, it needs the DDS loader for the header definitions
+#define _IRR_COMPILE_WITH_DDS_WRITER_
+#if defined(NO_IRR_COMPILE_WITH_DDS_WRITER_) || !defined(_IRR_COMPILE_WITH_DDS_LOADER_)
+#undef _IRR_COMPILE_WITH_DDS_WRITER_
+#endif
+//! Define _IRR_COMPILE_WITH_KTX2_WRITER_ if you want to write .ktx2 files, it needs the KTX2 loader for the header definitions
+#define _IRR_COMPILE_WITH_KTX2_WRITER_
+#if defined(NO_IRR_COMPILE_WITH_KTX2_WRITER_) || !defined(_IRR_COMPILE_WITH_KTX2_LOADER_)
+#undef _IRR_COMPILE_WITH_KTX2_WRITER_
+#endif
 
 //! Define __IRR_COMPILE_WITH_ZIP_ARCHIVE_LOADER_ if you want to open ZIP and GZIP archives
 /** ZIP reading has several more options below to configure. */
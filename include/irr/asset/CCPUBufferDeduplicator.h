@@ -0,0 +1,105 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_CPU_BUFFER_DEDUPLICATOR_H_INCLUDED__
+#define __IRR_C_CPU_BUFFER_DEDUPLICATOR_H_INCLUDED__
+
+#include <cstring>
+#include <mutex>
+
+#include "irr/core/core.h"
+#include "irr/asset/ICPUBuffer.h"
+#include "irr/asset/ICPUMesh.h"
+
+namespace irr
+{
+namespace asset
+{
+
+//! Content addressed registry of ICPUBuffers, for making identical vertex and index data loaded from different files share one buffer
+/** Buffers are keyed by their size and XXHash_256 of their contents, and a matching buffer only gets substituted after a full comparison,
+so hash collisions and buffers modified since they got registered can never lead to wrong data.
+The registry holds a reference to every registered buffer, buffers nothing but the registry references anymore get forgotten by prune(),
+which happens on its own whenever the registry doubled in size since the last prune, and whenever IAssetManager evicted or cleared cached assets.
+
+Mesh buffers sharing a buffer after deduplication also share it after GPU conversion, as IGPUObjectFromAssetConverter
+creates one GPU buffer per CPU buffer. Buffers which get modified in place after loading must not be deduplicated,
+as the modification would show up in every mesh sharing them.
+All functions are thread safe.*/
+class CCPUBufferDeduplicator : public core::IReferenceCounted
+{
+	public:
+		struct SStatistics
+		{
+			//! buffers hashed or found registered
+			uint64_t buffersVisited;
+			//! buffers replaced with a registered identical one
+			uint64_t buffersSubstituted;
+			//! sum of the sizes of the substituted buffers
+			uint64_t bytesSaved;
+			size_t registeredBuffers;
+		};
+
+		CCPUBufferDeduplicator() : m_pruneThreshold(MinPruneThreshold), m_statistics{} {}
+
+		//! @returns The registered buffer identical to `_buffer`, or `_buffer` itself after registering it if there was none
+		/** Dummy and empty buffers are returned as they are without being registered.*/
+		core::smart_refctd_ptr<ICPUBuffer> deduplicate(ICPUBuffer* _buffer);
+
+		//! Replaces the vertex attribute and index buffers of the mesh buffer with registered identical ones
+		/** Offsets, strides and formats stay as they were. A buffer shared by several attributes only gets deduplicated once.
+		@returns Number of distinct buffers replaced.*/
+		uint32_t deduplicate(ICPUMeshBuffer* _meshbuffer);
+		//! Same as the ICPUMeshBuffer overload for every mesh buffer of the mesh
+		uint32_t deduplicate(ICPUMesh* _mesh);
+		//! Deduplicates the buffers of meshes and mesh buffers in the bundle in place, and registers buffers in the bundle
+		/** The buffers of an ET_BUFFER bundle are only registered, not replaced, as they are what the bundle is.*/
+		uint32_t deduplicate(const SAssetBundle& _bundle);
+
+		//! Forgets the registered buffers which nothing but the registry references
+		void prune();
+		//! Whether the buffer is registered, the registry then holds one of its references
+		bool isRegistered(const ICPUBuffer* _buffer) const;
+		//! Forgets all registered buffers
+		void clear();
+
+		SStatistics getStatistics() const;
+
+	protected:
+		virtual ~CCPUBufferDeduplicator() = default;
+
+	private:
+		struct SKey
+		{
+			uint64_t hash[4];
+			size_t size;
+
+			inline bool operator==(const SKey& _other) const
+			{
+				return size==_other.size && memcmp(hash,_other.hash,sizeof(hash))==0;
+			}
+		};
+		struct SKeyHash
+		{
+			// the contents hash is already as good as random
+			inline size_t operator()(const SKey& _key) const { return static_cast<size_t>(_key.hash[0]); }
+		};
+
+		_IRR_STATIC_INLINE_CONSTEXPR size_t MinPruneThreshold = 256ull;
+
+		//! needs `m_mutex` to be locked
+		void prune_impl();
+
+		mutable std::mutex m_mutex;
+		core::unordered_map<SKey,core::smart_refctd_ptr<ICPUBuffer>,SKeyHash> m_buffers;
+		//! what every registered buffer is registered under, so registered buffers need no hashing
+		core::unordered_map<const ICPUBuffer*,SKey> m_keys;
+		size_t m_pruneThreshold;
+		SStatistics m_statistics;
+};
+
+} // end namespace asset
+} // end namespace irr
+
+#endif
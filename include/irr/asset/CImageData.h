@@ -55,6 +55,7 @@ class CImageData : public asset::IAsset
         inline void setupMemory(const void* inData)
         {
             size_t imgByteSize = getImageDataSizeInBytes();
+            IRR_MEMORY_TAG_SCOPE(core::EMT_IMAGE);
             data = _IRR_ALIGNED_MALLOC(imgByteSize,32u); // for 4x double formats
             if (inData)
                 memcpy(data,inData,imgByteSize);
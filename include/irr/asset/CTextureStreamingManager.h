@@ -0,0 +1,164 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_TEXTURE_STREAMING_MANAGER_H_INCLUDED__
+#define __IRR_C_TEXTURE_STREAMING_MANAGER_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_KTX2_LOADER_
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "irr/core/core.h"
+#include "irr/asset/format/EFormat.h"
+#include "irr/asset/ICPUTexture.h"
+#include "IFileSystem.h"
+
+namespace irr
+{
+namespace asset
+{
+
+//! Streams the mip levels of KTX2 textures in from disk, smallest first, within a memory budget
+/** addTexture() only reads the mip tail (the levels no larger than SCreationParams::mipTailExtent) so the texture is usable right away,
+the larger levels are read and decompressed by background threads as the texture gets requested at larger sizes on screen.
+When the budget is full, levels of textures that have not been used for the longest time (and then the ones needed the least) get evicted,
+the mip tail is never evicted.
+
+Only KTX2 files can be streamed because they can be read level by level, use CImageWriterKTX2 to convert other formats.
+Apart from the background threads, everything (including CStreamedTexture) must be used from the thread which calls update().
+The background threads never call into the IFileSystem, update() opens the files for them.*/
+class CTextureStreamingManager : public core::IReferenceCounted
+{
+	public:
+		struct SCreationParams
+		{
+			//! Bytes of level data which may be resident (or being loaded) at once, mip tails included
+			size_t memoryBudget = 256ull<<20ull;
+			//! Levels with no dimension larger than this are loaded by addTexture() and never evicted
+			uint32_t mipTailExtent = 64u;
+			//! Background loading threads, at least one is always started
+			uint32_t threadCount = 1u;
+		};
+
+		class CStreamedTexture : public core::IReferenceCounted
+		{
+				friend class CTextureStreamingManager;
+			public:
+				//! The texture made of all resident levels, a new object is made (this one is left as it was) every time the resident levels change
+				inline ICPUTexture* getTexture() const { return m_texture.get(); }
+				//! Incremented every time getTexture() changes, keep the value the GPU texture was made from to know when to update it
+				inline uint32_t getVersion() const { return m_version; }
+
+				//! Largest level resident, getTexture() has all levels from this one to the smallest
+				inline uint32_t getResidentBaseLevel() const { return m_residentBase; }
+				inline uint32_t getLevelCount() const { return static_cast<uint32_t>(m_levels.size()); }
+
+				inline const io::path& getFilename() const { return m_filename; }
+
+				//! Marks the texture as used for this frame, covering `_screenExtent` pixels along its larger dimension
+				/** Can be called many times per frame, the largest size is the one that counts. The level streamed in is the smallest one
+				at least as large as `_screenExtent`, the textures which are undersampled the most get their levels first.*/
+				inline void requestScreenExtent(float _screenExtent)
+				{
+					m_requestedExtent = std::max(m_requestedExtent, _screenExtent);
+				}
+
+			protected:
+				//! CImageLoaderKTX2::SHeader, defined with the manager so this header does not need the private loader one
+				struct SKTX2Header;
+
+				CStreamedTexture(const io::path& _filename);
+				virtual ~CStreamedTexture();
+
+				inline uint32_t getLevelExtent(uint32_t _level) const { return std::max(m_baseExtent>>_level, 1u); }
+
+				io::path m_filename;
+				SKTX2Header* m_header;
+				core::smart_refctd_ptr<ICPUTexture> m_texture;
+				//! nullptr for levels not resident
+				core::vector<CImageData*> m_levels;
+				core::vector<size_t> m_levelSizes;
+				uint64_t m_lastUsedFrame = 0u;
+				uint32_t m_version = 0u;
+				uint32_t m_residentBase = 0u;
+				uint32_t m_tailBase = 0u;
+				//! Largest dimension of level 0 which is not made of layers or faces
+				uint32_t m_baseExtent = 1u;
+				float m_requestedExtent = 0.f;
+				//! Screen extent of the last frame the texture was used in
+				float m_usedExtent = 0.f;
+				//! Level queued or being read by a background thread, only one at a time per texture
+				bool m_loading = false;
+				bool m_failed = false;
+				bool m_dirty = false;
+		};
+
+		CTextureStreamingManager(core::smart_refctd_ptr<io::IFileSystem>&& _fileSystem, const SCreationParams& _params);
+
+		//! Reads the header and mip tail of a KTX2 file
+		/** @returns nullptr (after logging why) if the file cannot be opened or is not a valid KTX2 file.
+		The texture stays managed for as long as anything else holds a reference to it.*/
+		core::smart_refctd_ptr<CStreamedTexture> addTexture(const io::path& _filename);
+
+		//! Call once a frame, after the requestScreenExtent() calls of that frame
+		/** Takes in the levels the background threads finished, evicts levels if the budget requires it and queues the next levels to read.
+		@returns Number of textures whose getTexture() changed.*/
+		uint32_t update();
+
+		inline size_t getResidentBytes() const { return m_residentBytes; }
+		inline size_t getMemoryBudget() const { return m_params.memoryBudget; }
+		//! Takes effect at the next update(), which evicts levels until the resident ones fit
+		inline void setMemoryBudget(size_t _budget) { m_params.memoryBudget = _budget; }
+
+	protected:
+		virtual ~CTextureStreamingManager();
+
+		struct SLoadRequest
+		{
+			CStreamedTexture* texture;
+			uint32_t level;
+			float priority;
+			//! Opened by the thread calling update() since IFileSystem is not thread-safe, the background thread reading the level drops it
+			io::IReadFile* file;
+		};
+		struct SLoadResult
+		{
+			CStreamedTexture* texture;
+			uint32_t level;
+			CImageData* image;
+		};
+
+		void workerMain();
+		//! How undersampled the texture would get this frame if its largest resident level was evicted
+		float getEvictionCost(const CStreamedTexture* _texture) const;
+		//! Least recently used texture with a level which can be evicted for a load of `_priority`
+		CStreamedTexture* findVictim(float _priority, const CStreamedTexture* _requester) const;
+		void evictLevel(CStreamedTexture* _texture);
+
+		core::smart_refctd_ptr<io::IFileSystem> m_fileSystem;
+		SCreationParams m_params;
+		core::vector<core::smart_refctd_ptr<CStreamedTexture> > m_textures;
+		uint64_t m_frame = 1u;
+		//! Resident level bytes plus the bytes of the levels queued or being read
+		size_t m_residentBytes = 0u;
+
+		//! Guards the two queues and m_quit, everything else is only touched by the thread calling update()
+		std::mutex m_queueMutex;
+		std::condition_variable m_queueCondition;
+		//! Sorted by priority, highest last
+		core::vector<SLoadRequest> m_requests;
+		core::vector<SLoadResult> m_results;
+		bool m_quit = false;
+		core::vector<std::thread> m_workers;
+};
+
+} // end namespace asset
+} // end namespace irr
+
+#endif
+#endif
@@ -6,6 +6,7 @@
 
 #include "IAsset.h"
 #include "IReadFile.h"
+#include "irr/system/CProfiler.h"
 
 namespace irr { namespace asset
 {
@@ -34,13 +35,19 @@ public:
 		a way that it'll look correctly in right-handed camera system. If it isn't set, compatibility with 
 		left-handed coordinate camera is assumed.
 		E_LOADER_PARAMETER_FLAGS::ELPF_DONT_COMPILE_GLSL means that GLSL won't be compiled to SPIR-V if it is loaded or generated.
+		E_LOADER_PARAMETER_FLAGS::ELPF_WELD_VERTICES asks loaders of formats without shared vertices (such as STL) to merge identical
+		vertices and output an indexed mesh instead.
+		E_LOADER_PARAMETER_FLAGS::ELPF_DEDUPLICATE_BUFFERS makes the asset manager replace the vertex and index buffers of every loaded mesh
+		with identical buffers it already loaded, from any file, see IAssetManager::getBufferDeduplicator().
 	*/
 
 	enum E_LOADER_PARAMETER_FLAGS : uint64_t
 	{
 		ELPF_NONE = 0,											//!< default value, it doesn't do anything
 		ELPF_RIGHT_HANDED_MESHES = 0x1,							//!< specifies that a mesh will be flipped in such a way that it'll look correctly in right-handed camera system
-		ELPF_DONT_COMPILE_GLSL = 0x2							//!< it states that GLSL won't be compiled to SPIR-V if it is loaded or generated						
+		ELPF_DONT_COMPILE_GLSL = 0x2,							//!< it states that GLSL won't be compiled to SPIR-V if it is loaded or generated						
+		ELPF_WELD_VERTICES = 0x4,								//!< merge bitwise identical vertices of formats which store every triangle separately, and index them
+		ELPF_DEDUPLICATE_BUFFERS = 0x8							//!< replace vertex and index buffers of loaded meshes with identical ones loaded before, see CCPUBufferDeduplicator
 	};
 
     struct SAssetLoadParams
@@ -6,6 +6,8 @@
 #define __IRR_I_ASSET_MANAGER_H_INCLUDED__
 
 #include <array>
+#include <atomic>
+#include <mutex>
 #include <ostream>
 
 #include "irr/core/Types.h"
@@ -19,6 +21,7 @@
 #include "irr/asset/IMeshManipulator.h"
 #include "irr/asset/IAssetLoader.h"
 #include "irr/asset/IAssetWriter.h"
+#include "irr/asset/CCPUBufferDeduplicator.h"
 
 #define USE_MAPS_FOR_PATH_BASED_CACHE //benchmark and choose, paths can be full system paths
 
@@ -46,6 +49,36 @@ namespace asset
 
         using CpuGpuCacheType = core::CConcurrentObjectCache<const IAsset*, core::smart_refctd_ptr<core::IReferenceCounted> >;
 
+        //! How the asset cache picks the assets to evict once a type goes over its budget, see setAssetCacheBudget()
+        enum E_CACHE_EVICTION_POLICY : uint32_t
+        {
+            //! least recently used first
+            ECEP_LRU = 0u,
+            //! largest size times time since last use first, so one big asset goes before many small ones which were used as long ago
+            ECEP_COST_AWARE
+        };
+        struct SAssetCacheBudget
+        {
+            //! Most bytes (summed IAsset::conservativeSizeEstimate()) the non-dummy cached assets of a type may take, 0 means no limit
+            size_t maxBytes = 0ull;
+            E_CACHE_EVICTION_POLICY policy = ECEP_LRU;
+            //! Turn evicted assets into dummies with IAsset::convertToDummyObject() instead of removing them from the cache
+            /** Dummies keep their cache keys, so loaders still find them and through them their GPU objects, but they lose their data.
+            Only makes sense for types which are only used through their GPU objects after loading.*/
+            bool demoteInsteadOfRemove = false;
+        };
+        struct SAssetCacheStatistics
+        {
+            //! lookups by loading functions which found assets of the type in the cache
+            uint64_t hits;
+            //! assets of the type which had to be loaded because the cache had nothing under their key
+            uint64_t misses;
+            uint64_t evictions;
+            uint64_t demotions;
+            //! Estimate of the bytes the cached assets of the type take, made exact by every eviction pass
+            size_t residentBytes;
+        };
+
     private:
         struct WriterKey
         {
@@ -105,14 +138,44 @@ namespace asset
 
         core::smart_refctd_ptr<IGeometryCreator> m_geometryCreator;
         core::smart_refctd_ptr<IMeshManipulator> m_meshManipulator;
+        core::smart_refctd_ptr<CCPUBufferDeduplicator> m_bufferDeduplicator;
         // called as a part of constructor only
         void initializeMeshTools();
 
+        struct SCacheUsage
+        {
+            //! guards `budget`, `lastUse` and eviction passes of the type
+            std::mutex mutex;
+            SAssetCacheBudget budget;
+            //! the value of m_cacheClock when each cached bundle was last inserted or found, keyed by its contents
+            core::unordered_map<const void*,uint64_t> lastUse;
+            std::atomic<uint64_t> hits{0ull};
+            std::atomic<uint64_t> misses{0ull};
+            std::atomic<uint64_t> evictions{0ull};
+            std::atomic<uint64_t> demotions{0ull};
+            std::atomic<size_t> residentBytes{0ull};
+        };
+        // mutable so the const getters can lock it, only loads through getAsset() and getAssetInHierarchy() count as hits, findAssets() does not
+        mutable std::array<SCacheUsage, IAsset::ET_STANDARD_TYPES_COUNT> m_cacheUsage;
+        mutable std::atomic<uint64_t> m_cacheClock{0ull};
+
+        //! Bytes the bundle counts with towards its type's budget, nothing for dummies
+        static size_t getCachedSize(const SAssetBundle& _bundle);
+        //! Counts a hit for and refreshes the last use of every bundle found in the cache
+        void recordCacheHits(const core::vector<SAssetBundle>& _found) const;
+        void recordCacheMiss(IAsset::E_TYPE _type) const
+        {
+            m_cacheUsage[IAsset::typeFlagToIndex(_type)].misses++;
+        }
+        //! Evicts the least valuable bundles which only the cache holds onto, until the type fits its budget
+        void enforceAssetCacheBudget(uint32_t _typeIx);
+
     public:
         //! Constructor
         explicit IAssetManager(core::smart_refctd_ptr<io::IFileSystem>&& _fs) :
             m_fileSystem(std::move(_fs)),
-            m_defaultLoaderOverride(this)
+            m_defaultLoaderOverride(this),
+            m_bufferDeduplicator(core::make_smart_refctd_ptr<CCPUBufferDeduplicator>())
         {
             initializeMeshTools();
 
@@ -128,6 +191,8 @@ namespace asset
 
         const IGeometryCreator* getGeometryCreator() const;
         const IMeshManipulator* getMeshManipulator() const;
+        //! Registry of the buffers loaded with IAssetLoader::ELPF_DEDUPLICATE_BUFFERS, can also be used to deduplicate any other assets on demand
+        CCPUBufferDeduplicator* getBufferDeduplicator() { return m_bufferDeduplicator.get(); }
 
     protected:
 		virtual ~IAssetManager()
@@ -156,6 +221,8 @@ namespace asset
         //TODO change name
         SAssetBundle getAssetInHierarchy(io::IReadFile* _file, const std::string& _supposedFilename, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override)
         {
+            IRR_PROFILE_ZONE("IAssetManager::getAssetInHierarchy");
+            IRR_MEMORY_TAG_SCOPE(core::EMT_ASSET_LOADER);
             IAssetLoader::SAssetLoadContext ctx{_params, _file};
 
             std::string filename = _file ? _file->getFileName().c_str() : _supposedFilename;
@@ -169,7 +236,10 @@ namespace asset
             {
                 core::vector<SAssetBundle> found = findAssets(filename);
                 if (found.size())
+                {
+                    recordCacheHits(found);
                     return _override->chooseRelevantFromFound(found, ctx, _hierarchyLevel);
+                }
                 else if (!(asset = _override->handleSearchFail(filename, ctx, _hierarchyLevel)).isEmpty())
                     return asset;
             }
@@ -190,6 +260,11 @@ namespace asset
                 if ((*loaderItr)->isALoadableFileFormat(file) && !(asset = (*loaderItr)->loadAsset(file, _params, _override, _hierarchyLevel)).isEmpty())
                     break;
             }
+            if (!asset.isEmpty() && (levelFlags & IAssetLoader::ECF_DUPLICATE_TOP_LEVEL) != IAssetLoader::ECF_DUPLICATE_TOP_LEVEL)
+                recordCacheMiss(asset.getAssetType());
+            // before caching, so the cached assets already share their buffers
+            if (!asset.isEmpty() && (_params.loaderFlags & IAssetLoader::ELPF_DEDUPLICATE_BUFFERS))
+                m_bufferDeduplicator->deduplicate(asset);
 
             if (!asset.isEmpty() && 
                 ((levelFlags & IAssetLoader::ECF_DONT_CACHE_TOP_LEVEL) != IAssetLoader::ECF_DONT_CACHE_TOP_LEVEL) &&
@@ -338,8 +413,22 @@ namespace asset
         //TODO change name
         bool insertAssetIntoCache(SAssetBundle& _asset)
         {
+            IRR_MEMORY_TAG_SCOPE(core::EMT_ASSET_CACHE);
             const uint32_t ix = IAsset::typeFlagToIndex(_asset.getAssetType());
-            return m_assetCache[ix]->insert(_asset.getCacheKey(), _asset);
+            if (!m_assetCache[ix]->insert(_asset.getCacheKey(), _asset))
+                return false;
+
+            SCacheUsage& usage = m_cacheUsage[ix];
+            size_t maxBytes;
+            {
+                std::lock_guard<std::mutex> lock(usage.mutex);
+                usage.lastUse[_asset.m_contents.get()] = m_cacheClock++;
+                maxBytes = usage.budget.maxBytes;
+            }
+            const size_t size = getCachedSize(_asset);
+            if (usage.residentBytes.fetch_add(size)+size > maxBytes && maxBytes)
+                enforceAssetCacheBudget(ix);
+            return true;
         }
 
         //! Remove an asset from cache (calls the private methods of IAsset behind the scenes)
@@ -347,7 +436,16 @@ namespace asset
         bool removeAssetFromCache(SAssetBundle& _asset) //will actually look up by assets key instead
         {
             const uint32_t ix = IAsset::typeFlagToIndex(_asset.getAssetType());
-            return m_assetCache[ix]->removeObject(_asset, _asset.getCacheKey());
+            if (!m_assetCache[ix]->removeObject(_asset, _asset.getCacheKey()))
+                return false;
+
+            SCacheUsage& usage = m_cacheUsage[ix];
+            std::lock_guard<std::mutex> lock(usage.mutex);
+            usage.lastUse.erase(_asset.m_contents.get());
+            const size_t size = getCachedSize(_asset);
+            const size_t resident = usage.residentBytes.load();
+            usage.residentBytes = resident>size ? (resident-size):0ull;
+            return true;
         }
 
         //! Removes all assets from the specified caches, all caches by default
@@ -355,7 +453,62 @@ namespace asset
         {
             for (size_t i = 0u; i < IAsset::ET_STANDARD_TYPES_COUNT; ++i)
                 if ((_assetTypeBitFlags>>i) & 1ull)
+                {
+                    // outside of the lock, clearing can destroy assets
                     m_assetCache[i]->clear();
+                    std::lock_guard<std::mutex> lock(m_cacheUsage[i].mutex);
+                    m_cacheUsage[i].lastUse.clear();
+                    m_cacheUsage[i].residentBytes = 0ull;
+                }
+            // buffers of the cleared assets might only be referenced by the buffer registry now
+            m_bufferDeduplicator->prune();
+        }
+
+        //! Limits the memory the cached assets of a type may take, by default there is no limit
+        /** Whenever inserting an asset into the cache takes its type over budget, the cached bundles of the type which nothing but the cache
+        holds onto get evicted (removed or demoted, see SAssetCacheBudget) in the order of the policy until the type fits again.
+        Bundles still referenced from outside the cache, by the application or other assets, are never evicted.
+        The new budget gets enforced right away.*/
+        void setAssetCacheBudget(IAsset::E_TYPE _type, const SAssetCacheBudget& _budget)
+        {
+            const uint32_t ix = IAsset::typeFlagToIndex(_type);
+            {
+                std::lock_guard<std::mutex> lock(m_cacheUsage[ix].mutex);
+                m_cacheUsage[ix].budget = _budget;
+            }
+            enforceAssetCacheBudget(ix);
+        }
+        SAssetCacheBudget getAssetCacheBudget(IAsset::E_TYPE _type) const
+        {
+            SCacheUsage& usage = m_cacheUsage[IAsset::typeFlagToIndex(_type)];
+            std::lock_guard<std::mutex> lock(usage.mutex);
+            return usage.budget;
+        }
+
+        SAssetCacheStatistics getAssetCacheStatistics(IAsset::E_TYPE _type) const
+        {
+            const SCacheUsage& usage = m_cacheUsage[IAsset::typeFlagToIndex(_type)];
+            return {usage.hits.load(),usage.misses.load(),usage.evictions.load(),usage.demotions.load(),usage.residentBytes.load()};
+        }
+        //! Zeroes the hit, miss, eviction and demotion counts of all types
+        void resetAssetCacheStatistics()
+        {
+            for (auto& usage : m_cacheUsage)
+            {
+                usage.hits = 0ull;
+                usage.misses = 0ull;
+                usage.evictions = 0ull;
+                usage.demotions = 0ull;
+            }
+        }
+
+        //! Evicts assets of the specified types until they fit their budgets, all types by default
+        /** Happens on its own on insertion, this is for when the application stopped holding onto cached assets and the memory should be freed now.*/
+        void enforceAssetCacheBudgets(const uint64_t& _assetTypeBitFlags = 0xffffffffffffffffull)
+        {
+            for (uint32_t i = 0u; i < IAsset::ET_STANDARD_TYPES_COUNT; ++i)
+                if ((_assetTypeBitFlags>>i) & 1ull)
+                    enforceAssetCacheBudget(i);
         }
 
         //! This function frees most of the memory consumed by IAssets, but not destroying them.
@@ -5,6 +5,7 @@
 
 #include <functional>
 #include <regex>
+#include <mutex>
 
 namespace irr { namespace asset
 {
@@ -32,9 +33,10 @@ public:
         //const std::string inclGuardBegin = "#ifndef " + inclGuardName + "\n#define " + inclGuardName + "\n";
         //const std::string inclGuardEnd = "\n#endif //" + inclGuardName;
 
-        core::vector<std::pair<std::regex, HandleFunc_t>> builtinNames = getBuiltinNamesToFunctionMapping();
+        // regexes are expensive to construct, so build the mapping only once per loader
+        std::call_once(m_builtinNamesInit, [this] { m_builtinNames = getBuiltinNamesToFunctionMapping(); });
 
-        for (const auto& pattern : builtinNames)
+        for (const auto& pattern : m_builtinNames)
             if (std::regex_match(_name, pattern.first))
                 return pattern.second(_name);
 
@@ -43,6 +45,10 @@ public:
 
     //! @returns Path relative to /irr/builtin/
     virtual const char* getVirtualDirectoryName() const = 0;
+
+private:
+    mutable std::once_flag m_builtinNamesInit;
+    mutable core::vector<std::pair<std::regex, HandleFunc_t>> m_builtinNames;
 };
 
 }}
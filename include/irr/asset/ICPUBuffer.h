@@ -37,6 +37,7 @@ class ICPUBuffer : public core::IBuffer, public asset::IAsset
 		*/
         ICPUBuffer(size_t sizeInBytes) : size(0)
         {
+            IRR_MEMORY_TAG_SCOPE(core::EMT_CPU_BUFFER);
 			data = _IRR_ALIGNED_MALLOC(sizeInBytes,_IRR_SIMD_ALIGNMENT);
             if (!data)
                 return;
@@ -3,15 +3,21 @@
 
 #include "irr/core/IReferenceCounted.h"
 #include "irr/asset/ShaderCommons.h"
+#include "irr/asset/ICPUShader.h"
+#include "irr/asset/IIncludeHandler.h"
 
 namespace irr { namespace asset
 {
-class ICPUShader;
 
 //! Will be derivative of IShaderGenerator, but we have to establish interface first
 class IGLSLCompiler : public core::IReferenceCounted
 {
+    core::smart_refctd_ptr<const IIncludeHandler> m_inclHandler;
+
 public:
+    //! @param _inclHandler resolves `#include` directives through its memoized lookups, without one includes fail to compile
+    IGLSLCompiler(const IIncludeHandler* _inclHandler = nullptr) : m_inclHandler(_inclHandler) {}
+
     /**
     If _stage is ESS_UNKNOWN, then compiler will try to deduce shader stage from #pragma annotation, i.e.:
     #pragma shader_stage(vertex),       or
@@ -22,8 +28,25 @@ public:
     #pragma shader_stage(compute)
 
     Such annotation should be placed right after #version directive.
+
+    `#include "path"` is resolved relative to the including file (`compilationId` for the top level source) and falls back to the
+    search directories, `#include <path>` only looks in the search directories.
     */
     ICPUShader* createShaderFromGLSL(const char* _glslCode, E_SHADER_STAGE _stage, const char* _entryPoint, bool _debug = false, const char* compilationId = nullptr) const;
+
+    //! Single variant of a shader, `defines` are applied as if `#define first second` were placed before the source
+    struct SShaderPermutation
+    {
+        core::vector<std::pair<std::string,std::string>> defines;
+        E_SHADER_STAGE stage = ESS_UNKNOWN;
+    };
+    /**
+    Compiles all permutations of `_glslCode` concurrently, stage deduction for ESS_UNKNOWN works just like in createShaderFromGLSL.
+    Permutations with equal stage and define set (regardless of define order) are compiled only once and share the returned shader.
+    @param _threadCount 0 means as many as there are hardware threads.
+    @returns Shaders in the same order as permutations in [_begin,_end), nullptr for the permutations which failed to compile (the error gets logged).
+    */
+    core::vector<core::smart_refctd_ptr<ICPUShader>> createShadersFromGLSL(const char* _glslCode, const SShaderPermutation* _begin, const SShaderPermutation* _end, const char* _entryPoint, bool _debug = false, const char* _compilationId = nullptr, uint32_t _threadCount = 0u) const;
 };
 
 }}
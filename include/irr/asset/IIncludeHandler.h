@@ -3,6 +3,7 @@
 
 #include "irr/core/IReferenceCounted.h"
 #include "irr/asset/IBuiltinIncludeLoader.h"
+#include "irr/asset/IIncluder.h"
 
 namespace irr { namespace asset
 {
@@ -13,10 +14,14 @@ protected:
     virtual ~IIncludeHandler() = default;
 
 public:
-    virtual std::string getIncludeStandard(const std::string& _path) const = 0;
-    virtual std::string getIncludeRelative(const std::string& _path, const std::string& _workingDirectory) const = 0;
+    //! @param _outHash if not null, receives XXHash_256 of the returned contents
+    virtual std::string getIncludeStandard(const std::string& _path, IIncluder::include_hash_t* _outHash = nullptr) const = 0;
+    virtual std::string getIncludeRelative(const std::string& _path, const std::string& _workingDirectory, IIncluder::include_hash_t* _outHash = nullptr) const = 0;
 
     virtual void addBuiltinIncludeLoader(IBuiltinIncludeLoader* _inclLoader) = 0;
+
+    //! Includes are memoized, call this to force re-reading everything (changes in files on disk are detected automatically by modification time)
+    virtual void clearIncludeCache() = 0;
 };
 
 }}
@@ -3,48 +3,147 @@
 
 #include "irr/core/IReferenceCounted.h"
 #include "irr/core/Types.h"
+#include "irr/core/xxHash256.h"
 #include "IFileSystem.h"
 #include <string>
+#include <array>
 
 namespace irr { namespace asset
 {
 
+//! Resolves include paths to their contents, memoizing the results
+/** Resolved contents are cached per absolute path together with their hash and a timestamp,
+and the search-directory probing done by getIncludeStandard() is memoized per requested path.
+A cached entry is reused for as long as getIncludeTimestamp_internal() keeps returning the same value for it.
+All the public getters are safe to call from multiple threads at once. */
 class IIncluder : public core::IReferenceCounted
 {
+public:
+    using include_hash_t = std::array<uint64_t,4u>;
+
 protected:
+    struct SCachedInclude
+    {
+        std::string contents;
+        include_hash_t hash;
+        uint64_t timestamp;
+    };
+
+    mutable core::mutex m_cacheMutex;
+    //! guarded by `m_cacheMutex` as well
     core::vector<std::string> m_searchDirectories;
+    //! absolute path -> contents and their hash
+    mutable core::unordered_map<std::string,SCachedInclude> m_cache;
+    //! path as requested from getIncludeStandard -> absolute path it resolved to
+    mutable core::unordered_map<std::string,std::string> m_standardLookups;
 
     virtual ~IIncluder() = default;
 
 public:
     IIncluder() : m_searchDirectories{""} {}
 
-    virtual void addSearchDirectory(const std::string& _searchDir) { m_searchDirectories.push_back(_searchDir); }
+    virtual void addSearchDirectory(const std::string& _searchDir)
+    {
+        std::lock_guard<core::mutex> lock(m_cacheMutex);
+        m_searchDirectories.push_back(_searchDir);
+        // a new search directory can change what a standard include resolves to
+        m_standardLookups.clear();
+    }
+
+    //! Drops all memoized includes, next lookups will hit the underlying storage again
+    void clearCache()
+    {
+        std::lock_guard<core::mutex> lock(m_cacheMutex);
+        m_cache.clear();
+        m_standardLookups.clear();
+    }
 
-    std::string getIncludeStandard(const std::string& _path) const
+    //! @param _outHash if not null, receives XXHash_256 of the returned contents
+    std::string getIncludeStandard(const std::string& _path, include_hash_t* _outHash = nullptr) const
     {
-        for (const std::string& searchDir : m_searchDirectories)
+        std::string resolved;
+        core::vector<std::string> searchDirectories;
+        {
+            std::lock_guard<core::mutex> lock(m_cacheMutex);
+            auto found = m_standardLookups.find(_path);
+            if (found != m_standardLookups.end())
+                resolved = found->second;
+            else
+                searchDirectories = m_searchDirectories;
+        }
+        if (!resolved.empty())
+        {
+            std::string res = getIncludeCached(resolved, _outHash);
+            if (!res.empty())
+                return res;
+            // the file went away, probe again
+            std::lock_guard<core::mutex> lock(m_cacheMutex);
+            searchDirectories = m_searchDirectories;
+        }
+
+        for (const std::string& searchDir : searchDirectories)
         {
             io::path path = searchDir.c_str();
             path += _path.c_str();
             path = io::IFileSystem::flattenFilename(path);
-            std::string res = getInclude_internal(path.c_str());
+            std::string res = getIncludeCached(path.c_str(), _outHash);
             if (!res.empty())
+            {
+                std::lock_guard<core::mutex> lock(m_cacheMutex);
+                m_standardLookups[_path] = path.c_str();
                 return res;
+            }
         }
         return {};
     }
-    std::string getIncludeRelative(const std::string& _path, const std::string& _workingDir) const
+    std::string getIncludeRelative(const std::string& _path, const std::string& _workingDir, include_hash_t* _outHash = nullptr) const
     {
         io::path path = _workingDir.c_str();
         path += _path.c_str();
 		path = io::IFileSystem::flattenFilename(path);
-        return getInclude_internal(path.c_str());
+        return getIncludeCached(path.c_str(), _outHash);
     }
 
 protected:
     //! Always gets absolute path
     virtual std::string getInclude_internal(const std::string& _path) const = 0;
+
+    //! Value which changes whenever contents under `_path` change, default assumes includes never change
+    virtual uint64_t getIncludeTimestamp_internal(const std::string& _path) const { return 0ull; }
+
+private:
+    std::string getIncludeCached(const std::string& _path, include_hash_t* _outHash) const
+    {
+        const uint64_t timestamp = getIncludeTimestamp_internal(_path);
+        {
+            std::lock_guard<core::mutex> lock(m_cacheMutex);
+            auto found = m_cache.find(_path);
+            if (found != m_cache.end())
+            {
+                if (found->second.timestamp == timestamp)
+                {
+                    if (_outHash)
+                        *_outHash = found->second.hash;
+                    return found->second.contents;
+                }
+                m_cache.erase(found);
+            }
+        }
+
+        // not holding the lock while fetching, two threads may race to insert the same entry which is harmless
+        SCachedInclude entry;
+        entry.contents = getInclude_internal(_path);
+        // failed lookups are not cached since the file may appear later
+        if (entry.contents.empty())
+            return {};
+        core::XXHash_256(entry.contents.data(), entry.contents.size(), entry.hash.data());
+        entry.timestamp = timestamp;
+        if (_outHash)
+            *_outHash = entry.hash;
+
+        std::lock_guard<core::mutex> lock(m_cacheMutex);
+        return m_cache.insert({_path,std::move(entry)}).first->second.contents;
+    }
 };
 
 }}
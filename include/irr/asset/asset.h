@@ -10,6 +10,8 @@
 #include "irr/asset/format/convertColor.h"
 #include "irr/asset/format/decodePixels.h"
 #include "irr/asset/format/encodePixels.h"
+#include "irr/asset/format/encodeBlocks.h"
+#include "irr/asset/format/generateMipMaps.h"
 
 //! move around in folders soon
 // base
@@ -46,6 +48,7 @@
 // manipulation + reflection + introspection
 #include "irr/asset/normal_quantization.h"
 #include "irr/asset/IMeshManipulator.h"
+#include "irr/asset/CCPUBufferDeduplicator.h"
 
 // baw files
 #include "irr/asset/bawformat/CBAWFile.h"
@@ -56,5 +59,6 @@
 #include "irr/asset/IAssetLoader.h"
 #include "irr/asset/IAssetManager.h"
 #include "irr/asset/IAssetWriter.h"
+#include "irr/asset/CTextureStreamingManager.h"
 
 #endif
\ No newline at end of file
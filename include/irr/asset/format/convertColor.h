@@ -157,8 +157,31 @@ namespace irr { namespace video
                 encbuf[i] = decbuf[i];
             impl::SCallEncode<dF, encT>{}(dstPix, encbuf);
         }
-	#undef SWIZZLE
     }
+
+    namespace impl
+    {
+        //! Swizzles and encodes a texel already decoded to doubles, used for sources decoded a whole block at a time
+        template<asset::E_FORMAT dF, class Swizzle>
+        inline void encodeDecodedTexel(double _texel[4], void* dstPix, PolymorphicSwizzle* swizzle)
+        {
+            using namespace asset;
+            SWIZZLE(_texel)
+            if (isIntegerFormat<dF>())
+            {
+                using encT = typename std::conditional<isSignedFormat<dF>(), int64_t, uint64_t>::type;
+
+                encT encbuf[4];
+                for (uint32_t i = 0u; i < 4u; ++i)
+                    encbuf[i] = _texel[i];
+                impl::SCallEncode<dF, encT>{}(dstPix, encbuf);
+            }
+            else
+                impl::SCallEncode<dF, double>{}(dstPix, _texel);
+        }
+    }
+	#undef SWIZZLE
+
     template<asset::E_FORMAT sF, asset::E_FORMAT dF, class Swizzle = DefaultSwizzle >
     inline void convertColor(const void* srcPix[4], void* dstPix, size_t _pixOrBlockCnt, core::vector3d<uint32_t>& _imgSize, PolymorphicSwizzle* swizzle = nullptr)
     {
@@ -176,6 +199,28 @@ namespace irr { namespace video
 
         const uint8_t** src = reinterpret_cast<const uint8_t**>(srcPix);
         uint8_t* const dst_begin = reinterpret_cast<uint8_t*>(dstPix);
+        if (isBlockCompressionFormat<sF>())
+        {
+            // decode every block once instead of once per texel, texels of partial blocks past the image edge get dropped
+            const uint32_t blocksPerRow = (_imgSize.X+sdims.X-1u)/sdims.X;
+            double texels[16][4];
+            for (size_t i = 0u; i < _pixOrBlockCnt; ++i, src[0] += srcStride)
+            {
+                if (!decodeBlock<sF>(src[0], texels))
+                    break;
+
+                const uint32_t px = i % blocksPerRow;
+                const uint32_t py = i / blocksPerRow;
+                for (uint32_t y = 0u; y < sdims.Y && sdims.Y*py+y < _imgSize.Y; ++y)
+                for (uint32_t x = 0u; x < sdims.X && sdims.X*px+x < _imgSize.X; ++x)
+                {
+                    const ptrdiff_t off = ((sdims.Y * py + y)*_imgSize.X + px * sdims.X + x);
+                    impl::encodeDecodedTexel<dF, Swizzle>(texels[sdims.X*y+x], dst_begin + static_cast<ptrdiff_t>(dstStride)*off, swizzle);
+                }
+            }
+            return;
+        }
+
         for (size_t i = 0u; i < _pixOrBlockCnt; ++i)
         {
             // assuming _imgSize is always represented in texels
@@ -1141,125 +1141,454 @@ namespace irr { namespace video // why is this in the video namespace!?
     // Block Compression formats
     namespace impl
     {
-        template<typename T>
-        inline void decodeBC1(const void* _pix, T* _output, uint32_t _x, uint32_t _y, bool _alpha)
+        //! Little endian bit stream over a single 128bit block, BC6H and BC7 fields are not byte aligned
+        class SBlockBitReader
         {
-#include "irr/irrpack.h"
-            struct {
-                uint16_t c0, c1;
-                uint32_t lut;
-            } PACK_STRUCT col;
-#include "irr/irrunpack.h"
-            memcpy(&col, _pix, 8u);
-
-            struct {
-                union {
-                    struct { uint64_t r, g, b, a; };
-                    uint64_t c[4];
-                };
-            } p[4];
-
-            uint16_t r0, g0, b0, r1, g1, b1;
-
-            const void* input = &col.c0;
-            decodePixels<asset::EF_B5G6R5_UNORM_PACK16, uint64_t>(&input, p[0].c, 0u, 0u);
-            r0 = p[0].r;
-            g0 = p[0].g;
-            b0 = p[0].b;
-            input = &col.c1;
-            decodePixels<asset::EF_B5G6R5_UNORM_PACK16, uint64_t>(&input, p[1].c, 0u, 0u);
-            r1 = p[1].r;
-            g1 = p[1].g;
-            b1 = p[1].b;
-            if (col.c0 > col.c1)
+                uint64_t bits[2];
+                uint32_t pos;
+            public:
+                SBlockBitReader(const void* _block) : pos(0u) { memcpy(bits, _block, sizeof(bits)); }
+
+                //! Reads at most 16 bits
+                inline uint32_t read(uint32_t _count)
+                {
+                    const uint32_t word = pos>>6u;
+                    const uint32_t bit = pos&63u;
+                    uint64_t retval = bits[word]>>bit;
+                    if (word==0u && bit+_count>64u)
+                        retval |= bits[1]<<(64u-bit);
+                    pos += _count;
+                    return static_cast<uint32_t>(retval)&((1u<<_count)-1u);
+                }
+        };
+
+        // partition and anchor tables shared by BC6H and BC7, 2 subset partitions have a bit per texel, 3 subset ones 2 bits
+        constexpr uint16_t BPTCPartitions2[64] = {
+            0xccccu,0x8888u,0xeeeeu,0xecc8u,0xc880u,0xfeecu,0xfec8u,0xec80u,0xc800u,0xffecu,0xfe80u,0xe800u,0xffe8u,0xff00u,0xfff0u,0xf000u,
+            0xf710u,0x008eu,0x7100u,0x08ceu,0x008cu,0x7310u,0x3100u,0x8cceu,0x088cu,0x3110u,0x6666u,0x366cu,0x17e8u,0x0ff0u,0x718eu,0x399cu,
+            0xaaaau,0xf0f0u,0x5a5au,0x33ccu,0x3c3cu,0x55aau,0x9696u,0xa55au,0x73ceu,0x13c8u,0x324cu,0x3bdcu,0x6996u,0xc33cu,0x9966u,0x0660u,
+            0x0272u,0x04e4u,0x4e40u,0x2720u,0xc936u,0x936cu,0x39c6u,0x639cu,0x9336u,0x9cc6u,0x817eu,0xe718u,0xccf0u,0x0fccu,0x7744u,0xee22u
+        };
+        constexpr uint32_t BPTCPartitions3[64] = {
+            0xaa685050u,0x6a5a5040u,0x5a5a4200u,0x5450a0a8u,0xa5a50000u,0xa0a05050u,0x5555a0a0u,0x5a5a5050u,
+            0xaa550000u,0xaa555500u,0xaaaa5500u,0x90909090u,0x94949494u,0xa4a4a4a4u,0xa9a59450u,0x2a0a4250u,
+            0xa5945040u,0x0a425054u,0xa5a5a500u,0x55a0a0a0u,0xa8a85454u,0x6a6a4040u,0xa4a45000u,0x1a1a0500u,
+            0x0050a4a4u,0xaaa59090u,0x14696914u,0x69691400u,0xa08585a0u,0xaa821414u,0x50a4a450u,0x6a5a0200u,
+            0xa9a58000u,0x5090a0a8u,0xa8a09050u,0x24242424u,0x00aa5500u,0x24924924u,0x24499224u,0x50a50a50u,
+            0x500aa550u,0xaaaa4444u,0x66660000u,0xa5a0a5a0u,0x50a050a0u,0x69286928u,0x44aaaa44u,0x66666600u,
+            0xaa444444u,0x54a854a8u,0x95809580u,0x96969600u,0xa85454a8u,0x80959580u,0xaa141414u,0x96960000u,
+            0xaaaa1414u,0xa05050a0u,0xa0a5a5a0u,0x96000000u,0x40804080u,0xa9a8a9a8u,0xaaaaaa44u,0x2a4a5254u
+        };
+        //! index of the anchor texel of the second subset in 2 subset partitions
+        constexpr uint8_t BPTCAnchors2[64] = {
+            15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15,15, 2, 8, 2, 2, 8, 8,15, 2, 8, 2, 2, 8, 8, 2, 2,
+            15,15, 6, 8, 2, 8,15,15, 2, 8, 2, 2, 2,15,15, 6, 6, 2, 6, 8,15,15, 2, 2,15,15,15,15,15, 2, 2,15
+        };
+        //! indices of the anchor texels of the second and third subset in 3 subset partitions
+        constexpr uint8_t BPTCAnchors3[2][64] = {
             {
-                p[2].r = (2 * r0 + 1 * r1) / 3;
-                p[2].g = (2 * g0 + 1 * g1) / 3;
-                p[2].b = (2 * b0 + 1 * b1) / 3;
-                p[2].a = 0xff;
-                p[3].r = (1 * r0 + 2 * r1) / 3;
-                p[3].g = (1 * g0 + 2 * g1) / 3;
-                p[3].b = (1 * b0 + 2 * b1) / 3;
-                p[3].a = 0xff;
-            }
-            else
+                 3, 3,15,15, 8, 3,15,15, 8, 8, 6, 6, 6, 5, 3, 3, 3, 3, 8,15, 3, 3, 6,10, 5, 8, 8, 6, 8, 5,15,15,
+                 8,15, 3, 5, 6,10, 8,15,15, 3,15, 5,15,15,15,15, 3,15, 5, 5, 5, 8, 5,10, 5,10, 8,13,15,12, 3, 3
+            },
             {
-                p[2].r = (r0 + r1) / 2;
-                p[2].g = (g0 + g1) / 2;
-                p[2].b = (b0 + b1) / 2;
-                p[2].a = 0xff;
-                p[3].r = 0;
-                p[3].g = 0;
-                p[3].b = 0;
-                p[3].a = 0;
+                15, 8, 8, 3,15,15, 3, 8,15,15,15,15,15,15,15, 8,15, 8,15, 3,15, 8,15, 8, 3,15, 6,10,15,15,10, 8,
+                15, 3,15,10,10, 8, 9,10, 6,15, 8,15, 3, 6, 6, 8,15, 3,15,15,15,15,15,15,15,15,15,15, 3,15,15, 8
             }
+        };
+        //! interpolation weights out of 64 for 2, 3 and 4 bit indices
+        constexpr uint8_t BPTCWeights2[4] = {0,21,43,64};
+        constexpr uint8_t BPTCWeights3[8] = {0,9,18,27,37,46,55,64};
+        constexpr uint8_t BPTCWeights4[16] = {0,4,9,13,17,21,26,30,34,38,43,47,51,55,60,64};
 
-            const uint32_t idx = 4u*_y + _x;
-            const uint32_t cw = 3u & (col.lut >> (2u * idx));
-            for (uint32_t i = 0u; i < (_alpha ? 4u : 3u); ++i)
-                _output[i] = p[cw].c[i];
+        inline const uint8_t* getBPTCWeights(uint32_t _indexBits)
+        {
+            return _indexBits==2u ? BPTCWeights2:(_indexBits==3u ? BPTCWeights3:BPTCWeights4);
         }
-        template<typename T>
-        inline void decodeBC2(const void* _pix, T* _output, uint32_t _x, uint32_t _y)
+        inline uint32_t getBPTCSubset(uint32_t _subsetCount, uint32_t _partition, uint32_t _texel)
         {
-            const uint8_t* pix = reinterpret_cast<const uint8_t*>(_pix);
-            decodeBC1(pix+8, _output, _x, _y, false);
-
-            const uint32_t idx = 4u*_y + _x;
-            const uint32_t bitI = idx * 4;
-            const uint32_t byI = bitI / 8u;
-            const uint32_t av = 0xfu & (pix[byI] >> (bitI & 7u));
-            _output[3] = av;
+            if (_subsetCount==2u)
+                return (BPTCPartitions2[_partition]>>_texel)&0x1u;
+            else if (_subsetCount==3u)
+                return (BPTCPartitions3[_partition]>>(2u*_texel))&0x3u;
+            return 0u;
         }
-        template<typename T>
-        inline void decodeBC4(const void* _pix, T* _output, int _offset, uint32_t _x, uint32_t _y)
+        inline bool isBPTCAnchor(uint32_t _subsetCount, uint32_t _partition, uint32_t _texel)
         {
-            struct
+            if (_texel==0u)
+                return true;
+            if (_subsetCount==2u)
+                return _texel==BPTCAnchors2[_partition];
+            if (_subsetCount==3u)
+                return _texel==BPTCAnchors3[0][_partition] || _texel==BPTCAnchors3[1][_partition];
+            return false;
+        }
+
+        //! Expands a 565 endpoint (R in the most significant bits) to RGBA8 stored in little endian order
+        inline uint32_t unpackBC1Endpoint(uint16_t _color)
+        {
+            const uint32_t r = (_color>>11u)&0x1fu;
+            const uint32_t g = (_color>>5u)&0x3fu;
+            const uint32_t b = _color&0x1fu;
+            return ((r<<3u)|(r>>2u)) | (((g<<2u)|(g>>4u))<<8u) | (((b<<3u)|(b>>2u))<<16u) | 0xff000000u;
+        }
+
+        //! Decodes the color part of a BC1, BC2 or BC3 block to 16 RGBA8 texels in row order
+        /** BC2 and BC3 always use the 4 color palette regardless of the endpoint order, hence `_forceFourColor`.*/
+        inline void decodeBC1Block(const void* _block, uint8_t _output[16][4], bool _forceFourColor)
+        {
+            const uint8_t* block = reinterpret_cast<const uint8_t*>(_block);
+            uint16_t c0, c1;
+            uint32_t lut;
+            memcpy(&c0, block, 2u);
+            memcpy(&c1, block+2, 2u);
+            memcpy(&lut, block+4, 4u);
+
+            uint8_t palette[4][4];
+            const uint32_t e0 = unpackBC1Endpoint(c0);
+            const uint32_t e1 = unpackBC1Endpoint(c1);
+            memcpy(palette[0], &e0, 4u);
+            memcpy(palette[1], &e1, 4u);
+            if (c0>c1 || _forceFourColor)
+            {
+                for (uint32_t i=0u; i<3u; i++)
+                {
+                    palette[2][i] = (2u*palette[0][i]+palette[1][i]+1u)/3u;
+                    palette[3][i] = (palette[0][i]+2u*palette[1][i]+1u)/3u;
+                }
+                palette[2][3] = palette[3][3] = 0xffu;
+            }
+            else
             {
-                uint8_t a0, a1;
-                uint8_t lut[6];
-            } b;
-            uint16_t a0, a1;
-            uint8_t a[8];
-            memcpy(&b, _pix, sizeof(b));
-
-            a0 = b.a0;
-            a1 = b.a1;
-            a[0] = (uint8_t)a0;
-            a[1] = (uint8_t)a1;
-            if (a0 > a1)
+                for (uint32_t i=0u; i<3u; i++)
+                    palette[2][i] = (palette[0][i]+palette[1][i]+1u)/2u;
+                palette[2][3] = 0xffu;
+                memset(palette[3], 0, 4u);
+            }
+
+#ifdef __IRR_COMPILE_WITH_SSE3
+            // whole palette fits in a register, every texel picks 4 consecutive bytes starting at 4*index
+            const __m128i pal = _mm_loadu_si128(reinterpret_cast<const __m128i*>(palette));
+            for (uint32_t i=0u; i<16u; i+=4u)
+            {
+                alignas(16) uint32_t mask[4];
+                for (uint32_t j=0u; j<4u; j++)
+                    mask[j] = ((lut>>(2u*(i+j)))&0x3u)*0x04040404u+0x03020100u;
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(_output[i]), _mm_shuffle_epi8(pal, _mm_load_si128(reinterpret_cast<const __m128i*>(mask))));
+            }
+#else
+            for (uint32_t i=0u; i<16u; i++)
+                memcpy(_output[i], palette[(lut>>(2u*i))&0x3u], 4u);
+#endif
+        }
+
+        //! Decodes a single channel BC4 block (also the alpha of BC3 and either half of BC5) to 16 bytes in row order
+        /** With `_signed` the output bytes are really int8_t in the [-127,127] range.*/
+        inline void decodeBC4Block(const void* _block, uint8_t _output[16], bool _signed)
+        {
+            const uint8_t* block = reinterpret_cast<const uint8_t*>(_block);
+            // only 8 entries are used, the rest is there so the palette can be loaded as a whole register
+            alignas(16) uint8_t palette[16] = {};
+            if (_signed)
             {
-                a[2] = (6 * a0 + 1 * a1) / 7;
-                a[3] = (5 * a0 + 2 * a1) / 7;
-                a[4] = (4 * a0 + 3 * a1) / 7;
-                a[5] = (3 * a0 + 4 * a1) / 7;
-                a[6] = (2 * a0 + 5 * a1) / 7;
-                a[7] = (1 * a0 + 6 * a1) / 7;
+                auto roundDiv = [](int32_t num, int32_t den) { return (num+(num<0 ? -den:den)/2)/den; };
+                const int32_t a0 = std::max<int32_t>(static_cast<int8_t>(block[0]), -127);
+                const int32_t a1 = std::max<int32_t>(static_cast<int8_t>(block[1]), -127);
+                int8_t* spalette = reinterpret_cast<int8_t*>(palette);
+                spalette[0] = a0;
+                spalette[1] = a1;
+                if (a0>a1)
+                {
+                    for (int32_t i=1; i<7; i++)
+                        spalette[i+1] = roundDiv((7-i)*a0+i*a1, 7);
+                }
+                else
+                {
+                    for (int32_t i=1; i<5; i++)
+                        spalette[i+1] = roundDiv((5-i)*a0+i*a1, 5);
+                    spalette[6] = -127;
+                    spalette[7] = 127;
+                }
             }
             else
             {
-                a[2] = (4 * a0 + 1 * a1) / 5;
-                a[3] = (3 * a0 + 2 * a1) / 5;
-                a[4] = (2 * a0 + 3 * a1) / 5;
-                a[5] = (1 * a0 + 4 * a1) / 5;
-                a[6] = 0;
-                a[7] = 0xff;
+                const uint32_t a0 = block[0];
+                const uint32_t a1 = block[1];
+                palette[0] = a0;
+                palette[1] = a1;
+                if (a0>a1)
+                {
+                    for (uint32_t i=1u; i<7u; i++)
+                        palette[i+1u] = ((7u-i)*a0+i*a1+3u)/7u;
+                }
+                else
+                {
+                    for (uint32_t i=1u; i<5u; i++)
+                        palette[i+1u] = ((5u-i)*a0+i*a1+2u)/5u;
+                    palette[6] = 0u;
+                    palette[7] = 0xffu;
+                }
             }
 
-            const uint32_t idx = 4u*_y + _x;
+            uint64_t lut = 0ull;
+            memcpy(&lut, block+2, 6u);
+#ifdef __IRR_COMPILE_WITH_SSE3
+            alignas(16) uint8_t mask[16];
+            for (uint32_t i=0u; i<16u; i++)
+                mask[i] = (lut>>(3u*i))&0x7u;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(_output), _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(palette)), _mm_load_si128(reinterpret_cast<const __m128i*>(mask))));
+#else
+            for (uint32_t i=0u; i<16u; i++)
+                _output[i] = palette[(lut>>(3u*i))&0x7u];
+#endif
+        }
 
-            if (idx < 8u)
+        inline int32_t signExtendBC6H(uint32_t _value, uint32_t _bits)
+        {
+            const uint32_t signBit = 1u<<(_bits-1u);
+            _value &= (signBit<<1u)-1u;
+            return static_cast<int32_t>(_value^signBit)-static_cast<int32_t>(signBit);
+        }
+        inline int32_t unquantizeBC6H(int32_t _comp, uint32_t _bits, bool _signed)
+        {
+            if (!_signed)
             {
-                int lut = int(b.lut[0]) | int(b.lut[1] << 8) | int(b.lut[2] << 16);
-                int aw = 7 & (lut >> (3 * idx));
-                _output[_offset] = a[aw];
+                if (_bits>=15u || _comp==0)
+                    return _comp;
+                if (_comp==static_cast<int32_t>((1u<<_bits)-1u))
+                    return 0xffff;
+                return ((_comp<<16)+0x8000)>>_bits;
             }
+
+            if (_bits>=16u || _comp==0)
+                return _comp;
+            const bool negative = _comp<0;
+            if (negative)
+                _comp = -_comp;
+            int32_t unq;
+            if (_comp>=static_cast<int32_t>((1u<<(_bits-1u))-1u))
+                unq = 0x7fff;
             else
+                unq = ((_comp<<15)+0x4000)>>(_bits-1u);
+            return negative ? -unq:unq;
+        }
+        //! Scales the interpolated value to the half float range and returns the half float bits
+        inline uint16_t finishUnquantizeBC6H(int32_t _comp, bool _signed)
+        {
+            if (!_signed)
+                return static_cast<uint16_t>((_comp*31)>>6);
+            if (_comp<0)
+                return static_cast<uint16_t>(0x8000|(((-_comp)*31)>>5));
+            return static_cast<uint16_t>((_comp*31)>>5);
+        }
+
+        //! Decodes a BC6H block to 16 RGB half floats in row order
+        /** @returns false for the reserved modes, the texels are all zero then.*/
+        inline bool decodeBC6HBlock(const void* _block, uint16_t _output[16][3], bool _signed)
+        {
+            // fields of the bit stream, endpoint component `c` of endpoint `e` (w,x,y,z) is field `4*c+e`
+            enum E_FIELD : uint8_t { RW=0,RX,RY,RZ,GW,GX,GY,GZ,BW,BX,BY,BZ,D };
+            struct SMode
+            {
+                uint8_t transformed, regions, endpointBits;
+                uint8_t deltaBits[3];
+                //! field, bit index of the first and last bit read, fields stored in reverse have first>last
+                uint8_t runs[24][3];
+            };
+            static const SMode modes[14] = {
+                {1,2,10,{5,5,5},{{GY,4,4},{BY,4,4},{BZ,4,4},{RW,0,9},{GW,0,9},{BW,0,9},{RX,0,4},{GZ,4,4},{GY,0,3},{GX,0,4},{BZ,0,0},{GZ,0,3},{BX,0,4},{BZ,1,1},{BY,0,3},{RY,0,4},{BZ,2,2},{RZ,0,4},{BZ,3,3},{D,0,4}}},
+                {1,2,7,{6,6,6},{{GY,5,5},{GZ,4,5},{RW,0,6},{BZ,0,1},{BY,4,4},{GW,0,6},{BY,5,5},{BZ,2,2},{GY,4,4},{BW,0,6},{BZ,3,3},{BZ,5,5},{BZ,4,4},{RX,0,5},{GY,0,3},{GX,0,5},{GZ,0,3},{BX,0,5},{BY,0,3},{RY,0,5},{RZ,0,5},{D,0,4}}},
+                {1,2,11,{5,4,4},{{RW,0,9},{GW,0,9},{BW,0,9},{RX,0,4},{RW,10,10},{GY,0,3},{GX,0,3},{GW,10,10},{BZ,0,0},{GZ,0,3},{BX,0,3},{BW,10,10},{BZ,1,1},{BY,0,3},{RY,0,4},{BZ,2,2},{RZ,0,4},{BZ,3,3},{D,0,4}}},
+                {1,2,11,{4,5,4},{{RW,0,9},{GW,0,9},{BW,0,9},{RX,0,3},{RW,10,10},{GZ,4,4},{GY,0,3},{GX,0,4},{GW,10,10},{GZ,0,3},{BX,0,3},{BW,10,10},{BZ,1,1},{BY,0,3},{RY,0,3},{BZ,0,0},{BZ,2,2},{RZ,0,3},{GY,4,4},{BZ,3,3},{D,0,4}}},
+                {1,2,11,{4,4,5},{{RW,0,9},{GW,0,9},{BW,0,9},{RX,0,3},{RW,10,10},{BY,4,4},{GY,0,3},{GX,0,3},{GW,10,10},{BZ,0,0},{GZ,0,3},{BX,0,4},{BW,10,10},{BY,0,3},{RY,0,3},{BZ,1,2},{RZ,0,3},{BZ,4,4},{BZ,3,3},{D,0,4}}},
+                {1,2,9,{5,5,5},{{RW,0,8},{BY,4,4},{GW,0,8},{GY,4,4},{BW,0,8},{BZ,4,4},{RX,0,4},{GZ,4,4},{GY,0,3},{GX,0,4},{BZ,0,0},{GZ,0,3},{BX,0,4},{BZ,1,1},{BY,0,3},{RY,0,4},{BZ,2,2},{RZ,0,4},{BZ,3,3},{D,0,4}}},
+                {1,2,8,{6,5,5},{{RW,0,7},{GZ,4,4},{BY,4,4},{GW,0,7},{BZ,2,2},{GY,4,4},{BW,0,7},{BZ,3,4},{RX,0,5},{GY,0,3},{GX,0,4},{BZ,0,0},{GZ,0,3},{BX,0,4},{BZ,1,1},{BY,0,3},{RY,0,5},{RZ,0,5},{D,0,4}}},
+                {1,2,8,{5,6,5},{{RW,0,7},{BZ,0,0},{BY,4,4},{GW,0,7},{GY,5,5},{GY,4,4},{BW,0,7},{GZ,5,5},{BZ,4,4},{RX,0,4},{GZ,4,4},{GY,0,3},{GX,0,5},{GZ,0,3},{BX,0,4},{BZ,1,1},{BY,0,3},{RY,0,4},{BZ,2,2},{RZ,0,4},{BZ,3,3},{D,0,4}}},
+                {1,2,8,{5,5,6},{{RW,0,7},{BZ,1,1},{BY,4,4},{GW,0,7},{BY,5,5},{GY,4,4},{BW,0,7},{BZ,5,5},{BZ,4,4},{RX,0,4},{GZ,4,4},{GY,0,3},{GX,0,4},{BZ,0,0},{GZ,0,3},{BX,0,5},{BY,0,3},{RY,0,4},{BZ,2,2},{RZ,0,4},{BZ,3,3},{D,0,4}}},
+                {0,2,6,{6,6,6},{{RW,0,5},{GZ,4,4},{BZ,0,1},{BY,4,4},{GW,0,5},{GY,5,5},{BY,5,5},{BZ,2,2},{GY,4,4},{BW,0,5},{GZ,5,5},{BZ,3,3},{BZ,5,5},{BZ,4,4},{RX,0,5},{GY,0,3},{GX,0,5},{GZ,0,3},{BX,0,5},{BY,0,3},{RY,0,5},{RZ,0,5},{D,0,4}}},
+                {0,1,10,{10,10,10},{{RW,0,9},{GW,0,9},{BW,0,9},{RX,0,9},{GX,0,9},{BX,0,9}}},
+                {1,1,11,{9,9,9},{{RW,0,9},{GW,0,9},{BW,0,9},{RX,0,8},{RW,10,10},{GX,0,8},{GW,10,10},{BX,0,8},{BW,10,10}}},
+                {1,1,12,{8,8,8},{{RW,0,9},{GW,0,9},{BW,0,9},{RX,0,7},{RW,11,10},{GX,0,7},{GW,11,10},{BX,0,7},{BW,11,10}}},
+                {1,1,16,{4,4,4},{{RW,0,9},{GW,0,9},{BW,0,9},{RX,0,3},{RW,15,10},{GX,0,3},{GW,15,10},{BX,0,3},{BW,15,10}}}
+            };
+            // 5 bit mode values to indices into `modes`, modes 0 and 1 only have 2 bits
+            constexpr uint8_t invalid = 0xffu;
+            static const uint8_t modeMap[32] = {
+                0,1,2,10,0,1,3,11,0,1,4,12,0,1,5,13,0,1,6,invalid,0,1,7,invalid,0,1,8,invalid,0,1,9,invalid
+            };
+
+            SBlockBitReader bits(_block);
+            uint32_t modeBits = bits.read(2u);
+            if (modeBits&0x2u)
+                modeBits |= bits.read(3u)<<2u;
+            const uint32_t modeIx = modeMap[modeBits];
+            if (modeIx==invalid)
+            {
+                memset(_output, 0, sizeof(uint16_t)*16u*3u);
+                return false;
+            }
+            const SMode& mode = modes[modeIx];
+
+            uint32_t fields[13] = {};
+            for (const auto& run : mode.runs)
+            {
+                if (run[0]==RW && run[1]==0u && run[2]==0u) // zero initialized tail of the run list
+                    break;
+                const int32_t step = run[1]<=run[2] ? 1:-1;
+                for (int32_t bit=run[1]; ; bit+=step)
+                {
+                    fields[run[0]] |= bits.read(1u)<<bit;
+                    if (bit==run[2])
+                        break;
+                }
+            }
+
+            // endpoints[c][e]
+            int32_t endpoints[3][4];
+            const uint32_t endpointCount = mode.regions*2u;
+            const uint32_t mask = (1u<<mode.endpointBits)-1u;
+            for (uint32_t c=0u; c<3u; c++)
+            {
+                const uint32_t w = fields[4u*c];
+                endpoints[c][0] = _signed ? signExtendBC6H(w, mode.endpointBits):w;
+                for (uint32_t e=1u; e<endpointCount; e++)
+                {
+                    const uint32_t value = fields[4u*c+e];
+                    if (mode.transformed)
+                    {
+                        const uint32_t absolute = (w+signExtendBC6H(value, mode.deltaBits[c]))&mask;
+                        endpoints[c][e] = _signed ? signExtendBC6H(absolute, mode.endpointBits):absolute;
+                    }
+                    else
+                        endpoints[c][e] = _signed ? signExtendBC6H(value, mode.endpointBits):value;
+                }
+                for (uint32_t e=0u; e<endpointCount; e++)
+                    endpoints[c][e] = unquantizeBC6H(endpoints[c][e], mode.endpointBits, _signed);
+            }
+
+            const uint32_t partition = fields[D];
+            const uint32_t indexBits = mode.regions==2u ? 3u:4u;
+            const uint8_t* weights = getBPTCWeights(indexBits);
+            for (uint32_t i=0u; i<16u; i++)
+            {
+                const uint32_t weight = weights[bits.read(indexBits-(isBPTCAnchor(mode.regions, partition, i) ? 1u:0u))];
+                const uint32_t subset = getBPTCSubset(mode.regions, partition, i);
+                for (uint32_t c=0u; c<3u; c++)
+                {
+                    const int32_t value = (endpoints[c][2u*subset]*int32_t(64u-weight)+endpoints[c][2u*subset+1u]*int32_t(weight)+32)>>6;
+                    _output[i][c] = finishUnquantizeBC6H(value, _signed);
+                }
+            }
+            return true;
+        }
+
+        //! Decodes a BC7 block to 16 RGBA8 texels in row order
+        /** @returns false for the reserved mode, the texels are all zero then.*/
+        inline bool decodeBC7Block(const void* _block, uint8_t _output[16][4])
+        {
+            struct SMode
+            {
+                uint8_t subsets, partitionBits, rotationBits, indexSelectionBits, colorBits, alphaBits, endpointPBits, sharedPBits, indexBits, secondaryIndexBits;
+            };
+            static const SMode modes[8] = {
+                {3,4,0,0,4,0,1,0,3,0},
+                {2,6,0,0,6,0,0,1,3,0},
+                {3,6,0,0,5,0,0,0,2,0},
+                {2,6,0,0,7,0,1,0,2,0},
+                {1,0,2,1,5,6,0,0,2,3},
+                {1,0,2,0,7,8,0,0,2,2},
+                {1,0,0,0,7,7,1,0,4,0},
+                {2,6,0,0,5,5,1,0,2,0}
+            };
+
+            const uint8_t firstByte = *reinterpret_cast<const uint8_t*>(_block);
+            if (!firstByte)
+            {
+                memset(_output, 0, 64u);
+                return false;
+            }
+            uint32_t modeIx = 0u;
+            while (!(firstByte&(1u<<modeIx)))
+                modeIx++;
+            const SMode& mode = modes[modeIx];
+
+            SBlockBitReader bits(_block);
+            bits.read(modeIx+1u);
+            const uint32_t partition = bits.read(mode.partitionBits);
+            const uint32_t rotation = bits.read(mode.rotationBits);
+            const uint32_t indexSelection = bits.read(mode.indexSelectionBits);
+
+            // endpoints[subset*2+e][c]
+            uint32_t endpoints[6][4];
+            const uint32_t endpointCount = mode.subsets*2u;
+            for (uint32_t c=0u; c<3u; c++)
+            for (uint32_t e=0u; e<endpointCount; e++)
+                endpoints[e][c] = bits.read(mode.colorBits);
+            for (uint32_t e=0u; e<endpointCount; e++)
+                endpoints[e][3] = mode.alphaBits ? bits.read(mode.alphaBits):0xffu;
+
+            uint32_t colorBits = mode.colorBits;
+            uint32_t alphaBits = mode.alphaBits;
+            if (mode.endpointPBits || mode.sharedPBits)
+            {
+                uint32_t pBits[6];
+                for (uint32_t e=0u; e<endpointCount; e+=2u)
+                {
+                    pBits[e] = bits.read(1u);
+                    pBits[e+1u] = mode.sharedPBits ? pBits[e]:bits.read(1u);
+                }
+                for (uint32_t e=0u; e<endpointCount; e++)
+                for (uint32_t c=0u; c<(alphaBits ? 4u:3u); c++)
+                    endpoints[e][c] = (endpoints[e][c]<<1u)|pBits[e];
+                colorBits++;
+                if (alphaBits)
+                    alphaBits++;
+            }
+            for (uint32_t e=0u; e<endpointCount; e++)
             {
-                int lut = int(b.lut[3]) | int(b.lut[4] << 8) | int(b.lut[5] << 16);
-                int aw = 7 & (lut >> (3 * idx));
-                _output[_offset] = a[aw];
+                for (uint32_t c=0u; c<3u; c++)
+                    endpoints[e][c] = (endpoints[e][c]<<(8u-colorBits))|(endpoints[e][c]>>(2u*colorBits-8u));
+                if (alphaBits)
+                    endpoints[e][3] = (endpoints[e][3]<<(8u-alphaBits))|(endpoints[e][3]>>(2u*alphaBits-8u));
             }
+
+            uint32_t indices[16];
+            for (uint32_t i=0u; i<16u; i++)
+                indices[i] = bits.read(mode.indexBits-(isBPTCAnchor(mode.subsets, partition, i) ? 1u:0u));
+            uint32_t secondaryIndices[16];
+            if (mode.secondaryIndexBits)
+            for (uint32_t i=0u; i<16u; i++)
+                secondaryIndices[i] = bits.read(mode.secondaryIndexBits-(i ? 0u:1u));
+
+            const uint8_t* colorWeights = getBPTCWeights(mode.indexBits);
+            const uint8_t* alphaWeights = colorWeights;
+            const uint32_t* colorIndices = indices;
+            const uint32_t* alphaIndices = indices;
+            if (mode.secondaryIndexBits)
+            {
+                // the index selection bit swaps which index set drives color and which drives alpha
+                alphaWeights = getBPTCWeights(mode.secondaryIndexBits);
+                alphaIndices = secondaryIndices;
+                if (indexSelection)
+                {
+                    std::swap(colorWeights, alphaWeights);
+                    std::swap(colorIndices, alphaIndices);
+                }
+            }
+
+            for (uint32_t i=0u; i<16u; i++)
+            {
+                const uint32_t subset = getBPTCSubset(mode.subsets, partition, i);
+                const uint32_t* e0 = endpoints[2u*subset];
+                const uint32_t* e1 = endpoints[2u*subset+1u];
+                const uint32_t colorWeight = colorWeights[colorIndices[i]];
+                const uint32_t alphaWeight = alphaWeights[alphaIndices[i]];
+                for (uint32_t c=0u; c<3u; c++)
+                    _output[i][c] = (e0[c]*(64u-colorWeight)+e1[c]*colorWeight+32u)>>6u;
+                _output[i][3] = (e0[3]*(64u-alphaWeight)+e1[3]*alphaWeight+32u)>>6u;
+                if (rotation)
+                    std::swap(_output[i][3], _output[i][rotation-1u]);
+            }
+            return true;
         }
 
         template<typename T>
@@ -1311,71 +1640,240 @@ namespace irr { namespace video // why is this in the video namespace!?
         }
     }
 
+    //! Decodes a whole 4x4 block of a BC1-BC7 format to 16 RGBA texels in row order
+    /** Channels the format lacks are 0, or 1 for alpha, sRGB formats get converted to linear.
+    Going through this instead of `decodePixels` texel by texel saves decoding every block 16 times.
+    @returns false if `_fmt` is not one of the BC formats.*/
+    inline bool decodeBlock(asset::E_FORMAT _fmt, const void* _block, double _output[16][4])
+    {
+        const uint8_t* block = reinterpret_cast<const uint8_t*>(_block);
+        uint8_t texels[16][4];
+        bool sRGB = false;
+        switch (_fmt)
+        {
+            case asset::EF_BC1_RGB_SRGB_BLOCK:
+                sRGB = true;
+                _IRR_FALLTHROUGH;
+            case asset::EF_BC1_RGB_UNORM_BLOCK:
+                impl::decodeBC1Block(block, texels, false);
+                for (auto& texel : texels)
+                    texel[3] = 0xffu;
+                break;
+            case asset::EF_BC1_RGBA_SRGB_BLOCK:
+                sRGB = true;
+                _IRR_FALLTHROUGH;
+            case asset::EF_BC1_RGBA_UNORM_BLOCK:
+                impl::decodeBC1Block(block, texels, false);
+                break;
+            case asset::EF_BC2_SRGB_BLOCK:
+                sRGB = true;
+                _IRR_FALLTHROUGH;
+            case asset::EF_BC2_UNORM_BLOCK:
+                impl::decodeBC1Block(block+8, texels, true);
+                for (uint32_t i=0u; i<16u; i++)
+                    texels[i][3] = ((block[i>>1u]>>((i&1u)*4u))&0xfu)*17u;
+                break;
+            case asset::EF_BC3_SRGB_BLOCK:
+                sRGB = true;
+                _IRR_FALLTHROUGH;
+            case asset::EF_BC3_UNORM_BLOCK:
+            {
+                impl::decodeBC1Block(block+8, texels, true);
+                uint8_t alpha[16];
+                impl::decodeBC4Block(block, alpha, false);
+                for (uint32_t i=0u; i<16u; i++)
+                    texels[i][3] = alpha[i];
+                break;
+            }
+            case asset::EF_BC4_UNORM_BLOCK:
+            case asset::EF_BC4_SNORM_BLOCK:
+            case asset::EF_BC5_UNORM_BLOCK:
+            case asset::EF_BC5_SNORM_BLOCK:
+            {
+                const bool isSigned = _fmt==asset::EF_BC4_SNORM_BLOCK || _fmt==asset::EF_BC5_SNORM_BLOCK;
+                const uint32_t channels = (_fmt==asset::EF_BC5_UNORM_BLOCK || _fmt==asset::EF_BC5_SNORM_BLOCK) ? 2u:1u;
+                for (uint32_t c=0u; c<channels; c++)
+                {
+                    uint8_t values[16];
+                    impl::decodeBC4Block(block+8u*c, values, isSigned);
+                    for (uint32_t i=0u; i<16u; i++)
+                        _output[i][c] = isSigned ? (static_cast<int8_t>(values[i])/127.):(values[i]/255.);
+                }
+                for (uint32_t i=0u; i<16u; i++)
+                {
+                    for (uint32_t c=channels; c<3u; c++)
+                        _output[i][c] = 0.;
+                    _output[i][3] = 1.;
+                }
+                return true;
+            }
+            case asset::EF_BC6H_UFLOAT_BLOCK:
+            case asset::EF_BC6H_SFLOAT_BLOCK:
+            {
+                uint16_t halfs[16][3];
+                impl::decodeBC6HBlock(block, halfs, _fmt==asset::EF_BC6H_SFLOAT_BLOCK);
+                for (uint32_t i=0u; i<16u; i++)
+                {
+                    for (uint32_t c=0u; c<3u; c++)
+                        _output[i][c] = core::Float16Compressor::decompress(halfs[i][c]);
+                    _output[i][3] = 1.;
+                }
+                return true;
+            }
+            case asset::EF_BC7_SRGB_BLOCK:
+                sRGB = true;
+                _IRR_FALLTHROUGH;
+            case asset::EF_BC7_UNORM_BLOCK:
+                impl::decodeBC7Block(block, texels);
+                break;
+            default:
+                return false;
+        }
+
+        for (uint32_t i=0u; i<16u; i++)
+        {
+            for (uint32_t c=0u; c<4u; c++)
+                _output[i][c] = texels[i][c]/255.;
+            if (sRGB)
+                impl::SRGB2lin(_output[i]);
+        }
+        return true;
+    }
+
+    template<asset::E_FORMAT fmt>
+    inline bool decodeBlock(const void* _block, double _output[16][4])
+    {
+        return decodeBlock(fmt, _block, _output);
+    }
+
+    //! Decodes a horizontal run of `_blockCount` consecutive blocks of a BC format into 4 rows of RGBA texels
+    /** Row `y` of the output starts at `_output+y*_outputRowPitch`, the pitch is in doubles and 0 means tightly packed rows of `4*_blockCount` texels.
+    @returns false if `_fmt` is not one of the BC formats.*/
+    inline bool decodeBlockRow(asset::E_FORMAT _fmt, const void* _blocks, uint32_t _blockCount, double* _output, size_t _outputRowPitch=0u)
+    {
+        if (!asset::isBlockCompressionFormat(_fmt))
+            return false;
+        if (!_outputRowPitch)
+            _outputRowPitch = static_cast<size_t>(_blockCount)*16u;
+
+        const uint32_t blockSize = asset::getTexelOrBlockBytesize(_fmt);
+        const uint8_t* block = reinterpret_cast<const uint8_t*>(_blocks);
+        double texels[16][4];
+        for (uint32_t i=0u; i<_blockCount; i++, block+=blockSize)
+        {
+            if (!decodeBlock(_fmt, block, texels))
+                return false;
+            for (uint32_t y=0u; y<4u; y++)
+                memcpy(_output+y*_outputRowPitch+i*16u, texels[4u*y], sizeof(double)*16u);
+        }
+        return true;
+    }
+
+    namespace impl
+    {
+        template<asset::E_FORMAT fmt>
+        inline void decodeBlockTexel(const void* _block, double* _output, uint32_t _x, uint32_t _y)
+        {
+            double texels[16][4];
+            decodeBlock<fmt>(_block, texels);
+            memcpy(_output, texels[4u*_y+_x], sizeof(texels[0]));
+        }
+    }
+
     template<>
     inline void decodePixels<asset::EF_BC1_RGB_UNORM_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
     {
-        impl::decodeBC1<double>(_pix[0], _output, _x, _y, false);
-        _output[0] /= 31.;
-        _output[1] /= 63.;
-        _output[2] /= 31.;
+        impl::decodeBlockTexel<asset::EF_BC1_RGB_UNORM_BLOCK>(_pix[0], _output, _x, _y);
     }
 
     template<>
     inline void decodePixels<asset::EF_BC1_RGB_SRGB_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
     {
-        decodePixels<asset::EF_BC1_RGB_UNORM_BLOCK, double>(_pix, _output, _x, _y);
-        impl::SRGB2lin(_output);
+        impl::decodeBlockTexel<asset::EF_BC1_RGB_SRGB_BLOCK>(_pix[0], _output, _x, _y);
     }
 
     template<>
     inline void decodePixels<asset::EF_BC1_RGBA_UNORM_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
     {
-        impl::decodeBC1<double>(_pix[0], _output, _x, _y, true);
-        _output[0] /= 31.;
-        _output[1] /= 63.;
-        _output[2] /= 31.;
+        impl::decodeBlockTexel<asset::EF_BC1_RGBA_UNORM_BLOCK>(_pix[0], _output, _x, _y);
     }
 
     template<>
     inline void decodePixels<asset::EF_BC1_RGBA_SRGB_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
     {
-        decodePixels<asset::EF_BC1_RGBA_UNORM_BLOCK, double>(_pix, _output, _x, _y);
-        impl::SRGB2lin(_output);
+        impl::decodeBlockTexel<asset::EF_BC1_RGBA_SRGB_BLOCK>(_pix[0], _output, _x, _y);
     }
 
     template<>
     inline void decodePixels<asset::EF_BC2_UNORM_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
     {
-        impl::decodeBC2<double>(_pix[0], _output, _x, _y);
-        _output[0] /= 31.;
-        _output[1] /= 63.;
-        _output[2] /= 31.;
-        _output[3] /= 15.;
+        impl::decodeBlockTexel<asset::EF_BC2_UNORM_BLOCK>(_pix[0], _output, _x, _y);
     }
 
     template<>
     inline void decodePixels<asset::EF_BC2_SRGB_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
     {
-        decodePixels<asset::EF_BC2_UNORM_BLOCK, double>(_pix, _output, _x, _y);
-        impl::SRGB2lin(_output);
+        impl::decodeBlockTexel<asset::EF_BC2_SRGB_BLOCK>(_pix[0], _output, _x, _y);
     }
 
     template<>
     inline void decodePixels<asset::EF_BC3_UNORM_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
     {
-        const void* pix[4];
-        memcpy(pix, _pix, sizeof(pix));
-        pix[0] = reinterpret_cast<const uint8_t*>(pix[0])+8;
-        decodePixels<asset::EF_BC1_RGBA_UNORM_BLOCK, double>(pix, _output, _x, _y);
-        impl::decodeBC4(_pix, _output, 3, _x, _y);
-        _output[3] /= 255.;
+        impl::decodeBlockTexel<asset::EF_BC3_UNORM_BLOCK>(_pix[0], _output, _x, _y);
     }
 
     template<>
     inline void decodePixels<asset::EF_BC3_SRGB_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
     {
-        decodePixels<asset::EF_BC3_UNORM_BLOCK, double>(_pix, _output, _x, _y);
-        impl::SRGB2lin(_output);
+        impl::decodeBlockTexel<asset::EF_BC3_SRGB_BLOCK>(_pix[0], _output, _x, _y);
+    }
+
+    template<>
+    inline void decodePixels<asset::EF_BC4_UNORM_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
+    {
+        impl::decodeBlockTexel<asset::EF_BC4_UNORM_BLOCK>(_pix[0], _output, _x, _y);
+    }
+
+    template<>
+    inline void decodePixels<asset::EF_BC4_SNORM_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
+    {
+        impl::decodeBlockTexel<asset::EF_BC4_SNORM_BLOCK>(_pix[0], _output, _x, _y);
+    }
+
+    template<>
+    inline void decodePixels<asset::EF_BC5_UNORM_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
+    {
+        impl::decodeBlockTexel<asset::EF_BC5_UNORM_BLOCK>(_pix[0], _output, _x, _y);
+    }
+
+    template<>
+    inline void decodePixels<asset::EF_BC5_SNORM_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
+    {
+        impl::decodeBlockTexel<asset::EF_BC5_SNORM_BLOCK>(_pix[0], _output, _x, _y);
+    }
+
+    template<>
+    inline void decodePixels<asset::EF_BC6H_UFLOAT_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
+    {
+        impl::decodeBlockTexel<asset::EF_BC6H_UFLOAT_BLOCK>(_pix[0], _output, _x, _y);
+    }
+
+    template<>
+    inline void decodePixels<asset::EF_BC6H_SFLOAT_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
+    {
+        impl::decodeBlockTexel<asset::EF_BC6H_SFLOAT_BLOCK>(_pix[0], _output, _x, _y);
+    }
+
+    template<>
+    inline void decodePixels<asset::EF_BC7_UNORM_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
+    {
+        impl::decodeBlockTexel<asset::EF_BC7_UNORM_BLOCK>(_pix[0], _output, _x, _y);
+    }
+
+    template<>
+    inline void decodePixels<asset::EF_BC7_SRGB_BLOCK, double>(const void* _pix[4], double* _output, uint32_t _x, uint32_t _y)
+    {
+        impl::decodeBlockTexel<asset::EF_BC7_SRGB_BLOCK>(_pix[0], _output, _x, _y);
     }
 
     template<>
@@ -1658,6 +2156,14 @@ namespace irr { namespace video // why is this in the video namespace!?
         case asset::EF_BC2_SRGB_BLOCK: decodePixels<asset::EF_BC2_SRGB_BLOCK, double>(_pix, _output, _blockX, _blockY); return true;
         case asset::EF_BC3_UNORM_BLOCK: decodePixels<asset::EF_BC3_UNORM_BLOCK, double>(_pix, _output, _blockX, _blockY); return true;
         case asset::EF_BC3_SRGB_BLOCK: decodePixels<asset::EF_BC3_SRGB_BLOCK, double>(_pix, _output, _blockX, _blockY); return true;
+        case asset::EF_BC4_UNORM_BLOCK: decodePixels<asset::EF_BC4_UNORM_BLOCK, double>(_pix, _output, _blockX, _blockY); return true;
+        case asset::EF_BC4_SNORM_BLOCK: decodePixels<asset::EF_BC4_SNORM_BLOCK, double>(_pix, _output, _blockX, _blockY); return true;
+        case asset::EF_BC5_UNORM_BLOCK: decodePixels<asset::EF_BC5_UNORM_BLOCK, double>(_pix, _output, _blockX, _blockY); return true;
+        case asset::EF_BC5_SNORM_BLOCK: decodePixels<asset::EF_BC5_SNORM_BLOCK, double>(_pix, _output, _blockX, _blockY); return true;
+        case asset::EF_BC6H_UFLOAT_BLOCK: decodePixels<asset::EF_BC6H_UFLOAT_BLOCK, double>(_pix, _output, _blockX, _blockY); return true;
+        case asset::EF_BC6H_SFLOAT_BLOCK: decodePixels<asset::EF_BC6H_SFLOAT_BLOCK, double>(_pix, _output, _blockX, _blockY); return true;
+        case asset::EF_BC7_UNORM_BLOCK: decodePixels<asset::EF_BC7_UNORM_BLOCK, double>(_pix, _output, _blockX, _blockY); return true;
+        case asset::EF_BC7_SRGB_BLOCK: decodePixels<asset::EF_BC7_SRGB_BLOCK, double>(_pix, _output, _blockX, _blockY); return true;
         case asset::EF_G8_B8_R8_3PLANE_420_UNORM: decodePixels<asset::EF_G8_B8_R8_3PLANE_420_UNORM, double>(_pix, _output, _blockX, _blockY); return true;
         case asset::EF_G8_B8R8_2PLANE_420_UNORM: decodePixels<asset::EF_G8_B8R8_2PLANE_420_UNORM, double>(_pix, _output, _blockX, _blockY); return true;
         case asset::EF_G8_B8_R8_3PLANE_422_UNORM: decodePixels<asset::EF_G8_B8_R8_3PLANE_422_UNORM, double>(_pix, _output, _blockX, _blockY); return true;
@@ -0,0 +1,56 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_ENCODE_BLOCKS_H_INCLUDED__
+#define __IRR_ENCODE_BLOCKS_H_INCLUDED__
+
+#include <string>
+
+#include "irr/core/core.h"
+#include "irr/asset/format/EFormat.h"
+#include "irr/asset/CImageData.h"
+#include "irr/asset/ICPUTexture.h"
+
+namespace irr { namespace video
+{
+    //! How hard the block encoders search for endpoints, every level is deterministic
+    enum E_BLOCK_ENCODE_QUALITY
+    {
+        //! Endpoints straight from the principal axis of the block, BC7 only tries mode 6
+        EBEQ_FAST = 0,
+        //! Least squares refinement of the endpoints, BC7 also tries the likeliest partition of the two subset modes
+        EBEQ_NORMAL,
+        //! More refinement passes plus a local search around the quantized endpoints, BC7 tries most modes and several partitions
+        EBEQ_BEST
+    };
+
+    //! Whether encodeBlock() can produce `_fmt`
+    /** That is BC1 (both RGB and RGBA), BC2, BC3, BC7 in UNORM and SRGB variants, and UNORM BC4 and BC5.*/
+    bool isBlockEncodable(asset::E_FORMAT _fmt);
+
+    //! Encodes 16 RGBA texels in row order into a single block of `_fmt`, the inverse of decodeBlock()
+    /** Texels are normalized and linear like decodePixels<double> produces them, values outside [0,1] get clamped
+    and sRGB formats get their color converted before quantization. BC1_RGBA turns texels with alpha below 0.5 transparent.
+    @returns false if `_fmt` is not encodable.*/
+    bool encodeBlock(asset::E_FORMAT _fmt, const double _texels[16][4], void* _output, E_BLOCK_ENCODE_QUALITY _quality=EBEQ_NORMAL);
+}
+}
+
+namespace irr { namespace asset
+{
+    //! Compresses a whole image range into a new CImageData of the block compressed format `_fmt`
+    /** Blocks are encoded in parallel, ragged blocks at the edges of the range repeat the edge texels.
+    The X and Y offsets of the range must be multiples of 4 so that blocks line up with the texture.
+    @param _threadCount 0 means core::getDefaultThreadCount().
+    @returns nullptr if `_fmt` is not encodable or the source cannot be decoded to floating point (integer and planar formats).*/
+    CImageData* createBlockCompressedImage(const CImageData* _image, E_FORMAT _fmt, video::E_BLOCK_ENCODE_QUALITY _quality=video::EBEQ_NORMAL, uint32_t _threadCount=0u);
+
+    //! Compresses every range of `_texture`, the blocks of all mip levels share one pool of threads
+    /** The new texture keeps the type of `_texture` and is named `_newName`, or the same as `_texture` if that is empty.
+    @returns Texture with a reference count of 1, or nullptr if any of the ranges could not be compressed.*/
+    ICPUTexture* createBlockCompressedTexture(const ICPUTexture* _texture, E_FORMAT _fmt, video::E_BLOCK_ENCODE_QUALITY _quality=video::EBEQ_NORMAL, uint32_t _threadCount=0u, const std::string& _newName="");
+}
+}
+
+#endif
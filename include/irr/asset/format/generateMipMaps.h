@@ -0,0 +1,50 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_GENERATE_MIP_MAPS_H_INCLUDED__
+#define __IRR_GENERATE_MIP_MAPS_H_INCLUDED__
+
+#include <string>
+
+#include "irr/core/core.h"
+#include "irr/asset/format/EFormat.h"
+#include "irr/asset/ICPUTexture.h"
+
+namespace irr { namespace asset
+{
+    //! Reconstruction filters for createMipMappedTexture(), all of them are separable
+    enum E_MIP_MAP_FILTER
+    {
+        //! Average of the texels a level texel covers, handles odd sizes by weighting partially covered texels
+        EMMF_BOX = 0,
+        //! Kaiser windowed sinc with a radius of 3 texels of the level being made, sharper than box without much ringing
+        EMMF_KAISER,
+        //! Lanczos 3, sharpest of the three and the one that rings the most
+        EMMF_LANCZOS
+    };
+
+    struct SMipMapGenerationParams
+    {
+        E_MIP_MAP_FILTER filter = EMMF_BOX;
+        //! Number of levels including the base one, 0 means the full chain down to a single texel
+        uint32_t levelCount = 0u;
+        //! If in (0,1), the alpha of every generated level is scaled so that the fraction of texels with alpha above this value stays the same as in the base level
+        /** Keeps alpha tested foliage and fences from thinning out in the distance. Every array layer and cube face is matched on its own.*/
+        float alphaCoverageReference = 0.f;
+        //! 0 means core::getDefaultThreadCount()
+        uint32_t threadCount = 0u;
+    };
+
+    //! Creates a texture with the base level of `_texture` and a new mip chain filtered from it
+    /** Levels already present above the base are replaced. Every level is filtered from the previous one at floating point precision
+    and sRGB formats are filtered in linear space, the new levels are stored in the format of the base level.
+    1D, 2D and cube textures (including arrays) only shrink in the dimensions that are not layers, cube faces are filtered separately with their edges clamped.
+    The passes are split into runs of texel rows which are handed out to the threads.
+    @returns Texture with a reference count of 1, or nullptr if the base level is not a single range covering the whole texture,
+    or its format is block compressed, planar, integer or has no encoder.*/
+    ICPUTexture* createMipMappedTexture(const ICPUTexture* _texture, const SMipMapGenerationParams& _params=SMipMapGenerationParams(), const std::string& _newName="");
+}
+}
+
+#endif
@@ -140,6 +140,19 @@ namespace asset
 		return bestFit;
     }
 
+	//! Does not touch the global cache, so unlike quantizeNormal2_10_10_10 it can be called from many threads at once
+	inline uint32_t quantizeNormal2_10_10_10_uncached(const core::vectorSIMDf &normal)
+	{
+		constexpr uint32_t quantizationBits = 10u;
+		const auto xorflag = core::vectorSIMDu32((0x1u<<quantizationBits)-1u);
+        core::vectorSIMDf fit = findBestFit(quantizationBits, normal);
+		auto negativeMask = normal < core::vectorSIMDf(0.f);
+		auto absIntFit = core::vectorSIMDu32(core::abs(fit))^core::mix(core::vectorSIMDu32(0u),core::vectorSIMDu32(xorflag),negativeMask);
+		auto snormVec = (absIntFit+core::mix(core::vectorSIMDu32(0u),core::vectorSIMDu32(1u),negativeMask))&xorflag;
+        
+        return snormVec[0]|(snormVec[1]<<quantizationBits)|(snormVec[2]<<(quantizationBits*2u));
+	}
+
 	inline uint32_t quantizeNormal2_10_10_10(const core::vectorSIMDf &normal)
 	{
         QuantizationCacheEntry2_10_10_10 dummySearchVal;
@@ -150,14 +163,7 @@ namespace asset
             return found->value;
         }
 
-		constexpr uint32_t quantizationBits = 10u;
-		const auto xorflag = core::vectorSIMDu32((0x1u<<quantizationBits)-1u);
-        core::vectorSIMDf fit = findBestFit(quantizationBits, normal);
-		auto negativeMask = normal < core::vectorSIMDf(0.f);
-		auto absIntFit = core::vectorSIMDu32(core::abs(fit))^core::mix(core::vectorSIMDu32(0u),core::vectorSIMDu32(xorflag),negativeMask);
-		auto snormVec = (absIntFit+core::mix(core::vectorSIMDu32(0u),core::vectorSIMDu32(1u),negativeMask))&xorflag;
-        
-        uint32_t bestFit = snormVec[0]|(snormVec[1]<<quantizationBits)|(snormVec[2]<<(quantizationBits*2u));
+        uint32_t bestFit = quantizeNormal2_10_10_10_uncached(normal);
 
 		dummySearchVal.value = bestFit;
         normalCacheFor2_10_10_10Quant.insert(found,dummySearchVal);
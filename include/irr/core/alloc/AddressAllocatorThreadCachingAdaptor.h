@@ -0,0 +1,337 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_ADDRESS_ALLOCATOR_THREAD_CACHING_ADAPTOR_H_INCLUDED__
+#define __IRR_ADDRESS_ALLOCATOR_THREAD_CACHING_ADAPTOR_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#include <mutex>
+
+#include "irr/core/Types.h"
+#include "irr/core/IReferenceCounted.h"
+#include "irr/core/math/glslFunctions.h"
+#include "irr/core/alloc/address_allocator_traits.h"
+#include "irr/core/parallel/IThreadBound.h"
+
+namespace irr
+{
+namespace core
+{
+
+
+//! Thread-caching front end for address allocators with arbitrary order frees (i.e. GeneralpurposeAddressAllocator)
+/** Small requests (up to `min_size()<<(sizeClassCount-1)` bytes) get rounded up to a power-of-two multiple of `min_size()`,
+which makes any freed block of a size class reusable by any later request of that class.
+Worker threads own a ThreadCache each and pass it to the `multi_` functions, freed small blocks land in the cache
+and allocations are served from it without touching the lock. The shared allocator is only locked on a cache miss
+(which refills `refillCount` blocks at once) or when a size class overflows `maxCachedPerClass` entries,
+in which case the cache is deterministically trimmed back to half of that with a single locked batch free.
+The cache-less `multi_` overloads lock on every call, just like AddressAllocatorBasicConcurrencyAdaptor.
+Blocks sitting in caches count as allocated as far as `get_free_size()` is concerned, call `trim` to give them back.
+A ThreadCache may outlive its adaptor (i.e. a `thread_local` one on a worker thread), it gets detached when the adaptor is destroyed
+and its blocks are simply forgotten, as they were part of the adaptor's address space.*/
+template<class AddressAllocator, class RecursiveLockable, uint32_t sizeClassCount=8u, uint32_t maxCachedPerClass=64u, uint32_t refillCount=8u>
+class AddressAllocatorThreadCachingAdaptor : private AddressAllocator
+{
+        static_assert(std::is_standard_layout<RecursiveLockable>::value,"Lock class is not standard layout");
+        static_assert(refillCount<=maxCachedPerClass,"Refills would overflow the cache");
+        mutable RecursiveLockable lock;
+
+        AddressAllocator& getBaseRef() {return reinterpret_cast<AddressAllocator&>(*this);}
+
+        //! Shared by the adaptor and its caches, so a cache can tell whether the adaptor is still alive
+        class ControlBlock : public IReferenceCounted
+        {
+            public:
+                ControlBlock(AddressAllocatorThreadCachingAdaptor* _adaptor) : adaptor(_adaptor) {}
+
+                //! held while a cache gives its blocks back and while the adaptor detaches from its caches
+                std::mutex mutex;
+                AddressAllocatorThreadCachingAdaptor* adaptor;
+        };
+        core::smart_refctd_ptr<ControlBlock> control = core::make_smart_refctd_ptr<ControlBlock>(this);
+    public:
+        _IRR_DECLARE_ADDRESS_ALLOCATOR_TYPEDEFS(typename AddressAllocator::size_type);
+
+        typedef address_allocator_traits<AddressAllocator>              traits;
+        static_assert(address_allocator_traits<AddressAllocator>::supportsArbitraryOrderFrees,"AddressAllocator does not support arbitrary order frees!");
+
+        //! Per-thread cache of freed blocks, must only ever be used by the thread which created it
+        class ThreadCache : public IThreadBound
+        {
+                friend class AddressAllocatorThreadCachingAdaptor;
+
+                core::smart_refctd_ptr<ControlBlock> control;
+                const size_type minSize;
+                //! freed addresses of every size class, used as a stack
+                core::vector<size_type> freeBlocks[sizeClassCount];
+            public:
+                ThreadCache(AddressAllocatorThreadCachingAdaptor* _parent) : control(_parent->control), minSize(_parent->min_size())
+                {
+                    for (auto& blocks : freeBlocks)
+                        blocks.reserve(maxCachedPerClass+refillCount);
+                }
+                ~ThreadCache()
+                {
+                    std::lock_guard<std::mutex> guard(control->mutex);
+                    if (control->adaptor)
+                        control->adaptor->trim(*this);
+                }
+
+                inline size_type get_cached_size() const noexcept
+                {
+                    size_type retval = 0u;
+                    for (uint32_t i=0u; i<sizeClassCount; i++)
+                        retval += freeBlocks[i].size()*(minSize<<size_type(i));
+                    return retval;
+                }
+        };
+
+        using AddressAllocator::AddressAllocator;
+        virtual ~AddressAllocatorThreadCachingAdaptor()
+        {
+            // waits for caches being destroyed right now to finish trimming, and stops any later ones from touching this
+            std::lock_guard<std::mutex> guard(control->mutex);
+            control->adaptor = nullptr;
+        }
+
+
+        //! Locked path, use if the calling thread does not have a ThreadCache
+        inline void         multi_alloc_addr(uint32_t count, size_type* outAddresses, const size_type* bytes, const size_type* alignment, const size_type* hint=nullptr) noexcept
+        {
+            lock.lock();
+            for (uint32_t i=0u; i<count; i++)
+            {
+                if (outAddresses[i]!=invalid_address)
+                    continue;
+                const size_type roundedBytes = roundRequestSize(bytes[i]);
+                traits::multi_alloc_addr(getBaseRef(),1u,outAddresses+i,&roundedBytes,alignment+i,hint ? (hint+i):nullptr);
+            }
+            lock.unlock();
+        }
+        //! Locked path, use if the calling thread does not have a ThreadCache
+        inline void         multi_free_addr(uint32_t count, const size_type* addr, const size_type* bytes) noexcept
+        {
+            lock.lock();
+            freeRounded(count,addr,bytes);
+            lock.unlock();
+        }
+
+        inline void         multi_alloc_addr(ThreadCache& cache, uint32_t count, size_type* outAddresses, const size_type* bytes, const size_type* alignment, const size_type* hint=nullptr) noexcept
+        {
+            #ifdef _IRR_DEBUG
+                assert(cache.belongsToCurrentThread() && cache.control==control);
+            #endif // _IRR_DEBUG
+            bool locked = false;
+            for (uint32_t i=0u; i<count; i++)
+            {
+                if (outAddresses[i]!=invalid_address)
+                    continue;
+
+                const uint32_t sizeClass = getSizeClass(bytes[i]);
+                if (sizeClass<sizeClassCount)
+                {
+                    outAddresses[i] = popFromCache(cache.freeBlocks[sizeClass],alignment[i]);
+                    if (outAddresses[i]!=invalid_address)
+                        continue;
+                }
+
+                if (!locked)
+                {
+                    lock.lock();
+                    locked = true;
+                }
+                if (sizeClass<sizeClassCount)
+                    refill(cache.freeBlocks[sizeClass],sizeClass,alignment[i]);
+                outAddresses[i] = sizeClass<sizeClassCount ? popFromCache(cache.freeBlocks[sizeClass],alignment[i]):
+                                                             AddressAllocator::alloc_addr(bytes[i],alignment[i],hint ? hint[i]:0ull);
+            }
+            if (locked)
+                lock.unlock();
+        }
+
+        inline void         multi_free_addr(ThreadCache& cache, uint32_t count, const size_type* addr, const size_type* bytes) noexcept
+        {
+            #ifdef _IRR_DEBUG
+                assert(cache.belongsToCurrentThread() && cache.control==control);
+            #endif // _IRR_DEBUG
+            bool locked = false;
+            for (uint32_t i=0u; i<count; i++)
+            {
+                if (addr[i]==invalid_address)
+                    continue;
+
+                const uint32_t sizeClass = getSizeClass(bytes[i]);
+                if (sizeClass<sizeClassCount)
+                {
+                    auto& blocks = cache.freeBlocks[sizeClass];
+                    blocks.push_back(addr[i]);
+                    if (blocks.size()<=maxCachedPerClass)
+                        continue;
+                }
+
+                if (!locked)
+                {
+                    lock.lock();
+                    locked = true;
+                }
+                if (sizeClass<sizeClassCount)
+                    flush(cache.freeBlocks[sizeClass],sizeClass,maxCachedPerClass/2u);
+                else
+                    AddressAllocator::free_addr(addr[i],bytes[i]);
+            }
+            if (locked)
+                lock.unlock();
+        }
+
+        //! Returns cached blocks to the shared allocator leaving at most `keepPerClass` in every size class
+        inline void         trim(ThreadCache& cache, uint32_t keepPerClass=0u) noexcept
+        {
+            lock.lock();
+            for (uint32_t i=0u; i<sizeClassCount; i++)
+                flush(cache.freeBlocks[i],i,keepPerClass);
+            lock.unlock();
+        }
+
+        //! All ThreadCaches need to be trimmed completely before calling this
+        inline void         reset() noexcept
+        {
+            lock.lock();
+            AddressAllocator::reset();
+            lock.unlock();
+        }
+
+        //! Conservative estimate, max_size() gives largest size we are sure to be able to allocate
+        inline size_type    max_size() const noexcept
+        {
+            lock.lock();
+            auto retval = AddressAllocator::max_size();
+            lock.unlock();
+            return retval;
+        }
+
+        //! Most address allocators do not support e.g. 1-byte allocations
+        inline size_type    min_size() const noexcept
+        {
+            return AddressAllocator::min_size();
+        }
+
+        inline size_type    max_alignment() const noexcept
+        {
+            return AddressAllocator::max_alignment();
+        }
+
+        //! Does not include blocks held by ThreadCaches
+        inline size_type    get_free_size() const noexcept
+        {
+            lock.lock();
+            auto retval = AddressAllocator::get_free_size();
+            lock.unlock();
+            return retval;
+        }
+
+        template<typename... Args>
+        inline size_type    safe_shrink_size(const Args&... args) const noexcept
+        {
+            lock.lock();
+            auto retval = AddressAllocator::safe_shrink_size(args...);
+            lock.unlock();
+            return retval;
+        }
+
+        template<typename... Args>
+        static inline size_type reserved_size(const Args&... args) noexcept
+        {
+            return AddressAllocator::reserved_size(args...);
+        }
+
+
+        //! Extra == USE WITH EXTREME CAUTION
+        inline RecursiveLockable&   get_lock() noexcept
+        {
+            return lock;
+        }
+    protected:
+        inline size_type    getSizeClassBytes(uint32_t sizeClass) const noexcept
+        {
+            return AddressAllocator::min_size()<<size_type(sizeClass);
+        }
+        //! Returns `sizeClassCount` for requests too large to be cached
+        inline uint32_t     getSizeClass(size_type bytes) const noexcept
+        {
+            const size_type minSize = AddressAllocator::min_size();
+            if (bytes<=minSize)
+                return 0u;
+            const size_type multiple = (bytes-1u)/minSize;
+            if (multiple>=(size_type(1u)<<size_type(sizeClassCount-1u)))
+                return sizeClassCount;
+            return findMSB(multiple)+1u;
+        }
+        inline size_type    roundRequestSize(size_type bytes) const noexcept
+        {
+            const uint32_t sizeClass = getSizeClass(bytes);
+            return sizeClass<sizeClassCount ? getSizeClassBytes(sizeClass):bytes;
+        }
+
+        //! Frees must be rounded the same way as allocations, lock must be held
+        inline void         freeRounded(uint32_t count, const size_type* addr, const size_type* bytes) noexcept
+        {
+            for (uint32_t i=0u; i<count; i++)
+            {
+                if (addr[i]!=invalid_address)
+                    AddressAllocator::free_addr(addr[i],roundRequestSize(bytes[i]));
+            }
+        }
+
+        //! Takes the most recently freed block that satisfies the alignment
+        /** Which is nearly always the last one, a block found further down gets swapped with the last one
+        instead of shifting everything after it, so the stack order is only approximately kept.*/
+        inline size_type    popFromCache(core::vector<size_type>& blocks, size_type alignment) const noexcept
+        {
+            const size_type combinedOffset = AddressAllocator::get_combined_offset();
+            for (auto it=blocks.rbegin(); it!=blocks.rend(); it++)
+            {
+                if (((*it)-combinedOffset)%alignment)
+                    continue;
+                const size_type retval = *it;
+                *it = blocks.back();
+                blocks.pop_back();
+                return retval;
+            }
+            return invalid_address;
+        }
+
+        //! Lock must be held
+        inline void         refill(core::vector<size_type>& blocks, uint32_t sizeClass, size_type alignment) noexcept
+        {
+            const size_type classBytes = getSizeClassBytes(sizeClass);
+            for (uint32_t i=0u; i<refillCount; i++)
+            {
+                const size_type addr = AddressAllocator::alloc_addr(classBytes,alignment);
+                if (addr==invalid_address)
+                    break;
+                blocks.push_back(addr);
+            }
+        }
+
+        //! Lock must be held, oldest blocks go back first
+        inline void         flush(core::vector<size_type>& blocks, uint32_t sizeClass, uint32_t keep) noexcept
+        {
+            if (blocks.size()<=keep)
+                return;
+
+            const size_type classBytes = getSizeClassBytes(sizeClass);
+            const auto flushEnd = blocks.end()-keep;
+            for (auto it=blocks.begin(); it!=flushEnd; it++)
+                AddressAllocator::free_addr(*it,classBytes);
+            blocks.erase(blocks.begin(),flushEnd);
+        }
+};
+
+
+}
+}
+
+#endif // __IRR_ADDRESS_ALLOCATOR_THREAD_CACHING_ADAPTOR_H_INCLUDED__
@@ -597,6 +597,7 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
 }
 
 #include "irr/core/alloc/AddressAllocatorConcurrencyAdaptors.h"
+#include "irr/core/alloc/AddressAllocatorThreadCachingAdaptor.h"
 
 namespace irr
 {
@@ -610,6 +611,9 @@ using GeneralpurposeAddressAllocatorST = GeneralpurposeAddressAllocator<size_typ
 template<typename size_type, class RecursiveLockable>
 using GeneralpurposeAddressAllocatorMT = AddressAllocatorBasicConcurrencyAdaptor<GeneralpurposeAddressAllocator<size_type>,RecursiveLockable>;
 
+template<typename size_type, class RecursiveLockable>
+using GeneralpurposeAddressAllocatorThreadCached = AddressAllocatorThreadCachingAdaptor<GeneralpurposeAddressAllocator<size_type>,RecursiveLockable>;
+
 }
 }
 
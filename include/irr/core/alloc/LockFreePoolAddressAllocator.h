@@ -0,0 +1,236 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_LOCK_FREE_POOL_ADDRESS_ALLOCATOR_H_INCLUDED__
+#define __IRR_LOCK_FREE_POOL_ADDRESS_ALLOCATOR_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#include <atomic>
+#include "irr/core/alloc/AddressAllocatorBase.h"
+
+namespace irr
+{
+namespace core
+{
+
+
+//! Thread-safe counterpart of PoolAddressAllocator which does not take any locks
+/** The free blocks form an intrusive singly linked list (Treiber stack) whose links live in the reserved space,
+the head is a block index tagged with a modification counter in a single 64bit atomic so ABA cannot happen.
+`alloc_addr`, `free_addr` and their `multi_` versions can be called concurrently from any number of threads,
+the `multi_` versions only do a single CAS per call so batching requests reduces contention greatly,
+everything else (construction, `reset`, moving) requires exclusive access, just like with the non-MT allocators.
+Resizing is not supported, and the block count has to fit in 32bits.*/
+template<typename _size_type>
+class LockFreePoolAddressAllocator : public AddressAllocatorBase<LockFreePoolAddressAllocator<_size_type>,_size_type>
+{
+    private:
+        typedef AddressAllocatorBase<LockFreePoolAddressAllocator<_size_type>,_size_type> Base;
+
+        typedef std::atomic<uint32_t>   link_t;
+        _IRR_STATIC_INLINE_CONSTEXPR uint32_t invalid_block = 0xffffffffu;
+
+        static inline uint64_t  packHead(uint64_t oldHead, uint32_t blockID) noexcept
+        {
+            return (((oldHead>>32ull)+1ull)<<32ull)|blockID;
+        }
+    public:
+        _IRR_DECLARE_ADDRESS_ALLOCATOR_TYPEDEFS(_size_type);
+
+        static constexpr bool supportsNullBuffer = true;
+
+        #define DUMMY_DEFAULT_CONSTRUCTOR LockFreePoolAddressAllocator() : blockCount(0u), blockSize(1u), links(nullptr), head(invalid_block), freeBlockCount(0u) {}
+        GCC_CONSTRUCTOR_INHERITANCE_BUG_WORKAROUND(DUMMY_DEFAULT_CONSTRUCTOR)
+        #undef DUMMY_DEFAULT_CONSTRUCTOR
+
+        virtual ~LockFreePoolAddressAllocator() {}
+
+        LockFreePoolAddressAllocator(void* reservedSpc, _size_type addressOffsetToApply, _size_type alignOffsetNeeded, _size_type maxAllocatableAlignment, size_type bufSz, size_type blockSz) noexcept :
+					Base(reservedSpc,addressOffsetToApply,alignOffsetNeeded,maxAllocatableAlignment),
+						blockCount((bufSz-alignOffsetNeeded)/blockSz), blockSize(blockSz), links(reinterpret_cast<link_t*>(Base::reservedSpace)), head(invalid_block), freeBlockCount(0u)
+        {
+            #ifdef _IRR_DEBUG
+                assert(blockCount<invalid_block);
+            #endif // _IRR_DEBUG
+            for (size_type i=0u; i<blockCount; i++)
+                new (links+i) link_t(invalid_block);
+            reset();
+        }
+
+        LockFreePoolAddressAllocator& operator=(LockFreePoolAddressAllocator&& other)
+        {
+            Base::operator=(std::move(other));
+            std::swap(blockCount,other.blockCount);
+            std::swap(blockSize,other.blockSize);
+            std::swap(links,other.links);
+            head.store(other.head.exchange(head.load(std::memory_order_relaxed),std::memory_order_relaxed),std::memory_order_relaxed);
+            freeBlockCount.store(other.freeBlockCount.exchange(freeBlockCount.load(std::memory_order_relaxed),std::memory_order_relaxed),std::memory_order_relaxed);
+            return *this;
+        }
+
+
+        inline size_type        alloc_addr( size_type bytes, size_type alignment, size_type hint=0ull) noexcept
+        {
+            size_type retval = invalid_address;
+            multi_alloc_addr(1u,&retval,&bytes,&alignment);
+            return retval;
+        }
+
+        //! Pops all the blocks needed with a single CAS, so batches are much cheaper than separate `alloc_addr` calls
+        inline void             multi_alloc_addr(uint32_t count, size_type* outAddresses, const size_type* bytes, const size_type* alignment, const size_type* hint=nullptr) noexcept
+        {
+            uint32_t needed = 0u;
+            for (uint32_t i=0u; i<count; i++)
+            {
+                if (outAddresses[i]==invalid_address && isValidRequest(bytes[i],alignment[i]))
+                    needed++;
+            }
+            if (!needed)
+                return;
+
+            uint64_t oldHead = head.load(std::memory_order_acquire);
+            uint32_t popped,newTop;
+            do
+            {
+                // walking links of blocks some other thread just popped is fine, the tag will have changed and the CAS fails
+                popped = 0u;
+                newTop = static_cast<uint32_t>(oldHead);
+                for (; popped<needed && newTop!=invalid_block; popped++)
+                    newTop = links[newTop].load(std::memory_order_relaxed);
+            } while (popped && !head.compare_exchange_weak(oldHead,packHead(oldHead,newTop),std::memory_order_acquire,std::memory_order_acquire));
+
+            if (!popped)
+                return;
+            freeBlockCount.fetch_sub(popped,std::memory_order_relaxed);
+
+            // we own the popped chain now, nobody else will touch its links
+            uint32_t blockID = static_cast<uint32_t>(oldHead);
+            for (uint32_t i=0u; i<count && popped; i++)
+            {
+                if (outAddresses[i]!=invalid_address || !isValidRequest(bytes[i],alignment[i]))
+                    continue;
+                outAddresses[i] = blockID*blockSize+Base::combinedOffset;
+                blockID = links[blockID].load(std::memory_order_relaxed);
+                popped--;
+            }
+        }
+
+        inline void             free_addr(size_type addr, size_type bytes) noexcept
+        {
+            multi_free_addr(1u,&addr,&bytes);
+        }
+
+        //! Links the freed blocks into a chain first, then pushes the whole chain with a single CAS
+        inline void             multi_free_addr(uint32_t count, const size_type* addr, const size_type* bytes) noexcept
+        {
+            uint32_t first = invalid_block;
+            uint32_t last = invalid_block;
+            uint32_t freed = 0u;
+            for (uint32_t i=0u; i<count; i++)
+            {
+                if (addr[i]==invalid_address)
+                    continue;
+                #ifdef _IRR_DEBUG
+                    assert(addr[i]>=Base::combinedOffset && (addr[i]-Base::combinedOffset)%blockSize==0);
+                #endif // _IRR_DEBUG
+                const uint32_t blockID = static_cast<uint32_t>(addressToBlockID(addr[i]));
+                if (last!=invalid_block)
+                    links[last].store(blockID,std::memory_order_relaxed);
+                else
+                    first = blockID;
+                last = blockID;
+                freed++;
+            }
+            if (!freed)
+                return;
+
+            uint64_t oldHead = head.load(std::memory_order_relaxed);
+            do
+            {
+                links[last].store(static_cast<uint32_t>(oldHead),std::memory_order_relaxed);
+            } while (!head.compare_exchange_weak(oldHead,packHead(oldHead,first),std::memory_order_release,std::memory_order_relaxed));
+
+            freeBlockCount.fetch_add(freed,std::memory_order_relaxed);
+        }
+
+        //! Not thread-safe
+        inline void             reset()
+        {
+            // same initial order as PoolAddressAllocator, lowest addresses get handed out first
+            for (size_type i=0u; i<blockCount; i++)
+                links[i].store(i+1u<blockCount ? static_cast<uint32_t>(i+1u):invalid_block,std::memory_order_relaxed);
+            head.store(packHead(head.load(std::memory_order_relaxed),blockCount ? 0u:invalid_block),std::memory_order_release);
+            freeBlockCount.store(static_cast<uint32_t>(blockCount),std::memory_order_relaxed);
+        }
+
+        //! conservative estimate, does not account for space lost to alignment
+        inline size_type        max_size() const noexcept
+        {
+            return blockSize;
+        }
+
+        //! Most allocators do not support e.g. 1-byte allocations
+        inline size_type        min_size() const noexcept
+        {
+            return blockSize;
+        }
+
+        //! Shrinking is not supported, so this always gives the current size
+        inline size_type        safe_shrink_size(size_type sizeBound, size_type newBuffAlignmentWeCanGuarantee=1u) noexcept
+        {
+            return Base::safe_shrink_size(get_total_size()-Base::alignOffset,newBuffAlignmentWeCanGuarantee);
+        }
+
+
+        static inline size_type reserved_size(size_type maxAlignment, size_type bufSz, size_type blockSz) noexcept
+        {
+            size_type maxBlockCount =  bufSz/blockSz;
+            return maxBlockCount*sizeof(link_t);
+        }
+        static inline size_type reserved_size(const LockFreePoolAddressAllocator<_size_type>& other, size_type bufSz) noexcept
+        {
+            return reserved_size(other.maxRequestableAlignment,bufSz,other.blockSize);
+        }
+
+        //! Only a snapshot when other threads are allocating or freeing
+        inline size_type        get_free_size() const noexcept
+        {
+            return freeBlockCount.load(std::memory_order_relaxed)*blockSize;
+        }
+        //! Only a snapshot when other threads are allocating or freeing
+        inline size_type        get_allocated_size() const noexcept
+        {
+            return (blockCount-freeBlockCount.load(std::memory_order_relaxed))*blockSize;
+        }
+        inline size_type        get_total_size() const noexcept
+        {
+            return blockCount*blockSize+Base::alignOffset;
+        }
+
+
+
+        inline size_type addressToBlockID(size_type addr) const noexcept
+        {
+            return (addr-Base::combinedOffset)/blockSize;
+        }
+    protected:
+        inline bool             isValidRequest(size_type bytes, size_type alignment) const noexcept
+        {
+            return (blockSize%alignment)==0u && bytes!=0u && bytes<=blockSize;
+        }
+
+        size_type               blockCount;
+        size_type               blockSize;
+        link_t*                 links;
+        //! lower 32 bits are the block ID of the top of the stack, upper 32 bits are the ABA tag
+        std::atomic<uint64_t>   head;
+        std::atomic<uint32_t>   freeBlockCount;
+};
+
+
+}
+}
+
+#endif // __IRR_LOCK_FREE_POOL_ADDRESS_ALLOCATOR_H_INCLUDED__
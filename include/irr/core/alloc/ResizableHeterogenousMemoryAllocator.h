@@ -4,6 +4,7 @@
 #include "irr/static_if.h"
 
 #include "irr/core/alloc/HeterogenousMemoryAddressAllocatorAdaptor.h"
+#include "irr/core/memory/CMemoryTracker.h"
 
 #include "irr/core/alloc/PoolAddressAllocator.h"
 
@@ -112,6 +113,7 @@ class ResizableHeterogenousMemoryAllocator : public impl::ResizableHeterogenousM
             size_type oldReservedSize = Base::mReservedSize;
             const void* oldReserved = alloc_traits::getReservedSpacePtr(mAddrAlloc);
 
+            IRR_MEMORY_TAG_SCOPE(core::EMT_ADDRESS_ALLOCATOR);
             Base::mReservedSize = alloc_traits::reserved_size(mAddrAlloc,newSize);
             void* newReserved = Base::mReservedAlloc.allocate(Base::mReservedSize,_IRR_SIMD_ALIGNMENT);
 
@@ -148,6 +150,7 @@ class ResizableHeterogenousMemoryAllocator : public impl::ResizableHeterogenousM
             size_type oldReservedSize = Base::mReservedSize;
             const void* oldReserved = alloc_traits::getReservedSpacePtr(mAddrAlloc);
 
+            IRR_MEMORY_TAG_SCOPE(core::EMT_ADDRESS_ALLOCATOR);
             Base::mReservedSize = alloc_traits::reserved_size(mAddrAlloc,newSize);
             void* newReserved = Base::mReservedAlloc.allocate(Base::mReservedSize,_IRR_SIMD_ALIGNMENT);
 
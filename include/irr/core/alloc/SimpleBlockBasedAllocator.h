@@ -11,6 +11,7 @@
 #include "irr/core/alloc/aligned_allocator.h"
 #include "irr/core/alloc/address_allocator_traits.h"
 #include "irr/core/alloc/AddressAllocatorConcurrencyAdaptors.h"
+#include "irr/core/memory/CMemoryTracker.h"
 
 #include <memory>
 
@@ -188,6 +189,7 @@ class SimpleBlockBasedAllocator
 		}
 		Block* createBlock()
 		{
+			IRR_MEMORY_TAG_SCOPE(core::EMT_ADDRESS_ALLOCATOR);
 			auto retval = reinterpret_cast<Block*>(blockAlloc.allocate(effectiveBlockSize, meta_alignment));
 			constructBlock(retval,typename gens<sizeof...(Args)>::type());
 			return retval;
@@ -0,0 +1,290 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_ARENA_ALLOCATOR_H_INCLUDED__
+#define __IRR_ARENA_ALLOCATOR_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#include <new>
+
+#include "irr/core/Types.h"
+#include "irr/core/alloc/AllocatorTrivialBases.h"
+#include "irr/core/alloc/LinearAddressAllocator.h"
+
+namespace irr
+{
+namespace core
+{
+
+//! Growable bump-pointer arena made out of blocks each managed by a LinearAddressAllocator
+/** Memory is reclaimed all at once by `reset()` or by rewinding to a `SMarker`, an individual free only gives memory back
+if it was the last allocation made (which is what a container freeing its newest buffer or LIFO scratch use look like).
+After a frame which needed more than one block, `reset()` coalesces them into a single block big enough
+for the whole frame (up to `getRetainedSize()` bytes), so in the steady state an arena never touches malloc.
+An arena is not thread-safe, either give every thread its own or use `getThreadArena()`.*/
+class LinearArena
+{
+    public:
+        _IRR_STATIC_INLINE_CONSTEXPR size_t max_alignment = 64u;
+
+        //! Position in the arena which can be rewound to, everything allocated after it gets reclaimed
+        struct SMarker
+        {
+            size_t blockIx;
+            size_t cursor;
+        };
+
+        //! Rewinds the arena back to where it was at construction on destruction, containers using the arena must die first
+        class SScope
+        {
+                LinearArena& arena;
+                const SMarker marker;
+            public:
+                SScope(LinearArena& _arena) : arena(_arena), marker(_arena.getMarker()) {}
+                ~SScope() { arena.rewind(marker); }
+
+                SScope(const SScope&) = delete;
+                SScope& operator=(const SScope&) = delete;
+        };
+
+        LinearArena(size_t _blockSize=0x10000ull, size_t _retainedSize=0x1000000ull) : blockSize(core::roundUp(_blockSize,max_alignment)), retainedSize(_retainedSize), currentBlock(0u) {}
+        ~LinearArena()
+        {
+            for (auto block : blocks)
+                freeBlock(block);
+        }
+
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        //! Arena private to the calling thread, meant for temporaries which do not outlive an `SScope`
+        static inline LinearArena& getThreadArena()
+        {
+            thread_local LinearArena arena;
+            return arena;
+        }
+
+        //! @returns nullptr if `alignment` exceeds `max_alignment` or the system is out of memory
+        inline void* allocate(size_t bytes, size_t alignment) noexcept
+        {
+            if (bytes==0u || alignment>max_alignment)
+                return nullptr;
+
+            for (; currentBlock<blocks.size(); currentBlock++)
+            {
+                auto block = blocks[currentBlock];
+                const size_t addr = block->alloc_addr(bytes,alignment);
+                if (addr!=block_allocator_t::invalid_address)
+                    return getBlockData(block)+addr;
+                // blocks past the current one are leftovers of a rewind, they have to be empty again
+                if (currentBlock+1u<blocks.size())
+                    blocks[currentBlock+1u]->reset();
+            }
+
+            const size_t newBlockSize = std::max<size_t>(core::roundUp(bytes,max_alignment),blocks.size() ? (blocks.back()->get_total_size()*2u):blockSize);
+            if (!addBlock(newBlockSize))
+                return nullptr;
+            currentBlock = blocks.size()-1u;
+            auto block = blocks.back();
+            return getBlockData(block)+block->alloc_addr(bytes,alignment);
+        }
+
+        //! Reclaims the allocation if nothing got allocated after it, otherwise does nothing
+        inline void deallocate(void* ptr, size_t bytes) noexcept
+        {
+            if (!ptr || currentBlock>=blocks.size())
+                return;
+
+            auto block = blocks[currentBlock];
+            const size_t blockData = reinterpret_cast<size_t>(getBlockData(block));
+            const size_t addr = reinterpret_cast<size_t>(ptr);
+            if (addr<blockData || addr-blockData+bytes!=block->get_allocated_size())
+                return;
+
+            const size_t offset = addr-blockData;
+            block->reset();
+            if (offset)
+                block->alloc_addr(offset,1u);
+        }
+
+        inline SMarker getMarker() const noexcept
+        {
+            if (currentBlock<blocks.size())
+                return {currentBlock,blocks[currentBlock]->get_allocated_size()};
+            return {0u,0u};
+        }
+
+        //! Reclaims everything allocated after `marker` was taken, releases whole blocks in excess of `getRetainedSize()`
+        inline void rewind(const SMarker& marker) noexcept
+        {
+            if (blocks.empty())
+                return;
+
+            currentBlock = marker.blockIx;
+            auto block = blocks[currentBlock];
+            // LinearAddressAllocator cannot move its cursor back, so re-bump it from scratch
+            block->reset();
+            if (marker.cursor)
+                block->alloc_addr(marker.cursor,1u);
+
+            while (blocks.size()>currentBlock+1u && get_total_size()>retainedSize)
+            {
+                freeBlock(blocks.back());
+                blocks.pop_back();
+            }
+        }
+
+        //! Reclaims everything, and coalesces all blocks into one if the last use needed more than one
+        inline void reset() noexcept
+        {
+            currentBlock = 0u;
+            if (blocks.size()>1u)
+            {
+                const size_t totalSize = std::min(get_total_size(),std::max(retainedSize,blockSize));
+                for (auto block : blocks)
+                    freeBlock(block);
+                blocks.clear();
+                addBlock(totalSize);
+            }
+            else if (blocks.size())
+                blocks.front()->reset();
+        }
+
+        inline size_t get_allocated_size() const noexcept
+        {
+            size_t retval = 0u;
+            for (size_t i=0u; i<blocks.size() && i<=currentBlock; i++)
+                retval += blocks[i]->get_allocated_size();
+            return retval;
+        }
+        inline size_t get_total_size() const noexcept
+        {
+            size_t retval = 0u;
+            for (const auto block : blocks)
+                retval += block->get_total_size();
+            return retval;
+        }
+        inline size_t getRetainedSize() const noexcept { return retainedSize; }
+
+    protected:
+        typedef LinearAddressAllocator<size_t> block_allocator_t;
+        //! every block starts with its address allocator, followed by the memory it manages
+        _IRR_STATIC_INLINE_CONSTEXPR size_t block_header_size = core::alignUp(sizeof(block_allocator_t),max_alignment);
+
+        static inline uint8_t* getBlockData(block_allocator_t* block) noexcept
+        {
+            return reinterpret_cast<uint8_t*>(block)+block_header_size;
+        }
+
+        inline bool addBlock(size_t size) noexcept
+        {
+            if (blocks.size()==blocks.capacity())
+            {
+                // grow the list up front, so a failure to do so can not leak the block
+                try
+                {
+                    blocks.reserve(blocks.size()*2u+1u);
+                }
+                catch (const std::bad_alloc&)
+                {
+                    return false;
+                }
+            }
+            void* mem = _IRR_ALIGNED_MALLOC(block_header_size+size,max_alignment);
+            if (!mem)
+                return false;
+            blocks.push_back(new (mem) block_allocator_t(reinterpret_cast<uint8_t*>(mem)+block_header_size,0u,0u,max_alignment,size));
+            return true;
+        }
+        static inline void freeBlock(block_allocator_t* block)
+        {
+            block->~block_allocator_t();
+            _IRR_ALIGNED_FREE(block);
+        }
+
+        const size_t blockSize;
+        const size_t retainedSize;
+        size_t currentBlock;
+        core::vector<block_allocator_t*> blocks;
+};
+
+
+//! Standard compliant allocator handing out memory from a LinearArena, see LinearArena::deallocate() for when a deallocation frees anything
+/** Default constructed instances use `LinearArena::getThreadArena()` of the constructing thread.
+Throws std::bad_alloc when the arena can not satisfy a request, including alignments over `LinearArena::max_alignment`.
+Containers using this allocator must be destroyed (or emptied with `shrink_to_fit`) before the arena is reset or rewound past their allocations.*/
+template <class T, size_t overAlign=alignof(T)>
+class IRR_FORCE_EBO arena_allocator : public irr::core::AllocatorTrivialBase<T>
+{
+        template<class U, size_t _align> friend class arena_allocator;
+
+        LinearArena* arena;
+    public:
+        typedef size_t	size_type;
+        typedef T*		pointer;
+
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+        typedef std::false_type is_always_equal;
+
+        template< class U> struct rebind { typedef arena_allocator<U,overAlign> other; };
+
+
+        arena_allocator() : arena(&LinearArena::getThreadArena()) {}
+        explicit arena_allocator(LinearArena* _arena) : arena(_arena) {}
+        template<typename U, size_t _align = overAlign>
+        arena_allocator(const arena_allocator<U,_align>& other) : arena(other.arena) {}
+
+
+        inline typename arena_allocator::pointer    allocate(   size_type n, size_type alignment,
+                                                                const void* hint=nullptr)
+        {
+            void* retval = arena->allocate(n*sizeof(T),alignment);
+            if (!retval && n)
+                throw std::bad_alloc();
+            return reinterpret_cast<typename arena_allocator::pointer>(retval);
+        }
+        inline typename arena_allocator::pointer    allocate(   size_type n, const void* hint=nullptr)
+        {
+            return allocate(n,overAlign>alignof(T) ? overAlign:alignof(T),hint);
+        }
+
+        //! Without the size nothing can be reclaimed
+        inline void                                 deallocate( typename arena_allocator::pointer p) noexcept {}
+        inline void                                 deallocate( typename arena_allocator::pointer p, size_type n) noexcept
+        {
+            arena->deallocate(p,n*sizeof(T));
+        }
+
+        inline LinearArena*                         getArena() const noexcept { return arena; }
+
+        template<typename U, size_t _align>
+        inline bool                                 operator!=(const arena_allocator<U,_align>& other) const noexcept
+        {
+            return arena!=other.arena;
+        }
+        template<typename U, size_t _align>
+        inline bool                                 operator==(const arena_allocator<U,_align>& other) const noexcept
+        {
+            return arena==other.arena;
+        }
+};
+
+
+// arena-scoped container aliases
+template<typename T>
+using arena_vector = vector<T,arena_allocator<T> >;
+
+template<typename K,typename T, class Hash=std::hash<K>, class KeyEqual=std::equal_to<K> >
+using arena_unordered_map = unordered_map<K,T,Hash,KeyEqual,arena_allocator<std::pair<const K,T> > >;
+
+template<typename K, class Hash=std::hash<K>, class KeyEqual=std::equal_to<K> >
+using arena_unordered_set = unordered_set<K,Hash,KeyEqual,arena_allocator<K> >;
+
+} // end namespace core
+} // end namespace irr
+
+#endif
@@ -11,17 +11,20 @@
 // allocator
 #include "irr/core/alloc/AddressAllocatorBase.h"
 #include "irr/core/alloc/AddressAllocatorConcurrencyAdaptors.h"
+#include "irr/core/alloc/AddressAllocatorThreadCachingAdaptor.h"
 #include "irr/core/alloc/address_allocator_traits.h"
 #include "irr/core/alloc/AlignedBase.h"
 #include "irr/core/alloc/aligned_allocator.h"
 #include "irr/core/alloc/aligned_allocator_adaptor.h"
 #include "irr/core/alloc/AllocatorTrivialBases.h"
+#include "irr/core/alloc/arena_allocator.h"
 #include "irr/core/alloc/ContiguousPoolAddressAllocator.h"
 #include "irr/core/alloc/GeneralpurposeAddressAllocator.h"
 #include "irr/core/alloc/HeterogenousMemoryAddressAllocatorAdaptor.h"
 #include "irr/core/alloc/IAddressAllocator.h"
 #include "irr/core/alloc/IAllocator.h"
 #include "irr/core/alloc/LinearAddressAllocator.h"
+#include "irr/core/alloc/LockFreePoolAddressAllocator.h"
 #include "irr/core/alloc/MultiBufferingAllocatorBase.h"
 #include "irr/core/alloc/null_allocator.h"
 #include "irr/core/alloc/PoolAddressAllocator.h"
@@ -40,12 +43,16 @@
 #include "irr/core/memory/dynamic_array.h"
 #include "irr/core/memory/refctd_dynamic_array.h"
 #include "irr/core/memory/CLeakDebugger.h"
+#include "irr/core/memory/CMemoryTracker.h"
 // samplers
 #include "irr/core/sampling/RandomSampler.h"
 #include "irr/core/sampling/SobolSampler.h"
 #include "irr/core/sampling/OwenSampler.h"
 // parallel
 #include "irr/core/parallel/IThreadBound.h"
+#include "irr/core/parallel/CThreadPool.h"
+#include "irr/core/parallel/parallel_for.h"
+#include "irr/core/parallel/radix_sort.h"
 #include "irr/core/parallel/unlock_guard.h"
 // string
 #include "irr/core/string/stringutil.h"
@@ -0,0 +1,133 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_MEMORY_TRACKER_H_INCLUDED__
+#define __IRR_C_MEMORY_TRACKER_H_INCLUDED__
+
+#include "irr/core/memory/memory.h"
+
+#include <cstdint>
+
+namespace irr
+{
+namespace core
+{
+
+//! Subsystems allocations get counted towards
+enum E_MEMORY_TAG : uint32_t
+{
+	//! anything allocated outside of a tagged scope
+	EMT_UNTAGGED = 0u,
+	//! the asset cache's own bookkeeping, the assets themselves count towards what they were loaded as
+	EMT_ASSET_CACHE,
+	//! whatever asset loaders allocate which is not a buffer or an image
+	EMT_ASSET_LOADER,
+	//! contents of ICPUBuffers, so vertex and index data of mesh buffers
+	EMT_CPU_BUFFER,
+	//! pixels of CPU side images (CImageData) waiting for or kept after texture upload
+	EMT_IMAGE,
+	//! scene nodes, animators and the render lists
+	EMT_SCENE,
+	//! reserved space and blocks of the address allocators
+	EMT_ADDRESS_ALLOCATOR,
+	//! free for the application to use
+	EMT_USER_0,
+	EMT_USER_1,
+	EMT_USER_2,
+	EMT_USER_3,
+	EMT_COUNT
+};
+
+//! Counts the live bytes, peak and number of allocations of every E_MEMORY_TAG
+/** Needs the engine to be built with IRR_MEMORY_TRACKING (_IRR_MEMORY_TRACKING_), which makes _IRR_ALIGNED_MALLOC and _IRR_ALIGNED_FREE
+count every allocation, and with them every core::allocator, IReferenceCounted object and anything else using them.
+Without it the macros below compile to nothing and every snapshot is all zeros.
+
+An allocation counts towards the tag of the innermost IRR_MEMORY_TAG_SCOPE() on the allocating thread when it was made,
+and gets taken off that same tag whichever thread frees it, so tagging the entry points of a subsystem is enough.
+Tracking an allocation costs a lock out of 64 picked by address and a hash map insertion, so it is meant for finding out where memory goes,
+cache budgets and hunting leaks or fragmentation (a live allocation count growing without the live bytes doing so) rather than for shipping builds.
+
+Memory allocated with _IRR_ALIGNED_MALLOC and freed some other way never leaves its tag.*/
+class CMemoryTracker
+{
+	public:
+		struct STagStatistics
+		{
+			//! bytes requested by the allocations which were not freed yet
+			size_t liveBytes;
+			//! most live bytes there were at any point since the start or resetPeaks()
+			size_t peakBytes;
+			size_t liveAllocations;
+			//! totals since the start
+			uint64_t allocationCount;
+			uint64_t allocatedBytes;
+			uint64_t freeCount;
+		};
+		struct SSnapshot
+		{
+			//! nanoseconds of a steady clock
+			uint64_t time;
+			STagStatistics tags[EMT_COUNT];
+		};
+
+		struct STagDifference
+		{
+			int64_t liveBytes;
+			int64_t liveAllocations;
+			uint64_t allocationCount;
+			uint64_t allocatedBytes;
+			uint64_t freeCount;
+			//! allocationCount and allocatedBytes divided by the time between the snapshots
+			double allocationsPerSecond;
+			double bytesPerSecond;
+		};
+		struct SDifference
+		{
+			//! nanoseconds between the snapshots
+			uint64_t duration;
+			STagDifference tags[EMT_COUNT];
+		};
+
+		//! Makes allocations on the calling thread count towards `_tag` until it gets destroyed
+		class SScopedTag
+		{
+			public:
+				inline SScopedTag(E_MEMORY_TAG _tag) : m_previous(setCurrentTag(_tag)) {}
+				inline ~SScopedTag() { setCurrentTag(m_previous); }
+
+				SScopedTag(const SScopedTag&) = delete;
+				SScopedTag& operator=(const SScopedTag&) = delete;
+
+			private:
+				const E_MEMORY_TAG m_previous;
+		};
+
+		//! @returns The tag which was current before
+		static E_MEMORY_TAG setCurrentTag(E_MEMORY_TAG _tag);
+		static E_MEMORY_TAG getCurrentTag();
+
+		static const char* getTagName(E_MEMORY_TAG _tag);
+
+		static SSnapshot getSnapshot();
+		//! What changed from `_earlier` to `_later`, both from getSnapshot()
+		static SDifference diff(const SSnapshot& _earlier, const SSnapshot& _later);
+
+		//! Makes the peaks start over from the current live bytes
+		static void resetPeaks();
+};
+
+} // end namespace core
+} // end namespace irr
+
+#ifdef _IRR_MEMORY_TRACKING_
+	#define _IRR_MEMORY_TAG_SCOPE_VARIABLE(LINE) irrMemoryTagScope ## LINE
+	#define _IRR_MEMORY_TAG_SCOPE_IMPL(TAG,LINE) irr::core::CMemoryTracker::SScopedTag _IRR_MEMORY_TAG_SCOPE_VARIABLE(LINE)(TAG)
+	//! Makes the allocations in the rest of the enclosing scope count towards `TAG`, see irr::core::CMemoryTracker
+	#define IRR_MEMORY_TAG_SCOPE(TAG) _IRR_MEMORY_TAG_SCOPE_IMPL(TAG,__LINE__)
+#else
+	#define IRR_MEMORY_TAG_SCOPE(TAG)
+#endif
+
+#endif
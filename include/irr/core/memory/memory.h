@@ -36,8 +36,8 @@
 
 //! You can swap these out for whatever you like, jemalloc, tcmalloc etc. but make them noexcept
 #ifdef _IRR_PLATFORM_WINDOWS_
-    #define _IRR_ALIGNED_MALLOC(size,alignment)     ::_aligned_malloc(size,alignment)
-    #define _IRR_ALIGNED_FREE(addr)                 ::_aligned_free(addr)
+    #define _IRR_UNTRACKED_ALIGNED_MALLOC(size,alignment)   ::_aligned_malloc(size,alignment)
+    #define _IRR_UNTRACKED_ALIGNED_FREE(addr)               ::_aligned_free(addr)
 #else
 
 namespace irr
@@ -53,8 +53,25 @@ namespace impl
     }
 }
 }
-    #define _IRR_ALIGNED_MALLOC(size,alignment)     irr::impl::aligned_malloc(size,alignment)
-    #define _IRR_ALIGNED_FREE(addr)                 ::free(addr)
+    #define _IRR_UNTRACKED_ALIGNED_MALLOC(size,alignment)   irr::impl::aligned_malloc(size,alignment)
+    #define _IRR_UNTRACKED_ALIGNED_FREE(addr)               ::free(addr)
+#endif
+
+//! With IRR_MEMORY_TRACKING every allocation gets counted towards the memory tag of the thread, see irr::core::CMemoryTracker
+#ifdef _IRR_MEMORY_TRACKING_
+namespace irr
+{
+namespace core
+{
+    void* tracked_aligned_malloc(size_t size, size_t alignment) noexcept;
+    void tracked_aligned_free(void* addr) noexcept;
+}
+}
+    #define _IRR_ALIGNED_MALLOC(size,alignment)     irr::core::tracked_aligned_malloc(size,alignment)
+    #define _IRR_ALIGNED_FREE(addr)                 irr::core::tracked_aligned_free(addr)
+#else
+    #define _IRR_ALIGNED_MALLOC(size,alignment)     _IRR_UNTRACKED_ALIGNED_MALLOC(size,alignment)
+    #define _IRR_ALIGNED_FREE(addr)                 _IRR_UNTRACKED_ALIGNED_FREE(addr)
 #endif
 
 
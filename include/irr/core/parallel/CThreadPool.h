@@ -0,0 +1,82 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_THREAD_POOL_H_INCLUDED__
+#define __IRR_C_THREAD_POOL_H_INCLUDED__
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "irr/core/Types.h"
+
+namespace irr
+{
+namespace core
+{
+
+//! Number of threads to use when the caller did not specify any (passed 0)
+inline uint32_t getDefaultThreadCount()
+{
+	const uint32_t hw = std::thread::hardware_concurrency();
+	return hw ? hw:1u;
+}
+
+//! Fixed set of worker threads kept alive between jobs, so fork-join work done every frame does not pay for creating threads
+/** A job is a function the calling thread and up to a requested number of workers call at once, each with its own index.
+Workers which are busy or asleep when the calling thread is done with its own call simply never join the job, so the job
+has to be written such that any subset of the calls gets all of it done, pulling work items off a shared atomic counter
+like parallel_for_chunked() does is the usual way. In exchange jobs can be run from any thread, concurrently, and from inside
+other jobs without ever deadlocking.*/
+class CThreadPool
+{
+	public:
+		//! Creates `_workerCount` threads right away
+		explicit CThreadPool(uint32_t _workerCount);
+		//! Joins the workers, no job may be running
+		~CThreadPool();
+
+		CThreadPool(const CThreadPool&) = delete;
+		CThreadPool& operator=(const CThreadPool&) = delete;
+
+		inline uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+		//! Pool with getDefaultThreadCount()-1 workers used by parallel_for_chunked(), created on first use and never destroyed
+		static CThreadPool& getGlobal();
+
+		//! Calls `_func(_context,0)` on the calling thread and `_func(_context,i)` with distinct `i` in [1,_helperCount] on the workers that get to it
+		/** Returns once the call on the calling thread and the calls which started on workers have all returned.
+		If any of the calls threw, the first exception caught gets rethrown from here after that, the rest are dropped.
+		@param _helperCount gets clamped to getWorkerCount().*/
+		void run(uint32_t _helperCount, void (*_func)(void*,uint32_t), void* _context);
+
+	private:
+		struct SJob
+		{
+			void (*func)(void*,uint32_t);
+			void* context;
+			uint32_t helperCount;
+			//! workers which took the job, guarded by `m_mutex` like the rest
+			uint32_t joined;
+			uint32_t finished;
+			//! first exception thrown by any of the calls
+			std::exception_ptr exception;
+		};
+
+		void workerLoop();
+
+		std::mutex m_mutex;
+		std::condition_variable m_jobAvailable;
+		std::condition_variable m_jobFinished;
+		//! jobs which still want more workers, oldest first
+		core::deque<SJob*> m_jobs;
+		bool m_exit;
+		core::vector<std::thread> m_workers;
+};
+
+} // end namespace core
+} // end namespace irr
+
+#endif
@@ -0,0 +1,77 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_PARALLEL_FOR_H_INCLUDED__
+#define __IRR_PARALLEL_FOR_H_INCLUDED__
+
+#include <atomic>
+#include <algorithm>
+
+#include "irr/core/Types.h"
+#include "irr/core/parallel/CThreadPool.h"
+
+namespace irr
+{
+namespace core
+{
+
+//! Runs `_func(chunkBegin,chunkEnd,threadIx)` over [_begin,_end) split into chunks of at most `_grainSize` elements.
+/** Chunks are handed out dynamically from an atomic counter so uneven work balances itself.
+The calling thread takes part in the work and gets `threadIx==0`, the rest is done by the workers of CThreadPool::getGlobal()
+which are free at the time, and the call returns once every chunk is done, so it is synchronous.
+No threads get created, so this is cheap enough to call several times a frame, and it can be nested or called from many threads at once.
+`threadIx` is always less than the returned count, which lets callers keep per-thread scratch storage without any locking.
+An exception thrown by `_func` on any thread gets rethrown from here once the other threads stopped, chunks nobody took by then never run.
+@param _threadCount 0 means getDefaultThreadCount(), it is also capped at the global pool's worker count plus one.
+@returns Upper bound of `threadIx` plus one, not every one of those threads necessarily got any chunks. */
+template<typename Func>
+inline uint32_t parallel_for_chunked(size_t _begin, size_t _end, size_t _grainSize, Func&& _func, uint32_t _threadCount=0u)
+{
+    if (_end<=_begin)
+        return 0u;
+
+    _grainSize = std::max<size_t>(_grainSize,1ull);
+    const size_t chunkCount = (_end-_begin+_grainSize-1ull)/_grainSize;
+    CThreadPool& pool = CThreadPool::getGlobal();
+    if (!_threadCount)
+        _threadCount = getDefaultThreadCount();
+    _threadCount = static_cast<uint32_t>(std::min<size_t>(std::min(_threadCount,pool.getWorkerCount()+1u),chunkCount));
+
+    if (_threadCount<=1u)
+    {
+        _func(_begin,_end,0u);
+        return 1u;
+    }
+
+    std::atomic<size_t> nextChunk(0ull);
+    auto work = [&](uint32_t threadIx) -> void
+    {
+        for (size_t chunk=nextChunk++; chunk<chunkCount; chunk=nextChunk++)
+        {
+            const size_t chunkBegin = _begin+chunk*_grainSize;
+            _func(chunkBegin,std::min(chunkBegin+_grainSize,_end),threadIx);
+        }
+    };
+
+    using work_t = decltype(work);
+    pool.run(_threadCount-1u,[](void* _work, uint32_t _threadIx) -> void {(*static_cast<work_t*>(_work))(_threadIx);},&work);
+
+    return _threadCount;
+}
+
+//! Convenience wrapper over parallel_for_chunked() calling `_func(i)` for every index
+template<typename Func>
+inline uint32_t parallel_for(size_t _begin, size_t _end, Func&& _func, uint32_t _threadCount=0u, size_t _grainSize=1ull)
+{
+    return parallel_for_chunked(_begin,_end,_grainSize,[&_func](size_t chunkBegin, size_t chunkEnd, uint32_t) -> void
+        {
+            for (size_t i=chunkBegin; i<chunkEnd; i++)
+                _func(i);
+        },_threadCount);
+}
+
+} // end namespace core
+} // end namespace irr
+
+#endif
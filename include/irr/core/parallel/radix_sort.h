@@ -0,0 +1,97 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_RADIX_SORT_H_INCLUDED__
+#define __IRR_RADIX_SORT_H_INCLUDED__
+
+#include <algorithm>
+#include <iterator>
+
+#include "irr/core/Types.h"
+#include "irr/core/parallel/parallel_for.h"
+
+namespace irr
+{
+namespace core
+{
+
+//! Stable LSD radix sort of `_count` elements by the 64 bit key `_getKey(element)`, 8 bits at a time
+/** Bytes which are the same in every key get no pass at all, so keys only using a few of their bits cost only as many passes.
+Elements go back and forth between `_data` and `_scratch`, which needs room for `_count` of them, and end up sorted in `_data`.
+Lists of at least `_parallelThreshold` elements are split into one chunk per thread, every chunk gets its own histogram
+and scatters its elements to its own offsets, which keeps the sort stable.
+@param _threadCount 0 means getDefaultThreadCount(). */
+template<typename T, typename KeyFunc>
+inline void radix_sort(T* _data, T* _scratch, size_t _count, KeyFunc&& _getKey, uint32_t _threadCount=0u, size_t _parallelThreshold=0x10000ull)
+{
+    if (_count<2ull)
+        return;
+
+    constexpr uint32_t DigitBits = 8u;
+    constexpr uint32_t BucketCount = 0x1u<<DigitBits;
+    constexpr uint64_t DigitMask = BucketCount-1u;
+
+    // bits in which any two keys differ
+    const uint64_t firstKey = _getKey(_data[0]);
+    uint64_t differing = 0ull;
+    for (size_t i=1ull; i<_count; i++)
+        differing |= _getKey(_data[i])^firstKey;
+    if (!differing)
+        return;
+
+    if (_count<_parallelThreshold)
+        _threadCount = 1u;
+    else if (!_threadCount)
+        _threadCount = getDefaultThreadCount();
+    const size_t chunkSize = (_count+_threadCount-1ull)/_threadCount;
+    const size_t chunkCount = (_count+chunkSize-1ull)/chunkSize;
+    core::vector<size_t> offsets(chunkCount*BucketCount);
+
+    T* src = _data;
+    T* dst = _scratch;
+    for (uint32_t shift=0u; shift<64u; shift+=DigitBits)
+    {
+        if (!((differing>>shift)&DigitMask))
+            continue;
+
+        // parallel_for_chunked() calls back with one range of all the chunks when it finds no free workers, so chunks are iterated here
+        parallel_for(0ull,chunkCount,[&](size_t chunk) -> void
+        {
+            size_t* histogram = offsets.data()+chunk*BucketCount;
+            std::fill_n(histogram,BucketCount,0ull);
+            const size_t chunkEnd = std::min(chunk*chunkSize+chunkSize,_count);
+            for (size_t i=chunk*chunkSize; i<chunkEnd; i++)
+                histogram[(_getKey(src[i])>>shift)&DigitMask]++;
+        },_threadCount);
+
+        // bucket major, so the elements of an earlier chunk land before the ones of a later chunk with the same digit
+        size_t sum = 0ull;
+        for (uint32_t bucket=0u; bucket<BucketCount; bucket++)
+        for (size_t chunk=0ull; chunk<chunkCount; chunk++)
+        {
+            size_t& offset = offsets[chunk*BucketCount+bucket];
+            const size_t count = offset;
+            offset = sum;
+            sum += count;
+        }
+
+        parallel_for(0ull,chunkCount,[&](size_t chunk) -> void
+        {
+            size_t* offset = offsets.data()+chunk*BucketCount;
+            const size_t chunkEnd = std::min(chunk*chunkSize+chunkSize,_count);
+            for (size_t i=chunk*chunkSize; i<chunkEnd; i++)
+                dst[offset[(_getKey(src[i])>>shift)&DigitMask]++] = std::move(src[i]);
+        },_threadCount);
+
+        std::swap(src,dst);
+    }
+
+    if (src!=_data)
+        std::move(src,src+_count,_data);
+}
+
+} // end namespace core
+} // end namespace irr
+
+#endif
@@ -0,0 +1,287 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_DYNAMIC_AABB_TREE_H_INCLUDED__
+#define __IRR_C_DYNAMIC_AABB_TREE_H_INCLUDED__
+
+#include "irr/core/core.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Bounding volume hierarchy of axis aligned boxes which can be changed one box at a time
+/** Every box (proxy) is a leaf, stored enlarged by a margin so a box moving a little stays inside it and the tree does not change.
+A box leaving its enlarged box is removed and inserted again, next to the subtree whose bounds grow the least,
+and the tree is kept balanced by rotations on the way back up, so queries visit O(log N) inner nodes plus the leaves they report.
+
+Queries walk the tree from the root and skip every subtree whose bounds miss the query, they call `_func` for every proxy found
+and stop as soon as it returns false. Proxies are reported by their enlarged boxes, so the caller needs to test the exact bounds when it matters.
+The query methods are const and can run on any number of threads at once, changing the tree is not thread safe.*/
+class CDynamicAABBTree
+{
+	public:
+		typedef uint32_t proxy_t;
+		_IRR_STATIC_INLINE_CONSTEXPR proxy_t invalid_proxy = 0xffffffffu;
+
+		//! @param _margin How much the stored boxes get enlarged on every side
+		CDynamicAABBTree(float _margin=0.1f) : m_margin(_margin) {}
+
+		//! Adds a box, `_userData` is not used by the tree
+		proxy_t createProxy(const core::aabbox3df& _box, void* _userData=nullptr);
+
+		void destroyProxy(proxy_t _proxy);
+
+		//! @returns true if the tree changed, when `_box` is not inside the enlarged box of the proxy anymore
+		bool moveProxy(proxy_t _proxy, const core::aabbox3df& _box);
+
+		inline void* getUserData(proxy_t _proxy) const { return m_nodes[_proxy].userData; }
+		//! The box the proxy is stored with, the one it was created or last reinserted with enlarged by the margin
+		inline const core::aabbox3df& getFatBox(proxy_t _proxy) const { return m_nodes[_proxy].box; }
+
+		inline size_t getProxyCount() const { return m_proxyCount; }
+		//! Longest path from the root to a leaf, 0 for an empty tree or a single proxy
+		inline uint32_t getHeight() const { return m_root!=invalid_proxy ? m_nodes[m_root].height:0u; }
+
+		//! Removes all proxies
+		void clear();
+
+		//! Calls `_func(proxy)` for every proxy with a box not fully behind any of the frustum's planes
+		/** Subtrees fully in front of a plane skip testing against it, whole subtrees inside the frustum get reported without any tests.*/
+		template<typename Func>
+		inline void queryFrustum(const SViewFrustum& _frustum, Func&& _func) const
+		{
+			if (m_root==invalid_proxy)
+				return;
+
+			const float* planes[SViewFrustum::VF_PLANE_COUNT];
+			for (uint32_t i=0u; i<SViewFrustum::VF_PLANE_COUNT; i++)
+				planes[i] = reinterpret_cast<const float*>(_frustum.planes+i);
+			constexpr uint32_t allPlanes = (0x1u<<SViewFrustum::VF_PLANE_COUNT)-1u;
+
+			// bits of the planes the node's parent was not fully in front of
+			SStackEntry stack[MaxStackSize];
+			uint32_t stackSize = 0u;
+			stack[stackSize++] = {m_root,allPlanes};
+			while (stackSize)
+			{
+				const SStackEntry entry = stack[--stackSize];
+				const SNode& node = m_nodes[entry.node];
+
+				uint32_t planeMask = entry.planeMask;
+				bool culled = false;
+				for (uint32_t i=0u; i<SViewFrustum::VF_PLANE_COUNT && !culled; i++)
+				{
+					if (!(planeMask&(0x1u<<i)))
+						continue;
+					// distances of the box corners furthest along and against the normal
+					float furthest = planes[i][3], nearest = planes[i][3];
+					for (uint32_t j=0u; j<3u; j++)
+					{
+						const float a = planes[i][j]*(&node.box.MinEdge.X)[j];
+						const float b = planes[i][j]*(&node.box.MaxEdge.X)[j];
+						furthest += std::max(a,b);
+						nearest += std::min(a,b);
+					}
+					culled = furthest<0.f;
+					if (nearest>=0.f)
+						planeMask &= ~(0x1u<<i);
+				}
+				if (culled)
+					continue;
+
+				if (node.isLeaf())
+				{
+					if (!_func(entry.node))
+						return;
+				}
+				else if (!planeMask)
+				{
+					if (!reportSubtree(entry.node,_func))
+						return;
+				}
+				else
+				{
+					_IRR_DEBUG_BREAK_IF(stackSize+2u>MaxStackSize);
+					stack[stackSize++] = {node.children[0],planeMask};
+					stack[stackSize++] = {node.children[1],planeMask};
+				}
+			}
+		}
+
+		//! Calls `_func(proxy)` for every proxy with a box overlapping `_box`
+		template<typename Func>
+		inline void queryBox(const core::aabbox3df& _box, Func&& _func) const
+		{
+			query([&_box](const core::aabbox3df& _nodeBox) -> bool { return _nodeBox.intersectsWithBox(_box); },_func);
+		}
+
+		//! Calls `_func(proxy)` for every proxy with a box overlapping the sphere
+		template<typename Func>
+		inline void querySphere(const core::vector3df& _center, float _radius, Func&& _func) const
+		{
+			const float radiusSQ = _radius*_radius;
+			query([&_center,radiusSQ](const core::aabbox3df& _nodeBox) -> bool
+			{
+				float distanceSQ = 0.f;
+				for (uint32_t j=0u; j<3u; j++)
+				{
+					const float c = (&_center.X)[j];
+					const float d = std::max(std::max((&_nodeBox.MinEdge.X)[j]-c,c-(&_nodeBox.MaxEdge.X)[j]),0.f);
+					distanceSQ += d*d;
+				}
+				return distanceSQ<=radiusSQ;
+			},_func);
+		}
+
+		//! Calls `_func(proxy,maxT)` for every proxy with a box the ray `_origin+t*_direction` hits with 0<=t<=maxT
+		/** `_func` returns the new maxT, so returning the distance to the hit it found clips the ray and makes the query skip everything further away,
+		returning maxT leaves the ray as it was and returning a negative value stops the query.*/
+		template<typename Func>
+		inline void queryRay(const core::vector3df& _origin, const core::vector3df& _direction, float _maxT, Func&& _func) const
+		{
+			if (m_root==invalid_proxy)
+				return;
+
+			const float invDirection[3] = {1.f/_direction.X,1.f/_direction.Y,1.f/_direction.Z};
+			auto hits = [&](const core::aabbox3df& _nodeBox) -> bool
+			{
+				float tMin = 0.f, tMax = _maxT;
+				for (uint32_t j=0u; j<3u; j++)
+				{
+					const float t0 = ((&_nodeBox.MinEdge.X)[j]-(&_origin.X)[j])*invDirection[j];
+					const float t1 = ((&_nodeBox.MaxEdge.X)[j]-(&_origin.X)[j])*invDirection[j];
+					// written so a NaN (ray parallel to and on a slab's plane) keeps the previous bounds
+					tMin = std::min(t0,t1)>tMin ? std::min(t0,t1):tMin;
+					tMax = std::max(t0,t1)<tMax ? std::max(t0,t1):tMax;
+				}
+				return tMin<=tMax;
+			};
+
+			uint32_t stack[MaxStackSize];
+			uint32_t stackSize = 0u;
+			stack[stackSize++] = m_root;
+			while (stackSize)
+			{
+				const uint32_t index = stack[--stackSize];
+				const SNode& node = m_nodes[index];
+				if (!hits(node.box))
+					continue;
+
+				if (node.isLeaf())
+				{
+					_maxT = _func(static_cast<proxy_t>(index),_maxT);
+					if (_maxT<0.f)
+						return;
+				}
+				else
+				{
+					_IRR_DEBUG_BREAK_IF(stackSize+2u>MaxStackSize);
+					stack[stackSize++] = node.children[0];
+					stack[stackSize++] = node.children[1];
+				}
+			}
+		}
+
+	protected:
+		//! Enough for any tree which fits in memory, the height of a balanced tree grows with log2 of the proxy count
+		_IRR_STATIC_INLINE_CONSTEXPR uint32_t MaxStackSize = 128u;
+
+		struct SNode
+		{
+			//! enlarged box of a leaf, bounds of the children of an inner node
+			core::aabbox3df box;
+			void* userData;
+			//! next free node for nodes in the free list
+			uint32_t parent;
+			//! both invalid_proxy for leaves
+			uint32_t children[2];
+			//! 0 for leaves, invalid_proxy for free nodes
+			uint32_t height;
+
+			inline bool isLeaf() const { return children[0]==invalid_proxy; }
+		};
+		struct SStackEntry
+		{
+			uint32_t node;
+			uint32_t planeMask;
+		};
+
+		//! Walks the tree, skipping subtrees for which `_overlaps(box)` is false
+		template<typename Overlap, typename Func>
+		inline void query(Overlap&& _overlaps, Func&& _func) const
+		{
+			if (m_root==invalid_proxy)
+				return;
+
+			uint32_t stack[MaxStackSize];
+			uint32_t stackSize = 0u;
+			stack[stackSize++] = m_root;
+			while (stackSize)
+			{
+				const uint32_t index = stack[--stackSize];
+				const SNode& node = m_nodes[index];
+				if (!_overlaps(node.box))
+					continue;
+
+				if (node.isLeaf())
+				{
+					if (!_func(static_cast<proxy_t>(index)))
+						return;
+				}
+				else
+				{
+					_IRR_DEBUG_BREAK_IF(stackSize+2u>MaxStackSize);
+					stack[stackSize++] = node.children[0];
+					stack[stackSize++] = node.children[1];
+				}
+			}
+		}
+
+		//! Reports every leaf below `_index`, false if `_func` stopped the query
+		template<typename Func>
+		inline bool reportSubtree(uint32_t _index, Func&& _func) const
+		{
+			uint32_t stack[MaxStackSize];
+			uint32_t stackSize = 0u;
+			stack[stackSize++] = _index;
+			while (stackSize)
+			{
+				const SNode& node = m_nodes[stack[--stackSize]];
+				if (node.isLeaf())
+				{
+					if (!_func(static_cast<proxy_t>(&node-m_nodes.data())))
+						return false;
+				}
+				else
+				{
+					stack[stackSize++] = node.children[0];
+					stack[stackSize++] = node.children[1];
+				}
+			}
+			return true;
+		}
+
+		uint32_t allocateNode();
+		void freeNode(uint32_t _index);
+		void insertLeaf(uint32_t _leaf);
+		void removeLeaf(uint32_t _leaf);
+		//! Rotates the subtree at `_index` if its children's heights differ by more than 1, @returns the index of the subtree's new root
+		uint32_t balance(uint32_t _index);
+		//! Recomputes the box and height of every node from the parent of `_index` up to the root, balancing them
+		void refitAncestors(uint32_t _index);
+
+		core::vector<SNode> m_nodes;
+		uint32_t m_root = invalid_proxy;
+		uint32_t m_freeList = invalid_proxy;
+		size_t m_proxyCount = 0u;
+		float m_margin;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -0,0 +1,109 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_OCCLUSION_CULLER_H_INCLUDED__
+#define __IRR_C_OCCLUSION_CULLER_H_INCLUDED__
+
+#include "irr/core/core.h"
+
+namespace irr
+{
+namespace asset
+{
+	class ICPUMeshBuffer;
+}
+namespace scene
+{
+
+//! CPU occlusion culling against a low resolution depth buffer of designated occluder meshes
+/** The occluders (simplified, closed stand-ins for walls, buildings and terrain) are rasterized by render() into a small depth buffer,
+split into tiles which get rasterized on the persistent workers of core::CThreadPool::getGlobal() at once, 4 pixels at a time with SIMD. The buffer stores 1/w, which is linear in screen space,
+made conservative for the whole pixel, and the farthest depth of every 8x8 block is kept as a coarse level for isOccluded() to test against first.
+
+Triangles with a vertex behind the near plane or far off screen are skipped instead of being clipped, so an occluder right in front of the camera occludes less,
+never more. A box is only reported as occluded when every pixel its screen rectangle touches has an occluder in front of the box's nearest corner.
+The buffer can be read back with getDepthBuffer() to check or display it, everything runs headless.
+
+render() and the occluder methods are not thread safe, isOccluded() can be called from any number of threads once render() returned.*/
+class COcclusionCuller : public core::IReferenceCounted
+{
+	public:
+		typedef uint32_t occluder_t;
+		_IRR_STATIC_INLINE_CONSTEXPR occluder_t invalid_occluder = 0xffffffffu;
+
+		_IRR_STATIC_INLINE_CONSTEXPR uint32_t TileSize = 32u;
+		_IRR_STATIC_INLINE_CONSTEXPR uint32_t BlockSize = 8u;
+
+		//! @param _width,_height Resolution of the depth buffer, rounded up to a multiple of TileSize
+		//! @param _threadCount Threads render() may use, 0 means core::getDefaultThreadCount(), either way capped at the thread pool's worker count plus one
+		COcclusionCuller(uint32_t _width=256u, uint32_t _height=128u, uint32_t _threadCount=0u);
+
+		//! Copies the triangles of the mesh buffer, which has to be a (indexed or not) EPT_TRIANGLES one
+		/** @returns invalid_occluder if the mesh buffer has no triangles.*/
+		occluder_t addOccluder(const asset::ICPUMeshBuffer* _meshbuffer, const core::matrix3x4SIMD& _worldTransform=core::matrix3x4SIMD());
+		//! Same as the other overload, for positions which are not in a mesh buffer, 3 indices per triangle
+		occluder_t addOccluder(const core::vectorSIMDf* _positions, uint32_t _vertexCount, const uint32_t* _indices, uint32_t _indexCount, const core::matrix3x4SIMD& _worldTransform=core::matrix3x4SIMD());
+		void removeOccluder(occluder_t _occluder);
+
+		inline void setOccluderTransform(occluder_t _occluder, const core::matrix3x4SIMD& _worldTransform) { m_occluders[_occluder].worldTransform = _worldTransform; }
+		inline const core::matrix3x4SIMD& getOccluderTransform(occluder_t _occluder) const { return m_occluders[_occluder].worldTransform; }
+
+		//! Rasterizes all occluders as seen through `_viewProjection` (projection times view, clip space w being the distance in front of the camera)
+		void render(const core::matrix4SIMD& _viewProjection);
+
+		//! Whether the world space box is certainly hidden behind the occluders as of the last render()
+		bool isOccluded(const core::aabbox3df& _box) const;
+
+		inline uint32_t getWidth() const { return m_width; }
+		inline uint32_t getHeight() const { return m_height; }
+		//! Row major, top row first, 1/w of the nearest occluder in every pixel and 0 where there is none
+		inline const float* getDepthBuffer() const { return m_depth.data(); }
+		//! Triangles which ended up in the depth buffer at the last render()
+		inline size_t getRasterizedTriangleCount() const { return m_triangles.size(); }
+
+	protected:
+		virtual ~COcclusionCuller() = default;
+
+		struct SOccluder
+		{
+			core::vector<core::vectorSIMDf> positions;
+			core::vector<uint32_t> indices;
+			core::matrix3x4SIMD worldTransform;
+		};
+		//! Triangle set up for rasterization, edge functions are A*x+B*y+C and positive inside
+		struct STriangle
+		{
+			float edgeA[3], edgeB[3], edgeC[3];
+			//! 1/w plane, already lowered to the smallest value within a pixel
+			float depthA, depthB, depthC;
+			//! pixels the triangle can cover, max exclusive
+			int32_t minX, minY, maxX, maxY;
+		};
+
+		//! Transforms and sets up the triangles of an occluder, appending the visible ones to `_out`
+		void setupTriangles(const SOccluder& _occluder, const float* _clipTransform, core::vector<STriangle>& _out) const;
+		void rasterizeTile(uint32_t _tile);
+
+		uint32_t m_width, m_height;
+		uint32_t m_tilesX, m_tilesY;
+		uint32_t m_threadCount;
+		core::vector<float> m_depth;
+		//! farthest depth in every BlockSize*BlockSize block
+		core::vector<float> m_blockDepth;
+		//! view projection of the last render(), row major
+		float m_viewProjection[16];
+
+		core::vector<SOccluder> m_occluders;
+		core::vector<occluder_t> m_freeOccluders;
+
+		//! scratch of render()
+		core::vector<core::vector<STriangle> > m_threadTriangles;
+		core::vector<STriangle> m_triangles;
+		core::vector<core::vector<uint32_t> > m_tileBins;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
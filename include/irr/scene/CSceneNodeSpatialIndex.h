@@ -0,0 +1,123 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_SCENE_NODE_SPATIAL_INDEX_H_INCLUDED__
+#define __IRR_C_SCENE_NODE_SPATIAL_INDEX_H_INCLUDED__
+
+#include <mutex>
+
+#include "ISceneNode.h"
+#include "irr/scene/CDynamicAABBTree.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Keeps the world space bounding boxes of scene nodes in a CDynamicAABBTree
+/** For frustum culling, overlap and ray queries over large (mostly static) scenes without visiting every node.
+Nodes put themselves on a dirty list when their absolute transformation gets recomputed or they call ISceneNode::markBoundsChanged(),
+update() only moves those, most of which stay inside their enlarged boxes and leave the tree as it was.
+Nodes are reported by the enlarged boxes, test the exact ones when it matters.
+The scene manager culls with the index set with ISceneManager::setSpatialIndex(), see markFrustum().
+Not thread safe, apart from queries and the nodes marking themselves dirty.*/
+class CSceneNodeSpatialIndex : public core::IReferenceCounted
+{
+	public:
+		//! @param _margin How much the boxes get enlarged on every side, larger means fewer tree changes for moving nodes and looser queries
+		CSceneNodeSpatialIndex(float _margin=0.1f) : m_tree(_margin) {}
+
+		//! Grabs the node, @returns false if it was in this or another index already
+		bool addNode(ISceneNode* _node);
+		//! @returns false if the node was not in the index
+		bool removeNode(ISceneNode* _node);
+		void clear();
+
+		//! Reads the box of the node again right away, instead of on the next update()
+		void updateNode(ISceneNode* _node);
+		//! Reads the boxes of the nodes marked dirty since the last time
+		/** Call it once the transformations are up to date, the scene manager does after OnAnimate() when the index is set with
+		ISceneManager::setSpatialIndex(), otherwise after ISceneManager::drawAll() or the OnAnimate() of the nodes.
+		@returns Number of nodes whose boxes were read again.*/
+		uint32_t update();
+
+		//! Marks the nodes with a box not fully outside the frustum, for isInMarkedFrustum()
+		/** @returns Number of nodes marked.*/
+		uint32_t markFrustum(const SViewFrustum& _frustum);
+		//! Whether the node might be in the frustum of the last markFrustum()
+		/** Only false for a node of this index which was outside of it and did not get added or marked dirty since. Thread safe.*/
+		inline bool isInMarkedFrustum(const ISceneNode* _node) const
+		{
+			if (_node->SpatialIndex!=this || _node->SpatialIndexDirty)
+				return true;
+			return m_entries[_node->SpatialIndexEntry].frustumMark==m_frustumMark;
+		}
+
+		inline size_t getNodeCount() const { return m_entries.size(); }
+		inline const CDynamicAABBTree& getTree() const { return m_tree; }
+
+		//! Calls `_func(node)` for every node with a box not fully outside the frustum, it stops the query by returning false
+		template<typename Func>
+		inline void queryFrustum(const SViewFrustum& _frustum, Func&& _func) const
+		{
+			m_tree.queryFrustum(_frustum,[&](CDynamicAABBTree::proxy_t _proxy) -> bool { return _func(getNode(_proxy)); });
+		}
+		//! Calls `_func(node)` for every node with a box overlapping `_box`, it stops the query by returning false
+		template<typename Func>
+		inline void queryBox(const core::aabbox3df& _box, Func&& _func) const
+		{
+			m_tree.queryBox(_box,[&](CDynamicAABBTree::proxy_t _proxy) -> bool { return _func(getNode(_proxy)); });
+		}
+		//! Calls `_func(node)` for every node with a box overlapping the sphere, it stops the query by returning false
+		template<typename Func>
+		inline void querySphere(const core::vector3df& _center, float _radius, Func&& _func) const
+		{
+			m_tree.querySphere(_center,_radius,[&](CDynamicAABBTree::proxy_t _proxy) -> bool { return _func(getNode(_proxy)); });
+		}
+		//! Calls `_func(node,maxT)` for every node with a box the ray hits before maxT, see CDynamicAABBTree::queryRay()
+		template<typename Func>
+		inline void queryRay(const core::vector3df& _origin, const core::vector3df& _direction, float _maxT, Func&& _func) const
+		{
+			m_tree.queryRay(_origin,_direction,_maxT,[&](CDynamicAABBTree::proxy_t _proxy, float _currentMaxT) -> float { return _func(getNode(_proxy),_currentMaxT); });
+		}
+
+		//! Appends the nodes which are truly visible and have a box not fully outside the frustum to `_out`
+		void getVisibleNodes(const SViewFrustum& _frustum, core::vector<ISceneNode*>& _out) const;
+
+	protected:
+		virtual ~CSceneNodeSpatialIndex();
+
+		friend class ISceneNode;
+
+		struct SEntry
+		{
+			ISceneNode* node;
+			CDynamicAABBTree::proxy_t proxy;
+			//! m_frustumMark of the last markFrustum() the node's box was not outside of
+			uint32_t frustumMark;
+		};
+
+		inline ISceneNode* getNode(CDynamicAABBTree::proxy_t _proxy) const
+		{
+			return reinterpret_cast<ISceneNode*>(m_tree.getUserData(_proxy));
+		}
+
+		//! reads the box of the node at `_entry` again
+		void moveEntry(SEntry& _entry);
+
+		//! the user data of every proxy is its node
+		CDynamicAABBTree m_tree;
+		//! every node knows the position of its entry, see ISceneNode::SpatialIndexEntry
+		core::vector<SEntry> m_entries;
+		//! nodes marked dirty since the last update(), they can add themselves from several threads
+		core::vector<ISceneNode*> m_dirtyNodes;
+		std::mutex m_dirtyNodesMutex;
+		//! new entries count as marked by the last markFrustum() until the next one
+		uint32_t m_frustumMark = 0u;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
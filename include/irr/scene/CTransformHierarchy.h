@@ -0,0 +1,136 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_TRANSFORM_HIERARCHY_H_INCLUDED__
+#define __IRR_C_TRANSFORM_HIERARCHY_H_INCLUDED__
+
+#include "irr/core/core.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! Transform hierarchy kept in contiguous arrays, one per depth, instead of in the nodes themselves
+/** An alternative to IDummyTransformationSceneNode::updateAbsolutePosition() for scenes with a very large number of nodes,
+anything which needs a world transform (a scene node, an instance, a bone) holds a node_t handle and reads the result after update().
+
+Every depth level stores the local and world matrices of its nodes and the index of each node's parent in the level above,
+so update() walks the levels top down without chasing pointers, updating the nodes of levels with a few thousand nodes or more in parallel
+(on the core::CThreadPool workers, so no threads get created per level).
+Local transforms which changed are tracked with a bitset and the world transforms recomputed in a level are tracked with another,
+which is what the level below checks to know if its parent moved. Only the changed branches of the hierarchy get recomputed.
+
+Removing nodes and changing parents only marks the layout as stale, the arrays get rebuilt (once) by the next update().
+Handles stay valid across rebuilds, the handle of a removed node is only reused after the next update().
+Not thread safe, apart from update() using extra threads internally.*/
+class CTransformHierarchy : public core::IReferenceCounted
+{
+	public:
+		typedef uint32_t node_t;
+		_IRR_STATIC_INLINE_CONSTEXPR node_t invalid_node = 0xffffffffu;
+
+		//! @param _threadCount Threads update() may use, 0 means core::getDefaultThreadCount() and 1 keeps it on the calling thread
+		CTransformHierarchy(uint32_t _threadCount=0u) : m_threadCount(_threadCount) {}
+
+		//! Adds a node, its world transform is valid after the next update()
+		node_t addNode(node_t _parent=invalid_node, const core::matrix3x4SIMD& _localTransform=core::matrix3x4SIMD());
+
+		//! The children of the node become roots, keeping their local transforms
+		void removeNode(node_t _node);
+
+		//! @returns false if `_parent` is `_node` or one of its descendants, the hierarchy is then left as it was
+		bool setParent(node_t _node, node_t _parent);
+
+		inline node_t getParent(node_t _node) const { return m_slots[_node].parent; }
+
+		inline const core::matrix3x4SIMD& getLocalTransform(node_t _node) const
+		{
+			const auto& slot = m_slots[_node];
+			return m_levels[slot.level].localTransforms[slot.index];
+		}
+		inline void setLocalTransform(node_t _node, const core::matrix3x4SIMD& _localTransform)
+		{
+			const auto& slot = m_slots[_node];
+			auto& level = m_levels[slot.level];
+			level.localTransforms[slot.index] = _localTransform;
+			level.dirty[slot.index>>6u] |= 0x1ull<<(slot.index&63u);
+		}
+
+		//! World transform as of the last update()
+		inline const core::matrix3x4SIMD& getWorldTransform(node_t _node) const
+		{
+			const auto& slot = m_slots[_node];
+			return m_levels[slot.level].worldTransforms[slot.index];
+		}
+		//! Whether the last update() recomputed the world transform of the node (because it or one of its ancestors changed)
+		inline bool wasUpdated(node_t _node) const
+		{
+			const auto& slot = m_slots[_node];
+			return (m_levels[slot.level].updated[slot.index>>6u]>>(slot.index&63u))&0x1ull;
+		}
+
+		//! Recomputes the world transforms of every node whose local transform, or the one of an ancestor, changed since the last call
+		/** @returns Number of world transforms recomputed.*/
+		uint32_t update();
+
+		inline size_t getNodeCount() const { return m_slots.size()-m_freeSlots.size()-m_removedSlots.size(); }
+		//! Number of depth levels, as of the last update()
+		inline uint32_t getDepth() const { return static_cast<uint32_t>(m_levels.size()); }
+
+	protected:
+		virtual ~CTransformHierarchy() = default;
+
+		struct SSlot
+		{
+			node_t parent;
+			//! Where the node is in m_levels, or invalid_node for handles not in use
+			uint32_t level;
+			uint32_t index;
+		};
+		struct SLevel
+		{
+			core::vector<core::matrix3x4SIMD> localTransforms;
+			core::vector<core::matrix3x4SIMD> worldTransforms;
+			//! Index of each node's parent in the level above
+			core::vector<uint32_t> parents;
+			//! invalid_node for entries of removed nodes which are still in the arrays
+			core::vector<node_t> nodes;
+			//! Bitsets, local transforms changed since the last update() and world transforms recomputed by the last update()
+			core::vector<uint64_t> dirty;
+			core::vector<uint64_t> updated;
+
+			inline uint32_t append(node_t _node, uint32_t _parent, const core::matrix3x4SIMD& _localTransform)
+			{
+				const uint32_t index = static_cast<uint32_t>(nodes.size());
+				localTransforms.push_back(_localTransform);
+				worldTransforms.push_back(_localTransform);
+				parents.push_back(_parent);
+				nodes.push_back(_node);
+				if ((index&63u)==0u)
+				{
+					dirty.push_back(0ull);
+					updated.push_back(0ull);
+				}
+				dirty[index>>6u] |= 0x1ull<<(index&63u);
+				return index;
+			}
+		};
+
+		//! Lays the levels out again from the parents in m_slots, grouping the children of a node together
+		void rebuildLevels();
+
+		uint32_t m_threadCount;
+		core::vector<SSlot> m_slots;
+		core::vector<node_t> m_freeSlots;
+		//! Slots of nodes removed since the last update(), their entries are still in m_levels
+		core::vector<node_t> m_removedSlots;
+		core::vector<SLevel> m_levels;
+		bool m_layoutStale = false;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
@@ -5,4 +5,9 @@
 #include "irr/video/video.h"
 #include "irr/ui/ui.h"
 
+#include "irr/scene/CTransformHierarchy.h"
+#include "irr/scene/CDynamicAABBTree.h"
+#include "irr/scene/CSceneNodeSpatialIndex.h"
+#include "irr/scene/COcclusionCuller.h"
+
 #endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_PROFILER_H_INCLUDED__
+#define __IRR_C_PROFILER_H_INCLUDED__
+
+#include <atomic>
+#include <string>
+
+#include "irr/core/core.h"
+
+namespace irr
+{
+namespace io
+{
+	class IWriteFile;
+}
+namespace system
+{
+
+//! Records how long nested zones of CPU work take on every thread, for viewing them as a Chrome trace
+/** Zones are marked with IRR_PROFILE_ZONE("name") at the top of a scope (or IRR_PROFILE_FUNCTION()), which records the time from there
+to the end of the scope. The macros compile to nothing unless the engine is built with IRR_PROFILING, and even then zones only get recorded
+between setEnabled(true) and setEnabled(false), a disabled zone costs a single atomic load.
+
+Every thread records into a buffer of its own, so recording zones takes no locks shared between threads. A thread which exits hands its
+buffer over to the next thread which records a zone, so short lived worker threads end up sharing a handful of rows in the trace.
+Zone names are not copied, they have to be string literals or otherwise outlive the recorded zones.
+
+writeChromeTrace() writes every recorded zone in the Chrome trace event format, which chrome://tracing and https://ui.perfetto.dev open.*/
+class CProfiler
+{
+	public:
+		struct SZone
+		{
+			const char* name;
+			//! nanoseconds since the profiler was first used
+			uint64_t begin;
+			uint64_t end;
+			//! number of zones the zone is nested in
+			uint32_t depth;
+		};
+
+		//! Records the zone from its construction until its destruction, if the profiler was enabled when it got constructed
+		class SScopedZone
+		{
+			public:
+				inline SScopedZone(const char* _name) : m_active(isEnabled())
+				{
+					if (m_active)
+						beginZone(_name);
+				}
+				inline ~SScopedZone()
+				{
+					if (m_active)
+						endZone();
+				}
+
+				SScopedZone(const SScopedZone&) = delete;
+				SScopedZone& operator=(const SScopedZone&) = delete;
+
+			private:
+				const bool m_active;
+		};
+
+		static inline void setEnabled(bool _enabled) { s_enabled.store(_enabled,std::memory_order_relaxed); }
+		static inline bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+		//! Zones have to end on the thread they began on, in the reverse order they began in
+		static void beginZone(const char* _name);
+		static void endZone();
+
+		//! Calls `_func(threadIx,zone)` for every zone which ended, in the order they ended on every thread
+		template<typename Func>
+		static inline void forEachZone(Func&& _func)
+		{
+			forEachZone_impl([](void* _data, uint32_t _threadIx, const SZone& _zone) -> void { (*reinterpret_cast<typename std::remove_reference<Func>::type*>(_data))(_threadIx,_zone); },const_cast<void*>(static_cast<const void*>(&_func)));
+		}
+
+		//! Writes all zones which ended as Chrome trace event JSON
+		/** Can be called while other threads record zones, their zones which have not ended yet are left out.
+		@returns false if writing to the file failed.*/
+		static bool writeChromeTrace(io::IWriteFile* _file);
+		//! Same as the other overload, returning the JSON
+		static std::string getChromeTrace();
+
+		//! Forgets all zones which ended
+		static void clear();
+
+	private:
+		static void forEachZone_impl(void (*_func)(void*,uint32_t,const SZone&), void* _data);
+
+		static std::atomic_bool s_enabled;
+};
+
+} // end namespace system
+} // end namespace irr
+
+#ifdef _IRR_PROFILING_
+	#define _IRR_PROFILE_ZONE_VARIABLE(LINE) irrProfileZone ## LINE
+	#define _IRR_PROFILE_ZONE_IMPL(NAME,LINE) irr::system::CProfiler::SScopedZone _IRR_PROFILE_ZONE_VARIABLE(LINE)(NAME)
+	//! Records the rest of the enclosing scope as a zone named `NAME`, see irr::system::CProfiler
+	#define IRR_PROFILE_ZONE(NAME) _IRR_PROFILE_ZONE_IMPL(NAME,__LINE__)
+	//! Records the rest of the enclosing scope as a zone named after the function it is in
+	#define IRR_PROFILE_FUNCTION() _IRR_PROFILE_ZONE_IMPL(__FUNCTION__,__LINE__)
+#else
+	#define IRR_PROFILE_ZONE(NAME)
+	#define IRR_PROFILE_FUNCTION()
+#endif
+
+#endif
@@ -8,5 +8,6 @@
 #include "irr/system/FuncPtrLoader.h"
 #include "irr/system/DefaultFuncPtrLoader.h"
 #include "irr/system/DynamicFunctionCaller.h"
+#include "irr/system/CProfiler.h"
 
 #endif
\ No newline at end of file
@@ -138,6 +138,7 @@ void CMeshSceneNode::setMesh(core::smart_refctd_ptr<video::IGPUMesh>&& mesh)
 		return;
 	
 	Mesh = mesh;
+	markBoundsChanged();
 }
 
 
@@ -256,6 +256,7 @@ bool CMeshSceneNodeInstanced::addInstances(uint32_t* instanceIDs, const size_t&
         instanceBBoxesCount = newCount;
     }
     needsBBoxRecompute = true;
+    markBoundsChanged();
 
     uint8_t* base_pointer = reinterpret_cast<uint8_t*>(instanceDataAllocator->getBackBufferPointer());
     for (size_t i=0; i<instanceCount; i++)
@@ -317,6 +318,7 @@ void CMeshSceneNodeInstanced::setInstanceTransform(const uint32_t& instanceID, c
     instance3x3TranposeInverse[8] = instanceInverse(2,2);
 
     needsBBoxRecompute = true;
+    markBoundsChanged();
 }
 
 core::matrix3x4SIMD CMeshSceneNodeInstanced::getInstanceTransform(const uint32_t& instanceID)
@@ -334,6 +336,24 @@ core::matrix3x4SIMD CMeshSceneNodeInstanced::getInstanceTransform(const uint32_t
     return retval;
 }
 
+void CMeshSceneNodeInstanced::setInstanceTransformNode(const uint32_t& instanceID, CTransformHierarchy::node_t node)
+{
+    auto found = std::lower_bound(instanceTransformNodes.begin(),instanceTransformNodes.end(),std::make_pair(instanceID,CTransformHierarchy::node_t(0u)));
+    const bool bound = found!=instanceTransformNodes.end() && found->first==instanceID;
+    if (node==CTransformHierarchy::invalid_node || !SceneManager)
+    {
+        if (bound)
+            instanceTransformNodes.erase(found);
+        return;
+    }
+
+    if (bound)
+        found->second = node;
+    else
+        instanceTransformNodes.insert(found,{instanceID,node});
+    setInstanceTransform(instanceID,SceneManager->getTransformHierarchy()->getWorldTransform(node));
+}
+
 void CMeshSceneNodeInstanced::setInstanceVisible(const uint32_t& instanceID, const bool& visible)
 {
     size_t redirect = instanceDataAllocator->getAddressAllocator().get_real_addr(instanceID)+36+48+extraDataInstanceSize;
@@ -378,6 +398,13 @@ void CMeshSceneNodeInstanced::removeInstances(const size_t& instanceCount, const
         instanceBBoxes[blockID].MaxEdge.set(-FLT_MAX,-FLT_MAX,-FLT_MAX);
     }
 
+    for (size_t i=0; i<instanceCount&&instanceTransformNodes.size(); i++)
+    {
+        auto found = std::lower_bound(instanceTransformNodes.begin(),instanceTransformNodes.end(),std::make_pair(instanceIDs[i],CTransformHierarchy::node_t(0u)));
+        if (found!=instanceTransformNodes.end() && found->first==instanceIDs[i])
+            instanceTransformNodes.erase(found);
+    }
+
     {// dummyBytes scope
     core::vector<uint32_t> dummyBytes_(instanceCount,dataPerInstanceInputSize);
     uint32_t* const dummyBytes = dummyBytes_.data();
@@ -410,6 +437,7 @@ void CMeshSceneNodeInstanced::removeInstances(const size_t& instanceCount, const
         instanceBBoxesCount = newCount;
     }
     needsBBoxRecompute = true;
+    markBoundsChanged();
 
     lodCullingPointMesh->setIndexCount(lodCullingPointMesh->getIndexCount()-instanceCount);
 }
@@ -470,6 +498,16 @@ void CMeshSceneNodeInstanced::RecullInstances()
 //! frame
 void CMeshSceneNodeInstanced::OnRegisterSceneNode()
 {
+    if (instanceTransformNodes.size() && SceneManager)
+    {
+        const CTransformHierarchy* hierarchy = SceneManager->getTransformHierarchy();
+        for (const auto& binding : instanceTransformNodes)
+        {
+            if (hierarchy->wasUpdated(binding.second))
+                setInstanceTransform(binding.first,hierarchy->getWorldTransform(binding.second));
+        }
+    }
+
     ISceneNode::OnRegisterSceneNode();
 
 	if (IsVisible&&LoD.size()&&instanceDataAllocator&&getInstanceCount()&&canProceedPastFence())
@@ -511,7 +549,8 @@ void CMeshSceneNodeInstanced::OnRegisterSceneNode()
 		if (transparentCount)
 			taken |= SceneManager->registerNodeForRendering(this, scene::ESNRP_TRANSPARENT);
 
-        if (taken)
+        // the scene manager frustum culls registered nodes later, in a batch
+        if (taken && !SceneManager->isCulled(this))
             RecullInstances();
 	}
 }
@@ -70,6 +70,8 @@ class CMeshSceneNodeInstanced : public IMeshSceneNodeInstanced
 
         virtual core::matrix3x4SIMD getInstanceTransform(const uint32_t& instanceID) override;
 
+        virtual void setInstanceTransformNode(const uint32_t& instanceID, CTransformHierarchy::node_t node) override;
+
         virtual void setInstanceVisible(const uint32_t& instanceID, const bool& visible) override;
 
         virtual void setInstanceData(const uint32_t& instanceID, const void* data) override;
@@ -151,6 +153,9 @@ class CMeshSceneNodeInstanced : public IMeshSceneNodeInstanced
         core::smart_refctd_ptr<video::IGPUMeshBuffer> lodCullingPointMesh;
         core::smart_refctd_ptr<video::IGPUBuffer> gpuCulledLodInstanceDataBuffer;
 
+        //! instances following a node of the scene manager's transform hierarchy, sorted by instance ID
+        core::vector<std::pair<uint32_t,CTransformHierarchy::node_t> > instanceTransformNodes;
+
         size_t dataPerInstanceOutputSize;
         size_t extraDataInstanceSize;
         size_t dataPerInstanceInputSize;
@@ -11,6 +11,8 @@
 #include "IWriteFile.h"
 
 #include "os.h"
+#include "irr/core/parallel/parallel_for.h"
+#include "irr/system/CProfiler.h"
 
 // We need this include for the case of skinned mesh support without
 // any such loader
@@ -42,7 +44,11 @@ CSceneManager::CSceneManager(IrrlichtDevice* device, video::IVideoDriver* driver
 		gui::ICursorControl* cursorControl)
 : ISceneNode(0, 0), Driver(driver), Timer(timer), FileSystem(fs), Device(device),
 	CursorControl(cursorControl),
-	ActiveCamera(0), CurrentRendertime(ESNRP_NONE),
+	CameraList(core::arena_allocator<ISceneNode*>(&RenderListArena)), LightList(core::arena_allocator<ISceneNode*>(&RenderListArena)),
+	SkyBoxList(core::arena_allocator<ISceneNode*>(&RenderListArena)), SolidNodeList(core::arena_allocator<DefaultNodeEntry>(&RenderListArena)),
+	TransparentNodeList(core::arena_allocator<TransparentNodeEntry>(&RenderListArena)), TransparentEffectNodeList(core::arena_allocator<TransparentNodeEntry>(&RenderListArena)),
+	CullCandidates(core::arena_allocator<CullCandidate>(&RenderListArena)), CullBoxes(core::arena_allocator<float>(&RenderListArena)),
+	TraversalThreadCount(1u), ActiveCamera(0), SpatialIndexMarked(false), TransformHierarchy(core::make_smart_refctd_ptr<CTransformHierarchy>()), CurrentRendertime(ESNRP_NONE),
 	IRR_XML_FORMAT_SCENE(L"irr_scene"), IRR_XML_FORMAT_NODE(L"node"), IRR_XML_FORMAT_NODE_ATTR_TYPE(L"type")
 {
 	#ifdef _IRR_DEBUG
@@ -239,6 +245,7 @@ IMeshSceneNode* CSceneManager::addCubeSceneNode(float size, IDummyTransformation
 		int32_t id, const core::vector3df& position,
 		const core::vector3df& rotation, const core::vector3df& scale)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	if (!parent)
 		parent = this;
 
@@ -257,6 +264,7 @@ IMeshSceneNode* CSceneManager::addSphereSceneNode(float radius, int32_t polyCoun
 		IDummyTransformationSceneNode* parent, int32_t id, const core::vector3df& position,
 		const core::vector3df& rotation, const core::vector3df& scale)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	if (!parent)
 		parent = this;
 
@@ -275,6 +283,7 @@ IMeshSceneNode* CSceneManager::addMeshSceneNode(core::smart_refctd_ptr<video::IG
 	const core::vector3df& position, const core::vector3df& rotation,
 	const core::vector3df& scale, bool alsoAddIfMeshPointerZero)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	if (!alsoAddIfMeshPointerZero && !mesh)
 		return 0;
 
@@ -290,6 +299,7 @@ IMeshSceneNode* CSceneManager::addMeshSceneNode(core::smart_refctd_ptr<video::IG
 IMeshSceneNodeInstanced* CSceneManager::addMeshSceneNodeInstanced(IDummyTransformationSceneNode* parent, int32_t id,
     const core::vector3df& position, const core::vector3df& rotation, const core::vector3df& scale)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	if (!parent)
 		parent = this;
 
@@ -305,6 +315,7 @@ ISkinnedMeshSceneNode* CSceneManager::addSkinnedMeshSceneNode(
     IDummyTransformationSceneNode* parent, int32_t id,
     const core::vector3df& position, const core::vector3df& rotation, const core::vector3df& scale)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	if (!mesh)
 		return 0;
 
@@ -326,6 +337,7 @@ ICameraSceneNode* CSceneManager::addCameraSceneNode(IDummyTransformationSceneNod
 	const core::vector3df& position, const core::vectorSIMDf& lookat, int32_t id,
 	bool makeActive)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	if (!parent)
 		parent = this;
 
@@ -346,6 +358,7 @@ ICameraSceneNode* CSceneManager::addCameraSceneNodeMaya(IDummyTransformationScen
 	float rotateSpeed, float zoomSpeed, float translationSpeed, int32_t id, float distance,
 	bool makeActive)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	ICameraSceneNode* node = addCameraSceneNode(parent, core::vector3df(),
 			core::vectorSIMDf(0,0,100), id, makeActive);
 	if (node)
@@ -366,6 +379,7 @@ ICameraSceneNode* CSceneManager::addCameraSceneNodeModifiedMaya(IDummyTransforma
 	float scrlZoomSpeed, bool zoomWithRMB,
 	bool makeActive)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	ICameraSceneNode* node = addCameraSceneNode(parent, core::vector3df(),
 		core::vectorSIMDf(0, 0, 100), id, makeActive);
 	if (node)
@@ -388,6 +402,7 @@ ICameraSceneNode* CSceneManager::addCameraSceneNodeFPS(IDummyTransformationScene
 	int32_t keyMapSize, bool noVerticalMovement, float jumpSpeed,
 	bool invertMouseY, bool makeActive)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	ICameraSceneNode* node = addCameraSceneNode(parent, core::vector3df(),
 			core::vectorSIMDf(0,0,100), id, makeActive);
 	if (node)
@@ -417,6 +432,7 @@ ISceneNode* CSceneManager::addSkyBoxSceneNode(	core::smart_refctd_ptr<video::ITe
 												core::smart_refctd_ptr<video::ITexture>&& back,
 												IDummyTransformationSceneNode* parent, int32_t id)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	if (!parent)
 		parent = this;
 
@@ -434,6 +450,7 @@ ISceneNode* CSceneManager::addSkyDomeSceneNode(	core::smart_refctd_ptr<video::IV
 	uint32_t vertRes, float texturePercentage, float spherePercentage, float radius, IDummyTransformationSceneNode* parent,
 	int32_t id)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	if (!parent)
 		parent = this;
 
@@ -448,6 +465,7 @@ ISceneNode* CSceneManager::addSkyDomeSceneNode(	core::smart_refctd_ptr<video::IV
 IDummyTransformationSceneNode* CSceneManager::addDummyTransformationSceneNode(
 	IDummyTransformationSceneNode* parent, int32_t id)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	if (!parent)
 		parent = this;
 
@@ -506,6 +524,109 @@ const core::aabbox3d<float>& CSceneManager::getBoundingBox()
 }
 
 
+namespace
+{
+	//! Groups of 4 boxes tested per task, scenes of up to 4096 culled nodes get culled on the calling thread only,
+	//! larger ones on the persistent workers of core::CThreadPool::getGlobal() so culling never starts a thread
+	constexpr size_t CullGroupsPerTask = 1024u;
+
+	//! Tests 4 boxes at a time against the bounding box and the planes of a frustum, the same tests as CSceneManager::isCulled()
+	class CBoxGroupCuller
+	{
+		public:
+			CBoxGroupCuller(const SViewFrustum& _frustum)
+			{
+				const auto& box = _frustum.getBoundingBox();
+				const float boxMin[3] = {box.MinEdge.X,box.MinEdge.Y,box.MinEdge.Z};
+				const float boxMax[3] = {box.MaxEdge.X,box.MaxEdge.Y,box.MaxEdge.Z};
+				for (uint32_t i=0u; i<3u; i++)
+				{
+					FrustumBoxMin[i] = splat(boxMin[i]);
+					FrustumBoxMax[i] = splat(boxMax[i]);
+				}
+				for (uint32_t i=0u; i<SViewFrustum::VF_PLANE_COUNT; i++)
+				{
+					const float* plane = reinterpret_cast<const float*>(_frustum.planes+i);
+					for (uint32_t j=0u; j<4u; j++)
+						Planes[i][j] = splat(plane[j]);
+				}
+			}
+
+			//! @param _group Min X,Y,Z and max X,Y,Z of 4 boxes
+			//! @param _outsideBox Bit i set if box i misses the frustum's bounding box
+			//! @param _outsidePlanes Bit i set if box i is fully behind one of the frustum's planes
+			inline void cull(const float* _group, uint32_t& _outsideBox, uint32_t& _outsidePlanes) const
+			{
+#ifdef __IRR_COMPILE_WITH_X86_SIMD_
+				__m128 boxMin[3], boxMax[3];
+				for (uint32_t i=0u; i<3u; i++)
+				{
+					boxMin[i] = _mm_loadu_ps(_group+i*4u);
+					boxMax[i] = _mm_loadu_ps(_group+12u+i*4u);
+				}
+
+				__m128 outside = _mm_setzero_ps();
+				for (uint32_t i=0u; i<3u; i++)
+					outside = _mm_or_ps(outside,_mm_or_ps(_mm_cmpgt_ps(boxMin[i],FrustumBoxMax[i]),_mm_cmplt_ps(boxMax[i],FrustumBoxMin[i])));
+				_outsideBox = _mm_movemask_ps(outside);
+
+				// the corner furthest along the normal is behind the plane
+				outside = _mm_setzero_ps();
+				for (uint32_t i=0u; i<SViewFrustum::VF_PLANE_COUNT; i++)
+				{
+					__m128 distance = Planes[i][3];
+					for (uint32_t j=0u; j<3u; j++)
+						distance = _mm_add_ps(distance,_mm_max_ps(_mm_mul_ps(Planes[i][j],boxMin[j]),_mm_mul_ps(Planes[i][j],boxMax[j])));
+					outside = _mm_or_ps(outside,_mm_cmplt_ps(distance,_mm_setzero_ps()));
+				}
+				_outsidePlanes = _mm_movemask_ps(outside);
+#else
+				_outsideBox = 0u;
+				_outsidePlanes = 0u;
+				for (uint32_t lane=0u; lane<4u; lane++)
+				{
+					bool outside = false;
+					for (uint32_t i=0u; i<3u; i++)
+						outside = outside || _group[i*4u+lane]>FrustumBoxMax[i] || _group[12u+i*4u+lane]<FrustumBoxMin[i];
+					_outsideBox |= uint32_t(outside)<<lane;
+
+					outside = false;
+					for (uint32_t i=0u; i<SViewFrustum::VF_PLANE_COUNT; i++)
+					{
+						float distance = Planes[i][3];
+						for (uint32_t j=0u; j<3u; j++)
+							distance += std::max(Planes[i][j]*_group[j*4u+lane],Planes[i][j]*_group[12u+j*4u+lane]);
+						outside = outside || distance<0.f;
+					}
+					_outsidePlanes |= uint32_t(outside)<<lane;
+				}
+#endif
+			}
+
+		private:
+#ifdef __IRR_COMPILE_WITH_X86_SIMD_
+			typedef __m128 lanes_t;
+			static inline lanes_t splat(float _value) { return _mm_set1_ps(_value); }
+#else
+			typedef float lanes_t;
+			static inline lanes_t splat(float _value) { return _value; }
+#endif
+			lanes_t FrustumBoxMin[3];
+			lanes_t FrustumBoxMax[3];
+			//! normal X,Y,Z and distance of every plane
+			lanes_t Planes[SViewFrustum::VF_PLANE_COUNT][4];
+	};
+
+	//! Stable sort of a render list by the entries' 64 bit keys, the scratch comes from the same arena as the list so its memory gets reused every frame
+	template<class Entry>
+	void sortRenderList(core::arena_vector<Entry>& _list)
+	{
+		IRR_PROFILE_ZONE("sortRenderList");
+		core::arena_vector<Entry> scratch(_list.size(),Entry(),_list.get_allocator());
+		core::radix_sort(_list.data(),scratch.data(),_list.size(),[](const Entry& _entry) -> uint64_t { return _entry.getSortKey(); });
+	}
+}
+
 //! returns if node is culled
 bool CSceneManager::isCulled(ISceneNode* node) const
 {
@@ -522,6 +643,10 @@ bool CSceneManager::isCulled(ISceneNode* node) const
     auto cullMode = node->getAutomaticCulling();
     if (cullMode & (scene::EAC_BOX|scene::EAC_FRUSTUM_BOX))
     {
+		// during drawAll() the nodes of the spatial index outside of the camera's frustum are known already
+		if (SpatialIndexMarked && !SpatialIndex->isInMarkedFrustum(node))
+			return true;
+
 		node->getAbsoluteTransformation().transformBoxEx(tbox);
         // can be seen by a bounding box ?
         if ((cullMode & scene::EAC_BOX) && !tbox.intersectsWithBox(cam->getViewFrustum()->getBoundingBox()))
@@ -540,10 +665,19 @@ uint32_t CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_
 {
 	uint32_t taken = 0;
 
+	// during the parallel traversal the nodes go to the lists of the chunk the thread is in, duplicate cameras get dropped when they are merged
+	SRegisteredNodes* target = getTraversalTarget();
+
 	switch(pass)
 	{
 		// take camera if it is not already registered
 		case ESNRP_CAMERA:
+			if (target)
+			{
+				target->Cameras.push_back(node);
+				taken = 1;
+			}
+			else
 			{
 				taken = 1;
 				for (uint32_t i = 0; i != CameraList.size(); ++i)
@@ -562,69 +696,262 @@ uint32_t CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_
 			break;
 
 		case ESNRP_SKY_BOX:
-			SkyBoxList.push_back(node);
+			if (target)
+				target->SkyBoxes.push_back(node);
+			else
+				SkyBoxList.push_back(node);
 			taken = 1;
 			break;
 		case ESNRP_SOLID:
-			if (!isCulled(node))
-			{
-				SolidNodeList.push_back(node);
-				taken = 1;
-			}
-			break;
 		case ESNRP_TRANSPARENT:
-			if (!isCulled(node))
-			{
-				TransparentNodeList.push_back(TransparentNodeEntry(node, ActiveCamera->getAbsolutePosition()));
-				taken = 1;
-			}
-			break;
 		case ESNRP_TRANSPARENT_EFFECT:
-			if (!isCulled(node))
-			{
-				TransparentEffectNodeList.push_back(TransparentNodeEntry(node, ActiveCamera->getAbsolutePosition()));
-				taken = 1;
-			}
-			break;
 		case ESNRP_AUTOMATIC:
-			if (!isCulled(node))
+			taken = registerNodeForCulling(node, pass, target);
+			break;
+
+		default: // ignore this one
+			break;
+	}
+
+	return taken;
+}
+
+//! queues a node registered for a pass which gets frustum culled
+uint32_t CSceneManager::registerNodeForCulling(ISceneNode* node, E_SCENE_NODE_RENDER_PASS pass, SRegisteredNodes* target)
+{
+	uint32_t cullingMode = 0u;
+	core::aabbox3d<float> tbox;
+	if (getActiveCamera())
+	{
+		tbox = node->getBoundingBox();
+		if (tbox.MinEdge==tbox.MaxEdge)
+			return 0;
+
+		cullingMode = node->getAutomaticCulling()&(scene::EAC_BOX|scene::EAC_FRUSTUM_BOX);
+		// nodes of the spatial index outside of the camera's frustum never become candidates
+		if (cullingMode && SpatialIndexMarked && !SpatialIndex->isInMarkedFrustum(node))
+			return 0;
+		if (cullingMode)
+			node->getAbsoluteTransformation().transformBoxEx(tbox);
+	}
+
+	const CullCandidate candidate = {node,pass,cullingMode};
+	if (target)
+	{
+		target->CullCandidates.push_back(candidate);
+		target->CullBoxes.push_back(tbox);
+	}
+	else
+		pushCullCandidate(candidate, tbox);
+	return 1;
+}
+
+//! adds a candidate and its box to CullCandidates and CullBoxes
+void CSceneManager::pushCullCandidate(const CullCandidate& candidate, const core::aabbox3df& box)
+{
+	const size_t lane = CullCandidates.size()&3u;
+	if (!lane)
+		CullBoxes.resize(CullBoxes.size()+24u,0.f);
+	float* group = CullBoxes.data()+CullBoxes.size()-24u;
+	const float* corners[2] = {&box.MinEdge.X,&box.MaxEdge.X};
+	for (uint32_t i=0u; i<6u; i++)
+		group[i*4u+lane] = corners[i/3u][i%3u];
+
+	CullCandidates.push_back(candidate);
+}
+
+//! frustum culls all the queued nodes at once and puts the visible ones in the solid and transparent lists
+void CSceneManager::cullRegisteredNodes()
+{
+	IRR_PROFILE_ZONE("CSceneManager::cullRegisteredNodes");
+
+	const size_t candidateCount = CullCandidates.size();
+	if (!candidateCount)
+		return;
+
+	// bit i of a group's mask is set when its node i is culled
+	const size_t groupCount = (candidateCount+3u)/4u;
+	core::arena_vector<uint8_t> culled(groupCount,0u,core::arena_allocator<uint8_t>(&RenderListArena));
+	if (const ICameraSceneNode* cam = getActiveCamera())
+	{
+		const CBoxGroupCuller culler(*cam->getViewFrustum());
+		if (OcclusionCuller)
+			OcclusionCuller->render(cam->getConcatenatedMatrix());
+		core::parallel_for_chunked(0u,groupCount,CullGroupsPerTask,[&](size_t _begin, size_t _end, uint32_t) -> void
+		{
+			for (size_t g=_begin; g<_end; g++)
 			{
-	#ifdef REIMPLEMENT_THIS
-				taken = 0;
-				const uint32_t count = node->getMaterialCount();
-				for (uint32_t i=0; i<count; ++i)
+				uint32_t outsideBox, outsidePlanes;
+				culler.cull(CullBoxes.data()+g*24u,outsideBox,outsidePlanes);
+
+				uint32_t mask = 0u;
+				const size_t laneCount = std::min<size_t>(candidateCount-g*4u,4u);
+				for (uint32_t lane=0u; lane<laneCount; lane++)
 				{
-					video::IMaterialRenderer* rnd =
-						Driver->getMaterialRenderer(node->getMaterial(i).MaterialType);
-					if (rnd && rnd->isTransparent())
+					const uint32_t cullingMode = CullCandidates[g*4u+lane].CullingMode;
+					if (((cullingMode&scene::EAC_BOX) && (outsideBox>>lane)&0x1u) || ((cullingMode&scene::EAC_FRUSTUM_BOX) && (outsidePlanes>>lane)&0x1u))
+						mask |= 0x1u<<lane;
+					else if (cullingMode && OcclusionCuller)
 					{
-						// register as transparent node
-						TransparentNodeEntry e(node, ActiveCamera->getAbsolutePosition());
-						TransparentNodeList.push_back(e);
-						taken = 1;
-						break;
+						const float* group = CullBoxes.data()+g*24u+lane;
+						const core::aabbox3df box(group[0],group[4],group[8],group[12],group[16],group[20]);
+						if (OcclusionCuller->isOccluded(box))
+							mask |= 0x1u<<lane;
 					}
 				}
-	#endif
-				// not transparent, register as solid
-				if (!taken)
+				culled[g] = mask;
+			}
+		});
+	}
+
+	// the lists get filled in registration order, same as when every node was tested on its own
+	const core::vector3df camPos = ActiveCamera ? ActiveCamera->getAbsolutePosition():core::vector3df();
+	for (size_t i=0u; i<candidateCount; i++)
+	{
+		if ((culled[i/4u]>>(i&3u))&0x1u)
+			continue;
+
+		ISceneNode* node = CullCandidates[i].Node;
+		switch (CullCandidates[i].Pass)
+		{
+			case ESNRP_TRANSPARENT:
+				TransparentNodeList.push_back(TransparentNodeEntry(node, camPos));
+				break;
+			case ESNRP_TRANSPARENT_EFFECT:
+				TransparentEffectNodeList.push_back(TransparentNodeEntry(node, camPos));
+				break;
+			case ESNRP_AUTOMATIC:
 				{
-					SolidNodeList.push_back(node);
-					taken = 1;
+					uint32_t taken = 0;
+		#ifdef REIMPLEMENT_THIS
+					const uint32_t count = node->getMaterialCount();
+					for (uint32_t j=0; j<count; ++j)
+					{
+						video::IMaterialRenderer* rnd =
+							Driver->getMaterialRenderer(node->getMaterial(j).MaterialType);
+						if (rnd && rnd->isTransparent())
+						{
+							// register as transparent node
+							TransparentNodeList.push_back(TransparentNodeEntry(node, camPos));
+							taken = 1;
+							break;
+						}
+					}
+		#endif
+					// not transparent, register as solid
+					if (!taken)
+						SolidNodeList.push_back(DefaultNodeEntry(node, camPos));
 				}
-			}
-			break;
+				break;
+			default:
+				SolidNodeList.push_back(DefaultNodeEntry(node, camPos));
+				break;
+		}
+	}
+	CullCandidates.clear();
+	CullBoxes.clear();
+}
 
-		default: // ignore this one
-			break;
+//! lists of the chunk the calling thread is traversing
+thread_local CSceneManager::SRegisteredNodes* CSceneManager::TraversalTarget = nullptr;
+
+//! number of top level subtrees every thread of the parallel traversal takes at a time, 0 if the traversal runs on the calling thread only
+size_t CSceneManager::getTraversalGrainSize() const
+{
+	if (TraversalThreadCount==1u || Children.size()<2u)
+		return 0u;
+
+	// a few chunks per thread, so threads getting the cheaper subtrees take more of them
+	const size_t threadCount = TraversalThreadCount ? TraversalThreadCount:core::getDefaultThreadCount();
+	return std::max<size_t>(Children.size()/(threadCount*4u),1u);
+}
+
+//! the lists of the parallel traversal chunk running on the calling thread, 0 if there is none
+CSceneManager::SRegisteredNodes* CSceneManager::getTraversalTarget() const
+{
+	// the target could belong to another scene manager traversing at the same time
+	SRegisteredNodes* target = TraversalTarget;
+	if (target && std::less<const SRegisteredNodes*>()(target,TraversalLists.data()+TraversalLists.size()) && !std::less<const SRegisteredNodes*>()(target,TraversalLists.data()))
+		return target;
+	return nullptr;
+}
+
+//! calls OnRegisterSceneNode() of all nodes, splitting the top level subtrees between threads if setTraversalThreadCount() allows it
+void CSceneManager::registerSceneNodes()
+{
+	IRR_PROFILE_ZONE("CSceneManager::registerSceneNodes");
+
+	const size_t grainSize = getTraversalGrainSize();
+	if (!grainSize || !IsVisible)
+	{
+		OnRegisterSceneNode();
+		return;
 	}
 
-	return taken;
+	// the top level must not change until every subtree is done, see ISceneManager::setTraversalThreadCount()
+	TraversalRoots.assign(Children.begin(),Children.end());
+	const size_t chunkCount = (TraversalRoots.size()+grainSize-1u)/grainSize;
+	if (TraversalLists.size()<chunkCount)
+		TraversalLists.resize(chunkCount);
+
+	core::parallel_for_chunked(0u,TraversalRoots.size(),grainSize,[&](size_t _begin, size_t _end, uint32_t) -> void
+	{
+		// the pool's threads outlive the traversal, so the target gets put back to what it was (0 unless another scene manager is traversing)
+		SRegisteredNodes* const previousTarget = TraversalTarget;
+		TraversalTarget = TraversalLists.data()+_begin/grainSize;
+		for (size_t i=_begin; i<_end; i++)
+		{
+			IDummyTransformationSceneNode* root = TraversalRoots[i];
+			if (root->isISceneNode())
+				static_cast<ISceneNode*>(root)->OnRegisterSceneNode();
+			else
+				OnRegisterSceneNode_static(root);
+		}
+		TraversalTarget = previousTarget;
+	},TraversalThreadCount);
+
+	// merging the chunks in order leaves the lists the same as after a traversal on one thread
+	for (size_t i=0u; i<chunkCount; i++)
+	{
+		SRegisteredNodes& lists = TraversalLists[i];
+		for (ISceneNode* camera : lists.Cameras)
+		{
+			if (std::find(CameraList.begin(),CameraList.end(),camera)==CameraList.end())
+				CameraList.push_back(camera);
+		}
+		SkyBoxList.insert(SkyBoxList.end(),lists.SkyBoxes.begin(),lists.SkyBoxes.end());
+		for (size_t j=0u; j<lists.CullCandidates.size(); j++)
+			pushCullCandidate(lists.CullCandidates[j],lists.CullBoxes[j]);
+
+		lists.Cameras.clear();
+		lists.SkyBoxes.clear();
+		lists.CullCandidates.clear();
+		lists.CullBoxes.clear();
+	}
 }
 
 //!
 void CSceneManager::OnAnimate(uint32_t timeMs)
 {
+	IRR_PROFILE_ZONE("CSceneManager::OnAnimate");
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
+
+	const size_t grainSize = getTraversalGrainSize();
+	if (grainSize)
+	{
+		// the top level must not change until every subtree is done, see ISceneManager::setTraversalThreadCount()
+		TraversalRoots.assign(Children.begin(),Children.end());
+		core::parallel_for(0u,TraversalRoots.size(),[&](size_t i) -> void
+		{
+			IDummyTransformationSceneNode* root = TraversalRoots[i];
+			if (root->isISceneNode())
+				static_cast<ISceneNode*>(root)->OnAnimate(timeMs);
+			else
+				OnAnimate_static(root,timeMs);
+		},TraversalThreadCount,grainSize);
+		return;
+	}
+
     size_t prevSize = Children.size();
     for (size_t i=0; i<prevSize;)
     {
@@ -645,6 +972,9 @@ void CSceneManager::OnAnimate(uint32_t timeMs)
 //! draws all scene nodes
 void CSceneManager::drawAll()
 {
+	IRR_PROFILE_ZONE("CSceneManager::drawAll");
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
+
 	if (!Driver)
 		return;
 
@@ -658,6 +988,10 @@ void CSceneManager::drawAll()
 
 	// do animations and other stuff.
 	OnAnimate(std::chrono::duration_cast<std::chrono::milliseconds>(Timer->getTime()).count());
+	// after the animators moved its nodes, so the nodes following it see this frame's transforms when registering
+	TransformHierarchy->update();
+	if (SpatialIndex)
+		SpatialIndex->update();
 
 	/*!
 		First Scene Node for prerendering should be the active camera
@@ -666,10 +1000,18 @@ void CSceneManager::drawAll()
 	if (ActiveCamera)
 	{
 		ActiveCamera->render();
+		// once the frustum is up to date, the nodes of the index outside of it get culled as they register
+		if (SpatialIndex)
+		{
+			SpatialIndex->markFrustum(*ActiveCamera->getViewFrustum());
+			SpatialIndexMarked = true;
+		}
 	}
 
 	// let all nodes register themselves
-	OnRegisterSceneNode();
+	registerSceneNodes();
+	cullRegisteredNodes();
+	SpatialIndexMarked = false;
 
 	//render camera scenes
 	{
@@ -696,7 +1038,7 @@ void CSceneManager::drawAll()
 	{
 		CurrentRendertime = ESNRP_SOLID;
 
-		std::stable_sort(SolidNodeList.begin(),SolidNodeList.end()); // sort by textures
+		sortRenderList(SolidNodeList);
 
         for (i=0; i<SolidNodeList.size(); ++i)
             SolidNodeList[i].Node->render();
@@ -708,7 +1050,7 @@ void CSceneManager::drawAll()
 	{
 		CurrentRendertime = ESNRP_TRANSPARENT;
 
-		std::stable_sort(TransparentNodeList.begin(),TransparentNodeList.end()); // sort by distance from camera
+		sortRenderList(TransparentNodeList);
         for (i=0; i<TransparentNodeList.size(); ++i)
             TransparentNodeList[i].Node->render();
 
@@ -719,7 +1061,7 @@ void CSceneManager::drawAll()
 	{
 		CurrentRendertime = ESNRP_TRANSPARENT_EFFECT;
 
-		std::stable_sort(TransparentEffectNodeList.begin(),TransparentEffectNodeList.end()); // sort by distance from camera
+		sortRenderList(TransparentEffectNodeList);
         for (i=0; i<TransparentEffectNodeList.size(); ++i)
             TransparentEffectNodeList[i].Node->render();
 
@@ -729,12 +1071,24 @@ void CSceneManager::drawAll()
 	LightList.clear();
 	clearDeletionList();
 
+	// the lists are empty, drop their storage so the whole frame's worth of list memory can be reclaimed at once
+	decltype(CameraList)(CameraList.get_allocator()).swap(CameraList);
+	decltype(LightList)(LightList.get_allocator()).swap(LightList);
+	decltype(SkyBoxList)(SkyBoxList.get_allocator()).swap(SkyBoxList);
+	decltype(SolidNodeList)(SolidNodeList.get_allocator()).swap(SolidNodeList);
+	decltype(TransparentNodeList)(TransparentNodeList.get_allocator()).swap(TransparentNodeList);
+	decltype(TransparentEffectNodeList)(TransparentEffectNodeList.get_allocator()).swap(TransparentEffectNodeList);
+	decltype(CullCandidates)(CullCandidates.get_allocator()).swap(CullCandidates);
+	decltype(CullBoxes)(CullBoxes.get_allocator()).swap(CullBoxes);
+	RenderListArena.reset();
+
 	CurrentRendertime = ESNRP_NONE;
 }
 
 //! creates a rotation animator, which rotates the attached scene node around itself.
 ISceneNodeAnimator* CSceneManager::createRotationAnimator(const core::vector3df& rotationPerSecond)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	ISceneNodeAnimator* anim = new CSceneNodeAnimatorRotation(std::chrono::duration_cast<std::chrono::milliseconds>(Timer->getTime()).count(),
 		rotationPerSecond);
 
@@ -749,6 +1103,7 @@ ISceneNodeAnimator* CSceneManager::createFlyCircleAnimator(
 		float startPosition,
 		float radiusEllipsoid)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	const float orbitDurationMs = core::radians(360.f) / speed;
 	const uint32_t effectiveTime = std::chrono::duration_cast<std::chrono::milliseconds>(Timer->getTime()).count() + (uint32_t)(orbitDurationMs * startPosition);
 
@@ -764,6 +1119,7 @@ ISceneNodeAnimator* CSceneManager::createFlyCircleAnimator(
 ISceneNodeAnimator* CSceneManager::createFlyStraightAnimator(const core::vectorSIMDf& startPoint,
 					const core::vectorSIMDf& endPoint, uint32_t timeForWay, bool loop,bool pingpong)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	ISceneNodeAnimator* anim = new CSceneNodeAnimatorFlyStraight(startPoint,
 		endPoint, timeForWay, loop, std::chrono::duration_cast<std::chrono::milliseconds>(Timer->getTime()).count(), pingpong);
 
@@ -774,6 +1130,7 @@ ISceneNodeAnimator* CSceneManager::createFlyStraightAnimator(const core::vectorS
 //! some time automaticly.
 ISceneNodeAnimator* CSceneManager::createDeleteAnimator(uint32_t when)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	return new CSceneNodeAnimatorDelete(this, std::chrono::duration_cast<std::chrono::milliseconds>(Timer->getTime()).count() + when);
 }
 
@@ -783,6 +1140,7 @@ ISceneNodeAnimator* CSceneManager::createFollowSplineAnimator(int32_t startTime,
 	const core::vector< core::vector3df >& points,
 	float speed, float tightness, bool loop, bool pingpong)
 {
+	IRR_MEMORY_TAG_SCOPE(core::EMT_SCENE);
 	ISceneNodeAnimator* a = new CSceneNodeAnimatorFollowSpline(startTime, points,
 		speed, tightness, loop, pingpong);
 	return a;
@@ -796,6 +1154,7 @@ void CSceneManager::addToDeletionQueue(IDummyTransformationSceneNode* node)
 		return;
 
 	node->grab();
+	std::lock_guard<std::mutex> lock(DeletionListMutex);
 	DeletionList.push_back(node);
 }
 
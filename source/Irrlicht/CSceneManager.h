@@ -9,8 +9,13 @@
 #include "ISceneNode.h"
 #include "ICursorControl.h"
 #include "ISkinningStateManager.h"
+#include "irr/core/alloc/arena_allocator.h"
+#include "irr/scene/COcclusionCuller.h"
+#include "irr/scene/CTransformHierarchy.h"
+#include "irr/scene/CSceneNodeSpatialIndex.h"
 
 #include <map>
+#include <mutex>
 #include <string>
 
 namespace irr
@@ -234,57 +239,87 @@ namespace scene
 		//! returns if node is culled
 		virtual bool isCulled(ISceneNode* node) const;
 
+		//! Sets the occlusion culler nodes get tested against before being drawn
+		virtual void setOcclusionCuller(COcclusionCuller* culler) { OcclusionCuller = core::smart_refctd_ptr<COcclusionCuller>(culler); }
+
+		//! Gets the occlusion culler set with setOcclusionCuller()
+		virtual COcclusionCuller* getOcclusionCuller() const { return OcclusionCuller.get(); }
+
+		//! Sets the spatial index drawAll() frustum culls the nodes in it with
+		virtual void setSpatialIndex(CSceneNodeSpatialIndex* index) { SpatialIndex = core::smart_refctd_ptr<CSceneNodeSpatialIndex>(index); }
+
+		//! Gets the spatial index set with setSpatialIndex()
+		virtual CSceneNodeSpatialIndex* getSpatialIndex() const { return SpatialIndex.get(); }
+
+		//! Sets how many threads drawAll() animates the scene and registers its nodes with
+		virtual void setTraversalThreadCount(uint32_t threadCount) { TraversalThreadCount = threadCount; }
+
+		//! Gets the thread count set with setTraversalThreadCount()
+		virtual uint32_t getTraversalThreadCount() const { return TraversalThreadCount; }
+
+		//! Gets the transform hierarchy drawAll() updates every frame
+		virtual CTransformHierarchy* getTransformHierarchy() { return TransformHierarchy.get(); }
+
 	protected:
 
 		//! clears the deletion list
 		void clearDeletionList();
 
+		//! calls OnRegisterSceneNode() of all nodes, splitting the top level subtrees between threads if setTraversalThreadCount() allows it
+		void registerSceneNodes();
+
+		//! number of top level subtrees every thread of the parallel traversal takes at a time, 0 if the traversal runs on the calling thread only
+		size_t getTraversalGrainSize() const;
+
+		struct SRegisteredNodes;
+		//! the lists of the parallel traversal chunk running on the calling thread, 0 if there is none
+		SRegisteredNodes* getTraversalTarget() const;
+
+		//! queues a node registered for a pass which gets frustum culled
+		uint32_t registerNodeForCulling(ISceneNode* node, E_SCENE_NODE_RENDER_PASS pass, SRegisteredNodes* target);
+
+		//! frustum culls all the queued nodes at once and puts the visible ones in the solid and transparent lists
+		/** The tests of large batches are split between the thread pool's workers, see CullGroupsPerTask.*/
+		void cullRegisteredNodes();
+
+		//! sorted by render priority, then front to back so the depth test can reject more of what comes later
 		struct DefaultNodeEntry
 		{
-				DefaultNodeEntry(ISceneNode* n) :
-					Node(n), renderPriority(0x80000000u)
+				DefaultNodeEntry() = default;
+				DefaultNodeEntry(ISceneNode* n, const core::vector3df& camera) : Node(n)
 				{
-					renderPriority = n->getRenderPriorityScore();
+					// positive floats order the same as their bits, the lowest 8 bits of the distance are dropped to make room for the material
+					const float distance = Node->getAbsoluteTransformation().getTranslation().getDistanceFromSQ(camera);
+					SortKey = (uint64_t(n->getRenderPriorityScore())<<32u)|(uint32_t(core::FloatIntUnion32(distance).i)>>8u);
 #ifdef REIMPLEMENT_THIS
 					if (n->getMaterialCount())
-						Material = n->getMaterial(0).MaterialType;
+						SortKey |= uint64_t(n->getMaterial(0).MaterialType&0xffu)<<24u;
 #endif
 				}
 
-				bool operator < (const DefaultNodeEntry& other) const
-				{
-#ifdef REIMPLEMENT_THIS
-					return (renderPriority < other.renderPriority)||(renderPriority==other.renderPriority && Material<other.Material);
-#else
-					return renderPriority < other.renderPriority;
-#endif
-				}
+				inline uint64_t getSortKey() const { return SortKey; }
 
 				ISceneNode* Node;
 			private:
-				uint32_t renderPriority;
-#ifdef REIMPLEMENT_THIS
-				video::E_MATERIAL_TYPE Material;
-#endif
+				uint64_t SortKey;
 		};
 
-		//! sort on distance (center) to camera
+		//! sort on distance (center) to camera, back to front
 		struct TransparentNodeEntry
 		{
+			TransparentNodeEntry() = default;
 			TransparentNodeEntry(ISceneNode* n, const core::vector3df& camera)
 				: Node(n)
 			{
-				Distance = Node->getAbsoluteTransformation().getTranslation().getDistanceFromSQ(camera);
+				const float distance = Node->getAbsoluteTransformation().getTranslation().getDistanceFromSQ(camera);
+				SortKey = ~uint32_t(core::FloatIntUnion32(distance).i);
 			}
 
-			bool operator < (const TransparentNodeEntry& other) const
-			{
-				return Distance > other.Distance;
-			}
+			inline uint64_t getSortKey() const { return SortKey; }
 
 			ISceneNode* Node;
 			private:
-				double Distance;
+				uint64_t SortKey;
 		};
 
 		//! sort on distance (sphere) to camera
@@ -328,19 +363,62 @@ namespace scene
 		//! cursor control
 		gui::ICursorControl* CursorControl;
 
+		//! backing memory of the render pass lists, reset at the end of every drawAll()
+		core::LinearArena RenderListArena;
+
 		//! render pass lists
-		core::vector<ISceneNode*> CameraList;
-		core::vector<ISceneNode*> LightList;
-		core::vector<ISceneNode*> SkyBoxList;
-		core::vector<DefaultNodeEntry> SolidNodeList;
-		core::vector<TransparentNodeEntry> TransparentNodeList;
-		core::vector<TransparentNodeEntry> TransparentEffectNodeList;
+		core::arena_vector<ISceneNode*> CameraList;
+		core::arena_vector<ISceneNode*> LightList;
+		core::arena_vector<ISceneNode*> SkyBoxList;
+		core::arena_vector<DefaultNodeEntry> SolidNodeList;
+		core::arena_vector<TransparentNodeEntry> TransparentNodeList;
+		core::arena_vector<TransparentNodeEntry> TransparentEffectNodeList;
+
+		//! node waiting for cullRegisteredNodes()
+		struct CullCandidate
+		{
+			ISceneNode* Node;
+			E_SCENE_NODE_RENDER_PASS Pass;
+			//! EAC_BOX and EAC_FRUSTUM_BOX bits of the node, 0 if it is never culled
+			uint32_t CullingMode;
+		};
+		core::arena_vector<CullCandidate> CullCandidates;
+		//! world space bounding boxes of the candidates in groups of 4, every group is the min X,Y,Z and max X,Y,Z of its 4 boxes
+		core::arena_vector<float> CullBoxes;
+		//! adds a candidate and its box to CullCandidates and CullBoxes
+		void pushCullCandidate(const CullCandidate& candidate, const core::aabbox3df& box);
+
+		//! nodes registered by one chunk of top level subtrees during the parallel traversal, merged in the order of the chunks
+		struct SRegisteredNodes
+		{
+			core::vector<ISceneNode*> Cameras;
+			core::vector<ISceneNode*> SkyBoxes;
+			core::vector<CullCandidate> CullCandidates;
+			core::vector<core::aabbox3df> CullBoxes;
+		};
+		//! lists of the chunk the calling thread is traversing
+		static thread_local SRegisteredNodes* TraversalTarget;
+		//! kept between frames so their storage gets reused
+		core::vector<SRegisteredNodes> TraversalLists;
+		//! the top level nodes when the parallel traversal started
+		core::vector<IDummyTransformationSceneNode*> TraversalRoots;
+		uint32_t TraversalThreadCount;
 
 		core::vector<IDummyTransformationSceneNode*> DeletionList;
+		//! nodes can queue themselves for deletion from the threads of the parallel traversal
+		std::mutex DeletionListMutex;
 
 		//! current active camera
 		ICameraSceneNode* ActiveCamera;
 
+		core::smart_refctd_ptr<COcclusionCuller> OcclusionCuller;
+
+		core::smart_refctd_ptr<CSceneNodeSpatialIndex> SpatialIndex;
+		//! whether SpatialIndex marked the active camera's frustum of the drawAll() running now
+		bool SpatialIndexMarked;
+
+		core::smart_refctd_ptr<CTransformHierarchy> TransformHierarchy;
+
 		core::smart_refctd_ptr<video::IGPUBuffer> redundantMeshDataBuf;
 
 		E_SCENE_NODE_RENDER_PASS CurrentRendertime;
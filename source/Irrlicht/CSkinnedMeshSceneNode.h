@@ -102,7 +102,7 @@ namespace scene
             //! renders the node.
             virtual void render();
 
-            virtual void setBoundingBox(const core::aabbox3d<float>& bbox) {Box = bbox;}
+            virtual void setBoundingBox(const core::aabbox3d<float>& bbox) {Box = bbox; markBoundsChanged();}
             //! returns the axis aligned bounding box of this node
             virtual const core::aabbox3d<float>& getBoundingBox() {return Box;}
 
@@ -5,6 +5,7 @@
 #include "ISkinningStateManager.h"
 #include "ITextureBufferObject.h"
 #include "IVideoDriver.h"
+#include "irr/system/CProfiler.h"
 
 ///#define UPDATE_WHOLE_BUFFER
 
@@ -293,6 +294,7 @@ namespace scene
 
             virtual void performBoning()
             {
+                IRR_PROFILE_ZONE("CSkinningStateManager::performBoning");
                 if (referenceHierarchy->getHierarchyLevels()==0||instanceBoneDataAllocator->getAddressAllocator().get_allocated_size()==0)
                     return;
 
@@ -47,6 +47,7 @@ CBAWMeshFileLoader::CBAWMeshFileLoader(IAssetManager* _manager) : m_manager(_man
 
 SAssetBundle CBAWMeshFileLoader::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
+	IRR_PROFILE_ZONE("CBAWMeshFileLoader::loadAsset");
 #ifdef _IRR_DEBUG
     auto time = std::chrono::high_resolution_clock::now();
 #endif // _IRR_DEBUG
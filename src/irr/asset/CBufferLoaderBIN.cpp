@@ -6,6 +6,7 @@ namespace irr
 	{
 		asset::SAssetBundle CBufferLoaderBIN::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 		{
+			IRR_PROFILE_ZONE("CBufferLoaderBIN::loadAsset");
 			if (!_file)
 				return {};
 
@@ -32,9 +32,12 @@ public:
             return;
 
         m_loaders.insert("/irr/builtin/"s + _loader->getVirtualDirectoryName(), _loader);
+        // new loader may shadow what was already resolved
+        clearCache();
     }
 
 protected:
+    //! Builtins are generated deterministically from the path, so getIncludeTimestamp_internal is left as the constant default
     std::string getInclude_internal(const std::string& _path) const override
     {
         const char* PREFIX = "/irr/builtin/";
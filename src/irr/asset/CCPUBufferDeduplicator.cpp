@@ -0,0 +1,185 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "irr/asset/CCPUBufferDeduplicator.h"
+
+#include "irr/core/xxHash256.h"
+#include "irr/system/CProfiler.h"
+
+namespace irr
+{
+namespace asset
+{
+
+core::smart_refctd_ptr<ICPUBuffer> CCPUBufferDeduplicator::deduplicate(ICPUBuffer* _buffer)
+{
+	if (!_buffer || _buffer->isADummyObjectForCache() || !_buffer->getPointer() || !_buffer->getSize())
+		return core::smart_refctd_ptr<ICPUBuffer>(_buffer);
+
+	IRR_MEMORY_TAG_SCOPE(core::EMT_ASSET_CACHE);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_statistics.buffersVisited++;
+	if (m_keys.find(_buffer)!=m_keys.end())
+		return core::smart_refctd_ptr<ICPUBuffer>(_buffer);
+
+	SKey key;
+	key.size = _buffer->getSize();
+	core::XXHash_256(_buffer->getPointer(),key.size,key.hash);
+
+	auto found = m_buffers.find(key);
+	if (found!=m_buffers.end())
+	{
+		ICPUBuffer* registered = found->second.get();
+		if (!registered->isADummyObjectForCache() && registered->getSize()==key.size && memcmp(registered->getPointer(),_buffer->getPointer(),key.size)==0)
+		{
+			m_statistics.buffersSubstituted++;
+			m_statistics.bytesSaved += key.size;
+			return found->second;
+		}
+		// the registered buffer got modified or demoted to a dummy since, or it is an actual collision, either way the new buffer takes over the key
+		m_keys.erase(registered);
+		found->second = core::smart_refctd_ptr<ICPUBuffer>(_buffer);
+	}
+	else
+		m_buffers.emplace(key,core::smart_refctd_ptr<ICPUBuffer>(_buffer));
+	m_keys.emplace(_buffer,key);
+
+	if (m_buffers.size()>=m_pruneThreshold)
+	{
+		prune_impl();
+		m_pruneThreshold = std::max<size_t>(m_buffers.size()*2u,size_t(MinPruneThreshold));
+	}
+	return core::smart_refctd_ptr<ICPUBuffer>(_buffer);
+}
+
+uint32_t CCPUBufferDeduplicator::deduplicate(ICPUMeshBuffer* _meshbuffer)
+{
+	if (!_meshbuffer)
+		return 0u;
+	auto* desc = _meshbuffer->getMeshDataAndFormat();
+	if (!desc)
+		return 0u;
+
+	// interleaved attributes share a buffer, every distinct one only gets hashed and looked up once
+	const ICPUBuffer* originals[EVAI_COUNT+1u];
+	core::smart_refctd_ptr<ICPUBuffer> results[EVAI_COUNT+1u];
+	uint32_t distinctCount = 0u;
+	uint32_t substituted = 0u;
+	auto deduplicateOnce = [&](ICPUBuffer* _buffer) -> const core::smart_refctd_ptr<ICPUBuffer>&
+	{
+		for (uint32_t i=0u; i<distinctCount; i++)
+		if (originals[i]==_buffer)
+			return results[i];
+
+		originals[distinctCount] = _buffer;
+		results[distinctCount] = deduplicate(_buffer);
+		if (results[distinctCount].get()!=_buffer)
+			substituted++;
+		return results[distinctCount++];
+	};
+
+	for (uint32_t i=0u; i<EVAI_COUNT; i++)
+	{
+		const E_VERTEX_ATTRIBUTE_ID attrId = static_cast<E_VERTEX_ATTRIBUTE_ID>(i);
+		ICPUBuffer* buffer = const_cast<ICPUBuffer*>(desc->getMappedBuffer(attrId));
+		if (!buffer)
+			continue;
+
+		const auto& deduplicated = deduplicateOnce(buffer);
+		if (deduplicated.get()!=buffer)
+			desc->swapVertexAttrBuffer(core::smart_refctd_ptr<ICPUBuffer>(deduplicated),attrId);
+	}
+
+	ICPUBuffer* indexBuffer = const_cast<ICPUBuffer*>(desc->getIndexBuffer());
+	if (indexBuffer)
+	{
+		const auto& deduplicated = deduplicateOnce(indexBuffer);
+		if (deduplicated.get()!=indexBuffer)
+			desc->setIndexBuffer(core::smart_refctd_ptr<ICPUBuffer>(deduplicated));
+	}
+	return substituted;
+}
+
+uint32_t CCPUBufferDeduplicator::deduplicate(ICPUMesh* _mesh)
+{
+	if (!_mesh)
+		return 0u;
+
+	uint32_t substituted = 0u;
+	for (uint32_t i=0u; i<_mesh->getMeshBufferCount(); i++)
+		substituted += deduplicate(_mesh->getMeshBuffer(i));
+	return substituted;
+}
+
+uint32_t CCPUBufferDeduplicator::deduplicate(const SAssetBundle& _bundle)
+{
+	IRR_PROFILE_ZONE("CCPUBufferDeduplicator::deduplicate");
+	if (_bundle.isEmpty())
+		return 0u;
+
+	uint32_t substituted = 0u;
+	auto contents = _bundle.getContents();
+	for (auto it=contents.first; it!=contents.second; ++it)
+	switch (_bundle.getAssetType())
+	{
+		case IAsset::ET_BUFFER:
+			deduplicate(static_cast<ICPUBuffer*>(it->get()));
+			break;
+		case IAsset::ET_SUB_MESH:
+			substituted += deduplicate(static_cast<ICPUMeshBuffer*>(it->get()));
+			break;
+		case IAsset::ET_MESH:
+			substituted += deduplicate(static_cast<ICPUMesh*>(it->get()));
+			break;
+		default:
+			break;
+	}
+	return substituted;
+}
+
+void CCPUBufferDeduplicator::prune()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	prune_impl();
+}
+
+bool CCPUBufferDeduplicator::isRegistered(const ICPUBuffer* _buffer) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_keys.find(_buffer)!=m_keys.end();
+}
+
+void CCPUBufferDeduplicator::prune_impl()
+{
+	for (auto it=m_buffers.begin(); it!=m_buffers.end();)
+	{
+		// dummies lost their data, they can never be substituted again
+		if (it->second->getReferenceCount()==1 || it->second->isADummyObjectForCache())
+		{
+			m_keys.erase(it->second.get());
+			m_buffers.erase(it++);
+		}
+		else
+			++it;
+	}
+}
+
+void CCPUBufferDeduplicator::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_keys.clear();
+	m_buffers.clear();
+	m_pruneThreshold = MinPruneThreshold;
+}
+
+CCPUBufferDeduplicator::SStatistics CCPUBufferDeduplicator::getStatistics() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	SStatistics retval = m_statistics;
+	retval.registeredBuffers = m_buffers.size();
+	return retval;
+}
+
+} // end namespace asset
+} // end namespace irr
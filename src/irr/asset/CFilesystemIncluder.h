@@ -4,6 +4,9 @@
 #include "irr/asset/IIncluder.h"
 #include "IFileSystem.h"
 
+#include <sys/types.h>
+#include <sys/stat.h>
+
 namespace irr { namespace asset
 {
 
@@ -33,6 +36,25 @@ public:
         return contents;
     }
 
+    //! Modification time of the file mixed with its size, or 0 if it's not a file on disk (i.e. lives in an archive)
+    /** The size is there because the modification time can be as coarse as a second (always on Windows),
+    so an edit made within the same second as the previous read would otherwise go unnoticed. */
+    uint64_t getIncludeTimestamp_internal(const std::string& _path) const override
+    {
+#ifdef _IRR_WINDOWS_API_
+        struct _stat64 buf;
+        if (_stat64(_path.c_str(), &buf) != 0)
+            return 0ull;
+        const uint64_t mtime = static_cast<uint64_t>(buf.st_mtime)*1000000000ull;
+#else
+        struct stat buf;
+        if (stat(_path.c_str(), &buf) != 0)
+            return 0ull;
+        const uint64_t mtime = static_cast<uint64_t>(buf.st_mtim.tv_sec)*1000000000ull+static_cast<uint64_t>(buf.st_mtim.tv_nsec);
+#endif
+        return mtime^(static_cast<uint64_t>(buf.st_size)*0x9E3779B97F4A7C15ull);
+    }
+
 private:
     io::IFileSystem* m_filesystem;
 };
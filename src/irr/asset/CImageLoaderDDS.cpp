@@ -14,6 +14,7 @@
 
 #ifdef _IRR_COMPILE_WITH_DDS_LOADER_
 
+#include <algorithm>
 #include <utility>
 #include "IReadFile.h"
 #include "os.h"
@@ -29,6 +30,71 @@ namespace asset
 
 static int32_t DDSLittleLong( int32_t src ) { return src; }
 
+namespace
+{
+	struct SDXGIFormat
+	{
+		uint32_t dxgiFormat;
+		asset::E_FORMAT format;
+	};
+	// first match wins in both directions, so BC1 loads as the RGBA variant but either variant can be written
+	const SDXGIFormat DXGIFormats[] = {
+		{2u, asset::EF_R32G32B32A32_SFLOAT},
+		{10u, asset::EF_R16G16B16A16_SFLOAT},
+		{11u, asset::EF_R16G16B16A16_UNORM},
+		{24u, asset::EF_A2B10G10R10_UNORM_PACK32},
+		{26u, asset::EF_B10G11R11_UFLOAT_PACK32},
+		{28u, asset::EF_R8G8B8A8_UNORM},
+		{29u, asset::EF_R8G8B8A8_SRGB},
+		{34u, asset::EF_R16G16_SFLOAT},
+		{35u, asset::EF_R16G16_UNORM},
+		{41u, asset::EF_R32_SFLOAT},
+		{49u, asset::EF_R8G8_UNORM},
+		{54u, asset::EF_R16_SFLOAT},
+		{56u, asset::EF_R16_UNORM},
+		{61u, asset::EF_R8_UNORM},
+		{67u, asset::EF_E5B9G9R9_UFLOAT_PACK32},
+		{71u, asset::EF_BC1_RGBA_UNORM_BLOCK},
+		{71u, asset::EF_BC1_RGB_UNORM_BLOCK},
+		{72u, asset::EF_BC1_RGBA_SRGB_BLOCK},
+		{72u, asset::EF_BC1_RGB_SRGB_BLOCK},
+		{74u, asset::EF_BC2_UNORM_BLOCK},
+		{75u, asset::EF_BC2_SRGB_BLOCK},
+		{77u, asset::EF_BC3_UNORM_BLOCK},
+		{78u, asset::EF_BC3_SRGB_BLOCK},
+		{80u, asset::EF_BC4_UNORM_BLOCK},
+		{81u, asset::EF_BC4_SNORM_BLOCK},
+		{83u, asset::EF_BC5_UNORM_BLOCK},
+		{84u, asset::EF_BC5_SNORM_BLOCK},
+		{87u, asset::EF_B8G8R8A8_UNORM},
+		{91u, asset::EF_B8G8R8A8_SRGB},
+		{95u, asset::EF_BC6H_UFLOAT_BLOCK},
+		{96u, asset::EF_BC6H_SFLOAT_BLOCK},
+		{98u, asset::EF_BC7_UNORM_BLOCK},
+		{99u, asset::EF_BC7_SRGB_BLOCK}
+	};
+}
+
+asset::E_FORMAT CImageLoaderDDS::getFormatFromDXGI(uint32_t _dxgiFormat)
+{
+	for (const auto& entry : DXGIFormats)
+	{
+		if (entry.dxgiFormat==_dxgiFormat)
+			return entry.format;
+	}
+	return asset::EF_UNKNOWN;
+}
+
+uint32_t CImageLoaderDDS::getDXGIFromFormat(asset::E_FORMAT _fmt)
+{
+	for (const auto& entry : DXGIFormats)
+	{
+		if (entry.format==_fmt)
+			return entry.dxgiFormat;
+	}
+	return 0u;
+}
+
 static bool DDSGetInfo(CImageLoaderDDS::ddsBuffer *dds, int32_t *width, int32_t *height, int32_t *depth, CImageLoaderDDS::eDDSPixelFormat *pf )
 {
 	if(	dds == NULL || pf == NULL )
@@ -96,6 +162,12 @@ static bool DDSGetInfo(CImageLoaderDDS::ddsBuffer *dds, int32_t *width, int32_t
 		*pf = CImageLoaderDDS::DDS_PF_DXT4;
 	else if( fourCC == *((uint32_t*) "DXT5") )
 		*pf = CImageLoaderDDS::DDS_PF_DXT5;
+	else if( fourCC == *((uint32_t*) "ATI1") || fourCC == *((uint32_t*) "BC4U") )
+		*pf = CImageLoaderDDS::DDS_PF_ATI1;
+	else if( fourCC == *((uint32_t*) "ATI2") || fourCC == *((uint32_t*) "BC5U") )
+		*pf = CImageLoaderDDS::DDS_PF_ATI2;
+	else if( fourCC == *((uint32_t*) "DX10") )
+		*pf = CImageLoaderDDS::DDS_PF_DX10;
 	else
 		return false;
 	
@@ -123,6 +195,7 @@ bool CImageLoaderDDS::isALoadableFileFormat(io::IReadFile* _file) const
 //! creates a surface from the file
 asset::SAssetBundle CImageLoaderDDS::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
+	IRR_PROFILE_ZONE("CImageLoaderDDS::loadAsset");
 	core::vector<asset::CImageData*> images;
 
     CImageLoaderDDS::eDDSPixelFormat pixelFormat;
@@ -133,6 +206,24 @@ asset::SAssetBundle CImageLoaderDDS::loadAsset(io::IReadFile* _file, const asset
 
 	if (DDSGetInfo(&header, &width, &height, &depth, &pixelFormat))
 	{
+		asset::E_FORMAT dx10Format = asset::EF_UNKNOWN;
+		if (pixelFormat==DDS_PF_DX10)
+		{
+			ddsHeaderDXT10 dx10Header;
+			_file->read(&dx10Header, sizeof(dx10Header));
+			dx10Format = getFormatFromDXGI(dx10Header.dxgiFormat);
+			if (dx10Format==asset::EF_UNKNOWN)
+			{
+				os::Printer::log("Unsupported DXGI format in DDS file.", _file->getFileName().c_str(), ELL_ERROR);
+				return {};
+			}
+			if (dx10Header.resourceDimension!=3u || dx10Header.arraySize>1u)//D3D10_RESOURCE_DIMENSION_TEXTURE2D
+			{
+				os::Printer::log("Only single 2D textures are supported in DDS files.", _file->getFileName().c_str(), ELL_ERROR);
+				return {};
+			}
+		}
+
 	    if (header.flags & 0x20000)//DDSD_MIPMAPCOUNT)
             mipmapCnt = header.mipMapCount;
 	    else
@@ -151,6 +242,9 @@ asset::SAssetBundle CImageLoaderDDS::loadAsset(io::IReadFile* _file, const asset
                 case DDS_PF_DXT3:
                 case DDS_PF_DXT4:
                 case DDS_PF_DXT5:
+                case DDS_PF_ATI1:
+                case DDS_PF_ATI2:
+                case DDS_PF_DX10:
                     tmpWidth = width;
                     break;
                 default:
@@ -159,14 +253,11 @@ asset::SAssetBundle CImageLoaderDDS::loadAsset(io::IReadFile* _file, const asset
             }
             uint32_t& tmpHeight = mipSize[1];
             uint32_t& tmpDepth = mipSize[2];
-            tmpWidth += (uint32_t(1)<<i)-1;
-            tmpHeight += (uint32_t(1)<<i)-1;
-            if (false) //! Should only happen for 3D textures
-                tmpDepth += (uint32_t(1)<<i)-1;
-            tmpWidth /= uint32_t(1)<<i;
-            tmpHeight /= uint32_t(1)<<i;
+            // mip levels round down and stop at 1, rounding up would misread every level past the first odd size
+            tmpWidth = std::max(tmpWidth>>i, 1u);
+            tmpHeight = std::max(tmpHeight>>i, 1u);
             if (false) //! should only happen for 3D textures
-                tmpDepth /= uint32_t(1)<<i;
+                tmpDepth = std::max(tmpDepth>>i, 1u);
 
             /* decompress */
             asset::E_FORMAT colorFormat = asset::EF_UNKNOWN;
@@ -243,6 +334,23 @@ asset::SAssetBundle CImageLoaderDDS::loadAsset(io::IReadFile* _file, const asset
                     }
                     break;
 
+                case DDS_PF_ATI1:
+                case DDS_PF_ATI2:
+                case DDS_PF_DX10:
+                    {
+                        if (pixelFormat==CImageLoaderDDS::DDS_PF_ATI1)
+                            colorFormat = asset::EF_BC4_UNORM_BLOCK;
+                        else if (pixelFormat==CImageLoaderDDS::DDS_PF_ATI2)
+                            colorFormat = asset::EF_BC5_UNORM_BLOCK;
+                        else
+                            colorFormat = dx10Format;
+
+                        asset::CImageData* data = new asset::CImageData(NULL,zeroDummy,mipSize,i,colorFormat,1);
+                        _file->read(data->getData(),data->getImageDataSizeInBytes());
+                        images.push_back(data);
+                    }
+                    break;
+
                 default:
 					{
 						os::Printer::log("Unsupported DDS texture format, 16bit uncompressed is not an option here.", ELL_ERROR);
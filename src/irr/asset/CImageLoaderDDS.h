@@ -10,6 +10,7 @@
 #if defined(_IRR_COMPILE_WITH_DDS_LOADER_)
 
 #include "irr/asset/IAssetLoader.h"
+#include "irr/asset/format/EFormat.h"
 
 namespace irr
 {
@@ -38,6 +39,10 @@ public:
         DDS_PF_DXT3,
         DDS_PF_DXT4,
         DDS_PF_DXT5,
+        DDS_PF_ATI1,
+        DDS_PF_ATI2,
+        //! format given by the DXGI format of the extended header
+        DDS_PF_DX10,
         DDS_PF_UNKNOWN
     };
 
@@ -160,6 +165,15 @@ public:
         uint8_t		data[4];
     } PACK_STRUCT;
 
+    //! Follows the main header when the FourCC is 'DX10'
+    struct ddsHeaderDXT10
+    {
+        uint32_t		dxgiFormat;
+        uint32_t		resourceDimension;
+        uint32_t		miscFlag;
+        uint32_t		arraySize;
+        uint32_t		miscFlags2;
+    } PACK_STRUCT;
 
 #include "irr/irrunpack.h"
 
@@ -181,6 +195,11 @@ public:
 
     virtual uint64_t getSupportedAssetTypesBitfield() const override { return asset::IAsset::ET_IMAGE; }
 
+    //! Maps a DXGI_FORMAT value of the extended header to our format, EF_UNKNOWN if there is no equivalent
+    static asset::E_FORMAT getFormatFromDXGI(uint32_t _dxgiFormat);
+    //! Inverse of getFormatFromDXGI, 0 (DXGI_FORMAT_UNKNOWN) if `_fmt` cannot be stored in a DDS file
+    static uint32_t getDXGIFromFormat(asset::E_FORMAT _fmt);
+
     virtual asset::SAssetBundle loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override = nullptr, uint32_t _hierarchyLevel = 0u) override;
 };
 
@@ -0,0 +1,230 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "CImageLoaderHDR.h"
+
+#ifdef _IRR_COMPILE_WITH_HDR_LOADER_
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "IReadFile.h"
+#include "os.h"
+#include "irr/asset/format/EFormat.h"
+#include "irr/asset/ICPUTexture.h"
+#include "irr/core/parallel/parallel_for.h"
+
+namespace irr
+{
+namespace asset
+{
+
+namespace
+{
+	//! Returns the next line without its line feed and moves `_pos` past it, false if the data ends first
+	bool readLine(const core::vector<uint8_t>& _data, size_t& _pos, std::string& _line)
+	{
+		const uint8_t* begin = _data.data()+_pos;
+		const uint8_t* end = reinterpret_cast<const uint8_t*>(memchr(begin, '\n', _data.size()-_pos));
+		if (!end)
+			return false;
+		_line.assign(begin, end);
+		_pos += end-begin+1u;
+		return true;
+	}
+
+	//! Decodes one scanline of RGBE texels, in any of the three encodings Radiance writes
+	bool decodeScanline(const core::vector<uint8_t>& _data, size_t& _pos, uint8_t* _out, uint32_t _width)
+	{
+		const uint8_t* in = _data.data()+_pos;
+		const uint8_t* const inEnd = _data.data()+_data.size();
+
+		// the newer per-channel run length encoding starts with 2,2 and the scanline width
+		if (_width>=8u && _width<0x8000u && inEnd-in>=4 && in[0]==2u && in[1]==2u && !(in[2]&0x80u))
+		{
+			if ((uint32_t(in[2])<<8u|in[3])!=_width)
+				return false;
+			in += 4;
+			for (uint32_t c=0u; c<4u; c++)
+			for (uint32_t x=0u; x<_width;)
+			{
+				if (in>=inEnd)
+					return false;
+				uint32_t count = *(in++);
+				if (count>128u)
+				{
+					count -= 128u;
+					if (x+count>_width || in>=inEnd)
+						return false;
+					const uint8_t value = *(in++);
+					for (uint32_t end=x+count; x<end; x++)
+						_out[4u*x+c] = value;
+				}
+				else
+				{
+					if (!count || x+count>_width || inEnd-in<count)
+						return false;
+					for (uint32_t end=x+count; x<end; x++)
+						_out[4u*x+c] = *(in++);
+				}
+			}
+			_pos = in-_data.data();
+			return true;
+		}
+
+		// flat texels, where 1,1,1,n repeats the previous texel n times (times 256 for every consecutive repeat)
+		uint32_t shift = 0u;
+		for (uint32_t x=0u; x<_width;)
+		{
+			if (inEnd-in<4)
+				return false;
+			if (in[0]==1u && in[1]==1u && in[2]==1u)
+			{
+				if (!x)
+					return false;
+				const uint32_t count = uint32_t(in[3])<<shift;
+				if (x+count>_width)
+					return false;
+				for (uint32_t end=x+count; x<end; x++)
+					memcpy(_out+4u*x, _out+4u*(x-1u), 4u);
+				shift += 8u;
+			}
+			else
+			{
+				memcpy(_out+4u*x, in, 4u);
+				x++;
+				shift = 0u;
+			}
+			in += 4;
+		}
+		_pos = in-_data.data();
+		return true;
+	}
+
+	//! Converts RGBE texels to RGBA floats, (mantissa+0.5)*2^(exponent-136) like Radiance itself does
+	void convertRGBE(const uint8_t* _in, float* _out, uint32_t _count)
+	{
+		uint32_t i = 0u;
+#ifdef __IRR_COMPILE_WITH_X86_SIMD_
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 one = _mm_set1_ps(1.f);
+		const __m128 mantissaScale = _mm_set1_ps(1.f/256.f);
+		const __m128i bias = _mm_set1_epi32(1);
+		const __m128i zero = _mm_setzero_si128();
+		for (; i<_count; i++)
+		{
+			int32_t texel;
+			memcpy(&texel, _in+4u*i, 4u);
+			const __m128i channels = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(texel));
+			// 2^(e-128) made straight in the float exponent bits, an exponent of 0 (black) gives 0 and so does 1, the only one below 2^-126
+			const __m128i exponent = _mm_shuffle_epi32(channels, _MM_SHUFFLE(3,3,3,3));
+			const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_max_epi32(_mm_sub_epi32(exponent, bias), zero), 23));
+			const __m128 rgb = _mm_mul_ps(_mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(channels), half), mantissaScale), scale);
+			_mm_storeu_ps(_out+4u*i, _mm_blend_ps(rgb, one, 0x8));
+		}
+#endif
+		for (; i<_count; i++)
+		{
+			const uint8_t* texel = _in+4u*i;
+			float* out = _out+4u*i;
+			const float scale = texel[3]>1u ? std::ldexp(1.f, int32_t(texel[3])-136):0.f;
+			for (uint32_t c=0u; c<3u; c++)
+				out[c] = (float(texel[c])+0.5f)*scale;
+			out[3] = 1.f;
+		}
+	}
+}
+
+bool CImageLoaderHDR::isALoadableFileFormat(io::IReadFile* _file) const
+{
+	if (!_file)
+		return false;
+
+	const size_t prevPos = _file->getPos();
+
+	char magic[10];
+	const int32_t readCount = _file->read(magic, sizeof(magic));
+	_file->seek(prevPos);
+
+	return	(readCount>=10 && memcmp(magic, "#?RADIANCE", 10)==0) ||
+			(readCount>=6 && memcmp(magic, "#?RGBE", 6)==0);
+}
+
+asset::SAssetBundle CImageLoaderHDR::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
+{
+	IRR_PROFILE_ZONE("CImageLoaderHDR::loadAsset");
+	const char* filename = _file->getFileName().c_str();
+
+	core::vector<uint8_t> data(_file->getSize());
+	_file->seek(0u);
+	for (size_t pos=0u; pos<data.size();)
+	{
+		const uint32_t chunk = static_cast<uint32_t>(std::min<size_t>(data.size()-pos, 0x40000000u));
+		if (_file->read(data.data()+pos, chunk)!=static_cast<int32_t>(chunk))
+		{
+			os::Printer::log("Could not read HDR file.", filename, ELL_ERROR);
+			return {};
+		}
+		pos += chunk;
+	}
+
+	// header lines up to an empty one, then the resolution string
+	size_t pos = 0u;
+	std::string line;
+	if (!readLine(data, pos, line) || line.compare(0u, 2u, "#?")!=0)
+	{
+		os::Printer::log("Not a Radiance HDR file.", filename, ELL_ERROR);
+		return {};
+	}
+	while (readLine(data, pos, line) && !line.empty())
+	{
+		if (line.compare(0u, 7u, "FORMAT=")==0 && line!="FORMAT=32-bit_rle_rgbe")
+		{
+			os::Printer::log("Only RGBE HDR files are supported, not", line.c_str(), ELL_ERROR);
+			return {};
+		}
+	}
+
+	char ySign, yAxis, xSign, xAxis;
+	uint32_t width = 0u, height = 0u;
+	if (!readLine(data, pos, line) || sscanf(line.c_str(), "%c%c %u %c%c %u", &ySign, &yAxis, &height, &xSign, &xAxis, &width)!=6 ||
+		yAxis!='Y' || xAxis!='X' || (ySign!='-'&&ySign!='+') || xSign!='+' || !width || !height || width>0x10000u || height>0x10000u)
+	{
+		os::Printer::log("Unsupported HDR resolution string", line.c_str(), ELL_ERROR);
+		return {};
+	}
+
+	core::vector<uint8_t> rgbe(size_t(width)*height*4ull);
+	for (uint32_t y=0u; y<height; y++)
+	if (!decodeScanline(data, pos, rgbe.data()+size_t(y)*width*4ull, width))
+	{
+		os::Printer::log("Corrupt or truncated HDR scanline data.", filename, ELL_ERROR);
+		return {};
+	}
+
+	const uint32_t zero[3] = {0u, 0u, 0u};
+	const uint32_t size[3] = {width, height, 1u};
+	asset::CImageData* image = new asset::CImageData(nullptr, zero, size, 0u, asset::EF_R32G32B32A32_SFLOAT, 1u);
+	const size_t pitch = image->getPitchIncludingAlignment();
+	uint8_t* out = reinterpret_cast<uint8_t*>(image->getData());
+	// "+Y" files store the bottom row first
+	const bool flip = ySign=='+';
+	core::parallel_for(0u, height, [&](size_t y) -> void
+	{
+		const size_t outRow = flip ? (height-1u-y):y;
+		convertRGBE(rgbe.data()+y*width*4ull, reinterpret_cast<float*>(out+outRow*pitch), width);
+	}, 0u, 16ull);
+
+	asset::ICPUTexture* tex = asset::ICPUTexture::create({image}, _file->getFileName().c_str(), video::ITexture::ETT_2D);
+	image->drop();
+	if (!tex)
+		return {};
+	return SAssetBundle({core::smart_refctd_ptr<IAsset>(tex, core::dont_grab)});
+}
+
+} // end namespace asset
+} // end namespace irr
+
+#endif
@@ -0,0 +1,43 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_IMAGE_LOADER_HDR_H_INCLUDED__
+#define __IRR_C_IMAGE_LOADER_HDR_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_HDR_LOADER_
+
+#include "irr/asset/IAssetLoader.h"
+
+namespace irr
+{
+namespace asset
+{
+
+//! Loader for Radiance RGBE (.hdr) images, flat or run length encoded
+/** Images are decoded to EF_R32G32B32A32_SFLOAT with an alpha of 1, top row first whichever way the file stores them.
+The scanlines are decompressed in order (their lengths are only known after decoding) and then converted to float by all threads, with SIMD.
+XYZE files and resolution strings with a rotated image (X before Y) are rejected.*/
+class CImageLoaderHDR : public asset::IAssetLoader
+{
+public:
+	virtual bool isALoadableFileFormat(io::IReadFile* _file) const override;
+
+	virtual const char** getAssociatedFileExtensions() const override
+	{
+		static const char* ext[]{ "hdr", "rgbe", nullptr };
+		return ext;
+	}
+
+	virtual uint64_t getSupportedAssetTypesBitfield() const override { return asset::IAsset::ET_IMAGE; }
+
+	virtual asset::SAssetBundle loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override = nullptr, uint32_t _hierarchyLevel = 0u) override;
+};
+
+} // end namespace asset
+} // end namespace irr
+
+#endif
+#endif
@@ -162,6 +162,7 @@ bool CImageLoaderJPG::isALoadableFileFormat(io::IReadFile* _file) const
 //! creates a surface from the file
 asset::SAssetBundle CImageLoaderJPG::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
+	IRR_PROFILE_ZONE("CImageLoaderJPG::loadAsset");
 #ifndef _IRR_COMPILE_WITH_LIBJPEG_
 	os::Printer::log("Can't load as not compiled with _IRR_COMPILE_WITH_LIBJPEG_:", _file->getFileName().c_str(), ELL_DEBUG);
 	return nullptr
@@ -0,0 +1,351 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "CImageLoaderKTX2.h"
+
+#ifdef _IRR_COMPILE_WITH_KTX2_LOADER_
+
+#include <atomic>
+
+#include "IReadFile.h"
+#include "os.h"
+#include "irr/core/parallel/parallel_for.h"
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	#include "zlib/zlib.h"
+#endif
+
+namespace irr
+{
+namespace asset
+{
+
+namespace
+{
+	static_assert(sizeof(CImageLoaderKTX2::SFileHeader)==80u, "KTX2 header must match the file layout");
+	static_assert(sizeof(CImageLoaderKTX2::SLevelIndexEntry)==24u, "KTX2 level index entry must match the file layout");
+
+	// E_FORMAT keeps the VkFormat order inside each of these groups, only the groups are arranged differently
+	static_assert(EF_E5B9G9R9_UFLOAT_PACK32-EF_R4G4_UNORM_PACK8==122, "E_FORMAT no longer matches VkFormat 1-123");
+	static_assert(EF_D32_SFLOAT_S8_UINT-EF_D16_UNORM==6, "E_FORMAT no longer matches VkFormat 124-130");
+	static_assert(EF_BC7_SRGB_BLOCK-EF_BC1_RGB_UNORM_BLOCK==15, "E_FORMAT no longer matches VkFormat 131-146");
+	static_assert(EF_EAC_R11G11_SNORM_BLOCK-EF_ETC2_R8G8B8_UNORM_BLOCK==9, "E_FORMAT no longer matches VkFormat 147-156");
+	static_assert(EF_ASTC_12x12_SRGB_BLOCK-EF_ASTC_4x4_UNORM_BLOCK==27, "E_FORMAT no longer matches VkFormat 157-184");
+	static_assert(EF_PVRTC2_4BPP_SRGB_BLOCK_IMG-EF_PVRTC1_2BPP_UNORM_BLOCK_IMG==7, "E_FORMAT no longer matches VkFormat 1000054000-1000054007");
+
+	struct SFormatRange
+	{
+		uint32_t firstVkFormat;
+		E_FORMAT first;
+		E_FORMAT last;
+	};
+	const SFormatRange FormatRanges[] = {
+		{1u, EF_R4G4_UNORM_PACK8, EF_E5B9G9R9_UFLOAT_PACK32},
+		{124u, EF_D16_UNORM, EF_D32_SFLOAT_S8_UINT},
+		{131u, EF_BC1_RGB_UNORM_BLOCK, EF_BC7_SRGB_BLOCK},
+		{147u, EF_ETC2_R8G8B8_UNORM_BLOCK, EF_EAC_R11G11_SNORM_BLOCK},
+		{157u, EF_ASTC_4x4_UNORM_BLOCK, EF_ASTC_12x12_SRGB_BLOCK},
+		{1000054000u, EF_PVRTC1_2BPP_UNORM_BLOCK_IMG, EF_PVRTC2_4BPP_SRGB_BLOCK_IMG}
+	};
+
+	//! IReadFile::read takes 32bit sizes, large levels need several calls
+	bool readFully(io::IReadFile* _file, void* _dst, size_t _size)
+	{
+		uint8_t* dst = reinterpret_cast<uint8_t*>(_dst);
+		while (_size)
+		{
+			const uint32_t chunk = static_cast<uint32_t>(std::min<size_t>(_size, 0x40000000u));
+			if (_file->read(dst, chunk)!=static_cast<int32_t>(chunk))
+				return false;
+			dst += chunk;
+			_size -= chunk;
+		}
+		return true;
+	}
+
+	CImageData* createLevelImage(const CImageLoaderKTX2::SHeader& _header, uint32_t _level)
+	{
+		const uint32_t zero[3] = {0u, 0u, 0u};
+		uint32_t extent[3];
+		CImageLoaderKTX2::getLevelExtent(_header, _level, extent);
+		return new CImageData(nullptr, zero, extent, _level, _header.format, 1u);
+	}
+
+	//! Checks the level index describes exactly the data CImageData expects, so levels can be read without any further checks
+	bool validateLevelSize(const CImageLoaderKTX2::SHeader& _header, uint32_t _level, const CImageData* _image)
+	{
+		const auto& entry = _header.levels[_level];
+		const uint64_t expected = _image->getImageDataSizeInBytes();
+		if (_header.supercompressionScheme==CImageLoaderKTX2::ESS_NONE)
+			return entry.byteLength==expected;
+		return entry.uncompressedByteLength==expected;
+	}
+
+	bool inflateLevel(const void* _src, size_t _srcSize, CImageData* _image)
+	{
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+		uLongf dstSize = static_cast<uLongf>(_image->getImageDataSizeInBytes());
+		const int err = uncompress(reinterpret_cast<Bytef*>(_image->getData()), &dstSize, reinterpret_cast<const Bytef*>(_src), static_cast<uLong>(_srcSize));
+		return err==Z_OK && dstSize==_image->getImageDataSizeInBytes();
+#else
+		return false;
+#endif
+	}
+}
+
+const uint8_t CImageLoaderKTX2::Identifier[12] = {0xABu, 0x4Bu, 0x54u, 0x58u, 0x20u, 0x32u, 0x30u, 0xBBu, 0x0Du, 0x0Au, 0x1Au, 0x0Au};
+
+E_FORMAT CImageLoaderKTX2::getFormatFromVkFormat(uint32_t _vkFormat)
+{
+	for (const auto& range : FormatRanges)
+	{
+		if (_vkFormat>=range.firstVkFormat && _vkFormat<=range.firstVkFormat+(range.last-range.first))
+			return static_cast<E_FORMAT>(range.first+(_vkFormat-range.firstVkFormat));
+	}
+	return EF_UNKNOWN;
+}
+
+uint32_t CImageLoaderKTX2::getVkFormatFromFormat(E_FORMAT _format)
+{
+	switch (_format)
+	{
+		// the memory layout of these depends on the implementation, KTX2 prohibits them
+		case EF_D16_UNORM_S8_UINT:
+		case EF_D24_UNORM_S8_UINT:
+		case EF_D32_SFLOAT_S8_UINT:
+			return 0u;
+		default:
+			break;
+	}
+	// KTX2 prohibits the A8B8G8R8 packed formats in favour of R8G8B8A8 which has identical memory layout
+	if (_format>=EF_A8B8G8R8_UNORM_PACK32 && _format<=EF_A8B8G8R8_SRGB_PACK32)
+		return getVkFormatFromFormat(static_cast<E_FORMAT>(EF_R8G8B8A8_UNORM+(_format-EF_A8B8G8R8_UNORM_PACK32)));
+
+	for (const auto& range : FormatRanges)
+	{
+		if (_format>=range.first && _format<=range.last)
+			return range.firstVkFormat+(_format-range.first);
+	}
+	return 0u;
+}
+
+void CImageLoaderKTX2::getLevelExtent(const SHeader& _header, uint32_t _level, uint32_t _extent[3])
+{
+	const uint32_t layers = std::max(_header.layerCount, 1u)*_header.faceCount;
+	_extent[0] = std::max(_header.pixelWidth>>_level, 1u);
+	if (!_header.pixelHeight)
+	{
+		_extent[1] = layers;
+		_extent[2] = 1u;
+	}
+	else if (_header.pixelDepth)
+	{
+		_extent[1] = std::max(_header.pixelHeight>>_level, 1u);
+		_extent[2] = std::max(_header.pixelDepth>>_level, 1u);
+	}
+	else
+	{
+		_extent[1] = std::max(_header.pixelHeight>>_level, 1u);
+		_extent[2] = layers;
+	}
+}
+
+bool CImageLoaderKTX2::isALoadableFileFormat(io::IReadFile* _file) const
+{
+	if (!_file)
+		return false;
+
+	const size_t prevPos = _file->getPos();
+
+	uint8_t identifier[sizeof(Identifier)];
+	const bool readAll = _file->read(identifier, sizeof(identifier))==static_cast<int32_t>(sizeof(identifier));
+	_file->seek(prevPos);
+
+	return readAll && memcmp(identifier, Identifier, sizeof(Identifier))==0;
+}
+
+bool CImageLoaderKTX2::readHeader(io::IReadFile* _file, SHeader& _header)
+{
+	const char* filename = _file->getFileName().c_str();
+
+	SFileHeader fileHeader;
+	_file->seek(0u);
+	if (!readFully(_file, &fileHeader, sizeof(fileHeader)) || memcmp(fileHeader.identifier, Identifier, sizeof(Identifier))!=0)
+	{
+		os::Printer::log("Not a KTX2 file.", filename, ELL_ERROR);
+		return false;
+	}
+
+	_header.format = getFormatFromVkFormat(fileHeader.vkFormat);
+	if (_header.format==EF_UNKNOWN)
+	{
+		// VK_FORMAT_UNDEFINED is what Basis Universal payloads use
+		os::Printer::log("Unsupported VkFormat in KTX2 file.", filename, ELL_ERROR);
+		return false;
+	}
+
+	switch (fileHeader.supercompressionScheme)
+	{
+		case ESS_NONE:
+			break;
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+		case ESS_ZLIB:
+			break;
+#endif
+		default:
+			os::Printer::log("Unsupported supercompression scheme in KTX2 file.", filename, ELL_ERROR);
+			return false;
+	}
+
+	_header.typeSize = fileHeader.typeSize;
+	_header.pixelWidth = fileHeader.pixelWidth;
+	_header.pixelHeight = fileHeader.pixelHeight;
+	_header.pixelDepth = fileHeader.pixelDepth;
+	_header.layerCount = fileHeader.layerCount;
+	_header.faceCount = fileHeader.faceCount;
+	_header.supercompressionScheme = fileHeader.supercompressionScheme;
+	// 0 asks for the mips to be generated after loading, there is still exactly one level stored
+	_header.levelCount = std::max(fileHeader.levelCount, 1u);
+
+	const bool isCube = _header.faceCount==6u;
+	if (!_header.pixelWidth || (_header.pixelDepth && !_header.pixelHeight) || (_header.faceCount!=1u && !isCube) ||
+		(isCube && (_header.pixelWidth!=_header.pixelHeight || _header.pixelDepth)) || (_header.pixelDepth && _header.layerCount))
+	{
+		os::Printer::log("Invalid or unsupported dimensions in KTX2 file.", filename, ELL_ERROR);
+		return false;
+	}
+	if (_header.levelCount>1u+core::findMSB(std::max(std::max(_header.pixelWidth, _header.pixelHeight), _header.pixelDepth)))
+	{
+		os::Printer::log("More mip levels than the dimensions allow in KTX2 file.", filename, ELL_ERROR);
+		return false;
+	}
+
+	if (isCube)
+		_header.type = _header.layerCount ? video::ITexture::ETT_CUBE_MAP_ARRAY:video::ITexture::ETT_CUBE_MAP;
+	else if (_header.pixelDepth)
+		_header.type = video::ITexture::ETT_3D;
+	else if (!_header.pixelHeight)
+		_header.type = _header.layerCount ? video::ITexture::ETT_1D_ARRAY:video::ITexture::ETT_1D;
+	else
+		_header.type = _header.layerCount ? video::ITexture::ETT_2D_ARRAY:video::ITexture::ETT_2D;
+
+	_header.levels.resize(_header.levelCount);
+	if (!readFully(_file, _header.levels.data(), _header.levels.size()*sizeof(SLevelIndexEntry)))
+	{
+		os::Printer::log("Truncated level index in KTX2 file.", filename, ELL_ERROR);
+		return false;
+	}
+	const uint64_t fileSize = _file->getSize();
+	for (const auto& level : _header.levels)
+	{
+		if (level.byteOffset>fileSize || level.byteLength>fileSize-level.byteOffset)
+		{
+			os::Printer::log("Level data outside of the KTX2 file.", filename, ELL_ERROR);
+			return false;
+		}
+	}
+	return true;
+}
+
+CImageData* CImageLoaderKTX2::readLevel(io::IReadFile* _file, const SHeader& _header, uint32_t _level)
+{
+	if (_level>=_header.levelCount)
+		return nullptr;
+
+	CImageData* image = createLevelImage(_header, _level);
+	bool success = validateLevelSize(_header, _level, image);
+
+	const auto& entry = _header.levels[_level];
+	if (success)
+	{
+		_file->seek(static_cast<size_t>(entry.byteOffset));
+		if (_header.supercompressionScheme==ESS_NONE)
+			success = readFully(_file, image->getData(), static_cast<size_t>(entry.byteLength));
+		else
+		{
+			core::vector<uint8_t> compressed(static_cast<size_t>(entry.byteLength));
+			success = readFully(_file, compressed.data(), compressed.size()) && inflateLevel(compressed.data(), compressed.size(), image);
+		}
+	}
+
+	if (!success)
+	{
+		os::Printer::log("Could not read level of KTX2 file.", _file->getFileName().c_str(), ELL_ERROR);
+		image->drop();
+		return nullptr;
+	}
+	return image;
+}
+
+asset::SAssetBundle CImageLoaderKTX2::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
+{
+	IRR_PROFILE_ZONE("CImageLoaderKTX2::loadAsset");
+	SHeader header;
+	if (!readHeader(_file, header))
+		return {};
+
+	core::vector<CImageData*> images(header.levelCount, nullptr);
+	auto dropImages = [&images]() -> void
+	{
+		for (auto image : images)
+		if (image)
+			image->drop();
+	};
+
+	if (header.supercompressionScheme==ESS_NONE)
+	{
+		// smallest level first, which is the order of the data in the file
+		for (uint32_t i=header.levelCount; i--;)
+		{
+			images[i] = readLevel(_file, header, i);
+			if (!images[i])
+			{
+				dropImages();
+				return {};
+			}
+		}
+	}
+	else
+	{
+		// read sequentially, then inflate all the levels at once
+		core::vector<core::vector<uint8_t> > compressed(header.levelCount);
+		for (uint32_t i=header.levelCount; i--;)
+		{
+			images[i] = createLevelImage(header, i);
+			compressed[i].resize(static_cast<size_t>(header.levels[i].byteLength));
+			_file->seek(static_cast<size_t>(header.levels[i].byteOffset));
+			if (!validateLevelSize(header, i, images[i]) || !readFully(_file, compressed[i].data(), compressed[i].size()))
+			{
+				os::Printer::log("Could not read level of KTX2 file.", _file->getFileName().c_str(), ELL_ERROR);
+				dropImages();
+				return {};
+			}
+		}
+
+		std::atomic<bool> success(true);
+		core::parallel_for(0u, header.levelCount, [&](size_t i) -> void
+		{
+			if (!inflateLevel(compressed[i].data(), compressed[i].size(), images[i]))
+				success = false;
+		});
+		if (!success)
+		{
+			os::Printer::log("Could not inflate level of KTX2 file.", _file->getFileName().c_str(), ELL_ERROR);
+			dropImages();
+			return {};
+		}
+	}
+
+	asset::ICPUTexture* tex = asset::ICPUTexture::create(images, _file->getFileName().c_str(), header.type);
+	dropImages();
+	if (!tex)
+		return {};
+
+	return SAssetBundle({core::smart_refctd_ptr<IAsset>(tex, core::dont_grab)});
+}
+
+} // end namespace asset
+} // end namespace irr
+
+#endif
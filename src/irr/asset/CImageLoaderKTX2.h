@@ -0,0 +1,120 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_IMAGE_LOADER_KTX2_H_INCLUDED__
+#define __IRR_C_IMAGE_LOADER_KTX2_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_KTX2_LOADER_
+
+#include "irr/asset/IAssetLoader.h"
+#include "irr/asset/format/EFormat.h"
+#include "irr/asset/ICPUTexture.h"
+
+namespace irr
+{
+namespace asset
+{
+
+//! Loader for Khronos KTX2 files
+/** Every format with a VkFormat equivalent can be loaded, with any number of mip levels, array layers, cube faces or 3D slices.
+Level data is stored the way it gets uploaded, so uncompressed levels are read straight into the CImageData memory.
+Supercompression schemes supported are none and zlib, Zstandard and BasisLZ files are rejected.
+
+KTX2 stores the smallest level first, loadAsset() reads the levels in that order, and readHeader() with readLevel()
+allow fetching single levels without reading the rest of the file, e.g. to get the mip tail first.*/
+class CImageLoaderKTX2 : public asset::IAssetLoader
+{
+public:
+	enum E_SUPERCOMPRESSION_SCHEME : uint32_t
+	{
+		ESS_NONE = 0u,
+		ESS_BASIS_LZ = 1u,
+		ESS_ZSTANDARD = 2u,
+		ESS_ZLIB = 3u
+	};
+
+	//! The 12 bytes every KTX2 file starts with
+	static const uint8_t Identifier[12];
+
+	//! Header as laid out on disk, the level index follows it directly
+	struct SFileHeader
+	{
+		uint8_t identifier[12];
+		uint32_t vkFormat;
+		uint32_t typeSize;
+		uint32_t pixelWidth;
+		uint32_t pixelHeight;
+		uint32_t pixelDepth;
+		uint32_t layerCount;
+		uint32_t faceCount;
+		uint32_t levelCount;
+		uint32_t supercompressionScheme;
+		uint32_t dfdByteOffset;
+		uint32_t dfdByteLength;
+		uint32_t kvdByteOffset;
+		uint32_t kvdByteLength;
+		uint64_t sgdByteOffset;
+		uint64_t sgdByteLength;
+	};
+
+	struct SLevelIndexEntry
+	{
+		uint64_t byteOffset;
+		uint64_t byteLength;
+		uint64_t uncompressedByteLength;
+	};
+
+	//! The header, already validated and with the format translated
+	struct SHeader
+	{
+		E_FORMAT format;
+		uint32_t typeSize;
+		uint32_t pixelWidth;
+		uint32_t pixelHeight;
+		uint32_t pixelDepth;
+		uint32_t layerCount;
+		uint32_t faceCount;
+		uint32_t levelCount;
+		uint32_t supercompressionScheme;
+		video::ITexture::E_TEXTURE_TYPE type;
+		//! Level 0 first, although the data of level 0 is last in the file
+		core::vector<SLevelIndexEntry> levels;
+	};
+
+	virtual bool isALoadableFileFormat(io::IReadFile* _file) const override;
+
+	virtual const char** getAssociatedFileExtensions() const override
+	{
+		static const char* ext[]{ "ktx2", nullptr };
+		return ext;
+	}
+
+	virtual uint64_t getSupportedAssetTypesBitfield() const override { return asset::IAsset::ET_IMAGE; }
+
+	virtual asset::SAssetBundle loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override = nullptr, uint32_t _hierarchyLevel = 0u) override;
+
+	//! Reads and validates the header and level index from the start of `_file`
+	/** @returns false (after logging why) if the file is not a KTX2 file this loader can read.*/
+	static bool readHeader(io::IReadFile* _file, SHeader& _header);
+
+	//! Reads and (if needed) inflates one level, covering all of its layers, faces and slices
+	/** @returns CImageData with a reference count of 1, or nullptr on a read or decompression error.*/
+	static CImageData* readLevel(io::IReadFile* _file, const SHeader& _header, uint32_t _level);
+
+	//! Size of a whole level in a CImageData, with layers, faces and slices stacked along the first dimension that is not mipmapped
+	static void getLevelExtent(const SHeader& _header, uint32_t _level, uint32_t _extent[3]);
+
+	//! @returns EF_UNKNOWN if the VkFormat has no E_FORMAT equivalent.
+	static E_FORMAT getFormatFromVkFormat(uint32_t _vkFormat);
+	//! @returns 0 (VK_FORMAT_UNDEFINED) if the format cannot be stored in KTX2, which is the case for planar formats and packed depth-stencil.
+	static uint32_t getVkFormatFromFormat(E_FORMAT _format);
+};
+
+} // end namespace asset
+} // end namespace irr
+
+#endif
+#endif
@@ -0,0 +1,899 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "CImageLoaderOpenEXR.h"
+
+#ifdef _IRR_COMPILE_WITH_EXR_LOADER_
+
+#include <atomic>
+#include <cstring>
+
+#include "IReadFile.h"
+#include "os.h"
+#include "irr/asset/format/EFormat.h"
+#include "irr/asset/ICPUTexture.h"
+#include "irr/core/math/floatutil.h"
+#include "irr/core/parallel/parallel_for.h"
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	#include "zlib/zlib.h"
+#endif
+
+namespace irr
+{
+namespace asset
+{
+
+namespace
+{
+	enum E_PIXEL_TYPE : int32_t
+	{
+		EPT_UINT = 0,
+		EPT_HALF,
+		EPT_FLOAT
+	};
+
+	enum E_COMPRESSION : uint8_t
+	{
+		EC_NONE = 0,
+		EC_RLE,
+		EC_ZIPS,
+		EC_ZIP,
+		EC_PIZ
+	};
+
+	struct SChannel
+	{
+		std::string name;
+		E_PIXEL_TYPE type;
+		//! Bytes per texel
+		uint32_t size;
+	};
+
+	//! Bounds checked little endian reads from the file contents
+	class CReader
+	{
+		public:
+			CReader(const uint8_t* _begin, const uint8_t* _end) : m_pos(_begin), m_end(_end) {}
+
+			inline bool valid() const { return m_valid; }
+			inline const uint8_t* pos() const { return m_pos; }
+
+			template<typename T>
+			inline T read()
+			{
+				T retval = T(0);
+				if (!skip(sizeof(T)))
+					return retval;
+				memcpy(&retval, m_pos-sizeof(T), sizeof(T));
+				return retval;
+			}
+
+			inline std::string readString()
+			{
+				const uint8_t* end = m_valid ? reinterpret_cast<const uint8_t*>(memchr(m_pos, 0, m_end-m_pos)):nullptr;
+				if (!end)
+				{
+					m_valid = false;
+					return {};
+				}
+				std::string retval(m_pos, end);
+				m_pos = end+1;
+				return retval;
+			}
+
+			inline bool skip(size_t _bytes)
+			{
+				if (!m_valid || size_t(m_end-m_pos)<_bytes)
+					return m_valid = false;
+				m_pos += _bytes;
+				return true;
+			}
+
+		private:
+			const uint8_t* m_pos;
+			const uint8_t* m_end;
+			bool m_valid = true;
+	};
+
+	//! Undoes the byte delta predictor and the split of even and odd bytes which RLE and ZIP compression apply before compressing
+	void unpredictAndInterleave(uint8_t* _in, uint8_t* _out, size_t _size)
+	{
+		for (size_t i=1u; i<_size; i++)
+			_in[i] = static_cast<uint8_t>(int32_t(_in[i-1u])+int32_t(_in[i])-128);
+
+		const uint8_t* t1 = _in;
+		const uint8_t* t2 = _in+(_size+1u)/2u;
+		for (size_t i=0u; i<_size; i++)
+			_out[i] = i&1u ? *(t2++):*(t1++);
+	}
+
+	bool rleUncompress(const uint8_t* _in, size_t _inSize, uint8_t* _out, size_t _outSize)
+	{
+		const uint8_t* const inEnd = _in+_inSize;
+		uint8_t* const outEnd = _out+_outSize;
+		while (_in<inEnd)
+		{
+			const int32_t count = static_cast<int8_t>(*(_in++));
+			if (count<0)
+			{
+				if (inEnd-_in<-count || outEnd-_out<-count)
+					return false;
+				memcpy(_out, _in, -count);
+				_in += -count;
+				_out += -count;
+			}
+			else
+			{
+				if (_in==inEnd || outEnd-_out<count+1)
+					return false;
+				memset(_out, *(_in++), count+1);
+				_out += count+1;
+			}
+		}
+		return _out==outEnd;
+	}
+
+	//! PIZ is Huffman coding of a 16 bit look up table index of every value, after a Haar wavelet transform of every channel
+	namespace piz
+	{
+		constexpr uint32_t BitmapSize = 8192u;
+		constexpr uint32_t UShortRange = 1u<<16u;
+		constexpr uint32_t HufEncSize = UShortRange+1u;
+		constexpr uint32_t HufDecBits = 14u;
+		constexpr uint32_t HufDecSize = 1u<<HufDecBits;
+		constexpr uint32_t HufDecMask = HufDecSize-1u;
+		constexpr uint32_t ShortZeroCodeRun = 59u;
+		constexpr uint32_t LongZeroCodeRun = 63u;
+		constexpr uint32_t ShortestLongRun = 2u+LongZeroCodeRun-ShortZeroCodeRun;
+
+		struct SHufDec
+		{
+			//! Length of a code of at most HufDecBits bits, 0 if the entry is a list of longer codes
+			uint32_t len;
+			uint32_t lit;
+			core::vector<uint32_t> longCodes;
+		};
+
+		//! Per thread storage, kept for the whole load to not allocate per block
+		struct SScratch
+		{
+			core::vector<uint64_t> hcode = core::vector<uint64_t>(HufEncSize);
+			core::vector<SHufDec> hdec = core::vector<SHufDec>(HufDecSize);
+			core::vector<uint16_t> lut = core::vector<uint16_t>(UShortRange);
+			core::vector<uint16_t> planar;
+		};
+
+		inline uint32_t hufLength(uint64_t _code) { return static_cast<uint32_t>(_code&63u); }
+		inline uint64_t hufCode(uint64_t _code) { return _code>>6u; }
+
+		class CBitReader
+		{
+			public:
+				CBitReader(const uint8_t* _begin, const uint8_t* _end) : m_in(_begin), m_end(_end) {}
+
+				inline bool getChar()
+				{
+					if (m_in>=m_end)
+						return false;
+					m_c = (m_c<<8u)|*(m_in++);
+					m_lc += 8;
+					return true;
+				}
+				inline bool getBits(uint32_t _bits, uint32_t& _out)
+				{
+					while (m_lc<int32_t(_bits))
+					if (!getChar())
+						return false;
+					m_lc -= _bits;
+					_out = static_cast<uint32_t>((m_c>>m_lc)&((1ull<<_bits)-1ull));
+					return true;
+				}
+
+				const uint8_t* m_in;
+				const uint8_t* m_end;
+				uint64_t m_c = 0u;
+				int32_t m_lc = 0;
+		};
+
+		//! Code lengths are stored in 6 bits, with runs of zero lengths
+		bool hufUnpackEncTable(CBitReader& _bits, uint32_t _im, uint32_t _iM, uint64_t* _hcode)
+		{
+			std::fill(_hcode, _hcode+HufEncSize, 0ull);
+			for (; _im<=_iM; _im++)
+			{
+				uint32_t l;
+				if (!_bits.getBits(6u, l))
+					return false;
+				_hcode[_im] = l;
+				if (l>=ShortZeroCodeRun)
+				{
+					uint32_t zerun = l-ShortZeroCodeRun+2u;
+					if (l==LongZeroCodeRun)
+					{
+						if (!_bits.getBits(8u, zerun))
+							return false;
+						zerun += ShortestLongRun;
+					}
+					if (_im+zerun>_iM+1u)
+						return false;
+					std::fill(_hcode+_im, _hcode+_im+zerun, 0ull);
+					_im += zerun-1u;
+				}
+			}
+
+			// canonical codes, stored as length | code<<6
+			uint64_t n[59] = {};
+			for (uint32_t i=0u; i<HufEncSize; i++)
+				n[_hcode[i]]++;
+			uint64_t c = 0u;
+			for (uint32_t i=58u; i>0u; i--)
+			{
+				const uint64_t nc = (c+n[i])>>1u;
+				n[i] = c;
+				c = nc;
+			}
+			for (uint32_t i=0u; i<HufEncSize; i++)
+			if (const uint32_t l=hufLength(_hcode[i]))
+				_hcode[i] = l|(n[l]++<<6u);
+			return true;
+		}
+
+		bool hufBuildDecTable(const uint64_t* _hcode, uint32_t _im, uint32_t _iM, SHufDec* _hdec)
+		{
+			for (uint32_t i=0u; i<HufDecSize; i++)
+			{
+				_hdec[i].len = 0u;
+				_hdec[i].lit = 0u;
+				_hdec[i].longCodes.clear();
+			}
+
+			for (; _im<=_iM; _im++)
+			{
+				const uint64_t c = hufCode(_hcode[_im]);
+				const uint32_t l = hufLength(_hcode[_im]);
+				if (c>>l)
+					return false;
+				if (l>HufDecBits)
+				{
+					SHufDec& entry = _hdec[c>>(l-HufDecBits)];
+					if (entry.len)
+						return false;
+					entry.longCodes.push_back(_im);
+				}
+				else if (l)
+				{
+					SHufDec* entry = _hdec+(c<<(HufDecBits-l));
+					for (uint32_t i=1u<<(HufDecBits-l); i>0u; i--,entry++)
+					{
+						if (entry->len || entry->longCodes.size())
+							return false;
+						entry->len = l;
+						entry->lit = _im;
+					}
+				}
+			}
+			return true;
+		}
+
+		//! `_rlc` is the symbol after which 8 bits say how many more times the previous value repeats
+		inline bool getCode(uint32_t _symbol, uint32_t _rlc, CBitReader& _bits, uint16_t*& _out, const uint16_t* _outBegin, const uint16_t* _outEnd)
+		{
+			if (_symbol==_rlc)
+			{
+				uint32_t count;
+				if (!_bits.getBits(8u, count) || size_t(_outEnd-_out)<count || _out==_outBegin)
+					return false;
+				const uint16_t value = _out[-1];
+				std::fill(_out, _out+count, value);
+				_out += count;
+				return true;
+			}
+			if (_out==_outEnd)
+				return false;
+			*(_out++) = static_cast<uint16_t>(_symbol);
+			return true;
+		}
+
+		bool hufDecode(const uint64_t* _hcode, const SHufDec* _hdec, const uint8_t* _in, uint32_t _bitCount, uint32_t _rlc, uint16_t* _out, size_t _outCount)
+		{
+			CBitReader bits(_in, _in+(_bitCount+7u)/8u);
+			uint16_t* const outBegin = _out;
+			uint16_t* const outEnd = _out+_outCount;
+			while (bits.m_in<bits.m_end)
+			{
+				bits.getChar();
+				while (bits.m_lc>=int32_t(HufDecBits))
+				{
+					const SHufDec& entry = _hdec[(bits.m_c>>(bits.m_lc-HufDecBits))&HufDecMask];
+					if (entry.len)
+					{
+						bits.m_lc -= entry.len;
+						if (!getCode(entry.lit, _rlc, bits, _out, outBegin, outEnd))
+							return false;
+						continue;
+					}
+
+					bool found = false;
+					for (const uint32_t symbol : entry.longCodes)
+					{
+						const uint32_t l = hufLength(_hcode[symbol]);
+						while (bits.m_lc<int32_t(l) && bits.getChar()) {}
+						if (bits.m_lc>=int32_t(l) && hufCode(_hcode[symbol])==((bits.m_c>>(bits.m_lc-l))&((1ull<<l)-1ull)))
+						{
+							bits.m_lc -= l;
+							if (!getCode(symbol, _rlc, bits, _out, outBegin, outEnd))
+								return false;
+							found = true;
+							break;
+						}
+					}
+					if (!found)
+						return false;
+				}
+			}
+
+			// the codes left in the last, partial, byte
+			const uint32_t padding = (8u-_bitCount)&7u;
+			bits.m_c >>= padding;
+			bits.m_lc -= padding;
+			while (bits.m_lc>0)
+			{
+				const SHufDec& entry = _hdec[(bits.m_c<<(HufDecBits-bits.m_lc))&HufDecMask];
+				if (!entry.len || int32_t(entry.len)>bits.m_lc)
+					return false;
+				bits.m_lc -= entry.len;
+				if (!getCode(entry.lit, _rlc, bits, _out, outBegin, outEnd))
+					return false;
+			}
+			return _out==outEnd;
+		}
+
+		bool hufUncompress(const uint8_t* _in, size_t _inSize, uint16_t* _out, size_t _outCount, SScratch& _scratch)
+		{
+			if (!_inSize)
+				return !_outCount;
+			constexpr size_t HeaderSize = 20u;
+			if (_inSize<HeaderSize)
+				return false;
+
+			uint32_t im, iM, bitCount;
+			memcpy(&im, _in, 4u);
+			memcpy(&iM, _in+4u, 4u);
+			memcpy(&bitCount, _in+12u, 4u);
+			if (im>=HufEncSize || iM>=HufEncSize)
+				return false;
+
+			CBitReader tableBits(_in+HeaderSize, _in+_inSize);
+			if (!hufUnpackEncTable(tableBits, im, iM, _scratch.hcode.data()))
+				return false;
+			const uint8_t* data = tableBits.m_in;
+			if (bitCount>8ull*(_in+_inSize-data))
+				return false;
+			if (!hufBuildDecTable(_scratch.hcode.data(), im, iM, _scratch.hdec.data()))
+				return false;
+			return hufDecode(_scratch.hcode.data(), _scratch.hdec.data(), data, bitCount, iM, _out, _outCount);
+		}
+
+		inline void wdec14(uint16_t _l, uint16_t _h, uint16_t& _a, uint16_t& _b)
+		{
+			const int32_t hi = int16_t(_h);
+			const int32_t ai = int16_t(_l)+(hi&1)+(hi>>1);
+			_a = static_cast<uint16_t>(ai);
+			_b = static_cast<uint16_t>(ai-hi);
+		}
+
+		inline void wdec16(uint16_t _l, uint16_t _h, uint16_t& _a, uint16_t& _b)
+		{
+			const int32_t m = _l;
+			const int32_t d = _h;
+			const int32_t bb = (m-(d>>1))&0xffff;
+			const int32_t aa = (d+bb-0x8000)&0xffff;
+			_b = static_cast<uint16_t>(bb);
+			_a = static_cast<uint16_t>(aa);
+		}
+
+		//! Inverse of the 2D Haar wavelet transform, with offsets between texels `_ox` and rows `_oy`
+		void wav2Decode(uint16_t* _in, int32_t _nx, int32_t _ox, int32_t _ny, int32_t _oy, uint16_t _maxValue)
+		{
+			const bool w14 = _maxValue<(1u<<14u);
+			auto wdec = [w14](uint16_t _l, uint16_t _h, uint16_t& _a, uint16_t& _b) -> void
+			{
+				if (w14)
+					wdec14(_l, _h, _a, _b);
+				else
+					wdec16(_l, _h, _a, _b);
+			};
+
+			const int32_t n = std::min(_nx, _ny);
+			int32_t p = 1;
+			while (p<=n)
+				p <<= 1;
+			p >>= 1;
+			int32_t p2 = p;
+			p >>= 1;
+
+			for (; p>=1; p2=p,p>>=1)
+			{
+				const ptrdiff_t ey = ptrdiff_t(_oy)*(_ny-p2);
+				const ptrdiff_t oy1 = ptrdiff_t(_oy)*p;
+				const ptrdiff_t oy2 = ptrdiff_t(_oy)*p2;
+				const ptrdiff_t ox1 = ptrdiff_t(_ox)*p;
+				const ptrdiff_t ox2 = ptrdiff_t(_ox)*p2;
+				const ptrdiff_t ex = ptrdiff_t(_ox)*(_nx-p2);
+				uint16_t i00, i01, i10, i11;
+
+				ptrdiff_t py = 0;
+				for (; py<=ey; py+=oy2)
+				{
+					ptrdiff_t px = py;
+					for (; px<=py+ex; px+=ox2)
+					{
+						uint16_t* p00 = _in+px;
+						uint16_t* p01 = p00+ox1;
+						uint16_t* p10 = p00+oy1;
+						uint16_t* p11 = p10+ox1;
+						wdec(*p00, *p10, i00, i10);
+						wdec(*p01, *p11, i01, i11);
+						wdec(i00, i01, *p00, *p01);
+						wdec(i10, i11, *p10, *p11);
+					}
+					// odd column
+					if (_nx&p)
+					{
+						uint16_t* p10 = _in+px+oy1;
+						wdec(_in[px], *p10, i00, *p10);
+						_in[px] = i00;
+					}
+				}
+				// odd row
+				if (_ny&p)
+				{
+					for (ptrdiff_t px=py; px<=py+ex; px+=ox2)
+					{
+						uint16_t* p01 = _in+px+ox1;
+						wdec(_in[px], *p01, i00, *p01);
+						_in[px] = i00;
+					}
+				}
+			}
+		}
+
+		//! Decodes a block of `_lines` lines of `_width` texels into the layout of uncompressed blocks
+		bool uncompress(const uint8_t* _in, size_t _inSize, uint8_t* _out, size_t _outSize, const core::vector<SChannel>& _channels, uint32_t _width, uint32_t _lines, SScratch& _scratch)
+		{
+			CReader reader(_in, _in+_inSize);
+			const uint16_t minNonZero = reader.read<uint16_t>();
+			const uint16_t maxNonZero = reader.read<uint16_t>();
+			if (!reader.valid() || maxNonZero>=BitmapSize)
+				return false;
+			uint8_t bitmap[BitmapSize] = {};
+			if (minNonZero<=maxNonZero)
+			{
+				const uint8_t* bitmapBytes = reader.pos();
+				if (!reader.skip(maxNonZero-minNonZero+1u))
+					return false;
+				memcpy(bitmap+minNonZero, bitmapBytes, maxNonZero-minNonZero+1u);
+			}
+
+			// every value that occurs gets an index, Huffman coding and the wavelet transform work on those
+			uint16_t* lut = _scratch.lut.data();
+			uint32_t k = 0u;
+			for (uint32_t i=0u; i<UShortRange; i++)
+			if (!i || (bitmap[i>>3u]&(1u<<(i&7u))))
+				lut[k++] = static_cast<uint16_t>(i);
+			const uint16_t maxValue = static_cast<uint16_t>(k-1u);
+			std::fill(lut+k, lut+UShortRange, 0u);
+
+			const uint32_t length = reader.read<uint32_t>();
+			const uint8_t* huffman = reader.pos();
+			if (!reader.skip(length))
+				return false;
+
+			const size_t valueCount = _outSize/2u;
+			_scratch.planar.resize(valueCount);
+			uint16_t* planar = _scratch.planar.data();
+			if (!hufUncompress(huffman, length, planar, valueCount, _scratch))
+				return false;
+
+			// values are stored channel after channel, a 32 bit texel is two 16 bit values which are transformed separately
+			uint16_t* channelBegin = planar;
+			for (const auto& channel : _channels)
+			{
+				const uint32_t valuesPerTexel = channel.size/2u;
+				for (uint32_t j=0u; j<valuesPerTexel; j++)
+					wav2Decode(channelBegin+j, _width, valuesPerTexel, _lines, _width*valuesPerTexel, maxValue);
+				channelBegin += size_t(_width)*_lines*valuesPerTexel;
+			}
+			for (size_t i=0u; i<valueCount; i++)
+				planar[i] = lut[planar[i]];
+
+			uint8_t* out = _out;
+			for (uint32_t y=0u; y<_lines; y++)
+			{
+				const uint16_t* channelLine = planar;
+				for (const auto& channel : _channels)
+				{
+					const size_t lineValues = size_t(_width)*channel.size/2u;
+					memcpy(out, channelLine+y*lineValues, lineValues*2u);
+					out += lineValues*2u;
+					channelLine += lineValues*_lines;
+				}
+			}
+			return true;
+		}
+	}
+
+	//! Converts `_count` halfs to floats, the SIMD path handles denormals, infinities and NaNs like the scalar one
+	void halfToFloat(const uint16_t* _in, float* _out, uint32_t _count)
+	{
+		uint32_t i = 0u;
+#ifdef __IRR_COMPILE_WITH_X86_SIMD_
+		const __m128i noSignMask = _mm_set1_epi32(0x7fff);
+		const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32((254-15)<<23));
+		const __m128i wasInfNaN = _mm_set1_epi32(0x7bff);
+		const __m128i infNaNExponent = _mm_set1_epi32(255<<23);
+		const __m128i zero = _mm_setzero_si128();
+		for (; i+4u<=_count; i+=4u)
+		{
+			const __m128i h = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(_in+i)), zero);
+			const __m128i expMantissa = _mm_and_si128(h, noSignMask);
+			const __m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expMantissa), 16);
+			// rebiasing the exponent is a multiply, which also makes half denormals normal floats
+			const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(expMantissa, 13)), magic);
+			const __m128i infNaN = _mm_and_si128(_mm_cmpgt_epi32(expMantissa, wasInfNaN), infNaNExponent);
+			_mm_storeu_ps(_out+i, _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infNaN))));
+		}
+#endif
+		for (; i<_count; i++)
+			_out[i] = core::Float16Compressor::decompress(_in[i]);
+	}
+}
+
+bool CImageLoaderOpenEXR::isALoadableFileFormat(io::IReadFile* _file) const
+{
+	if (!_file)
+		return false;
+
+	const size_t prevPos = _file->getPos();
+
+	uint8_t magic[4];
+	const int32_t readCount = _file->read(magic, sizeof(magic));
+	_file->seek(prevPos);
+
+	return readCount==4 && magic[0]==0x76u && magic[1]==0x2fu && magic[2]==0x31u && magic[3]==0x01u;
+}
+
+asset::SAssetBundle CImageLoaderOpenEXR::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
+{
+	IRR_PROFILE_ZONE("CImageLoaderOpenEXR::loadAsset");
+	const char* filename = _file->getFileName().c_str();
+
+	core::vector<uint8_t> data(_file->getSize());
+	_file->seek(0u);
+	for (size_t pos=0u; pos<data.size();)
+	{
+		const uint32_t chunk = static_cast<uint32_t>(std::min<size_t>(data.size()-pos, 0x40000000u));
+		if (_file->read(data.data()+pos, chunk)!=static_cast<int32_t>(chunk))
+		{
+			os::Printer::log("Could not read EXR file.", filename, ELL_ERROR);
+			return {};
+		}
+		pos += chunk;
+	}
+
+	CReader reader(data.data(), data.data()+data.size());
+	reader.skip(4u);
+	const uint32_t version = reader.read<uint32_t>();
+	if (!reader.valid() || (version&0xffu)!=2u)
+	{
+		os::Printer::log("Unsupported EXR version.", filename, ELL_ERROR);
+		return {};
+	}
+	if (version&(0x200u|0x800u|0x1000u))
+	{
+		os::Printer::log("Tiled, deep and multipart EXR files are not supported.", filename, ELL_ERROR);
+		return {};
+	}
+
+	core::vector<SChannel> channels;
+	uint8_t compression = EC_NONE;
+	int32_t dataWindow[4] = {0, 0, -1, -1};
+	for (;;)
+	{
+		const std::string name = reader.readString();
+		if (name.empty())
+			break;
+		const std::string type = reader.readString();
+		const uint32_t size = reader.read<uint32_t>();
+		CReader value(reader.pos(), reader.pos()+size);
+		if (!reader.skip(size))
+			break;
+
+		if (name=="channels" && type=="chlist")
+		{
+			for (std::string channelName=value.readString(); value.valid() && !channelName.empty(); channelName=value.readString())
+			{
+				const int32_t pixelType = value.read<int32_t>();
+				value.skip(4u);
+				const int32_t xSampling = value.read<int32_t>();
+				const int32_t ySampling = value.read<int32_t>();
+				if (pixelType<EPT_UINT || pixelType>EPT_FLOAT || xSampling!=1 || ySampling!=1)
+				{
+					os::Printer::log("Unsupported EXR channel type or subsampling in channel", channelName.c_str(), ELL_ERROR);
+					return {};
+				}
+				channels.push_back({channelName, static_cast<E_PIXEL_TYPE>(pixelType), pixelType==EPT_HALF ? 2u:4u});
+			}
+		}
+		else if (name=="compression" && type=="compression")
+			compression = value.read<uint8_t>();
+		else if (name=="dataWindow" && type=="box2i")
+		{
+			for (uint32_t i=0u; i<4u; i++)
+				dataWindow[i] = value.read<int32_t>();
+		}
+
+		if (!value.valid())
+			break;
+	}
+	if (!reader.valid())
+	{
+		os::Printer::log("Corrupt EXR header.", filename, ELL_ERROR);
+		return {};
+	}
+
+	uint32_t linesPerBlock;
+	switch (compression)
+	{
+		case EC_NONE:
+		case EC_RLE:
+			linesPerBlock = 1u;
+			break;
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+		case EC_ZIPS:
+			linesPerBlock = 1u;
+			break;
+		case EC_ZIP:
+			linesPerBlock = 16u;
+			break;
+#endif
+		case EC_PIZ:
+			linesPerBlock = 32u;
+			break;
+		default:
+			os::Printer::log("Unsupported EXR compression.", filename, ELL_ERROR);
+			return {};
+	}
+
+	const int64_t width64 = int64_t(dataWindow[2])-dataWindow[0]+1;
+	const int64_t height64 = int64_t(dataWindow[3])-dataWindow[1]+1;
+	if (width64<=0 || height64<=0 || width64>0x10000 || height64>0x10000 || channels.empty())
+	{
+		os::Printer::log("EXR file has no channels or an invalid data window.", filename, ELL_ERROR);
+		return {};
+	}
+	const uint32_t width = static_cast<uint32_t>(width64);
+	const uint32_t height = static_cast<uint32_t>(height64);
+
+	// which file channel goes to each of RGBA
+	int32_t source[4] = {-1, -1, -1, -1};
+	for (uint32_t i=0u; i<channels.size(); i++)
+	{
+		const char* names[5] = {"R", "G", "B", "A", "Y"};
+		for (uint32_t c=0u; c<5u; c++)
+		if (channels[i].name==names[c])
+		{
+			if (c<4u)
+				source[c] = i;
+			else if (source[0]<0 && source[1]<0 && source[2]<0)
+				source[0] = source[1] = source[2] = i;
+		}
+	}
+	if (source[0]<0 && source[1]<0 && source[2]<0 && source[3]<0)
+	{
+		if (channels.size()!=1u)
+		{
+			os::Printer::log("EXR file has no R, G, B, A or Y channel.", filename, ELL_ERROR);
+			return {};
+		}
+		source[0] = source[1] = source[2] = 0;
+	}
+
+	bool allHalf = true;
+	for (uint32_t c=0u; c<4u; c++)
+	if (source[c]>=0 && channels[source[c]].type!=EPT_HALF)
+		allHalf = false;
+	const asset::E_FORMAT format = allHalf ? asset::EF_R16G16B16A16_SFLOAT:asset::EF_R32G32B32A32_SFLOAT;
+
+	size_t lineSize = 0u;
+	for (const auto& channel : channels)
+		lineSize += size_t(width)*channel.size;
+
+	const uint32_t blockCount = (height+linesPerBlock-1u)/linesPerBlock;
+	const uint8_t* offsetTable = reader.pos();
+	if (!reader.skip(blockCount*sizeof(uint64_t)))
+	{
+		os::Printer::log("Truncated EXR offset table.", filename, ELL_ERROR);
+		return {};
+	}
+
+	const uint32_t zero[3] = {0u, 0u, 0u};
+	const uint32_t size[3] = {width, height, 1u};
+	asset::CImageData* image = new asset::CImageData(nullptr, zero, size, 0u, format, 1u);
+	const size_t pitch = image->getPitchIncludingAlignment();
+	uint8_t* out = reinterpret_cast<uint8_t*>(image->getData());
+
+	struct SThreadScratch
+	{
+		core::vector<uint8_t> compressed;
+		core::vector<uint8_t> block;
+		core::vector<float> floatLine;
+		core::vector<uint16_t> halfLine;
+		std::unique_ptr<piz::SScratch> piz;
+	};
+	const uint32_t threadCount = core::getDefaultThreadCount();
+	core::vector<SThreadScratch> scratch(threadCount);
+
+	std::atomic<bool> success(true);
+	core::parallel_for_chunked(0u, blockCount, 1u, [&](size_t _begin, size_t _end, uint32_t _threadIx) -> void
+	{
+		SThreadScratch& thread = scratch[_threadIx];
+		for (size_t b=_begin; b<_end && success; b++)
+		{
+			uint64_t offset;
+			memcpy(&offset, offsetTable+b*sizeof(uint64_t), sizeof(uint64_t));
+			CReader block(data.data(), data.data()+data.size());
+			int32_t y = -1;
+			uint32_t blockSize = 0u;
+			if (offset<=data.size() && block.skip(offset))
+			{
+				y = block.read<int32_t>();
+				blockSize = block.read<uint32_t>();
+			}
+			const uint8_t* blockData = block.pos();
+			const int64_t firstLine = int64_t(y)-dataWindow[1];
+			if (!block.skip(blockSize) || firstLine<0 || firstLine>=height || firstLine%linesPerBlock)
+			{
+				success = false;
+				return;
+			}
+			const uint32_t lines = std::min<uint32_t>(linesPerBlock, height-static_cast<uint32_t>(firstLine));
+			const size_t expectedSize = lineSize*lines;
+
+			// blocks which would not get any smaller are stored uncompressed
+			const uint8_t* decoded = blockData;
+			if (blockSize<expectedSize)
+			{
+				thread.block.resize(expectedSize);
+				bool ok = false;
+				switch (compression)
+				{
+					case EC_RLE:
+						thread.compressed.resize(expectedSize);
+						ok = rleUncompress(blockData, blockSize, thread.compressed.data(), expectedSize);
+						break;
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+					case EC_ZIPS:
+					case EC_ZIP:
+					{
+						thread.compressed.resize(expectedSize);
+						uLongf destSize = static_cast<uLongf>(expectedSize);
+						ok = uncompress(thread.compressed.data(), &destSize, blockData, blockSize)==Z_OK && destSize==expectedSize;
+						break;
+					}
+#endif
+					case EC_PIZ:
+						if (!thread.piz)
+							thread.piz.reset(new piz::SScratch);
+						ok = piz::uncompress(blockData, blockSize, thread.block.data(), expectedSize, channels, width, lines, *thread.piz);
+						break;
+					default:
+						break;
+				}
+				if (!ok)
+				{
+					success = false;
+					return;
+				}
+				if (compression!=EC_PIZ)
+					unpredictAndInterleave(thread.compressed.data(), thread.block.data(), expectedSize);
+				decoded = thread.block.data();
+			}
+			else if (blockSize!=expectedSize)
+			{
+				success = false;
+				return;
+			}
+
+			for (uint32_t l=0u; l<lines; l++)
+			{
+				const uint8_t* line = decoded+l*lineSize;
+				uint8_t* outRow = out+(firstLine+l)*pitch;
+				const uint8_t* channelLines[4] = {nullptr, nullptr, nullptr, nullptr};
+				{
+					const uint8_t* channelLine = line;
+					for (uint32_t i=0u; i<channels.size(); i++)
+					{
+						for (uint32_t c=0u; c<4u; c++)
+						if (source[c]==int32_t(i))
+							channelLines[c] = channelLine;
+						channelLine += size_t(width)*channels[i].size;
+					}
+				}
+
+				if (allHalf)
+				{
+					uint16_t* outTexels = reinterpret_cast<uint16_t*>(outRow);
+					for (uint32_t c=0u; c<4u; c++)
+					{
+						if (!channelLines[c])
+						{
+							const uint16_t value = c==3u ? 0x3c00u:0u;
+							for (uint32_t x=0u; x<width; x++)
+								outTexels[4u*x+c] = value;
+							continue;
+						}
+						for (uint32_t x=0u; x<width; x++)
+							memcpy(outTexels+4u*x+c, channelLines[c]+2u*x, 2u);
+					}
+					continue;
+				}
+
+				float* outTexels = reinterpret_cast<float*>(outRow);
+				thread.floatLine.resize(width);
+				for (uint32_t c=0u; c<4u; c++)
+				{
+					if (!channelLines[c])
+					{
+						const float value = c==3u ? 1.f:0.f;
+						for (uint32_t x=0u; x<width; x++)
+							outTexels[4u*x+c] = value;
+						continue;
+					}
+					switch (channels[source[c]].type)
+					{
+						case EPT_HALF:
+							// the line may not be 2 byte aligned in the file
+							thread.halfLine.resize(width);
+							memcpy(thread.halfLine.data(), channelLines[c], 2u*width);
+							halfToFloat(thread.halfLine.data(), thread.floatLine.data(), width);
+							break;
+						case EPT_FLOAT:
+							memcpy(thread.floatLine.data(), channelLines[c], 4u*width);
+							break;
+						default:
+							for (uint32_t x=0u; x<width; x++)
+							{
+								uint32_t value;
+								memcpy(&value, channelLines[c]+4u*x, 4u);
+								thread.floatLine[x] = static_cast<float>(value);
+							}
+							break;
+					}
+					for (uint32_t x=0u; x<width; x++)
+						outTexels[4u*x+c] = thread.floatLine[x];
+				}
+			}
+		}
+	}, threadCount);
+
+	if (!success)
+	{
+		os::Printer::log("Corrupt or truncated EXR block.", filename, ELL_ERROR);
+		image->drop();
+		return {};
+	}
+
+	asset::ICPUTexture* tex = asset::ICPUTexture::create({image}, _file->getFileName().c_str(), video::ITexture::ETT_2D);
+	image->drop();
+	if (!tex)
+		return {};
+	return SAssetBundle({core::smart_refctd_ptr<IAsset>(tex, core::dont_grab)});
+}
+
+} // end namespace asset
+} // end namespace irr
+
+#endif
@@ -0,0 +1,45 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_IMAGE_LOADER_OPENEXR_H_INCLUDED__
+#define __IRR_C_IMAGE_LOADER_OPENEXR_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_EXR_LOADER_
+
+#include "irr/asset/IAssetLoader.h"
+
+namespace irr
+{
+namespace asset
+{
+
+//! Loader for single part scanline OpenEXR (.exr) images
+/** The R, G, B and A channels (or Y, or the only channel there is) are decoded to EF_R16G16B16A16_SFLOAT when they are all half,
+otherwise to EF_R32G32B32A32_SFLOAT, missing colour channels are 0 and a missing alpha is 1. Rows are stored top first, the data window becomes the image.
+
+Uncompressed, RLE, ZIPS, ZIP (both need zlib) and PIZ blocks are decoded by all threads at once, half to float conversion uses SIMD.
+PXR24, B44 and DWA compression, tiled, deep and multipart files as well as subsampled channels are rejected.*/
+class CImageLoaderOpenEXR : public asset::IAssetLoader
+{
+public:
+	virtual bool isALoadableFileFormat(io::IReadFile* _file) const override;
+
+	virtual const char** getAssociatedFileExtensions() const override
+	{
+		static const char* ext[]{ "exr", nullptr };
+		return ext;
+	}
+
+	virtual uint64_t getSupportedAssetTypesBitfield() const override { return asset::IAsset::ET_IMAGE; }
+
+	virtual asset::SAssetBundle loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override = nullptr, uint32_t _hierarchyLevel = 0u) override;
+};
+
+} // end namespace asset
+} // end namespace irr
+
+#endif
+#endif
@@ -79,6 +79,7 @@ bool CImageLoaderPng::isALoadableFileFormat(io::IReadFile* _file) const
 // load in the image data
 asset::SAssetBundle CImageLoaderPng::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
+    IRR_PROFILE_ZONE("CImageLoaderPng::loadAsset");
     core::vector<asset::CImageData*> images;
 #ifdef _IRR_COMPILE_WITH_LIBPNG_
 	if (!_file)
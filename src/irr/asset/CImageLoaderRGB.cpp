@@ -166,6 +166,7 @@ bool CImageLoaderRGB::isALoadableFileFormat(io::IReadFile* _file) const
 				null pointer on fail */
 asset::IAsset* CImageLoaderRGB::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
+	IRR_PROFILE_ZONE("CImageLoaderRGB::loadAsset");
 	int32_t* paletteData = 0;
 
 	rgbStruct rgb;   // construct our structure for holding data
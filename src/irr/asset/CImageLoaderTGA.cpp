@@ -140,6 +140,7 @@ static void convertColorFlip(asset::CImageData **image, const T *src, bool flip)
 //! creates a surface from the file
 asset::SAssetBundle CImageLoaderTGA::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
+	IRR_PROFILE_ZONE("CImageLoaderTGA::loadAsset");
 	STGAHeader header;
 	uint32_t *palette = 0;
 
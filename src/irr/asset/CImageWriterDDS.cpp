@@ -0,0 +1,151 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "CImageWriterDDS.h"
+
+#ifdef _IRR_COMPILE_WITH_DDS_WRITER_
+
+#include "CImageLoaderDDS.h"
+#include "IWriteFile.h"
+#include "irr/asset/ICPUTexture.h"
+
+#include "os.h"
+
+namespace irr
+{
+namespace asset
+{
+
+CImageWriterDDS::CImageWriterDDS()
+{
+#ifdef _IRR_DEBUG
+	setDebugName("CImageWriterDDS");
+#endif
+}
+
+bool CImageWriterDDS::writeAsset(io::IWriteFile* _file, const SAssetWriteParams& _params, IAssetWriterOverride* _override)
+{
+    if (!_override)
+        getDefaultOverride(_override);
+
+    SAssetWriteContext ctx{_params, _file};
+
+	core::vector<const asset::CImageData*> levels;
+	if (_params.rootAsset->getAssetType()==IAsset::ET_IMAGE)
+	{
+		const asset::ICPUTexture* texture = static_cast<const asset::ICPUTexture*>(_params.rootAsset);
+		for (uint32_t i=0u; i<=texture->getHighestMip(); i++)
+		{
+			const auto range = texture->getMipMap(i);
+			if (range.second-range.first!=1 || (*range.first)->getSupposedMipLevel()!=i)
+			{
+				os::Printer::log("DDS writer needs every mip level of the texture as a single range.", texture->getSourceFilename(), ELL_ERROR);
+				return false;
+			}
+			levels.push_back(*range.first);
+		}
+	}
+	else
+		levels.push_back(static_cast<const asset::CImageData*>(_params.rootAsset));
+
+	const asset::CImageData* base = levels.front();
+	const auto format = base->getColorFormat();
+	const uint32_t dxgiFormat = CImageLoaderDDS::getDXGIFromFormat(format);
+	if (!dxgiFormat)
+	{
+		os::Printer::log("Unsupported color format, operation aborted.", ELL_ERROR);
+		return false;
+	}
+
+	const auto size = base->getSize();
+	for (uint32_t i=0u; i<levels.size(); i++)
+	{
+		const auto levelSize = levels[i]->getSize();
+		const uint32_t* offset = levels[i]->getOffset();
+		if (offset[0]||offset[1]||offset[2] || levelSize.Z!=1u || levelSize.X!=std::max(size.X>>i,1u) || levelSize.Y!=std::max(size.Y>>i,1u))
+		{
+			os::Printer::log("DDS writer only writes whole 2D mip levels, operation aborted.", ELL_ERROR);
+			return false;
+		}
+	}
+
+	io::IWriteFile* file = _override->getOutputFile(_file, ctx, { _params.rootAsset, 0u });
+
+	const bool blockCompressed = isBlockCompressionFormat(format);
+	auto tightPitch = [format](uint32_t _width) -> uint32_t
+	{
+		return (asset::getBytesPerPixel(format)*_width).getIntegerApprox();
+	};
+
+	CImageLoaderDDS::ddsBuffer header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "DDS ", 4u);
+	header.size = 124u;
+	header.flags = 0x1u|0x2u|0x4u|0x1000u;//DDSD_CAPS|DDSD_HEIGHT|DDSD_WIDTH|DDSD_PIXELFORMAT
+	header.height = size.Y;
+	header.width = size.X;
+	if (blockCompressed)
+	{
+		header.flags |= 0x80000u;//DDSD_LINEARSIZE
+		header.linearSize = base->getImageDataSizeInBytes();
+	}
+	else
+	{
+		header.flags |= 0x8u;//DDSD_PITCH
+		header.pitch = tightPitch(size.X);
+	}
+	header.caps.caps1 = 0x1000u;//DDSCAPS_TEXTURE
+	if (levels.size()>1u)
+	{
+		header.flags |= 0x20000u;//DDSD_MIPMAPCOUNT
+		header.mipMapCount = levels.size();
+		header.caps.caps1 |= 0x8u|0x400000u;//DDSCAPS_COMPLEX|DDSCAPS_MIPMAP
+	}
+	header.pixelFormat.size = 32u;
+	header.pixelFormat.flags = 0x4u;//DDPF_FOURCC
+	memcpy(&header.pixelFormat.fourCC, "DX10", 4u);
+
+	CImageLoaderDDS::ddsHeaderDXT10 dx10Header;
+	dx10Header.dxgiFormat = dxgiFormat;
+	dx10Header.resourceDimension = 3u;//D3D10_RESOURCE_DIMENSION_TEXTURE2D
+	dx10Header.miscFlag = 0u;
+	dx10Header.arraySize = 1u;
+	dx10Header.miscFlags2 = 0u;
+
+	const int32_t headerSize = sizeof(header)-4;
+	if (file->write(&header, headerSize) != headerSize)
+		return false;
+	if (file->write(&dx10Header, sizeof(dx10Header)) != int32_t(sizeof(dx10Header)))
+		return false;
+
+	for (const auto level : levels)
+	{
+		const uint8_t* data = reinterpret_cast<const uint8_t*>(level->getData());
+		if (!data)
+			return false;
+
+		// DDS rows are tightly packed, only uncompressed levels with a larger unpack alignment have padding to strip
+		const uint32_t pitch = blockCompressed ? 0u:level->getPitchIncludingAlignment();
+		const uint32_t rowSize = blockCompressed ? 0u:tightPitch(level->getSize().X);
+		if (pitch==rowSize)
+		{
+			const int32_t dataSize = level->getImageDataSizeInBytes();
+			if (file->write(data, dataSize) != dataSize)
+				return false;
+			continue;
+		}
+		for (uint32_t y=0u; y<level->getSize().Y; y++)
+		{
+			if (file->write(data+size_t(y)*pitch, rowSize) != int32_t(rowSize))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+} // namespace asset
+} // namespace irr
+
+#endif
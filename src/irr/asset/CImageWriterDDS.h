@@ -0,0 +1,47 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_IMAGE_WRITER_DDS_H_INCLUDED__
+#define __IRR_C_IMAGE_WRITER_DDS_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_DDS_WRITER_
+
+#include "irr/asset/IAssetWriter.h"
+
+namespace irr
+{
+namespace asset
+{
+
+//! Writes textures with the DX10 extended header, so every format the DDS loader knows a DXGI equivalent of can be stored
+/** The main use are block compressed textures, the data of those is written as is.
+A whole ICPUTexture gets all of its mip levels written, each level must then be a single range covering the whole level.*/
+class CImageWriterDDS : public asset::IAssetWriter
+{
+public:
+	//! constructor
+	CImageWriterDDS();
+
+    virtual const char** getAssociatedFileExtensions() const
+    {
+        static const char* ext[]{ "dds", nullptr };
+        return ext;
+    }
+
+    virtual uint64_t getSupportedAssetTypesBitfield() const override { return asset::IAsset::ET_IMAGE|asset::IAsset::ET_SUB_IMAGE; }
+
+    virtual uint32_t getSupportedFlags() override { return 0u; }
+
+    virtual uint32_t getForcedFlags() { return asset::EWF_BINARY; }
+
+    virtual bool writeAsset(io::IWriteFile* _file, const SAssetWriteParams& _params, IAssetWriterOverride* _override = nullptr) override;
+};
+
+} // namespace asset
+} // namespace irr
+
+#endif // _IRR_COMPILE_WITH_DDS_WRITER_
+#endif
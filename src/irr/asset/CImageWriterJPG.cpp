@@ -9,6 +9,7 @@
 #include "IWriteFile.h"
 #include "irr/asset/format/convertColor.h"
 #include "irr/asset/ICPUTexture.h"
+#include "irr/core/parallel/parallel_for.h"
 
 #include "os.h"
 
@@ -98,15 +99,73 @@ static void jpeg_file_dest(j_compress_ptr cinfo, io::IWriteFile* file)
 }
 
 
+//! Converts one row of `_width` texels to 8 bit gray or RGB, the alpha of RGBA and BGRA gets dropped with SIMD
+static void convertRow(asset::E_FORMAT _format, bool _grayscale, const uint8_t* _src, uint8_t* _dst, uint32_t _width)
+{
+	switch (_format)
+	{
+		case asset::EF_R8_SRGB:
+			_IRR_FALLTHROUGH;
+		case asset::EF_R8G8B8_SRGB:
+			memcpy(_dst, _src, _width*(_grayscale ? 1u:3u));
+			return;
+		case asset::EF_R8G8B8A8_SRGB:
+			_IRR_FALLTHROUGH;
+		case asset::EF_B8G8R8A8_SRGB:
+		{
+			const uint32_t r = _format==asset::EF_B8G8R8A8_SRGB ? 2u:0u;
+			uint32_t x = 0u;
+#ifdef __IRR_COMPILE_WITH_SSE3
+			// every 16 byte store only has 12 valid bytes, so the loop stops while there still is room for the other 4
+			const __m128i mask = r ?	_mm_setr_epi8(2,1,0, 6,5,4, 10,9,8, 14,13,12, -1,-1,-1,-1):
+										_mm_setr_epi8(0,1,2, 4,5,6, 8,9,10, 12,13,14, -1,-1,-1,-1);
+			for (; x+6u<=_width; x+=4u)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(_dst+3u*x), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_src+4u*x)), mask));
+#endif
+			for (; x<_width; x++)
+			{
+				_dst[3u*x+0u] = _src[4u*x+r];
+				_dst[3u*x+1u] = _src[4u*x+1u];
+				_dst[3u*x+2u] = _src[4u*x+2u-r];
+			}
+			return;
+		}
+		default:
+			break;
+	}
+
+	const void* srcPix[4] = {_src, nullptr, nullptr, nullptr};
+	core::vector3d<uint32_t> rowSize(_width, 1u, 1u);
+	video::convertColor(_format, _grayscale ? asset::EF_R8_SRGB:asset::EF_R8G8B8_SRGB, srcPix, _dst, _width, rowSize);
+}
+
 /* write_JPEG_memory: store JPEG compressed image into memory.
 */
 static bool writeJPEGFile(io::IWriteFile* file, const asset::CImageData* image, uint32_t quality)
 {
 	auto format = image->getColorFormat();
-	bool grayscale = (format == asset::EF_R8_SRGB) || (format == asset::EF_R8_UNORM);
+	if (format==asset::EF_UNKNOWN || asset::isBlockCompressionFormat(format) || asset::isPlanarFormat(format) || asset::isIntegerFormat(format) || asset::isDepthOrStencilFormat(format))
+	{
+		os::Printer::log("Unsupported color format, operation aborted.", ELL_ERROR);
+		return false;
+	}
+	bool grayscale = asset::getFormatChannelCount(format)==1u;
 	
 	core::vector3d<uint32_t> dim = image->getSize();
 
+	// all rows get converted up front by all threads, libjpeg then takes them in as few calls as it wants
+	const uint32_t components = grayscale ? 1u:3u;
+	const size_t rowSize = size_t(dim.X)*components;
+	const uint32_t pitch = image->getPitchIncludingAlignment();
+	const uint8_t* src = reinterpret_cast<const uint8_t*>(image->getData());
+	core::vector<uint8_t> converted(rowSize*dim.Y);
+	core::vector<JSAMPROW> rowPointers(dim.Y);
+	core::parallel_for(0u, dim.Y, [&](size_t y) -> void
+	{
+		convertRow(format, grayscale, src+y*pitch, converted.data()+y*rowSize, dim.X);
+		rowPointers[y] = converted.data()+y*rowSize;
+	}, 0u, 16ull);
+
 	struct jpeg_compress_struct cinfo;
 	struct jpeg_error_mgr jerr;
 	cinfo.err = jpeg_std_error(&jerr);
@@ -115,7 +174,7 @@ static bool writeJPEGFile(io::IWriteFile* file, const asset::CImageData* image,
 	jpeg_file_dest(&cinfo, file);
 	cinfo.image_width = dim.X;
 	cinfo.image_height = dim.Y;
-	cinfo.input_components = grayscale ? 1 : 3;
+	cinfo.input_components = components;
 	cinfo.in_color_space = grayscale ? JCS_GRAYSCALE : JCS_RGB;
 
 	jpeg_set_defaults(&cinfo);
@@ -126,65 +185,16 @@ static bool writeJPEGFile(io::IWriteFile* file, const asset::CImageData* image,
 	jpeg_set_quality(&cinfo, quality, TRUE);
 	jpeg_start_compress(&cinfo, TRUE);
 
-	uint8_t * dest = new uint8_t[dim.X*3];
-
-	if (dest)
-	{
-		const uint32_t pitch = image->getPitchIncludingAlignment();
-		JSAMPROW row_pointer[1];      /* pointer to JSAMPLE row[s] */
-		row_pointer[0] = dest;
-		
-		uint8_t* src = (uint8_t*)image->getData();
-		
-		/* Switch up, write from bottom -> top because the texture is flipped from OpenGL side */
-		uint32_t eof = cinfo.image_height * cinfo.image_width * cinfo.input_components;
-		
-		while (cinfo.next_scanline < cinfo.image_height)
-		{
-			/* Since the first argument to convertColor() requires a const void *[4], wrap our buffer pointer (src) and pass that to convertColor(). */
-			const void *src_container[4] = {src, nullptr, nullptr, nullptr};
-			
-			/* Pass-through the pixels for EF_R8_SRGB/EF_R8G8B8_SRGB, and perform color conversion for the rest.*/
-			switch (format) {
-				case asset::EF_R8G8B8_UNORM:
-					video::convertColor<EF_R8G8B8_UNORM, EF_R8G8B8_SRGB>(src_container, dest, dim.X, dim);
-					break;
-				case asset::EF_B5G6R5_UNORM_PACK16:
-					video::convertColor<EF_B5G6R5_UNORM_PACK16, EF_R8G8B8_SRGB>(src_container, dest, dim.X, dim);
-					break;
-				case asset::EF_A1R5G5B5_UNORM_PACK16:
-					video::convertColor<EF_A1R5G5B5_UNORM_PACK16, EF_R8G8B8_SRGB>(src_container, dest, dim.X, dim);
-					break;
-				case asset::EF_R8_UNORM:
-					video::convertColor<EF_R8_UNORM, EF_R8_SRGB>(src_container, dest, dim.X, dim);
-					break;
-				case asset::EF_R8_SRGB:
-					_IRR_FALLTHROUGH;
-				case asset::EF_R8G8B8_SRGB:
-					memcpy(dest, src, pitch);
-					break;
-				default:
-				{
-					os::Printer::log("Unsupported color format, operation aborted.", ELL_ERROR);
-					delete [] dest;
-					return false;
-				}
-			}
-			
-			src += pitch;
-			jpeg_write_scanlines(&cinfo, row_pointer, 1);
-		}
-
-		delete [] dest;
+	while (cinfo.next_scanline < cinfo.image_height)
+		jpeg_write_scanlines(&cinfo, rowPointers.data()+cinfo.next_scanline, cinfo.image_height-cinfo.next_scanline);
 
-		/* Step 6: Finish compression */
-		jpeg_finish_compress(&cinfo);
-	}
+	/* Step 6: Finish compression */
+	jpeg_finish_compress(&cinfo);
 
 	/* Step 7: Destroy */
 	jpeg_destroy_compress(&cinfo);
 
-	return (dest != 0);
+	return true;
 }
 
 #endif // _IRR_COMPILE_WITH_LIBJPEG_
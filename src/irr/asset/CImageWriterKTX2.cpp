@@ -0,0 +1,562 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "CImageWriterKTX2.h"
+
+#ifdef _IRR_COMPILE_WITH_KTX2_WRITER_
+
+#include <atomic>
+
+#include "CImageLoaderKTX2.h"
+#include "IWriteFile.h"
+#include "irr/asset/ICPUTexture.h"
+#include "irr/core/parallel/parallel_for.h"
+
+#include "os.h"
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	#include "zlib/zlib.h"
+#endif
+
+namespace irr
+{
+namespace asset
+{
+
+namespace
+{
+	// values from the Khronos Data Format Specification
+	enum E_DF_MODEL : uint8_t
+	{
+		EDFM_RGBSDA = 1u,
+		EDFM_BC1A = 128u,
+		EDFM_BC2 = 129u,
+		EDFM_BC3 = 130u,
+		EDFM_BC4 = 131u,
+		EDFM_BC5 = 132u,
+		EDFM_BC6H = 133u,
+		EDFM_BC7 = 134u,
+		EDFM_ETC2 = 161u,
+		EDFM_ASTC = 162u,
+		EDFM_PVRTC = 164u,
+		EDFM_PVRTC2 = 165u
+	};
+	enum E_DF_CHANNEL : uint8_t
+	{
+		EDFC_RED = 0u,
+		EDFC_GREEN = 1u,
+		EDFC_BLUE = 2u,
+		EDFC_STENCIL = 13u,
+		EDFC_DEPTH = 14u,
+		EDFC_ALPHA = 15u,
+		// block compressed models number their channels on their own
+		EDFC_BC1A_ALPHA_PRESENT = 1u,
+		EDFC_ETC2_COLOR = 2u
+	};
+	enum E_DF_QUALIFIER : uint8_t
+	{
+		EDFQ_LINEAR = 0x10u,
+		EDFQ_EXPONENT = 0x20u,
+		EDFQ_SIGNED = 0x40u,
+		EDFQ_FLOAT = 0x80u
+	};
+	constexpr uint32_t FloatOne = 0x3F800000u;
+	constexpr uint32_t FloatMinusOne = 0xBF800000u;
+
+	struct SChannel
+	{
+		uint8_t channel;
+		uint8_t bitOffset;
+		uint8_t bitLength;
+	};
+
+	//! Builds the basic data format descriptor KTX2 requires, including the leading total size
+	class CDFDBuilder
+	{
+			core::vector<uint32_t> samples;
+			uint8_t model, transfer;
+			uint8_t blockDim[4];
+			uint32_t bytesPlane0;
+		public:
+			CDFDBuilder(E_FORMAT _fmt, uint8_t _model) : model(_model), transfer(isSRGBFormat(_fmt) ? 2u:1u), bytesPlane0(getTexelOrBlockBytesize(_fmt))
+			{
+				const auto dims = getBlockDimensions(_fmt);
+				for (uint32_t i=0u; i<4u; i++)
+					blockDim[i] = i<3u ? static_cast<uint8_t>(dims[i]-1u):0u;
+			}
+
+			inline void addSample(uint32_t _bitOffset, uint32_t _bitLength, uint8_t _channelAndQualifiers, uint32_t _lower, uint32_t _upper)
+			{
+				samples.push_back(_bitOffset|((_bitLength-1u)<<16u)|(uint32_t(_channelAndQualifiers)<<24u));
+				samples.push_back(0u);
+				samples.push_back(_lower);
+				samples.push_back(_upper);
+			}
+
+			inline core::vector<uint32_t> finalize() const
+			{
+				const uint32_t blockSize = 24u+static_cast<uint32_t>(samples.size())*4u;
+				core::vector<uint32_t> dfd = {
+					4u+blockSize,
+					0u, // vendor KHRONOS, descriptor type BASICFORMAT
+					2u|(blockSize<<16u), // version 1.3
+					uint32_t(model)|(1u<<8u)|(uint32_t(transfer)<<16u), // BT709 primaries, straight alpha
+					uint32_t(blockDim[0])|(uint32_t(blockDim[1])<<8u)|(uint32_t(blockDim[2])<<16u)|(uint32_t(blockDim[3])<<24u),
+					bytesPlane0,
+					0u
+				};
+				dfd.insert(dfd.end(), samples.begin(), samples.end());
+				return dfd;
+			}
+	};
+
+	//! Sample bounds and qualifiers of an uncompressed channel
+	void addUncompressedSample(CDFDBuilder& _builder, E_FORMAT _fmt, const SChannel& _channel)
+	{
+		uint8_t type = _channel.channel;
+		// alpha is never sRGB encoded
+		if (isSRGBFormat(_fmt) && _channel.channel==EDFC_ALPHA)
+			type |= EDFQ_LINEAR;
+
+		const bool isSigned = isSignedFormat(_fmt);
+		if (isSigned)
+			type |= EDFQ_SIGNED;
+		const uint32_t bits = std::min<uint32_t>(_channel.bitLength, 32u);
+
+		uint32_t lower, upper;
+		if (isFloatingPointFormat(_fmt) || (_channel.channel==EDFC_DEPTH && _fmt==EF_D32_SFLOAT))
+		{
+			type |= EDFQ_FLOAT;
+			lower = isSigned ? FloatMinusOne:0u;
+			upper = FloatOne;
+		}
+		else if (isNormalizedFormat(_fmt) || _channel.channel==EDFC_DEPTH)
+		{
+			const uint64_t max = isSigned ? ((1ull<<(bits-1u))-1ull):((1ull<<bits)-1ull);
+			upper = static_cast<uint32_t>(max);
+			lower = isSigned ? static_cast<uint32_t>(-static_cast<int64_t>(max)):0u;
+		}
+		else
+		{
+			// integer and scaled channels are not normalized, 1 stands for the value 1
+			upper = 1u;
+			lower = isSigned ? 0xffffffffu:0u;
+		}
+		_builder.addSample(_channel.bitOffset, _channel.bitLength, type, lower, upper);
+	}
+
+	//! @returns Number of channels written to `_channels`, 0 if the format is not one of the packed ones
+	uint32_t getPackedChannels(E_FORMAT _fmt, SChannel _channels[4])
+	{
+		auto set = [_channels](std::initializer_list<SChannel> _list) -> uint32_t
+		{
+			std::copy(_list.begin(), _list.end(), _channels);
+			return static_cast<uint32_t>(_list.size());
+		};
+		// bit offsets count from the least significant bit of the little endian word, the first named channel is the most significant
+		switch (_fmt)
+		{
+			case EF_R4G4_UNORM_PACK8: return set({{EDFC_GREEN,0,4},{EDFC_RED,4,4}});
+			case EF_R4G4B4A4_UNORM_PACK16: return set({{EDFC_ALPHA,0,4},{EDFC_BLUE,4,4},{EDFC_GREEN,8,4},{EDFC_RED,12,4}});
+			case EF_B4G4R4A4_UNORM_PACK16: return set({{EDFC_ALPHA,0,4},{EDFC_RED,4,4},{EDFC_GREEN,8,4},{EDFC_BLUE,12,4}});
+			case EF_R5G6B5_UNORM_PACK16: return set({{EDFC_BLUE,0,5},{EDFC_GREEN,5,6},{EDFC_RED,11,5}});
+			case EF_B5G6R5_UNORM_PACK16: return set({{EDFC_RED,0,5},{EDFC_GREEN,5,6},{EDFC_BLUE,11,5}});
+			case EF_R5G5B5A1_UNORM_PACK16: return set({{EDFC_ALPHA,0,1},{EDFC_BLUE,1,5},{EDFC_GREEN,6,5},{EDFC_RED,11,5}});
+			case EF_B5G5R5A1_UNORM_PACK16: return set({{EDFC_ALPHA,0,1},{EDFC_RED,1,5},{EDFC_GREEN,6,5},{EDFC_BLUE,11,5}});
+			case EF_A1R5G5B5_UNORM_PACK16: return set({{EDFC_BLUE,0,5},{EDFC_GREEN,5,5},{EDFC_RED,10,5},{EDFC_ALPHA,15,1}});
+			case EF_B10G11R11_UFLOAT_PACK32: return set({{EDFC_RED,0,11},{EDFC_GREEN,11,11},{EDFC_BLUE,22,10}});
+			case EF_X8_D24_UNORM_PACK32: return set({{EDFC_DEPTH,0,24}});
+			case EF_D16_UNORM: return set({{EDFC_DEPTH,0,16}});
+			case EF_D32_SFLOAT: return set({{EDFC_DEPTH,0,32}});
+			case EF_S8_UINT: return set({{EDFC_STENCIL,0,8}});
+			default:
+				break;
+		}
+		if (_fmt>=EF_A2R10G10B10_UNORM_PACK32 && _fmt<=EF_A2R10G10B10_SINT_PACK32)
+			return set({{EDFC_BLUE,0,10},{EDFC_GREEN,10,10},{EDFC_RED,20,10},{EDFC_ALPHA,30,2}});
+		if (_fmt>=EF_A2B10G10R10_UNORM_PACK32 && _fmt<=EF_A2B10G10R10_SINT_PACK32)
+			return set({{EDFC_RED,0,10},{EDFC_GREEN,10,10},{EDFC_BLUE,20,10},{EDFC_ALPHA,30,2}});
+		return 0u;
+	}
+
+	//! Describes block compressed formats
+	bool createCompressedDFD(E_FORMAT _fmt, core::vector<uint32_t>& _dfd)
+	{
+		const bool isSigned = isSignedFormat(_fmt);
+		const uint8_t sign = isSigned ? EDFQ_SIGNED:0u;
+		const uint32_t lower = isSigned ? 0x80000000u:0u;
+		const uint32_t upper = isSigned ? 0x7fffffffu:0xffffffffu;
+
+		if (_fmt>=EF_ASTC_4x4_UNORM_BLOCK && _fmt<=EF_ASTC_12x12_SRGB_BLOCK)
+		{
+			CDFDBuilder builder(_fmt, EDFM_ASTC);
+			builder.addSample(0u, 128u, 0u, lower, upper);
+			_dfd = builder.finalize();
+			return true;
+		}
+		if (_fmt>=EF_PVRTC1_2BPP_UNORM_BLOCK_IMG && _fmt<=EF_PVRTC2_4BPP_SRGB_BLOCK_IMG)
+		{
+			const bool isPVRTC2 = _fmt==EF_PVRTC2_2BPP_UNORM_BLOCK_IMG || _fmt==EF_PVRTC2_4BPP_UNORM_BLOCK_IMG || _fmt==EF_PVRTC2_2BPP_SRGB_BLOCK_IMG || _fmt==EF_PVRTC2_4BPP_SRGB_BLOCK_IMG;
+			CDFDBuilder builder(_fmt, isPVRTC2 ? EDFM_PVRTC2:EDFM_PVRTC);
+			builder.addSample(0u, 64u, 0u, lower, upper);
+			_dfd = builder.finalize();
+			return true;
+		}
+
+		// {model, first channel, second channel or 0xff if the block is a single sample}
+		uint8_t model, first, second = 0xffu;
+		switch (_fmt)
+		{
+			case EF_BC1_RGB_UNORM_BLOCK: case EF_BC1_RGB_SRGB_BLOCK: model = EDFM_BC1A; first = 0u; break;
+			case EF_BC1_RGBA_UNORM_BLOCK: case EF_BC1_RGBA_SRGB_BLOCK: model = EDFM_BC1A; first = EDFC_BC1A_ALPHA_PRESENT; break;
+			case EF_BC2_UNORM_BLOCK: case EF_BC2_SRGB_BLOCK: model = EDFM_BC2; first = EDFC_ALPHA|EDFQ_LINEAR; second = 0u; break;
+			case EF_BC3_UNORM_BLOCK: case EF_BC3_SRGB_BLOCK: model = EDFM_BC3; first = EDFC_ALPHA|EDFQ_LINEAR; second = 0u; break;
+			case EF_BC4_UNORM_BLOCK: case EF_BC4_SNORM_BLOCK: model = EDFM_BC4; first = sign; break;
+			case EF_BC5_UNORM_BLOCK: case EF_BC5_SNORM_BLOCK: model = EDFM_BC5; first = EDFC_RED|sign; second = EDFC_GREEN|sign; break;
+			case EF_BC7_UNORM_BLOCK: case EF_BC7_SRGB_BLOCK: model = EDFM_BC7; first = 0u; break;
+			case EF_ETC2_R8G8B8_UNORM_BLOCK: case EF_ETC2_R8G8B8_SRGB_BLOCK:
+			case EF_ETC2_R8G8B8A1_UNORM_BLOCK: case EF_ETC2_R8G8B8A1_SRGB_BLOCK: model = EDFM_ETC2; first = EDFC_ETC2_COLOR; break;
+			case EF_ETC2_R8G8B8A8_UNORM_BLOCK: case EF_ETC2_R8G8B8A8_SRGB_BLOCK: model = EDFM_ETC2; first = EDFC_ALPHA|EDFQ_LINEAR; second = EDFC_ETC2_COLOR; break;
+			case EF_EAC_R11_UNORM_BLOCK: case EF_EAC_R11_SNORM_BLOCK: model = EDFM_ETC2; first = EDFC_RED|sign; break;
+			case EF_EAC_R11G11_UNORM_BLOCK: case EF_EAC_R11G11_SNORM_BLOCK: model = EDFM_ETC2; first = EDFC_RED|sign; second = EDFC_GREEN|sign; break;
+			case EF_BC6H_UFLOAT_BLOCK: case EF_BC6H_SFLOAT_BLOCK:
+			{
+				CDFDBuilder builder(_fmt, EDFM_BC6H);
+				builder.addSample(0u, 128u, EDFQ_FLOAT|sign, isSigned ? FloatMinusOne:0u, FloatOne);
+				_dfd = builder.finalize();
+				return true;
+			}
+			default:
+				return false;
+		}
+
+		// the linear qualifier only matters next to sRGB color
+		if (!isSRGBFormat(_fmt))
+			first &= ~EDFQ_LINEAR;
+		CDFDBuilder builder(_fmt, model);
+		const uint32_t bits = getTexelOrBlockBytesize(_fmt)*8u;
+		if (second==0xffu)
+			builder.addSample(0u, bits, first, lower, upper);
+		else
+		{
+			builder.addSample(0u, bits/2u, first, lower, upper);
+			builder.addSample(bits/2u, bits/2u, second, lower, upper);
+		}
+		_dfd = builder.finalize();
+		return true;
+	}
+
+	bool createDFD(E_FORMAT _fmt, core::vector<uint32_t>& _dfd)
+	{
+		if (isBlockCompressionFormat(_fmt))
+			return createCompressedDFD(_fmt, _dfd);
+
+		CDFDBuilder builder(_fmt, EDFM_RGBSDA);
+		if (_fmt==EF_E5B9G9R9_UFLOAT_PACK32)
+		{
+			// every mantissa is followed by the shared exponent
+			for (uint8_t c=0u; c<3u; c++)
+			{
+				builder.addSample(c*9u, 9u, c, 0u, 256u);
+				builder.addSample(27u, 5u, c|EDFQ_EXPONENT, 15u, 31u);
+			}
+			_dfd = builder.finalize();
+			return true;
+		}
+
+		SChannel channels[4];
+		uint32_t channelCount = getPackedChannels(_fmt, channels);
+		if (!channelCount)
+		{
+			// array formats, every channel has the same size and they follow each other in memory
+			channelCount = getFormatChannelCount(_fmt);
+			if (!channelCount || channelCount>4u)
+				return false;
+			const uint8_t bits = static_cast<uint8_t>(getTexelOrBlockBytesize(_fmt)*8u/channelCount);
+			const bool bgr = (_fmt>=EF_B8G8R8_UNORM && _fmt<=EF_B8G8R8_SRGB) || (_fmt>=EF_B8G8R8A8_UNORM && _fmt<=EF_B8G8R8A8_SRGB);
+			const uint8_t order[4] = {bgr ? EDFC_BLUE:EDFC_RED, EDFC_GREEN, bgr ? EDFC_RED:EDFC_BLUE, EDFC_ALPHA};
+			for (uint32_t c=0u; c<channelCount; c++)
+				channels[c] = {order[c], static_cast<uint8_t>(c*bits), bits};
+		}
+		for (uint32_t c=0u; c<channelCount; c++)
+			addUncompressedSample(builder, _fmt, channels[c]);
+		_dfd = builder.finalize();
+		return true;
+	}
+
+	//! Key/value data with just the writer identification, padded to 4 bytes
+	core::vector<uint8_t> createKeyValueData()
+	{
+		const char key[] = "KTXwriter";
+		const char value[] = "IrrlichtBaW";
+		const uint32_t length = sizeof(key)+sizeof(value);
+
+		core::vector<uint8_t> kvd(sizeof(uint32_t)+core::alignUp(length, 4u), 0u);
+		memcpy(kvd.data(), &length, sizeof(length));
+		memcpy(kvd.data()+sizeof(length), key, sizeof(key));
+		memcpy(kvd.data()+sizeof(length)+sizeof(key), value, sizeof(value));
+		return kvd;
+	}
+
+	//! Least common multiple of the texel or block size and 4
+	inline uint64_t getLevelAlignment(E_FORMAT _fmt)
+	{
+		const uint64_t size = getTexelOrBlockBytesize(_fmt);
+		if (size%4u==0u)
+			return size;
+		return size%2u==0u ? size*2u:size*4u;
+	}
+
+	bool writeZeros(io::IWriteFile* _file, size_t _count)
+	{
+		const uint8_t zeros[16] = {};
+		for (; _count; )
+		{
+			const uint32_t chunk = static_cast<uint32_t>(std::min<size_t>(_count, sizeof(zeros)));
+			if (_file->write(zeros, chunk)!=static_cast<int32_t>(chunk))
+				return false;
+			_count -= chunk;
+		}
+		return true;
+	}
+
+	bool writeFully(io::IWriteFile* _file, const void* _data, size_t _size)
+	{
+		const uint8_t* data = reinterpret_cast<const uint8_t*>(_data);
+		while (_size)
+		{
+			const uint32_t chunk = static_cast<uint32_t>(std::min<size_t>(_size, 0x40000000u));
+			if (_file->write(data, chunk)!=static_cast<int32_t>(chunk))
+				return false;
+			data += chunk;
+			_size -= chunk;
+		}
+		return true;
+	}
+}
+
+CImageWriterKTX2::CImageWriterKTX2()
+{
+#ifdef _IRR_DEBUG
+	setDebugName("CImageWriterKTX2");
+#endif
+}
+
+bool CImageWriterKTX2::writeAsset(io::IWriteFile* _file, const SAssetWriteParams& _params, IAssetWriterOverride* _override)
+{
+    if (!_override)
+        getDefaultOverride(_override);
+
+    SAssetWriteContext ctx{_params, _file};
+
+	core::vector<const asset::CImageData*> levels;
+	video::ITexture::E_TEXTURE_TYPE type;
+	if (_params.rootAsset->getAssetType()==IAsset::ET_IMAGE)
+	{
+		const asset::ICPUTexture* texture = static_cast<const asset::ICPUTexture*>(_params.rootAsset);
+		for (uint32_t i=0u; i<=texture->getHighestMip(); i++)
+		{
+			const auto range = texture->getMipMap(i);
+			if (range.second-range.first!=1 || (*range.first)->getSupposedMipLevel()!=i)
+			{
+				os::Printer::log("KTX2 writer needs every mip level of the texture as a single range.", texture->getSourceFilename(), ELL_ERROR);
+				return false;
+			}
+			levels.push_back(*range.first);
+		}
+		type = texture->getType();
+	}
+	else
+	{
+		levels.push_back(static_cast<const asset::CImageData*>(_params.rootAsset));
+		type = levels.front()->getSize().Z>1u ? video::ITexture::ETT_3D:video::ITexture::ETT_2D;
+	}
+
+	const asset::CImageData* base = levels.front();
+	const auto format = base->getColorFormat();
+	const uint32_t vkFormat = CImageLoaderKTX2::getVkFormatFromFormat(format);
+	core::vector<uint32_t> dfd;
+	if (!vkFormat || !createDFD(format, dfd))
+	{
+		os::Printer::log("Unsupported color format, operation aborted.", ELL_ERROR);
+		return false;
+	}
+
+	// the loader's view of the header is what decides the expected size of every level
+	CImageLoaderKTX2::SHeader header;
+	header.format = format;
+	header.type = type;
+	header.levelCount = static_cast<uint32_t>(levels.size());
+	header.supercompressionScheme = CImageLoaderKTX2::ESS_NONE;
+	const auto size = base->getSize();
+	header.pixelWidth = size.X;
+	header.pixelHeight = size.Y;
+	header.pixelDepth = 0u;
+	header.layerCount = 0u;
+	header.faceCount = 1u;
+	switch (type)
+	{
+		case video::ITexture::ETT_1D:
+			header.pixelHeight = 0u;
+			break;
+		case video::ITexture::ETT_1D_ARRAY:
+			header.pixelHeight = 0u;
+			header.layerCount = size.Y;
+			break;
+		case video::ITexture::ETT_2D_ARRAY:
+			header.layerCount = size.Z;
+			break;
+		case video::ITexture::ETT_CUBE_MAP:
+			header.faceCount = 6u;
+			break;
+		case video::ITexture::ETT_CUBE_MAP_ARRAY:
+			header.faceCount = 6u;
+			header.layerCount = size.Z/6u;
+			break;
+		case video::ITexture::ETT_3D:
+			header.pixelDepth = size.Z;
+			break;
+		default:
+			break;
+	}
+
+	for (uint32_t i=0u; i<levels.size(); i++)
+	{
+		uint32_t extent[3];
+		CImageLoaderKTX2::getLevelExtent(header, i, extent);
+		const uint32_t* offset = levels[i]->getOffset();
+		const uint32_t* max = levels[i]->getSliceMax();
+		if (offset[0]||offset[1]||offset[2] || !std::equal(extent, extent+3, max))
+		{
+			os::Printer::log("KTX2 writer only writes whole mip levels, operation aborted.", ELL_ERROR);
+			return false;
+		}
+	}
+
+	io::IWriteFile* file = _override->getOutputFile(_file, ctx, { _params.rootAsset, 0u });
+	const asset::E_WRITER_FLAGS flags = _override->getAssetWritingFlags(ctx, _params.rootAsset, 0u);
+	const float comprLvl = _override->getAssetCompressionLevel(ctx, _params.rootAsset, 0u);
+
+	// KTX2 rows are tightly packed, uncompressed levels with a larger unpack alignment get repacked
+	const bool blockCompressed = isBlockCompressionFormat(format);
+	core::vector<core::vector<uint8_t> > repacked(levels.size());
+	core::vector<std::pair<const uint8_t*, size_t> > levelData(levels.size());
+	for (uint32_t i=0u; i<levels.size(); i++)
+	{
+		const uint8_t* data = reinterpret_cast<const uint8_t*>(levels[i]->getData());
+		if (!data)
+			return false;
+		levelData[i] = {data, levels[i]->getImageDataSizeInBytes()};
+		if (blockCompressed)
+			continue;
+
+		const auto levelSize = levels[i]->getSize();
+		const size_t pitch = levels[i]->getPitchIncludingAlignment();
+		const size_t rowSize = (getBytesPerPixel(format)*levelSize.X).getIntegerApprox();
+		if (pitch==rowSize)
+			continue;
+		const size_t rows = size_t(levelSize.Y)*levelSize.Z;
+		repacked[i].resize(rows*rowSize);
+		for (size_t r=0u; r<rows; r++)
+			memcpy(repacked[i].data()+r*rowSize, data+r*pitch, rowSize);
+		levelData[i] = {repacked[i].data(), repacked[i].size()};
+	}
+
+	core::vector<CImageLoaderKTX2::SLevelIndexEntry> levelIndex(levels.size());
+	for (uint32_t i=0u; i<levels.size(); i++)
+		levelIndex[i].uncompressedByteLength = levelIndex[i].byteLength = levelData[i].second;
+
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	core::vector<core::vector<uint8_t> > compressed;
+	if (flags&asset::EWF_COMPRESSED)
+	{
+		header.supercompressionScheme = CImageLoaderKTX2::ESS_ZLIB;
+		const int zlibLevel = comprLvl>0.f ? core::clamp(static_cast<int>(std::ceil(comprLvl*9.f)), 1, 9):Z_DEFAULT_COMPRESSION;
+
+		compressed.resize(levels.size());
+		std::atomic<bool> success(true);
+		core::parallel_for(0u, levels.size(), [&](size_t i) -> void
+		{
+			uLongf compressedSize = compressBound(static_cast<uLong>(levelData[i].second));
+			compressed[i].resize(compressedSize);
+			if (compress2(compressed[i].data(), &compressedSize, levelData[i].first, static_cast<uLong>(levelData[i].second), zlibLevel)!=Z_OK)
+				success = false;
+			compressed[i].resize(compressedSize);
+		});
+		if (!success)
+		{
+			os::Printer::log("Could not deflate level for KTX2 file.", ELL_ERROR);
+			return false;
+		}
+		for (uint32_t i=0u; i<levels.size(); i++)
+		{
+			levelData[i] = {compressed[i].data(), compressed[i].size()};
+			levelIndex[i].byteLength = compressed[i].size();
+		}
+	}
+#endif
+
+	const core::vector<uint8_t> kvd = createKeyValueData();
+
+	CImageLoaderKTX2::SFileHeader fileHeader;
+	memcpy(fileHeader.identifier, CImageLoaderKTX2::Identifier, sizeof(fileHeader.identifier));
+	fileHeader.vkFormat = vkFormat;
+	// size of the unit endianness conversion would swap, 1 for anything packed into bytes or blocks
+	fileHeader.typeSize = 1u;
+	if (!blockCompressed)
+	{
+		SChannel packed[4];
+		const uint32_t texelSize = getTexelOrBlockBytesize(format);
+		const uint32_t channels = getFormatChannelCount(format);
+		if (getPackedChannels(format, packed) || format==EF_E5B9G9R9_UFLOAT_PACK32)
+			fileHeader.typeSize = texelSize;
+		else if (channels)
+			fileHeader.typeSize = std::max(texelSize/channels, 1u);
+	}
+	fileHeader.pixelWidth = header.pixelWidth;
+	fileHeader.pixelHeight = header.pixelHeight;
+	fileHeader.pixelDepth = header.pixelDepth;
+	fileHeader.layerCount = header.layerCount;
+	fileHeader.faceCount = header.faceCount;
+	fileHeader.levelCount = header.levelCount;
+	fileHeader.supercompressionScheme = header.supercompressionScheme;
+	fileHeader.dfdByteOffset = static_cast<uint32_t>(sizeof(fileHeader)+levelIndex.size()*sizeof(CImageLoaderKTX2::SLevelIndexEntry));
+	fileHeader.dfdByteLength = static_cast<uint32_t>(dfd.size()*sizeof(uint32_t));
+	fileHeader.kvdByteOffset = fileHeader.dfdByteOffset+fileHeader.dfdByteLength;
+	fileHeader.kvdByteLength = static_cast<uint32_t>(kvd.size());
+	fileHeader.sgdByteOffset = 0u;
+	fileHeader.sgdByteLength = 0u;
+
+	// smallest level first so readers can show the mip tail before the rest arrives,
+	// each level aligned so it can be copied straight into a staging buffer
+	const uint64_t alignment = header.supercompressionScheme!=CImageLoaderKTX2::ESS_NONE ? 1u:getLevelAlignment(format);
+	uint64_t offset = fileHeader.kvdByteOffset+fileHeader.kvdByteLength;
+	for (uint32_t i=levels.size(); i--;)
+	{
+		offset = (offset+alignment-1u)/alignment*alignment;
+		levelIndex[i].byteOffset = offset;
+		offset += levelIndex[i].byteLength;
+	}
+
+	if (!writeFully(file, &fileHeader, sizeof(fileHeader)) ||
+		!writeFully(file, levelIndex.data(), levelIndex.size()*sizeof(CImageLoaderKTX2::SLevelIndexEntry)) ||
+		!writeFully(file, dfd.data(), fileHeader.dfdByteLength) ||
+		!writeFully(file, kvd.data(), kvd.size()))
+		return false;
+
+	uint64_t written = fileHeader.kvdByteOffset+fileHeader.kvdByteLength;
+	for (uint32_t i=levels.size(); i--;)
+	{
+		if (!writeZeros(file, static_cast<size_t>(levelIndex[i].byteOffset-written)) || !writeFully(file, levelData[i].first, levelData[i].second))
+			return false;
+		written = levelIndex[i].byteOffset+levelIndex[i].byteLength;
+	}
+
+	return true;
+}
+
+} // namespace asset
+} // namespace irr
+
+#endif
@@ -0,0 +1,47 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#ifndef __IRR_C_IMAGE_WRITER_KTX2_H_INCLUDED__
+#define __IRR_C_IMAGE_WRITER_KTX2_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_KTX2_WRITER_
+
+#include "irr/asset/IAssetWriter.h"
+
+namespace irr
+{
+namespace asset
+{
+
+//! Writes textures of any type and any format KTX2 allows, with all their mip levels
+/** A whole ICPUTexture needs every mip level as a single range covering the whole level, layers and faces included.
+With EWF_COMPRESSED every level is zlib supercompressed on its own (in parallel), the compression level maps onto zlib's 1-9.*/
+class CImageWriterKTX2 : public asset::IAssetWriter
+{
+public:
+	//! constructor
+	CImageWriterKTX2();
+
+    virtual const char** getAssociatedFileExtensions() const
+    {
+        static const char* ext[]{ "ktx2", nullptr };
+        return ext;
+    }
+
+    virtual uint64_t getSupportedAssetTypesBitfield() const override { return asset::IAsset::ET_IMAGE|asset::IAsset::ET_SUB_IMAGE; }
+
+    virtual uint32_t getSupportedFlags() override { return asset::EWF_COMPRESSED; }
+
+    virtual uint32_t getForcedFlags() { return asset::EWF_BINARY; }
+
+    virtual bool writeAsset(io::IWriteFile* _file, const SAssetWriteParams& _params, IAssetWriterOverride* _override = nullptr) override;
+};
+
+} // namespace asset
+} // namespace irr
+
+#endif // _IRR_COMPILE_WITH_KTX2_WRITER_
+#endif
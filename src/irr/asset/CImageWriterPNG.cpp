@@ -7,48 +7,195 @@
 
 #ifdef _IRR_COMPILE_WITH_PNG_WRITER_
 
-#include "CImageLoaderPNG.h"
+#include <atomic>
 
 #include "IWriteFile.h"
 #include "os.h" // for logging
+#include "irr/asset/format/EFormat.h"
 #include "irr/asset/ICPUTexture.h"
 #include "irr/asset/format/convertColor.h"
+#include "irr/core/parallel/parallel_for.h"
 
-#ifdef _IRR_COMPILE_WITH_LIBPNG_
-	#include "libpng/png.h"
-#endif // _IRR_COMPILE_WITH_LIBPNG_
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+	#include "zlib/zlib.h"
+#endif
 
 namespace irr
 {
 namespace asset
 {
 
-#ifdef _IRR_COMPILE_WITH_LIBPNG_
-// PNG function for error handling
-static void png_cpexcept_error(png_structp png_ptr, png_const_charp msg)
+#ifdef _IRR_COMPILE_WITH_ZLIB_
+namespace
 {
-	os::Printer::log("PNG fatal error", msg, ELL_ERROR);
-	longjmp(png_jmpbuf(png_ptr), 1);
-}
+	constexpr uint8_t PNGSignature[8] = {0x89u,'P','N','G',0x0du,0x0au,0x1au,0x0au};
+	//! How far back deflate can reference, the size of the dictionary every strip gets primed with
+	constexpr size_t DeflateWindow = 32ull<<10ull;
+	constexpr size_t MinStripBytes = 64ull<<10ull;
 
-// PNG function for warning handling
-static void png_cpexcept_warning(png_structp png_ptr, png_const_charp msg)
-{
-	os::Printer::log("PNG warning", msg, ELL_WARNING);
-}
+	//! Format the image gets stored as, EF_UNKNOWN if it cannot be converted to anything PNG stores
+	E_FORMAT getPNGFormat(E_FORMAT _format)
+	{
+		switch (_format)
+		{
+			case EF_R8_SRGB:
+			case EF_R8G8B8_SRGB:
+			case EF_R8G8B8A8_SRGB:
+				return _format;
+			default:
+				break;
+		}
+		if (_format==EF_UNKNOWN || isBlockCompressionFormat(_format) || isPlanarFormat(_format) || isIntegerFormat(_format) || isDepthOrStencilFormat(_format))
+			return EF_UNKNOWN;
+		switch (getFormatChannelCount(_format))
+		{
+			case 1u:
+				return EF_R8_SRGB;
+			case 2u:
+			case 3u:
+				return EF_R8G8B8_SRGB;
+			case 4u:
+				return EF_R8G8B8A8_SRGB;
+			default:
+				return EF_UNKNOWN;
+		}
+	}
 
-// PNG function for file writing
-void PNGAPI user_write_data_fcn(png_structp png_ptr, png_bytep data, png_size_t length)
-{
-	png_size_t check;
+	//! Converts one row of `_width` texels to `_pngFormat`, BGRA gets swizzled directly instead of going through convertColor()
+	void convertRow(E_FORMAT _format, E_FORMAT _pngFormat, const uint8_t* _src, uint8_t* _dst, uint32_t _width)
+	{
+		if (_format==EF_B8G8R8A8_SRGB)
+		{
+			uint32_t x = 0u;
+#ifdef __IRR_COMPILE_WITH_SSE3
+			const __m128i mask = _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
+			for (; x+4u<=_width; x+=4u)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(_dst+4u*x), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(_src+4u*x)), mask));
+#endif
+			for (; x<_width; x++)
+			{
+				_dst[4u*x+0u] = _src[4u*x+2u];
+				_dst[4u*x+1u] = _src[4u*x+1u];
+				_dst[4u*x+2u] = _src[4u*x+0u];
+				_dst[4u*x+3u] = _src[4u*x+3u];
+			}
+			return;
+		}
+
+		const void* srcPix[4] = {_src, nullptr, nullptr, nullptr};
+		core::vector3d<uint32_t> rowSize(_width, 1u, 1u);
+		video::convertColor(_format, _pngFormat, srcPix, _dst, _width, rowSize);
+	}
 
-	io::IWriteFile* file=(io::IWriteFile*)png_get_io_ptr(png_ptr);
-	check=(png_size_t) file->write((const void*)data,(uint32_t)length);
+	inline uint8_t paethPredictor(int32_t _a, int32_t _b, int32_t _c)
+	{
+		const int32_t p = _a+_b-_c;
+		const int32_t pa = std::abs(p-_a);
+		const int32_t pb = std::abs(p-_b);
+		const int32_t pc = std::abs(p-_c);
+		if (pa<=pb && pa<=pc)
+			return _a;
+		return pb<=pc ? _b:_c;
+	}
+
+	//! Writes the filter type byte followed by the filtered row, `_prev` is null for the first row
+	void filterRow(CImageWriterPNG::E_PNG_FILTER _filter, const uint8_t* _row, const uint8_t* _prev, uint8_t* _out, uint32_t _rowBytes, uint32_t _bpp)
+	{
+		*(_out++) = static_cast<uint8_t>(_filter);
+		switch (_filter)
+		{
+			case CImageWriterPNG::EPF_SUB:
+				for (uint32_t i=0u; i<_rowBytes; i++)
+					_out[i] = _row[i]-(i>=_bpp ? _row[i-_bpp]:0u);
+				break;
+			case CImageWriterPNG::EPF_UP:
+				for (uint32_t i=0u; i<_rowBytes; i++)
+					_out[i] = _row[i]-(_prev ? _prev[i]:0u);
+				break;
+			case CImageWriterPNG::EPF_AVERAGE:
+				for (uint32_t i=0u; i<_rowBytes; i++)
+				{
+					const uint32_t left = i>=_bpp ? _row[i-_bpp]:0u;
+					const uint32_t up = _prev ? _prev[i]:0u;
+					_out[i] = _row[i]-static_cast<uint8_t>((left+up)>>1u);
+				}
+				break;
+			case CImageWriterPNG::EPF_PAETH:
+				for (uint32_t i=0u; i<_rowBytes; i++)
+				{
+					const int32_t left = i>=_bpp ? _row[i-_bpp]:0;
+					const int32_t up = _prev ? _prev[i]:0;
+					const int32_t upLeft = (_prev && i>=_bpp) ? _prev[i-_bpp]:0;
+					_out[i] = _row[i]-paethPredictor(left, up, upLeft);
+				}
+				break;
+			default:
+				memcpy(_out, _row, _rowBytes);
+				break;
+		}
+	}
+
+	//! Sum of the filtered bytes taken as signed, the heuristic libpng uses to pick a filter per row
+	uint64_t filteredRowCost(const uint8_t* _out, uint32_t _rowBytes)
+	{
+		uint64_t sum = 0u;
+		for (uint32_t i=0u; i<_rowBytes; i++)
+			sum += std::abs(static_cast<int32_t>(static_cast<int8_t>(_out[i])));
+		return sum;
+	}
 
-	if (check != length)
-		png_error(png_ptr, "Write Error");
+	//! Deflates `_data` as a raw deflate stream ending on a byte boundary, so the streams of consecutive strips can be concatenated
+	bool deflateStrip(const uint8_t* _data, size_t _size, const uint8_t* _dictionary, size_t _dictionarySize, bool _last, int _level, core::vector<uint8_t>& _out)
+	{
+		z_stream stream;
+		memset(&stream, 0, sizeof(stream));
+		if (deflateInit2(&stream, _level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY)!=Z_OK)
+			return false;
+		if (_dictionarySize && deflateSetDictionary(&stream, _dictionary, static_cast<uInt>(_dictionarySize))!=Z_OK)
+		{
+			deflateEnd(&stream);
+			return false;
+		}
+
+		// sync flush marker is 5 bytes, the slack covers it
+		const size_t prefix = _out.size();
+		_out.resize(prefix+deflateBound(&stream, static_cast<uLong>(_size))+16u);
+		stream.next_in = const_cast<Bytef*>(_data);
+		stream.avail_in = static_cast<uInt>(_size);
+		stream.next_out = _out.data()+prefix;
+		stream.avail_out = static_cast<uInt>(_out.size()-prefix);
+		const int result = deflate(&stream, _last ? Z_FINISH:Z_SYNC_FLUSH);
+		const bool success = _last ? (result==Z_STREAM_END):(result==Z_OK && stream.avail_in==0u);
+		_out.resize(_out.size()-stream.avail_out);
+		deflateEnd(&stream);
+		return success;
+	}
+
+	inline void writeBigEndian(uint8_t* _out, uint32_t _value)
+	{
+		_out[0] = _value>>24u;
+		_out[1] = _value>>16u;
+		_out[2] = _value>>8u;
+		_out[3] = _value;
+	}
+
+	bool writeChunk(io::IWriteFile* _file, const char _type[4], const uint8_t* _data, uint32_t _size)
+	{
+		uint8_t header[8];
+		writeBigEndian(header, _size);
+		memcpy(header+4u, _type, 4u);
+		uLong crc = crc32(0ul, header+4u, 4u);
+		if (_size)
+			crc = crc32(crc, _data, _size);
+		uint8_t footer[4];
+		writeBigEndian(footer, static_cast<uint32_t>(crc));
+
+		return	_file->write(header, 8u)==8 &&
+				(!_size || _file->write(_data, _size)==static_cast<int32_t>(_size)) &&
+				_file->write(footer, 4u)==4;
+	}
 }
-#endif // _IRR_COMPILE_WITH_LIBPNG_
+#endif // _IRR_COMPILE_WITH_ZLIB_
 
 CImageWriterPNG::CImageWriterPNG()
 {
@@ -61,7 +208,7 @@ bool CImageWriterPNG::writeAsset(io::IWriteFile* _file, const SAssetWriteParams&
 {
     if (!_override)
         getDefaultOverride(_override);
-#ifdef _IRR_COMPILE_WITH_LIBPNG_
+#ifdef _IRR_COMPILE_WITH_ZLIB_
     SAssetWriteContext ctx{_params, _file};
 
     const asset::CImageData* image =
@@ -73,141 +220,139 @@ bool CImageWriterPNG::writeAsset(io::IWriteFile* _file, const SAssetWriteParams&
     assert(image);
 
     io::IWriteFile* file = _override->getOutputFile(_file, ctx, {image, 0u});
+    const asset::E_WRITER_FLAGS flags = _override->getAssetWritingFlags(ctx, image, 0u);
+    const float comprLvl = _override->getAssetCompressionLevel(ctx, image, 0u);
 
 	if (!file || !image)
 		return false;
 
-	// Allocate the png write struct
-	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING,
-		nullptr, (png_error_ptr)png_cpexcept_error, (png_error_ptr)png_cpexcept_warning);
-	if (!png_ptr)
+	const SWriteProperties defaultProperties;
+	const SWriteProperties& properties = _params.userData ? *reinterpret_cast<const SWriteProperties*>(_params.userData):defaultProperties;
+
+	const auto format = image->getColorFormat();
+	const auto pngFormat = getPNGFormat(format);
+	if (pngFormat==EF_UNKNOWN)
 	{
-		os::Printer::log("PNGWriter: Internal PNG create write struct failure\n", file->getFileName().c_str(), ELL_ERROR);
+		os::Printer::log("Unsupported color format, operation aborted.", ELL_ERROR);
 		return false;
 	}
 
-	// Allocate the png info struct
-	png_infop info_ptr = png_create_info_struct(png_ptr);
-	if (!info_ptr)
-	{
-		os::Printer::log("PNGWriter: Internal PNG create info struct failure\n", file->getFileName().c_str(), ELL_ERROR);
-		png_destroy_write_struct(&png_ptr, nullptr);
+	const core::vector3d<uint32_t> dim = image->getSize();
+	const uint32_t bpp = getTexelOrBlockBytesize(pngFormat);
+	const uint32_t rowBytes = bpp*dim.X;
+	const uint32_t height = dim.Y;
+	if (!dim.X || !height)
 		return false;
-	}
 
-	// for proper error handling
-	if (setjmp(png_jmpbuf(png_ptr)))
+	const uint8_t* data = reinterpret_cast<const uint8_t*>(image->getData());
+	const size_t pitch = image->getPitchIncludingAlignment();
+	const uint32_t threadCount = properties.threadCount ? properties.threadCount:core::getDefaultThreadCount();
+
+	// rows already in a format PNG stores are filtered straight from the image
+	core::vector<uint8_t> converted;
+	const uint8_t* rows = data;
+	size_t rowPitch = pitch;
+	if (pngFormat!=format)
 	{
-		png_destroy_write_struct(&png_ptr, &info_ptr);
-		return false;
+		converted.resize(size_t(rowBytes)*height);
+		core::parallel_for(0u, height, [&](size_t y) -> void
+		{
+			convertRow(format, pngFormat, data+y*pitch, converted.data()+y*rowBytes, dim.X);
+		}, threadCount, 16ull);
+		rows = converted.data();
+		rowPitch = rowBytes;
 	}
-	
-	auto format = image->getColorFormat();
-	
-	png_set_write_fn(png_ptr, file, user_write_data_fcn, nullptr);
-	
-	// Set info
-	switch (format)
-	{
-		case asset::EF_R8G8B8_SRGB:
-			png_set_IHDR(png_ptr, info_ptr,
-				image->getSize().X, image->getSize().Y,
-				8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
-				PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
-			break;
-		case asset::EF_R8G8B8A8_SRGB:
-			png_set_IHDR(png_ptr, info_ptr,
-				image->getSize().X, image->getSize().Y,
-				8, PNG_COLOR_TYPE_RGB_ALPHA, PNG_INTERLACE_NONE,
-				PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
-		break;
-		case asset::EF_R8_SRGB:
-		case asset::EF_R8_UNORM:
-			png_set_IHDR(png_ptr, info_ptr,
-				image->getSize().X, image->getSize().Y,
-				8, PNG_COLOR_TYPE_GRAY, PNG_INTERLACE_NONE,
-				PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
-		break;
-		default:
+
+	const size_t filteredRowBytes = rowBytes+1ull;
+	core::vector<uint8_t> filtered(filteredRowBytes*height);
+	core::parallel_for_chunked(0u, height, 16ull, [&](size_t _begin, size_t _end, uint32_t) -> void
+	{
+		core::vector<uint8_t> candidate(properties.filter==EPF_ADAPTIVE ? filteredRowBytes:0ull);
+		for (size_t y=_begin; y<_end; y++)
+		{
+			const uint8_t* row = rows+y*rowPitch;
+			const uint8_t* prev = y ? (row-rowPitch):nullptr;
+			uint8_t* out = filtered.data()+y*filteredRowBytes;
+			if (properties.filter!=EPF_ADAPTIVE)
 			{
-				os::Printer::log("Unsupported color format, operation aborted.", ELL_ERROR);
-				return false;
+				filterRow(properties.filter, row, prev, out, rowBytes, bpp);
+				continue;
 			}
-	}
 
-	int32_t lineWidth = image->getSize().X;
-	switch (format)
-	{
-		case asset::EF_R8_SRGB:
-		case asset::EF_R8_UNORM:
-			lineWidth *= 1;
-			break;
-		case asset::EF_R8G8B8_SRGB:
-			lineWidth *= 3;
-			break;
-		case asset::EF_R8G8B8A8_SRGB:
-			lineWidth *= 4;
-			break;
-		default:
+			uint64_t bestCost = ~0ull;
+			for (uint32_t f=EPF_NONE; f<EPF_ADAPTIVE; f++)
 			{
-				os::Printer::log("Unsupported color format, operation aborted.", ELL_ERROR);
-				return false;
+				filterRow(static_cast<E_PNG_FILTER>(f), row, prev, candidate.data(), rowBytes, bpp);
+				const uint64_t cost = filteredRowCost(candidate.data()+1u, rowBytes);
+				if (cost<bestCost)
+				{
+					bestCost = cost;
+					memcpy(out, candidate.data(), filteredRowBytes);
+				}
 			}
+		}
+	}, threadCount);
+
+	uint32_t stripRows = properties.stripRows;
+	if (!stripRows)
+	{
+		stripRows = (height+threadCount*4u-1u)/(threadCount*4u);
+		stripRows = std::max<uint32_t>(stripRows, static_cast<uint32_t>((MinStripBytes+filteredRowBytes-1u)/filteredRowBytes));
 	}
-	
-	uint8_t* data = (uint8_t*)image->getData();
-	core::vector3d<uint32_t> dim = image->getSize();
+	stripRows = std::min(stripRows, height);
+	const uint32_t stripCount = (height+stripRows-1u)/stripRows;
 
-	constexpr uint32_t maxPNGFileHeight = 16u * 1024u; // arbitrary limit
-	if (dim.Y>maxPNGFileHeight)
+	const int zlibLevel = (flags&asset::EWF_COMPRESSED)&&comprLvl>0.f ? core::clamp(static_cast<int>(std::ceil(comprLvl*9.f)), 1, 9):Z_DEFAULT_COMPRESSION;
+	core::vector<core::vector<uint8_t> > strips(stripCount);
+	core::vector<uLong> checksums(stripCount);
+	std::atomic<bool> success(true);
+	core::parallel_for(0u, stripCount, [&](size_t i) -> void
 	{
-		os::Printer::log("PNGWriter: Image dimensions too big!\n", file->getFileName().c_str(), ELL_ERROR);
-		png_destroy_write_struct(&png_ptr, &info_ptr);
+		const size_t begin = i*stripRows*filteredRowBytes;
+		const size_t end = std::min<size_t>(begin+stripRows*filteredRowBytes, filtered.size());
+		const size_t dictionarySize = std::min(begin, DeflateWindow);
+		if (!deflateStrip(filtered.data()+begin, end-begin, filtered.data()+begin-dictionarySize, dictionarySize, i+1u==stripCount, zlibLevel, strips[i]))
+			success = false;
+		checksums[i] = adler32(adler32(0ul, nullptr, 0u), filtered.data()+begin, static_cast<uInt>(end-begin));
+	}, threadCount);
+	if (!success)
+	{
+		os::Printer::log("PNGWriter: Could not deflate image data\n", file->getFileName().c_str(), ELL_ERROR);
 		return false;
 	}
-	
-	// Create array of pointers to rows in image data
-	png_bytep RowPointers[maxPNGFileHeight];
 
-	// Fill array of pointers to rows in image data
-	for (uint32_t i = 0; i < dim.Y; ++i)
+	// the strips are one zlib stream, its header goes before the first and the combined checksum after the last
+	uLong checksum = checksums[0];
+	for (uint32_t i=1u; i<stripCount; i++)
 	{
-		switch (format) {
-			case asset::EF_R8_UNORM:
-				{
-					const void *src_container[4] = {data, nullptr, nullptr, nullptr};
-					video::convertColor<EF_R8_UNORM, EF_R8_SRGB>(src_container, data, dim.X, dim);
-				}
-				break;
-			case asset::EF_R8_SRGB:
-				_IRR_FALLTHROUGH;
-			case asset::EF_R8G8B8_SRGB:
-				_IRR_FALLTHROUGH;
-			case asset::EF_R8G8B8A8_SRGB:
-				RowPointers[i] = reinterpret_cast<png_bytep>(data);
-				break;
-			default:
-			{
-				os::Printer::log("Unsupported color format, operation aborted.", ELL_ERROR);
-				return false;
-			}
-		}
-		
-		data += lineWidth;
+		const size_t stripSize = std::min<size_t>(size_t(stripRows)*filteredRowBytes, filtered.size()-i*size_t(stripRows)*filteredRowBytes);
+		checksum = adler32_combine(checksum, checksums[i], static_cast<z_off_t>(stripSize));
 	}
-	
-	// for proper error handling
-	if (setjmp(png_jmpbuf(png_ptr)))
 	{
-		png_destroy_write_struct(&png_ptr, &info_ptr);
-		return false;
+		const uint8_t level = zlibLevel==Z_DEFAULT_COMPRESSION ? 2u:(zlibLevel<2 ? 0u:(zlibLevel<6 ? 1u:(zlibLevel==6 ? 2u:3u)));
+		uint8_t zlibHeader[2] = {0x78u, static_cast<uint8_t>(level<<6u)};
+		zlibHeader[1] += 31u-((zlibHeader[0]*256u+zlibHeader[1])%31u);
+		strips.front().insert(strips.front().begin(), zlibHeader, zlibHeader+2);
+		uint8_t adler[4];
+		writeBigEndian(adler, static_cast<uint32_t>(checksum));
+		strips.back().insert(strips.back().end(), adler, adler+4);
 	}
 
-	png_set_rows(png_ptr, info_ptr, RowPointers);
-	png_write_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, nullptr);
+	uint8_t ihdr[13];
+	writeBigEndian(ihdr, dim.X);
+	writeBigEndian(ihdr+4u, height);
+	ihdr[8] = 8u; // bit depth
+	ihdr[9] = pngFormat==EF_R8_SRGB ? 0u:(pngFormat==EF_R8G8B8_SRGB ? 2u:6u); // gray, RGB or RGBA
+	ihdr[10] = 0u; // deflate
+	ihdr[11] = 0u; // adaptive filtering
+	ihdr[12] = 0u; // no interlace
 
-	png_destroy_write_struct(&png_ptr, &info_ptr);
-	return true;
+	if (file->write(PNGSignature, sizeof(PNGSignature))!=static_cast<int32_t>(sizeof(PNGSignature)) || !writeChunk(file, "IHDR", ihdr, sizeof(ihdr)))
+		return false;
+	for (const auto& strip : strips)
+	if (!writeChunk(file, "IDAT", strip.data(), static_cast<uint32_t>(strip.size())))
+		return false;
+	return writeChunk(file, "IEND", nullptr, 0u);
 #else
 	return false;
 #endif
@@ -217,4 +362,3 @@ bool CImageWriterPNG::writeAsset(io::IWriteFile* _file, const SAssetWriteParams&
 } // namespace irr
 
 #endif
-
@@ -16,9 +16,35 @@ namespace irr
 namespace asset
 {
 
+//! Writes 8 bit grayscale, RGB and RGBA PNG files
+/** Any other non-integer, non-compressed format gets converted to the closest of those, in parallel and with SIMD for BGRA.
+The image is split into strips of rows which are filtered and deflated on separate threads, each strip becomes one IDAT chunk
+and is primed with the end of the previous strip as its dictionary, so the file barely grows compared to a single deflate stream.
+With EWF_COMPRESSED the compression level maps onto zlib's 1-9, otherwise zlib's default is used.*/
 class CImageWriterPNG : public asset::IAssetWriter
 {
 public:
+	//! Row filters of the PNG standard, EPF_ADAPTIVE picks the best one for every row like libpng does
+	enum E_PNG_FILTER
+	{
+		EPF_NONE = 0,
+		EPF_SUB,
+		EPF_UP,
+		EPF_AVERAGE,
+		EPF_PAETH,
+		EPF_ADAPTIVE
+	};
+
+	//! Pass through SAssetWriteParams::userData to tune the writer, defaults are used if userData is null
+	struct SWriteProperties
+	{
+		E_PNG_FILTER filter = EPF_ADAPTIVE;
+		//! Rows per independently compressed strip, 0 picks enough strips for every thread to get a few of at least 64kB each
+		uint32_t stripRows = 0u;
+		//! 0 means core::getDefaultThreadCount()
+		uint32_t threadCount = 0u;
+	};
+
 	//! constructor
 	CImageWriterPNG();
 
@@ -30,7 +56,7 @@ public:
 
     virtual uint64_t getSupportedAssetTypesBitfield() const override { return asset::IAsset::ET_SUB_IMAGE; }
 
-    virtual uint32_t getSupportedFlags() override { return 0u; }
+    virtual uint32_t getSupportedFlags() override { return asset::EWF_COMPRESSED; }
 
     virtual uint32_t getForcedFlags() { return asset::EWF_BINARY; }
 
@@ -42,4 +68,3 @@ public:
 
 #endif // _C_IMAGE_WRITER_PNG_H_INCLUDED__
 #endif
-
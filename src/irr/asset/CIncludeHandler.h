@@ -29,14 +29,14 @@ public:
         m_includers.emplace_back(new CBuiltinIncluder, core::dont_grab);
     }
 
-    std::string getIncludeStandard(const std::string& _path) const override
+    std::string getIncludeStandard(const std::string& _path, IIncluder::include_hash_t* _outHash = nullptr) const override
     {
-        return getIncluderDependentOnPath(_path)->getIncludeStandard(_path);
+        return getIncluderDependentOnPath(_path)->getIncludeStandard(_path, _outHash);
     }
 
-    std::string getIncludeRelative(const std::string& _path, const std::string& _workingDirectory) const override
+    std::string getIncludeRelative(const std::string& _path, const std::string& _workingDirectory, IIncluder::include_hash_t* _outHash = nullptr) const override
     {
-        return getIncluderDependentOnPath(_path)->getIncludeRelative(_path, _workingDirectory);
+        return getIncluderDependentOnPath(_path)->getIncludeRelative(_path, _workingDirectory, _outHash);
     }
 
     void addBuiltinIncludeLoader(IBuiltinIncludeLoader* _inclLoader) override
@@ -44,6 +44,12 @@ public:
         static_cast<CBuiltinIncluder*>(m_includers[EII_BUILTIN].get())->addBuiltinLoader(_inclLoader);
     }
 
+    void clearIncludeCache() override
+    {
+        for (auto& includer : m_includers)
+            includer->clearCache();
+    }
+
 private:
     const IIncluder* getIncluderDependentOnPath(const std::string& _path) const
     {
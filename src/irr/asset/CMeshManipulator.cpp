@@ -17,6 +17,7 @@
 #include "irr/asset/CSmoothNormalGenerator.h"
 #include "irr/asset/CForsythVertexCacheOptimizer.h"
 #include "irr/asset/COverdrawMeshOptimizer.h"
+#include "irr/system/CProfiler.h"
 
 namespace irr
 {
@@ -35,6 +36,7 @@ core::vector<QuantizationCacheEntryHalfFloat> normalCacheForHalfFloatQuant;
 //! \param mesh: Mesh on which the operation is performed.
 void IMeshManipulator::flipSurfaces(ICPUMeshBuffer* inbuffer)
 {
+	IRR_PROFILE_ZONE("IMeshManipulator::flipSurfaces");
 	if (!inbuffer)
 		return;
 
@@ -137,6 +139,7 @@ void IMeshManipulator::flipSurfaces(ICPUMeshBuffer* inbuffer)
 
 core::smart_refctd_ptr<ICPUMeshBuffer> CMeshManipulator::createMeshBufferFetchOptimized(const ICPUMeshBuffer* _inbuffer)
 {
+	IRR_PROFILE_ZONE("IMeshManipulator::createMeshBufferFetchOptimized");
 	if (!_inbuffer || !_inbuffer->getMeshDataAndFormat() || !_inbuffer->getIndices())
 		return NULL;
 
@@ -245,6 +248,7 @@ core::smart_refctd_ptr<ICPUMeshBuffer> CMeshManipulator::createMeshBufferFetchOp
 //! Creates a copy of the mesh, which will only consist of unique primitives
 core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createMeshBufferUniquePrimitives(ICPUMeshBuffer* inbuffer, bool _makeIndexBuf)
 {
+	IRR_PROFILE_ZONE("IMeshManipulator::createMeshBufferUniquePrimitives");
 	if (!inbuffer)
 		return 0;
     IMeshDataFormatDesc<ICPUBuffer>* oldDesc = inbuffer->getMeshDataAndFormat();
@@ -353,6 +357,7 @@ core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createMeshBufferUniqueP
 //
 core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::calculateSmoothNormals(ICPUMeshBuffer* inbuffer, bool makeNewMesh, float epsilon, E_VERTEX_ATTRIBUTE_ID normalAttrID, VxCmpFunction vxcmp)
 {
+	IRR_PROFILE_ZONE("IMeshManipulator::calculateSmoothNormals");
 	if (inbuffer == nullptr)
 	{
 		_IRR_DEBUG_BREAK_IF(true);
@@ -417,6 +422,7 @@ static bool cmpVertices(ICPUMeshBuffer* _inbuf, const void* _va, const void* _vb
 //! Creates a copy of a mesh, which will have identical vertices welded together
 core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createMeshBufferWelded(ICPUMeshBuffer *inbuffer, const SErrorMetric* _errMetrics, const bool& optimIndexType, const bool& makeNewMesh)
 {
+    IRR_PROFILE_ZONE("IMeshManipulator::createMeshBufferWelded");
     if (!inbuffer)
         return nullptr;
     IMeshDataFormatDesc<ICPUBuffer>* oldDesc = inbuffer->getMeshDataAndFormat();
@@ -558,6 +564,7 @@ core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createMeshBufferWelded(
 
 core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createOptimizedMeshBuffer(const ICPUMeshBuffer* _inbuffer, const SErrorMetric* _errMetric)
 {
+	IRR_PROFILE_ZONE("IMeshManipulator::createOptimizedMeshBuffer");
 	if (!_inbuffer)
 		return nullptr;
 	auto outbuffer = createMeshBufferDuplicate(_inbuffer);
@@ -730,6 +737,7 @@ core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createOptimizedMeshBuff
 
 void IMeshManipulator::requantizeMeshBuffer(ICPUMeshBuffer* _meshbuffer, const SErrorMetric* _errMetric)
 {
+	IRR_PROFILE_ZONE("IMeshManipulator::requantizeMeshBuffer");
 	CMeshManipulator::SAttrib newAttribs[EVAI_COUNT];
 	for (size_t i = 0u; i < EVAI_COUNT; ++i)
 		newAttribs[i].vaid = (E_VERTEX_ATTRIBUTE_ID)i;
@@ -860,6 +868,7 @@ void CMeshManipulator::copyMeshBufferMemberVars<ICPUSkinnedMeshBuffer>(ICPUSkinn
 
 core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createMeshBufferDuplicate(const ICPUMeshBuffer* _src)
 {
+	IRR_PROFILE_ZONE("IMeshManipulator::createMeshBufferDuplicate");
 	if (!_src)
 		return nullptr;
 
@@ -923,6 +932,7 @@ core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createMeshBufferDuplica
 
 void IMeshManipulator::filterInvalidTriangles(ICPUMeshBuffer* _input)
 {
+    IRR_PROFILE_ZONE("IMeshManipulator::filterInvalidTriangles");
     if (!_input || !_input->getMeshDataAndFormat() || !_input->getIndices())
         return;
 
@@ -16,6 +16,8 @@
 #include "os.h"
 #include "irr/asset/IAssetManager.h"
 
+#include <array>
+
 /*
 namespace std
 {
@@ -51,6 +53,250 @@ namespace asset
 
 static const uint32_t WORD_BUFFER_LENGTH = 512;
 
+namespace
+{
+
+//! Allocation-free replacement for sscanf("%f"), returns the pointer past the number or `_p` if there was none
+inline const char* parseFloat(const char* _p, const char* const _end, float& _out)
+{
+    // powers of ten exactly representable as doubles
+    static const double powersOf10[] = {1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22};
+
+    const char* p = _p;
+    const bool negative = p!=_end && *p=='-';
+    if (p!=_end && (*p=='-'||*p=='+'))
+        p++;
+
+    uint64_t mantissa = 0ull;
+    int32_t exponent = 0;
+    uint32_t significantDigits = 0u;
+    bool anyDigits = false;
+    for (; p!=_end && core::isdigit(*p); p++)
+    {
+        anyDigits = true;
+        if (significantDigits<19u)
+        {
+            mantissa = mantissa*10ull+(*p-'0');
+            significantDigits += mantissa ? 1u:0u;
+        }
+        else
+            exponent++;
+    }
+    if (p!=_end && *p=='.')
+    {
+        for (p++; p!=_end && core::isdigit(*p); p++)
+        {
+            anyDigits = true;
+            if (significantDigits<19u)
+            {
+                mantissa = mantissa*10ull+(*p-'0');
+                significantDigits += mantissa ? 1u:0u;
+                exponent--;
+            }
+        }
+    }
+    if (!anyDigits)
+    {
+        // nan, inf and other oddities are rare enough to go through the CRT
+        char word[32];
+        uint32_t len = 0u;
+        for (; _p+len!=_end && len<31u && !core::isspace(_p[len]); len++)
+            word[len] = _p[len];
+        word[len] = 0;
+        char* wordEnd;
+        _out = strtof(word,&wordEnd);
+        return _p+(wordEnd-word);
+    }
+    if (p!=_end && (*p=='e'||*p=='E'))
+    {
+        const char* expPtr = p+1;
+        const bool negativeExp = expPtr!=_end && *expPtr=='-';
+        if (expPtr!=_end && (*expPtr=='-'||*expPtr=='+'))
+            expPtr++;
+        if (expPtr!=_end && core::isdigit(*expPtr))
+        {
+            int32_t exp = 0;
+            for (; expPtr!=_end && core::isdigit(*expPtr); expPtr++)
+                exp = std::min(exp*10+(*expPtr-'0'),100000);
+            exponent += negativeExp ? (-exp):exp;
+            p = expPtr;
+        }
+    }
+
+    double value = static_cast<double>(mantissa);
+    if (exponent<0)
+        value = exponent>=-22 ? (value/powersOf10[-exponent]):(value*std::pow(10.0,exponent));
+    else if (exponent>0)
+        value = exponent<=22 ? (value*powersOf10[exponent]):(value*std::pow(10.0,exponent));
+    _out = static_cast<float>(negative ? (-value):value);
+    return p;
+}
+
+//! Allocation-free integer parser, returns the pointer past the number or `_p` if there was none
+inline const char* parseInt(const char* _p, const char* const _end, int32_t& _out)
+{
+    const char* p = _p;
+    const bool negative = p!=_end && *p=='-';
+    if (p!=_end && (*p=='-'||*p=='+'))
+        p++;
+    if (p==_end || !core::isdigit(*p))
+        return _p;
+
+    int64_t value = 0;
+    for (; p!=_end && core::isdigit(*p); p++)
+        value = std::min<int64_t>(value*10ll+(*p-'0'),0x7fffffffll);
+    _out = static_cast<int32_t>(negative ? (-value):value);
+    return p;
+}
+
+//! Skips everything core::isspace() does except for line breaks
+inline const char* skipInlineSpaces(const char* _p, const char* const _end)
+{
+    while (_p!=_end && core::isspace(*_p) && *_p!='\n' && *_p!='\r')
+        _p++;
+    return _p;
+}
+
+inline bool isLineEnd(const char* _p, const char* const _end)
+{
+    return _p==_end || *_p=='\n' || *_p=='\r';
+}
+
+//! Face corner as parsed by a chunk, `relativeMask` marks indices which were negative in the file
+//! and hence are relative to the chunk start instead of absolute
+struct SParsedCorner
+{
+    int32_t ix[3];
+    uint32_t relativeMask;
+};
+
+//! Everything that cannot be resolved by the chunk itself, kept in file order
+struct SParsedStatement
+{
+    //! start of a non-face line which needs to be processed in order (mtllib, usemtl, g, s), nullptr for faces
+    const char* line;
+    uint32_t firstCorner;
+    uint32_t cornerCount;
+};
+
+//! Results of parsing one line-aligned piece of the file, filled independently of all other chunks
+struct SParsedChunk
+{
+    core::vector<core::vector3df> positions;
+    core::vector<core::vector3df> normals;
+    core::vector<core::vector2df> uvs;
+    core::vector<SParsedCorner> corners;
+    core::vector<SParsedStatement> statements;
+};
+
+void parseChunk(SParsedChunk& _chunk, const char* _begin, const char* const _end, const bool _flipX)
+{
+    const char* p = _begin;
+    while (p!=_end)
+    {
+        // skip leading whitespace and empty lines
+        while (p!=_end && core::isspace(*p))
+            p++;
+        if (p==_end)
+            break;
+
+        const char* const lineStart = p;
+        switch (*p)
+        {
+            case 'v':
+                if (p+1!=_end && (p[1]==' '||p[1]=='\t'))
+                {
+                    float xyz[3] = {0.f,0.f,0.f};
+                    p = skipInlineSpaces(p+1,_end);
+                    for (uint32_t i=0u; i<3u && !isLineEnd(p,_end); i++)
+                        p = skipInlineSpaces(parseFloat(p,_end,xyz[i]),_end);
+                    // change handedness
+                    xyz[0] = -xyz[0];
+                    if (_flipX)
+                        xyz[0] = -xyz[0];
+                    _chunk.positions.emplace_back(xyz[0],xyz[1],xyz[2]);
+                }
+                else if (p+1!=_end && p[1]=='n')
+                {
+                    float xyz[3] = {0.f,0.f,0.f};
+                    p = skipInlineSpaces(p+2,_end);
+                    for (uint32_t i=0u; i<3u && !isLineEnd(p,_end); i++)
+                        p = skipInlineSpaces(parseFloat(p,_end,xyz[i]),_end);
+                    xyz[0] = -xyz[0];
+                    if (_flipX)
+                        xyz[0] = -xyz[0];
+                    _chunk.normals.emplace_back(xyz[0],xyz[1],xyz[2]);
+                }
+                else if (p+1!=_end && p[1]=='t')
+                {
+                    float uv[2] = {0.f,0.f};
+                    p = skipInlineSpaces(p+2,_end);
+                    for (uint32_t i=0u; i<2u && !isLineEnd(p,_end); i++)
+                        p = skipInlineSpaces(parseFloat(p,_end,uv[i]),_end);
+                    // change handedness
+                    _chunk.uvs.emplace_back(uv[0],1.f-uv[1]);
+                }
+                break;
+            case 'f':
+            {
+                SParsedStatement face = {nullptr,static_cast<uint32_t>(_chunk.corners.size()),0u};
+                const uint32_t localCounts[3] = {static_cast<uint32_t>(_chunk.positions.size()),static_cast<uint32_t>(_chunk.uvs.size()),static_cast<uint32_t>(_chunk.normals.size())};
+                p = skipInlineSpaces(p+1,_end);
+                // a comment can follow the last corner
+                while (!isLineEnd(p,_end) && *p!='#')
+                {
+                    const char* const cornerStart = p;
+                    SParsedCorner corner = {{-1,-1,-1},0u};
+                    for (uint32_t idxType=0u; idxType<3u; idxType++)
+                    {
+                        int32_t raw;
+                        const char* next = parseInt(p,_end,raw);
+                        if (next!=p)
+                        {
+                            if (raw<0)
+                            {
+                                corner.ix[idxType] = static_cast<int32_t>(localCounts[idxType])+raw;
+                                corner.relativeMask |= 0x1u<<idxType;
+                            }
+                            else
+                                corner.ix[idxType] = raw-1;
+                            p = next;
+                        }
+                        if (p==_end || *p!='/')
+                            break;
+                        p++;
+                    }
+                    // skip whatever is left of a malformed corner
+                    while (p!=_end && !core::isspace(*p) && *p!='#')
+                        p++;
+                    p = skipInlineSpaces(p,_end);
+                    if (p==cornerStart)
+                        break;
+                    _chunk.corners.push_back(corner);
+                    face.cornerCount++;
+                }
+                _chunk.statements.push_back(face);
+            }
+                break;
+            case 'm':
+            case 'g':
+            case 's':
+            case 'u':
+                _chunk.statements.push_back({lineStart,0u,0u});
+                break;
+            default: // comments and unsupported statements
+                break;
+        }
+
+        // eat up rest of line
+        while (!isLineEnd(p,_end))
+            p++;
+    }
+}
+
+}
+
+
 
 //! Constructor
 COBJMeshFileLoader::COBJMeshFileLoader(IAssetManager* _manager) : AssetManager(_manager), FileSystem(_manager->getFileSystem())
@@ -68,6 +314,7 @@ COBJMeshFileLoader::~COBJMeshFileLoader()
 
 asset::SAssetBundle COBJMeshFileLoader::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
+    IRR_PROFILE_ZONE("COBJMeshFileLoader::loadAsset");
     SContext ctx(
         asset::IAssetLoader::SAssetLoadContext{
             _params,
@@ -83,10 +330,6 @@ asset::SAssetBundle COBJMeshFileLoader::loadAsset(io::IReadFile* _file, const as
 
 	const uint32_t WORD_BUFFER_LENGTH = 512;
 
-	core::vector<core::vector3df> vertexBuffer;
-	core::vector<core::vector3df> normalsBuffer;
-	core::vector<core::vector2df> textureCoordBuffer;
-
 	SObjMtl * currMtl = new SObjMtl();
 	ctx.Materials.push_back(currMtl);
 	uint32_t smoothingGroup=0;
@@ -95,67 +338,174 @@ asset::SAssetBundle COBJMeshFileLoader::loadAsset(io::IReadFile* _file, const as
 	const io::path relPath = io::IFileSystem::getFileDir(fullName)+"/";
 
 	char* buf = new char[filesize];
-	memset(buf, 0, filesize);
 	_file->read((void*)buf, filesize);
 	const char* const bufEnd = buf+filesize;
 
+	// split the file into line-aligned chunks and parse them all in parallel,
+	// anything depending on the state built up by previous lines (indices, materials, groups) is resolved afterwards
+	constexpr size_t MIN_CHUNK_SIZE = 0x40000ull;
+	const uint32_t threadCount = core::getDefaultThreadCount();
+	const size_t chunkCount = std::max<size_t>(std::min<size_t>(filesize/MIN_CHUNK_SIZE,threadCount*4ull),1ull);
+	core::vector<const char*> chunkBounds(chunkCount+1ull);
+	chunkBounds[0] = buf;
+	for (size_t i=1ull; i<chunkCount; i++)
+	{
+		const char* bound = std::max<const char*>(buf+(filesize*i)/chunkCount,chunkBounds[i-1ull]);
+		while (bound!=bufEnd && *(bound++)!='\n') {}
+		chunkBounds[i] = bound;
+	}
+	chunkBounds[chunkCount] = bufEnd;
+
+	const bool flipX = _params.loaderFlags & E_LOADER_PARAMETER_FLAGS::ELPF_RIGHT_HANDED_MESHES;
+	core::vector<SParsedChunk> chunks(chunkCount);
+	core::parallel_for(0ull,chunkCount,[&](size_t i)
+	{
+		parseChunk(chunks[i],chunkBounds[i],chunkBounds[i+1ull],flipX);
+	},threadCount);
+
+	// parse-time temporaries live in the thread's arena, reclaimed when the scope ends
+	core::LinearArena::SScope arenaScope(core::LinearArena::getThreadArena());
+	core::arena_vector<core::vector3df> vertexBuffer;
+	core::arena_vector<core::vector3df> normalsBuffer;
+	core::arena_vector<core::vector2df> textureCoordBuffer;
+	core::arena_vector<uint32_t> faceCorners;
+	faceCorners.reserve(32); // should be large enough
+	// where every chunk's data begins in the merged buffers, needed to resolve relative indices
+	core::arena_vector<std::array<int32_t,3u> > chunkBases(chunkCount);
+	{
+		size_t counts[3] = {0ull,0ull,0ull};
+		for (size_t i=0ull; i<chunkCount; i++)
+		{
+			chunkBases[i] = {static_cast<int32_t>(counts[0]),static_cast<int32_t>(counts[1]),static_cast<int32_t>(counts[2])};
+			counts[0] += chunks[i].positions.size();
+			counts[1] += chunks[i].uvs.size();
+			counts[2] += chunks[i].normals.size();
+		}
+		vertexBuffer.resize(counts[0]);
+		textureCoordBuffer.resize(counts[1]);
+		normalsBuffer.resize(counts[2]);
+		core::parallel_for(0ull,chunkCount,[&](size_t i)
+		{
+			std::copy(chunks[i].positions.begin(),chunks[i].positions.end(),vertexBuffer.begin()+chunkBases[i][0]);
+			std::copy(chunks[i].uvs.begin(),chunks[i].uvs.end(),textureCoordBuffer.begin()+chunkBases[i][1]);
+			std::copy(chunks[i].normals.begin(),chunks[i].normals.end(),normalsBuffer.begin()+chunkBases[i][2]);
+			core::vector<core::vector3df>().swap(chunks[i].positions);
+			core::vector<core::vector2df>().swap(chunks[i].uvs);
+			core::vector<core::vector3df>().swap(chunks[i].normals);
+		},threadCount);
+	}
+	const int32_t bufferSizes[3] = {static_cast<int32_t>(vertexBuffer.size()),static_cast<int32_t>(textureCoordBuffer.size()),static_cast<int32_t>(normalsBuffer.size())};
+
 	// Process obj information
-	const char* bufPtr = buf;
 	std::string grpName, mtlName;
 	bool mtlChanged=false;
     bool submeshLoadedFromCache = false;
 
-	while(bufPtr != bufEnd)
+	for (size_t chunkIx=0ull; chunkIx<chunkCount; chunkIx++)
+	for (const SParsedStatement& statement : chunks[chunkIx].statements)
 	{
-		switch(bufPtr[0])
-		{
-		case 'm':	// mtllib (material)
+		if (!statement.line) // face
 		{
-			if (ctx.useMaterials)
+            if (submeshLoadedFromCache)
+                continue;
+			// Assign vertex color from currently active material's diffuse color
+			if (mtlChanged)
 			{
-				char name[WORD_BUFFER_LENGTH];
-				bufPtr = goAndCopyNextWord(name, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-#ifdef _IRR_DEBUG_OBJ_LOADER_
-				os::Printer::log("Reading material _file",name);
-#endif
-				readMTL(ctx, name, relPath);
+				// retrieve the material
+				SObjMtl *useMtl = findMtl(ctx, mtlName, grpName);
+				// only change material if we found it
+				if (useMtl)
+					currMtl = useMtl;
+				mtlChanged=false;
 			}
-		}
-			break;
 
-		case 'v':               // v, vn, vt
-            if (submeshLoadedFromCache)
-                break;
-			switch(bufPtr[1])
+			// resolve all vertices in this face, faces referencing nonexistent data are dropped
+			const SParsedCorner* corners = chunks[chunkIx].corners.data()+statement.firstCorner;
+			for (uint32_t c=0u; c<statement.cornerCount; c++)
 			{
-			case ' ':          // vertex
+				int32_t ix[3];
+				for (uint32_t idxType=0u; idxType<3u; idxType++)
 				{
-					core::vector3df vec;
-					bufPtr = readVec3(bufPtr, vec, bufEnd);
-					if (_params.loaderFlags & E_LOADER_PARAMETER_FLAGS::ELPF_RIGHT_HANDED_MESHES)
-						performActionBasedOnOrientationSystem<float>(vec.X, [](float& varToFlip) {varToFlip = -varToFlip;});
-					vertexBuffer.push_back(vec);
+					ix[idxType] = corners[c].ix[idxType];
+					if (corners[c].relativeMask&(0x1u<<idxType))
+						ix[idxType] += chunkBases[chunkIx][idxType];
+					if (ix[idxType]<0 || ix[idxType]>=bufferSizes[idxType])
+						ix[idxType] = -1;
 				}
-				break;
+				if (ix[0]<0)
+				{
+					faceCorners.clear();
+					break;
+				}
+				const SObjIndexTriple key = {ix[0],ix[1],ix[2]};
+				if (key.vn<0)
+					currMtl->RecalculateNormals=true;
 
-			case 'n':       // normal
+				auto found = currMtl->VertMap.find(key);
+				if (found!=currMtl->VertMap.end())
 				{
-					core::vector3df vec;
-					bufPtr = readVec3(bufPtr, vec, bufEnd);
-					if (_params.loaderFlags & E_LOADER_PARAMETER_FLAGS::ELPF_RIGHT_HANDED_MESHES)
-						performActionBasedOnOrientationSystem<float>(vec.X, [](float& varToFlip) {varToFlip = -varToFlip;});
-					normalsBuffer.push_back(vec);
+					faceCorners.push_back(found->second);
+					continue;
 				}
-				break;
 
-			case 't':       // texcoord
+				SObjVertex v;
+				v.pos[0] = vertexBuffer[key.v].X;
+				v.pos[1] = vertexBuffer[key.v].Y;
+				v.pos[2] = vertexBuffer[key.v].Z;
+				//set texcoord
+				if (key.vt>=0)
 				{
-					core::vector2df vec;
-					bufPtr = readUV(bufPtr, vec, bufEnd);
-					textureCoordBuffer.push_back(vec);
+					v.uv[0] = textureCoordBuffer[key.vt].X;
+					v.uv[1] = textureCoordBuffer[key.vt].Y;
 				}
-				break;
+				else
+				{
+					v.uv[0] = 0.f;
+					v.uv[1] = 0.f;
+				}
+				//set normal
+				if (key.vn>=0)
+				{
+					core::vectorSIMDf simdNormal;
+					simdNormal.set(normalsBuffer[key.vn]);
+					v.normal32bit = asset::quantizeNormal2_10_10_10(simdNormal);
+				}
+				else
+					v.normal32bit = 0;
+
+				const uint32_t vertLocation = currMtl->Vertices.size();
+				currMtl->Vertices.push_back(v);
+				currMtl->VertMap.insert({key,vertLocation});
+				faceCorners.push_back(vertLocation);
+			}
+
+			// triangulate the face
+			for ( uint32_t i = 1; i+1 < faceCorners.size(); ++i )
+			{
+				// Add a triangle
+				currMtl->Indices.push_back(faceCorners[i + 1]);
+				currMtl->Indices.push_back(faceCorners[i]);
+				currMtl->Indices.push_back(faceCorners[0]);
+			}
+			faceCorners.resize(0); // fast clear
+			continue;
+		}
+
+		const char* bufPtr = statement.line;
+		switch(bufPtr[0])
+		{
+		case 'm':	// mtllib (material)
+		{
+			if (ctx.useMaterials)
+			{
+				char name[WORD_BUFFER_LENGTH];
+				bufPtr = goAndCopyNextWord(name, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
+#ifdef _IRR_DEBUG_OBJ_LOADER_
+				os::Printer::log("Reading material _file",name);
+#endif
+				readMTL(ctx, name, relPath);
 			}
+		}
 			break;
 
 		case 'g': // group name
@@ -198,7 +548,11 @@ asset::SAssetBundle COBJMeshFileLoader::loadAsset(io::IReadFile* _file, const as
 				if (core::stringc("off")==smooth)
 					smoothingGroup=0;
 				else
-                    sscanf(smooth,"%u",&smoothingGroup);
+				{
+					int32_t group = 0;
+					parseInt(smooth,smooth+strlen(smooth),group);
+					smoothingGroup = group;
+				}
 			}
 			break;
 
@@ -230,111 +584,10 @@ asset::SAssetBundle COBJMeshFileLoader::loadAsset(io::IReadFile* _file, const as
 			}
 			break;
 
-		case 'f':               // face
-		{
-            if (submeshLoadedFromCache)
-                break;
-			char vertexWord[WORD_BUFFER_LENGTH]; // for retrieving vertex data
-			SObjVertex v;
-			// Assign vertex color from currently active material's diffuse color
-			if (mtlChanged)
-			{
-				// retrieve the material
-				SObjMtl *useMtl = findMtl(ctx, mtlName, grpName);
-				// only change material if we found it
-				if (useMtl)
-					currMtl = useMtl;
-				mtlChanged=false;
-			}
-
-			// get all vertices data in this face (current line of obj _file)
-			const core::stringc wordBuffer = copyLine(bufPtr, bufEnd);
-			const char* linePtr = wordBuffer.c_str();
-			const char* const endPtr = linePtr+wordBuffer.size();
-
-			core::vector<uint32_t> faceCorners;
-			faceCorners.reserve(32); // should be large enough
-
-			// read in all vertices
-			linePtr = goNextWord(linePtr, endPtr);
-			while (0 != linePtr[0])
-			{
-				// Array to communicate with retrieveVertexIndices()
-				// sends the buffer sizes and gets the actual indices
-				// if index not set returns -1
-				int32_t Idx[3];
-				Idx[1] = Idx[2] = -1;
-
-				// read in next vertex's data
-				uint32_t wlength = copyWord(vertexWord, linePtr, WORD_BUFFER_LENGTH, endPtr);
-				// this function will also convert obj's 1-based index to c++'s 0-based index
-				retrieveVertexIndices(vertexWord, Idx, vertexWord+wlength+1, vertexBuffer.size(), textureCoordBuffer.size(), normalsBuffer.size());
-				v.pos[0] = vertexBuffer[Idx[0]].X;
-				v.pos[1] = vertexBuffer[Idx[0]].Y;
-				v.pos[2] = vertexBuffer[Idx[0]].Z;
-				//set texcoord
-				if ( -1 != Idx[1] )
-                {
-					v.uv[0] = textureCoordBuffer[Idx[1]].X;
-					v.uv[1] = textureCoordBuffer[Idx[1]].Y;
-                }
-				else
-                {
-					v.uv[0] = 0.f;
-					v.uv[1] = 0.f;
-                }
-                //set normal
-				if ( -1 != Idx[2] )
-                {
-					core::vectorSIMDf simdNormal;
-					simdNormal.set(normalsBuffer[Idx[2]]);
-					v.normal32bit = asset::quantizeNormal2_10_10_10(simdNormal);
-                }
-				else
-				{
-					v.normal32bit = 0;
-					currMtl->RecalculateNormals=true;
-				}
-
-				int vertLocation;
-				core::map<SObjVertex, int>::iterator n = currMtl->VertMap.find(v);
-				if (n!=currMtl->VertMap.end())
-				{
-					vertLocation = n->second;
-				}
-				else
-				{
-					currMtl->Vertices.push_back(v);
-					vertLocation = currMtl->Vertices.size() -1;
-					currMtl->VertMap.insert(std::pair<SObjVertex, int>(v, vertLocation));
-				}
-
-				faceCorners.push_back(vertLocation);
-
-				// go to next vertex
-				linePtr = goNextWord(linePtr, endPtr);
-			}
-
-			// triangulate the face
-			for ( uint32_t i = 1; i < faceCorners.size() - 1; ++i )
-			{
-				// Add a triangle
-				currMtl->Indices.push_back(faceCorners[i + 1]);
-				currMtl->Indices.push_back(faceCorners[i]);
-				currMtl->Indices.push_back(faceCorners[0]);
-			}
-			faceCorners.resize(0); // fast clear
-			faceCorners.reserve(32);
-		}
-		break;
-
-		case '#': // comment
 		default:
 			break;
 		}	// end switch(bufPtr[0])
-		// eat up rest of line
-		bufPtr = goNextLine(bufPtr, bufEnd);
-	}	// end while(bufPtr && (bufPtr-buf<filesize))
+	}	// end for (statement : chunks[chunkIx].statements)
 	// Clean up the allocate obj _file contents
 	delete [] buf;
 
@@ -489,7 +742,7 @@ const char* COBJMeshFileLoader::readTextures(const SContext& _ctx, const char* b
 		if (!strncmp(bufPtr,"-bm",3))
 		{
 			bufPtr = goAndCopyNextWord(textureNameBuf, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-			sscanf(textureNameBuf,"%f",&currMaterial->Material.MaterialTypeParam);
+			parseFloat(textureNameBuf,textureNameBuf+strlen(textureNameBuf),currMaterial->Material.MaterialTypeParam);
 			bufPtr = goAndCopyNextWord(textureNameBuf, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
 			continue;
 		}
@@ -559,7 +812,7 @@ const char* COBJMeshFileLoader::readTextures(const SContext& _ctx, const char* b
 
 	if ((type==ETT_BUMP_MAP) && (core::isdigit(textureNameBuf[0])))
 	{
-		sscanf(textureNameBuf,"%f",&currMaterial->Material.MaterialTypeParam);
+		parseFloat(textureNameBuf,textureNameBuf+strlen(textureNameBuf),currMaterial->Material.MaterialTypeParam);
 		bufPtr = goAndCopyNextWord(textureNameBuf, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
 	}
 	if (clamp)
@@ -689,7 +942,7 @@ void COBJMeshFileLoader::readMTL(SContext& _ctx, const char* fileName, const io:
 
 						bufPtr = goAndCopyNextWord(nsStr, bufPtr, COLOR_BUFFER_LENGTH, bufEnd);
 						float shininessValue;
-						sscanf(nsStr,"%f",&shininessValue);
+						parseFloat(nsStr,nsStr+strlen(nsStr),shininessValue);
 
 						// wavefront shininess is from [0, 1000], so scale for OpenGL
 						shininessValue *= 0.128f;
@@ -751,7 +1004,7 @@ void COBJMeshFileLoader::readMTL(SContext& _ctx, const char* fileName, const io:
 
 				bufPtr = goAndCopyNextWord(dStr, bufPtr, COLOR_BUFFER_LENGTH, bufEnd);
 				float dValue;
-				sscanf(dStr,"%f",&dValue);
+				parseFloat(dStr,dStr+strlen(dStr),dValue);
 
 				currMaterial->Material.DiffuseColor.setAlpha( (int32_t)(dValue * 255) );
 				if (dValue<1.0f)
@@ -774,9 +1027,9 @@ void COBJMeshFileLoader::readMTL(SContext& _ctx, const char* fileName, const io:
 					bufPtr = goAndCopyNextWord(blueStr,  bufPtr, COLOR_BUFFER_LENGTH, bufEnd);
 
 					float red,green,blue;
-					sscanf(redStr,"%f",&red);
-					sscanf(greenStr,"%f",&green);
-					sscanf(blueStr,"%f",&blue);
+					parseFloat(redStr,redStr+strlen(redStr),red);
+					parseFloat(greenStr,greenStr+strlen(greenStr),green);
+					parseFloat(blueStr,blueStr+strlen(blueStr),blue);
 					float transparency = ( red+green+blue ) / 3;
 
 					currMaterial->Material.DiffuseColor.setAlpha( (int32_t)(transparency * 255) );
@@ -811,52 +1064,18 @@ const char* COBJMeshFileLoader::readColor(const char* bufPtr, video::SColor& col
 
 	color.setAlpha(255);
 	bufPtr = goAndCopyNextWord(colStr, bufPtr, COLOR_BUFFER_LENGTH, bufEnd);
-	sscanf(colStr,"%f",&tmp);
+	parseFloat(colStr,colStr+strlen(colStr),tmp);
 	color.setRed((int32_t)(tmp * 255.0f));
 	bufPtr = goAndCopyNextWord(colStr,   bufPtr, COLOR_BUFFER_LENGTH, bufEnd);
-	sscanf(colStr,"%f",&tmp);
+	parseFloat(colStr,colStr+strlen(colStr),tmp);
 	color.setGreen((int32_t)(tmp * 255.0f));
 	bufPtr = goAndCopyNextWord(colStr,   bufPtr, COLOR_BUFFER_LENGTH, bufEnd);
-	sscanf(colStr,"%f",&tmp);
+	parseFloat(colStr,colStr+strlen(colStr),tmp);
 	color.setBlue((int32_t)(tmp * 255.0f));
 	return bufPtr;
 }
 
 
-//! Read 3d vector of floats
-const char* COBJMeshFileLoader::readVec3(const char* bufPtr, core::vector3df& vec, const char* const bufEnd)
-{
-	const uint32_t WORD_BUFFER_LENGTH = 256;
-	char wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	sscanf(wordBuffer,"%f",&vec.X);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	sscanf(wordBuffer,"%f",&vec.Y);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	sscanf(wordBuffer,"%f",&vec.Z);
-
-	vec.X = -vec.X; // change handedness
-	return bufPtr;
-}
-
-
-//! Read 2d vector of floats
-const char* COBJMeshFileLoader::readUV(const char* bufPtr, core::vector2df& vec, const char* const bufEnd)
-{
-	const uint32_t WORD_BUFFER_LENGTH = 256;
-	char wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	sscanf(wordBuffer,"%f",&vec.X);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	sscanf(wordBuffer,"%f",&vec.Y);
-
-	vec.Y = 1-vec.Y; // change handedness
-	return bufPtr;
-}
-
-
 //! Read boolean value represented as 'on' or 'off'
 const char* COBJMeshFileLoader::readBool(const char* bufPtr, bool& tf, const char* const bufEnd)
 {
@@ -970,23 +1189,6 @@ uint32_t COBJMeshFileLoader::copyWord(char* outBuf, const char* const inBuf, uin
 }
 
 
-core::stringc COBJMeshFileLoader::copyLine(const char* inBuf, const char* bufEnd)
-{
-	if (!inBuf)
-		return core::stringc();
-
-	const char* ptr = inBuf;
-	while (ptr<bufEnd)
-	{
-		if (*ptr=='\n' || *ptr=='\r')
-			break;
-		++ptr;
-	}
-	// we must avoid the +1 in case the array is used up
-	return core::stringc(inBuf, (uint32_t)(ptr-inBuf+((ptr < bufEnd) ? 1 : 0)));
-}
-
-
 const char* COBJMeshFileLoader::goAndCopyNextWord(char* outBuf, const char* inBuf, uint32_t outBufLength, const char* bufEnd)
 {
 	inBuf = goNextWord(inBuf, bufEnd, false);
@@ -995,74 +1197,6 @@ const char* COBJMeshFileLoader::goAndCopyNextWord(char* outBuf, const char* inBu
 }
 
 
-bool COBJMeshFileLoader::retrieveVertexIndices(char* vertexData, int32_t* idx, const char* bufEnd, uint32_t vbsize, uint32_t vtsize, uint32_t vnsize)
-{
-	char word[16] = "";
-	const char* p = goFirstWord(vertexData, bufEnd);
-	uint32_t idxType = 0;	// 0 = posIdx, 1 = texcoordIdx, 2 = normalIdx
-
-	uint32_t i = 0;
-	while ( p != bufEnd )
-	{
-		if ( ( core::isdigit(*p)) || (*p == '-') )
-		{
-			// build up the number
-			word[i++] = *p;
-		}
-		else if ( *p == '/' || *p == ' ' || *p == '\0' )
-		{
-			// number is completed. Convert and store it
-			word[i] = '\0';
-			// if no number was found index will become 0 and later on -1 by decrement
-			sscanf(word,"%u",idx+idxType);
-			if (idx[idxType]<0)
-			{
-				switch (idxType)
-				{
-					case 0:
-						idx[idxType] += vbsize;
-						break;
-					case 1:
-						idx[idxType] += vtsize;
-						break;
-					case 2:
-						idx[idxType] += vnsize;
-						break;
-				}
-			}
-			else
-				idx[idxType]-=1;
-
-			// reset the word
-			word[0] = '\0';
-			i = 0;
-
-			// go to the next kind of index type
-			if (*p == '/')
-			{
-				if ( ++idxType > 2 )
-				{
-					// error checking, shouldn't reach here unless file is wrong
-					idxType = 0;
-				}
-			}
-			else
-			{
-				// set all missing values to disable (=-1)
-				while (++idxType < 3)
-					idx[idxType]=-1;
-				++p;
-				break; // while
-			}
-		}
-
-		// go to the next char
-		++p;
-	}
-
-	return true;
-}
-
 std::string COBJMeshFileLoader::genKeyForMeshBuf(const SContext & _ctx, const std::string & _baseKey, const std::string & _mtlName, const std::string & _grpName) const
 {
     if (_ctx.useMaterials)
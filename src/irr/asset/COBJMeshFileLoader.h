@@ -99,6 +99,27 @@ public:
 } PACK_STRUCT;
 #include "irr/irrunpack.h"
 
+//! 0-based (position,texcoord,normal) indices of a face corner, -1 when absent
+struct SObjIndexTriple
+{
+    inline bool operator==(const SObjIndexTriple& other) const
+    {
+        return v==other.v && vt==other.vt && vn==other.vn;
+    }
+
+    struct hash
+    {
+        inline size_t operator()(const SObjIndexTriple& k) const
+        {
+            return (uint64_t(uint32_t(k.v))*4996156539000000107ull)^(uint64_t(uint32_t(k.vt))*620612627000000023ull)^(uint64_t(uint32_t(k.vn))*1231379668000000199ull);
+        }
+    };
+
+    int32_t v;
+    int32_t vt;
+    int32_t vn;
+};
+
 //! Meshloader capable of loading obj meshes.
 class COBJMeshFileLoader : public asset::IAssetLoader
 {
@@ -184,7 +205,7 @@ private:
                 Material = o.Material;
             }
 
-            core::map<SObjVertex, int> VertMap;
+            core::unordered_map<SObjIndexTriple,uint32_t,SObjIndexTriple::hash> VertMap;
             core::vector<SObjVertex> Vertices;
             core::vector<uint32_t> Indices;
             video::SCPUMaterial Material;
@@ -206,9 +227,6 @@ private:
 	const char* goNextLine(const char* buf, const char* const bufEnd);
 	// copies the current word from the inBuf to the outBuf
 	uint32_t copyWord(char* outBuf, const char* inBuf, uint32_t outBufLength, const char* const pBufEnd);
-	// copies the current line from the inBuf to the outBuf
-	core::stringc copyLine(const char* inBuf, const char* const bufEnd);
-
 	// combination of goNextWord followed by copyWord
 	const char* goAndCopyNextWord(char* outBuf, const char* inBuf, uint32_t outBufLength, const char* const pBufEnd);
 
@@ -220,18 +238,9 @@ private:
 
 	//! Read RGB color
 	const char* readColor(const char* bufPtr, video::SColor& color, const char* const pBufEnd);
-	//! Read 3d vector of floats
-	const char* readVec3(const char* bufPtr, core::vector3df& vec, const char* const pBufEnd);
-	//! Read 2d vector of floats
-	const char* readUV(const char* bufPtr, core::vector2df& vec, const char* const pBufEnd);
 	//! Read boolean value represented as 'on' or 'off'
 	const char* readBool(const char* bufPtr, bool& tf, const char* const bufEnd);
 
-	// reads and convert to integer the vertex indices in a line of obj file's face statement
-	// -1 for the index if it doesn't exist
-	// indices are changed to 0-based index instead of 1-based from the obj file
-	bool retrieveVertexIndices(char* vertexData, int32_t* idx, const char* bufEnd, uint32_t vbsize, uint32_t vtsize, uint32_t vnsize);
-
     std::string genKeyForMeshBuf(const SContext& _ctx, const std::string& _baseKey, const std::string& _mtlName, const std::string& _grpName) const;
 
 	IAssetManager* AssetManager;
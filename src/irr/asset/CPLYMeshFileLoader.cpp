@@ -6,6 +6,7 @@
 #ifdef _IRR_COMPILE_WITH_PLY_LOADER_
 
 #include <numeric>
+#include <algorithm>
 
 #include "CPLYMeshFileLoader.h"
 #include "irr/asset/IMeshManipulator.h"
@@ -66,6 +67,7 @@ bool CPLYMeshFileLoader::isALoadableFileFormat(io::IReadFile* _file) const
 //! creates/loads an animated mesh from the file.
 asset::SAssetBundle CPLYMeshFileLoader::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
+	IRR_PROFILE_ZONE("CPLYMeshFileLoader::loadAsset");
 	if (!_file)
 		return {};
 
@@ -242,6 +244,9 @@ asset::SAssetBundle CPLYMeshFileLoader::loadAsset(io::IReadFile* _file, const as
 			core::vector<uint32_t> indices;
 
 			bool hasNormals = true;
+			// binary fixed-width vertices get read straight into the vertex buffer
+			core::smart_refctd_ptr<asset::ICPUBuffer> vertexBlock;
+			SVertexBlockLayout vertexBlockLayout;
 
 			// loop through each of the elements
 			for (uint32_t i=0; i<ctx.ElementList.size(); ++i)
@@ -249,7 +254,14 @@ asset::SAssetBundle CPLYMeshFileLoader::loadAsset(io::IReadFile* _file, const as
 				// do we want this element type?
 				if (ctx.ElementList[i]->Name == "vertex")
 				{
-					// loop through vertex properties
+					if (!vertexBlock && getVertexBlockLayout(ctx, *ctx.ElementList[i], vertexBlockLayout))
+					{
+						vertexBlock = readVertexBlock(ctx, *ctx.ElementList[i], vertexBlockLayout, _params);
+						if (!vertexBlock)
+							return {};
+						hasNormals = vertexBlockLayout.offsets[E_NORM] != SVertexBlockLayout::invalid_offset;
+					}
+					else // loop through vertex properties
 					for (uint32_t j=0; j<ctx.ElementList[i]->Count; ++j)
 						hasNormals &= readVertex(ctx, *ctx.ElementList[i], attribs, _params);
 				}
@@ -279,13 +291,22 @@ asset::SAssetBundle CPLYMeshFileLoader::loadAsset(io::IReadFile* _file, const as
 			else
 			{
 				mb->setPrimitiveType(asset::EPT_POINTS);
-				mb->setIndexCount(attribs[E_POS].size());
+				mb->setIndexCount(vertexBlock ? vertCount:attribs[E_POS].size());
 				//mb->getMaterial().setFlag(video::EMF_POINTCLOUD, true);
 			}
 
+			if (vertexBlock)
+			{
+				const uint32_t stride = vertexBlock->getSize()/vertCount;
+				const asset::E_VERTEX_ATTRIBUTE_ID vaids[4]{ asset::EVAI_ATTR0, asset::EVAI_ATTR1, asset::EVAI_ATTR2, asset::EVAI_ATTR3 };
+				for (uint32_t i = 0u; i < 4u; ++i)
+				if (vertexBlockLayout.offsets[i] != SVertexBlockLayout::invalid_offset)
+					desc->setVertexAttrBuffer(core::smart_refctd_ptr(vertexBlock), vaids[i], vertexBlockLayout.formats[i], stride, vertexBlockLayout.offsets[i]);
+			}
+
 			mb->setMeshDataAndFormat(std::move(desc));
 
-			if (!genVertBuffersForMBuffer(mb.get(), attribs))
+			if (!vertexBlock && !genVertBuffersForMBuffer(mb.get(), attribs))
 				return {};
 
 			mb->recalculateBoundingBox();
@@ -302,6 +323,193 @@ asset::SAssetBundle CPLYMeshFileLoader::loadAsset(io::IReadFile* _file, const as
 }
 
 
+namespace
+{
+	//! Reverses the bytes of every multi-byte property of every vertex in place
+	void byteswapVertices(uint8_t* _data, size_t _vertexCount, uint32_t _stride, const core::vector<uint32_t>& _propertySizes)
+	{
+		size_t vertex = 0u;
+#ifdef __IRR_COMPILE_WITH_SSE3
+		// if every multi-byte property is an aligned 32bit word, no swap crosses a 16 byte lane and a PSHUFB does it all
+		bool wordSwapsOnly = (_stride%4u) == 0u;
+		for (uint32_t i = 0u, offset = 0u; i < _propertySizes.size(); offset += _propertySizes[i++])
+		if (_propertySizes[i]>1u && (_propertySizes[i] != 4u || (offset%4u)))
+			wordSwapsOnly = false;
+
+		if (wordSwapsOnly)
+		{
+			uint32_t gcd = _stride;
+			for (uint32_t b = 16u; b;)
+			{
+				const uint32_t tmp = gcd%b;
+				gcd = b;
+				b = tmp;
+			}
+			// shuffle masks repeat every lcm(_stride,16) bytes
+			const uint32_t periodVertices = 16u/gcd;
+			const uint32_t maskCount = _stride/gcd;
+
+			core::vector<uint8_t> permutation(_stride);
+			for (uint32_t i = 0u, offset = 0u; i < _propertySizes.size(); offset += _propertySizes[i++])
+			for (uint32_t j = 0u; j < _propertySizes[i]; j++)
+				permutation[offset+j] = offset+_propertySizes[i]-1u-j;
+
+			core::vector<uint8_t> masks(maskCount*16u);
+			for (uint32_t i = 0u; i < masks.size(); i++)
+			{
+				const uint32_t inVertex = i%_stride;
+				masks[i] = (i%16u)+permutation[inVertex]-inVertex;
+			}
+
+			const size_t periods = _vertexCount/periodVertices;
+			__m128i* lanes = reinterpret_cast<__m128i*>(_data);
+			for (size_t i = 0u; i < periods; i++)
+			for (uint32_t j = 0u; j < maskCount; j++, lanes++)
+				_mm_storeu_si128(lanes, _mm_shuffle_epi8(_mm_loadu_si128(lanes), _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks.data())+j)));
+			vertex = periods*periodVertices;
+		}
+#endif
+		for (uint8_t* it = _data+vertex*_stride; vertex < _vertexCount; vertex++)
+		for (auto size : _propertySizes)
+		{
+			std::reverse(it, it+size);
+			it += size;
+		}
+	}
+}
+
+bool CPLYMeshFileLoader::getVertexBlockLayout(const SContext& _ctx, const SPLYElement& _el, SVertexBlockLayout& _outLayout) const
+{
+	if (!_ctx.IsBinaryFile || !_el.IsFixedWidth || !_el.Count || !_el.KnownSize)
+		return false;
+
+	core::vector<uint32_t> offsets(_el.Properties.size());
+	for (uint32_t i = 0u, offset = 0u; i < _el.Properties.size(); offset += _el.Properties[i++].size())
+	{
+		// "uint" gets parsed as EPLYPT_INT16, so we cannot trust the computed sizes anymore
+		if (_el.Properties[i].Type == EPLYPT_INT16)
+			return false;
+		offsets[i] = offset;
+	}
+
+	auto findProperty = [&_el](const char* _name, const char* _altName) -> int32_t
+	{
+		for (uint32_t i = 0u; i < _el.Properties.size(); ++i)
+		if (_el.Properties[i].Name == _name || (_altName && _el.Properties[i].Name == _altName))
+			return i;
+		return -1;
+	};
+	// components have to be consecutive properties of the same type, returns false if the attribute is present but unusable
+	auto findAttribute = [&](uint32_t _attr, const char* const* _names, const char* const* _altNames, uint32_t _count, uint32_t _optionalCount) -> bool
+	{
+		_outLayout.offsets[_attr] = SVertexBlockLayout::invalid_offset;
+		int32_t first = -1;
+		for (uint32_t i = 0u; i < _count && first < 0; ++i)
+			first = findProperty(_names[i], _altNames ? _altNames[i] : nullptr);
+		if (first < 0)
+			return true;
+
+		first = findProperty(_names[0], _altNames ? _altNames[0] : nullptr);
+		if (first < 0 || first+_count > _el.Properties.size())
+			return false;
+		const E_PLY_PROPERTY_TYPE type = _el.Properties[first].Type;
+		uint32_t components = 1u;
+		for (; components < _count+_optionalCount && first+components < _el.Properties.size(); ++components)
+		{
+			const auto& prop = _el.Properties[first+components];
+			if (prop.Name != _names[components] && !(_altNames && prop.Name == _altNames[components]))
+				break;
+			if (prop.Type != type)
+				return false;
+		}
+		if (components < _count)
+			return false;
+
+		_outLayout.offsets[_attr] = offsets[first];
+		switch (type)
+		{
+			case EPLYPT_FLOAT32:
+				_outLayout.formats[_attr] = components == 4u ? asset::EF_R32G32B32A32_SFLOAT : (components == 3u ? asset::EF_R32G32B32_SFLOAT : asset::EF_R32G32_SFLOAT);
+				return true;
+			case EPLYPT_INT8:
+				if (_attr != E_COL)
+					return false;
+				_outLayout.formats[_attr] = components == 4u ? asset::EF_R8G8B8A8_UNORM : asset::EF_R8G8B8_UNORM;
+				return true;
+			default:
+				return false;
+		}
+	};
+
+	const char* posNames[] = { "x","y","z" };
+	const char* normNames[] = { "nx","ny","nz" };
+	const char* uvNames[] = { "u","v" };
+	const char* uvAltNames[] = { "s","t" };
+	const char* colNames[] = { "red","green","blue","alpha" };
+	if (!findAttribute(E_POS, posNames, nullptr, 3u, 0u) || _outLayout.offsets[E_POS] == SVertexBlockLayout::invalid_offset)
+		return false;
+	return findAttribute(E_NORM, normNames, nullptr, 3u, 0u) && findAttribute(E_UV, uvNames, uvAltNames, 2u, 0u) && findAttribute(E_COL, colNames, nullptr, 3u, 1u);
+}
+
+core::smart_refctd_ptr<asset::ICPUBuffer> CPLYMeshFileLoader::readVertexBlock(SContext& _ctx, const SPLYElement& _el, const SVertexBlockLayout& _layout, const asset::IAssetLoader::SAssetLoadParams& _params)
+{
+	const size_t blockSize = size_t(_el.Count)*_el.KnownSize;
+	auto buffer = core::make_smart_refctd_ptr<asset::ICPUBuffer>(blockSize);
+	uint8_t* const data = reinterpret_cast<uint8_t*>(buffer->getPointer());
+
+	// whatever the header parsing buffered goes first, the rest of the block bypasses the input buffer
+	const size_t buffered = std::min<size_t>(_ctx.EndPointer-_ctx.StartPointer, blockSize);
+	memcpy(data, _ctx.StartPointer, buffered);
+	if (buffered == blockSize)
+		_ctx.StartPointer += blockSize;
+	else
+	{
+		size_t done = buffered;
+		while (done < blockSize)
+		{
+			const int32_t count = _ctx.File->read(data+done, static_cast<uint32_t>(std::min<size_t>(blockSize-done, 0x40000000ull)));
+			if (count <= 0)
+				break;
+			done += count;
+		}
+		if (done != blockSize)
+		{
+			os::Printer::log("PLY vertex element is truncated", _ctx.File->getFileName().c_str(), ELL_ERROR);
+			return nullptr;
+		}
+
+		_ctx.StartPointer = _ctx.EndPointer = _ctx.Buffer;
+		fillBuffer(_ctx);
+	}
+
+	if (_ctx.IsWrongEndian)
+	{
+		core::vector<uint32_t> propertySizes(_el.Properties.size());
+		for (uint32_t i = 0u; i < _el.Properties.size(); ++i)
+			propertySizes[i] = _el.Properties[i].size();
+		byteswapVertices(data, _el.Count, _el.KnownSize, propertySizes);
+	}
+
+	if (_params.loaderFlags & E_LOADER_PARAMETER_FLAGS::ELPF_RIGHT_HANDED_MESHES)
+	{
+		for (auto attr : { E_POS,E_NORM })
+		{
+			if (_layout.offsets[attr] == SVertexBlockLayout::invalid_offset)
+				continue;
+			for (uint8_t* it = data+_layout.offsets[attr]; it < data+blockSize; it += _el.KnownSize)
+			{
+				float x;
+				memcpy(&x, it, sizeof(float));
+				performActionBasedOnOrientationSystem<float>(x, [](float& varToFlip) { varToFlip = -varToFlip; });
+				memcpy(it, &x, sizeof(float));
+			}
+		}
+	}
+
+	return buffer;
+}
+
+
 bool CPLYMeshFileLoader::readVertex(SContext& _ctx, const SPLYElement& Element, core::vector<core::vectorSIMDf> _outAttribs[4], const asset::IAssetLoader::SAssetLoadParams& _params)
 {
 	if (!_ctx.IsBinaryFile)
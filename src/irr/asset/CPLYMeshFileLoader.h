@@ -152,12 +152,23 @@ private:
 
     enum { E_POS = 0, E_UV = 2, E_NORM = 3, E_COL = 1 };
 
+	//! Where the attributes live inside a binary fixed-width vertex, lets us use the file's vertex block as the vertex buffer
+	struct SVertexBlockLayout
+	{
+		_IRR_STATIC_INLINE_CONSTEXPR uint32_t invalid_offset = 0xdeadbeefu;
+
+		uint32_t offsets[4];
+		asset::E_FORMAT formats[4];
+	};
+
 	bool allocateBuffer(SContext& _ctx);
 	char* getNextLine(SContext& _ctx);
 	char* getNextWord(SContext& _ctx);
 	void fillBuffer(SContext& _ctx);
 	E_PLY_PROPERTY_TYPE getPropertyType(const char* typeString) const;
 
+	bool getVertexBlockLayout(const SContext& _ctx, const SPLYElement& _el, SVertexBlockLayout& _outLayout) const;
+	core::smart_refctd_ptr<asset::ICPUBuffer> readVertexBlock(SContext& _ctx, const SPLYElement& _el, const SVertexBlockLayout& _layout, const asset::IAssetLoader::SAssetLoadParams& _params);
 	bool readVertex(SContext& _ctx, const SPLYElement &Element, core::vector<core::vectorSIMDf> _attribs[4], const asset::IAssetLoader::SAssetLoadParams& _params);
 	bool readFace(SContext& _ctx, const SPLYElement &Element, core::vector<uint32_t>& _outIndices);
 	void skipElement(SContext& _ctx, const SPLYElement &Element);
@@ -8,6 +8,8 @@
 #include "CSTLMeshFileLoader.h"
 #include "irr/asset/normal_quantization.h"
 #include "irr/asset/CCPUMesh.h"
+#include "irr/core/alloc/arena_allocator.h"
+#include "irr/core/parallel/parallel_for.h"
 
 #include "IReadFile.h"
 #include "os.h"
@@ -19,85 +21,146 @@ namespace irr
 	namespace asset
 	{
 
-		asset::SAssetBundle CSTLMeshFileLoader::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
+		namespace
 		{
-			const long filesize = _file->getSize();
-			if (filesize < 6) // we need a header
-				return {};
+			//! pos(12) + normal(4) + optional color(4), all the vertex data an STL can have fits in five words
+			struct SVertexKey
+			{
+				uint32_t data[5];
 
-			bool hasColor = false;
+				inline bool operator==(const SVertexKey& other) const
+				{
+					return memcmp(data, other.data, sizeof(data)) == 0;
+				}
 
-			auto mesh = core::make_smart_refctd_ptr<asset::CCPUMesh>();
-			auto meshbuffer = core::make_smart_refctd_ptr<asset::ICPUMeshBuffer>();
-			auto desc = core::make_smart_refctd_ptr<asset::ICPUMeshDataFormatDesc>();
+				struct hash
+				{
+					inline size_t operator()(const SVertexKey& key) const
+					{
+						uint64_t retval = 0xcbf29ce484222325ull;
+						for (auto word : key.data)
+							retval = (retval^word)*0x100000001b3ull;
+						return static_cast<size_t>(retval);
+					}
+				};
+			};
 
-			meshbuffer->setNormalnAttributeIx(EVAI_ATTR3);
+			//! Merges bitwise identical vertices in place keeping the order of first occurrence, returns the unique vertex count
+			size_t weldVertices(uint8_t* _vertices, size_t _vertexCount, size_t _vertexSize, uint32_t* _outIndices)
+			{
+				core::unordered_map<SVertexKey, uint32_t, SVertexKey::hash> uniqueVertices;
+				uniqueVertices.reserve(_vertexCount/4u);
 
-			bool binary = false;
-			core::stringc token;
-			if (getNextToken(_file, token) != "solid")
-				binary = hasColor = true;
+				size_t uniqueCount = 0u;
+				for (size_t i = 0u; i < _vertexCount; ++i)
+				{
+					SVertexKey key = {};
+					memcpy(key.data, _vertices + i*_vertexSize, _vertexSize);
+					auto found = uniqueVertices.emplace(key, static_cast<uint32_t>(uniqueCount));
+					if (found.second)
+					{
+						// never overwrites a vertex we have not looked at yet
+						if (uniqueCount != i)
+							memcpy(_vertices + uniqueCount*_vertexSize, _vertices + i*_vertexSize, _vertexSize);
+						uniqueCount++;
+					}
+					_outIndices[i] = found.first->second;
+				}
+				return uniqueCount;
+			}
 
-			core::vector<core::vectorSIMDf> positions, normals;
-			core::vector<uint32_t> colors;
-			if (binary)
+			//! Takes ownership of `_vertices` which must have been allocated with `_IRR_ALIGNED_MALLOC`
+			core::smart_refctd_ptr<asset::CCPUMesh> createMesh(uint8_t* _vertices, size_t _vertexCount, bool _hasColor, const asset::IAssetLoader::SAssetLoadParams& _params)
 			{
-				if (_file->getSize() < 80)
-					return {};
+				const size_t vtxSize = _hasColor ? (3 * sizeof(float) + 4 + 4) : (3 * sizeof(float) + 4);
+
+				auto mesh = core::make_smart_refctd_ptr<asset::CCPUMesh>();
+				auto meshbuffer = core::make_smart_refctd_ptr<asset::ICPUMeshBuffer>();
+				auto desc = core::make_smart_refctd_ptr<asset::ICPUMeshDataFormatDesc>();
 
-				_file->seek(80); // skip header
-				uint32_t vtxCnt = 0u;
-				_file->read(&vtxCnt, 4);
-				positions.reserve(3 * vtxCnt);
-				normals.reserve(vtxCnt);
-				colors.reserve(vtxCnt);
+				meshbuffer->setNormalnAttributeIx(EVAI_ATTR3);
+				meshbuffer->setIndexCount(_vertexCount);
+
+				core::smart_refctd_ptr<asset::ICPUBuffer> vertexBuf;
+				if (_params.loaderFlags & asset::IAssetLoader::ELPF_WELD_VERTICES)
+				{
+					auto indexBuf = core::make_smart_refctd_ptr<asset::ICPUBuffer>(_vertexCount * sizeof(uint32_t));
+					const size_t uniqueCount = weldVertices(_vertices, _vertexCount, vtxSize, reinterpret_cast<uint32_t*>(indexBuf->getPointer()));
+
+					// welding usually leaves a fraction of the vertices, so a tight copy is worth it
+					vertexBuf = core::make_smart_refctd_ptr<asset::ICPUBuffer>(uniqueCount * vtxSize);
+					memcpy(vertexBuf->getPointer(), _vertices, vertexBuf->getSize());
+					_IRR_ALIGNED_FREE(_vertices);
+
+					desc->setIndexBuffer(std::move(indexBuf));
+					meshbuffer->setIndexType(asset::EIT_32BIT);
+				}
+				else
+					vertexBuf = core::make_smart_refctd_ptr<asset::CCustomAllocatorCPUBuffer<> >(_vertexCount * vtxSize, _vertices, core::adopt_memory);
+
+				desc->setVertexAttrBuffer(core::smart_refctd_ptr(vertexBuf), asset::EVAI_ATTR0, asset::EF_R32G32B32_SFLOAT, vtxSize, 0);
+				desc->setVertexAttrBuffer(core::smart_refctd_ptr(vertexBuf), asset::EVAI_ATTR3, asset::EF_A2B10G10R10_SNORM_PACK32, vtxSize, 12);
+				if (_hasColor)
+					desc->setVertexAttrBuffer(core::smart_refctd_ptr(vertexBuf), asset::EVAI_ATTR1, asset::EF_B8G8R8A8_UNORM, vtxSize, 16);
+
+				meshbuffer->setMeshDataAndFormat(std::move(desc));
+				mesh->addMeshBuffer(std::move(meshbuffer));
+				//mesh->getMeshBuffer(0)->setPrimitiveType(EPT_POINTS);
+				mesh->recalculateBoundingBox(true);
+
+				return mesh;
 			}
-			else
-				goNextLine(_file); // skip header
+		}
 
+		asset::SAssetBundle CSTLMeshFileLoader::loadAsset(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
+		{
+			IRR_PROFILE_ZONE("CSTLMeshFileLoader::loadAsset");
+			const long filesize = _file->getSize();
+			if (filesize < 6) // we need a header
+				return {};
+
+			core::stringc token;
+			if (getNextToken(_file, token) != "solid")
+				return loadBinary(_file, _params);
+			goNextLine(_file); // skip header
+
+			// parse-time temporaries live in the thread's arena, reclaimed when the scope ends
+			core::LinearArena::SScope arenaScope(core::LinearArena::getThreadArena());
+			core::arena_vector<core::vectorSIMDf> positions, normals;
+			// the arena can not reuse what growing vectors leave behind, so size them for the usual ~256 bytes of text per facet up front
+			const size_t estimatedFacets = static_cast<size_t>(filesize)/256u;
+			positions.reserve(estimatedFacets*3u);
+			normals.reserve(estimatedFacets);
 
-			uint16_t attrib = 0u;
 			token.reserve(32);
 			while (_file->getPos() < filesize)
 			{
-				if (!binary)
+				if (getNextToken(_file, token) != "facet")
 				{
-					if (getNextToken(_file, token) != "facet")
-					{
-						if (token == "endsolid")
-							break;
-						return {};
-					}
-					if (getNextToken(_file, token) != "normal")
-					{
-						return {};
-					}
+					if (token == "endsolid")
+						break;
+					return {};
 				}
-
+				if (getNextToken(_file, token) != "normal")
 				{
-					core::vectorSIMDf n;
-					getNextVector(_file, n, binary);
-					if(_params.loaderFlags & E_LOADER_PARAMETER_FLAGS::ELPF_RIGHT_HANDED_MESHES)
-						performActionBasedOnOrientationSystem<float>(n.x, [](float& varToFlip) {varToFlip = -varToFlip;});
-					normals.push_back(core::normalize(n));
+					return {};
 				}
 
-				if (!binary)
-				{
-					if (getNextToken(_file, token) != "outer" || getNextToken(_file, token) != "loop")
-						return {};
-				}
+				core::vectorSIMDf n;
+				getNextVector(_file, n);
+				if(_params.loaderFlags & E_LOADER_PARAMETER_FLAGS::ELPF_RIGHT_HANDED_MESHES)
+					performActionBasedOnOrientationSystem<float>(n.x, [](float& varToFlip) {varToFlip = -varToFlip;});
+
+				if (getNextToken(_file, token) != "outer" || getNextToken(_file, token) != "loop")
+					return {};
 
 				{
 					core::vectorSIMDf p[3];
 					for (uint32_t i = 0u; i < 3u; ++i)
 					{
-						if (!binary)
-						{
-							if (getNextToken(_file, token) != "vertex")
-								return {};
-						}
-						getNextVector(_file, p[i], binary);
+						if (getNextToken(_file, token) != "vertex")
+							return {};
+						getNextVector(_file, p[i]);
 						if (_params.loaderFlags & E_LOADER_PARAMETER_FLAGS::ELPF_RIGHT_HANDED_MESHES)
 							performActionBasedOnOrientationSystem<float>(p[i].x, [](float& varToFlip){varToFlip = -varToFlip; });
 					}
@@ -105,66 +168,140 @@ namespace irr
 						positions.push_back(p[2u - i]);
 				}
 
-				if (!binary)
-				{
-					if (getNextToken(_file, token) != "endloop" || getNextToken(_file, token) != "endfacet")
-						return {};
-				}
-				else
-				{
-					_file->read(&attrib, 2);
-				}
-
-				if (hasColor && (attrib & 0x8000)) // assuming VisCam/SolidView non-standard trick to store color in 2 bytes of extra attribute
-				{
-					colors.push_back(video::A1R5G5B5toA8R8G8B8(attrib));
-				}
-				else
-				{
-					hasColor = false;
-					colors.clear();
-				}
+				if (getNextToken(_file, token) != "endloop" || getNextToken(_file, token) != "endfacet")
+					return {};
 
-				if ((normals.back() == core::vectorSIMDf()).all())
+				if ((n == core::vectorSIMDf()).all())
 				{
-					normals.back().set(
-						core::plane3dSIMDf(
+					n = core::plane3dSIMDf(
 							*(positions.rbegin() + 2),
 							*(positions.rbegin() + 1),
-							*(positions.rbegin() + 0)).getNormal()
-					);
+							*(positions.rbegin() + 0)).getNormal();
 				}
+				normals.push_back(core::normalize(n));
 			} // end while (_file->getPos() < filesize)
 
-			const size_t vtxSize = hasColor ? (3 * sizeof(float) + 4 + 4) : (3 * sizeof(float) + 4);
+			constexpr size_t vtxSize = 3 * sizeof(float) + 4;
+			uint8_t* vertices = reinterpret_cast<uint8_t*>(_IRR_ALIGNED_MALLOC(std::max<size_t>(vtxSize * positions.size(), 1u), _IRR_SIMD_ALIGNMENT));
+
+			uint32_t normal{};
+			for (size_t i = 0u; i < positions.size(); ++i)
 			{
-				auto vertexBuf = core::make_smart_refctd_ptr<asset::ICPUBuffer>(vtxSize * positions.size());
+				if (i % 3 == 0)
+					normal = asset::quantizeNormal2_10_10_10(normals[i / 3]);
+				uint8_t* ptr = vertices + i * vtxSize;
+				memcpy(ptr, positions[i].pointer, 3 * 4);
+				((uint32_t*)(ptr + 12))[0] = normal;
+			}
+
+			return SAssetBundle({ createMesh(vertices, positions.size(), false, _params) });
+		}
+
+		asset::SAssetBundle CSTLMeshFileLoader::loadBinary(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params)
+		{
+			constexpr size_t HEADER_SIZE = 80u;
+			constexpr size_t TRI_SIZE = 50u; // normal, 3 vertices and a 16bit attribute
+			if (_file->getSize() < HEADER_SIZE + 4u)
+				return {};
+
+			_file->seek(HEADER_SIZE); // skip header
+			uint32_t triCnt = 0u;
+			_file->read(&triCnt, 4);
+			// don't trust the count more than the file size
+			triCnt = static_cast<uint32_t>(std::min<size_t>(triCnt, (_file->getSize() - HEADER_SIZE - 4u) / TRI_SIZE));
+			if (!triCnt)
+				return {};
+
+			// every vertex gets a color slot, it gets squeezed out at the end if not all triangles had a color
+			constexpr size_t vtxSizeWithColor = 3 * sizeof(float) + 4 + 4;
+			constexpr size_t vtxSizeNoColor = 3 * sizeof(float) + 4;
+			const size_t vtxCnt = 3ull * triCnt;
+			uint8_t* vertices = reinterpret_cast<uint8_t*>(_IRR_ALIGNED_MALLOC(vtxSizeWithColor * vtxCnt, _IRR_SIMD_ALIGNMENT));
+			if (!vertices)
+				return {};
 
-				uint32_t normal{};
-				for (size_t i = 0u; i < positions.size(); ++i)
+			// triangles are read in big blocks, the padding lets the last one be unpacked with full 16 byte loads
+			constexpr uint32_t BLOCK_TRIS = 0x10000u;
+			core::LinearArena::SScope arenaScope(core::LinearArena::getThreadArena());
+			core::arena_vector<uint8_t> block(BLOCK_TRIS * TRI_SIZE + 16u);
+
+			// mechanical parts are mostly flat, so there are far fewer unique normals than triangles and each gets quantized once
+			core::unordered_map<SVertexKey, uint32_t, SVertexKey::hash> normalIDs;
+			core::vector<core::vectorSIMDf> uniqueNormals;
+
+			const core::vectorSIMDf flipX = (_params.loaderFlags & E_LOADER_PARAMETER_FLAGS::ELPF_RIGHT_HANDED_MESHES) ? core::vectorSIMDf(1.f) : core::vectorSIMDf(-1.f, 1.f, 1.f, 1.f);
+			bool hasColor = true;
+			uint8_t* out = vertices;
+			for (uint32_t first = 0u; first < triCnt; first += BLOCK_TRIS)
+			{
+				const uint32_t count = std::min(BLOCK_TRIS, triCnt - first);
+				if (_file->read(block.data(), count * TRI_SIZE) != static_cast<int32_t>(count * TRI_SIZE))
 				{
-					if (i % 3 == 0)
-						normal = asset::quantizeNormal2_10_10_10(normals[i / 3]);
-					uint8_t* ptr = ((uint8_t*)(vertexBuf->getPointer())) + i * vtxSize;
-					memcpy(ptr, positions[i].pointer, 3 * 4);
-					((uint32_t*)(ptr + 12))[0] = normal;
-					if (hasColor)
-						memcpy(ptr + 16, colors.data() + i / 3, 4);
+					_IRR_ALIGNED_FREE(vertices);
+					return {};
 				}
 
-				desc->setVertexAttrBuffer(core::smart_refctd_ptr(vertexBuf), asset::EVAI_ATTR0, asset::EF_R32G32B32_SFLOAT, vtxSize, 0);
-				desc->setVertexAttrBuffer(core::smart_refctd_ptr(vertexBuf), asset::EVAI_ATTR3, asset::EF_A2B10G10R10_SNORM_PACK32, vtxSize, 12);
-				if (hasColor)
-					desc->setVertexAttrBuffer(core::smart_refctd_ptr(vertexBuf), asset::EVAI_ATTR1, asset::EF_B8G8R8A8_UNORM, vtxSize, 16);
+				for (uint32_t i = 0u; i < count; ++i)
+				{
+					const uint8_t* tri = block.data() + i * TRI_SIZE;
+					const float* floats = reinterpret_cast<const float*>(tri);
+
+					core::vectorSIMDf n = core::vectorSIMDf(floats) * flipX;
+					core::vectorSIMDf p[3];
+					for (uint32_t j = 0u; j < 3u; ++j)
+					{
+						p[j] = core::vectorSIMDf(floats + 3u * (j + 1u)) * flipX;
+						p[j].makeSafe3D();
+					}
+					n.makeSafe3D();
+					// seems like in STL format vertices are ordered in clockwise manner...
+					if ((n == core::vectorSIMDf()).all())
+						n = core::plane3dSIMDf(p[2], p[1], p[0]).getNormal();
+					else
+						n = core::normalize(n);
+
+					SVertexKey key = {};
+					memcpy(key.data, n.pointer, 3u * sizeof(float));
+					auto found = normalIDs.emplace(key, static_cast<uint32_t>(uniqueNormals.size()));
+					if (found.second)
+						uniqueNormals.push_back(n);
+					const uint32_t normalID = found.first->second;
+
+					uint16_t attrib;
+					memcpy(&attrib, tri + 48, 2);
+					// assuming VisCam/SolidView non-standard trick to store color in 2 bytes of extra attribute
+					hasColor = hasColor && (attrib & 0x8000);
+					const uint32_t color = video::A1R5G5B5toA8R8G8B8(attrib);
+
+					for (uint32_t j = 0u; j < 3u; ++j, out += vtxSizeWithColor)
+					{
+						// the store spills into the normal slot, which gets written right after
+						p[2u - j].storeTo4Floats(reinterpret_cast<float*>(out));
+						memcpy(out + 12, &normalID, 4);
+						memcpy(out + 16, &color, 4);
+					}
+				}
 			}
-			meshbuffer->setMeshDataAndFormat(std::move(desc));
-			mesh->addMeshBuffer(std::move(meshbuffer));
 
-			mesh->getMeshBuffer(0)->setIndexCount(positions.size());
-			//mesh->getMeshBuffer(0)->setPrimitiveType(EPT_POINTS);
-			mesh->recalculateBoundingBox(true);
+			core::vector<uint32_t> quantizedNormals(uniqueNormals.size());
+			core::parallel_for(0u, uniqueNormals.size(), [&](size_t i)
+			{
+				quantizedNormals[i] = asset::quantizeNormal2_10_10_10_uncached(uniqueNormals[i]);
+			});
+
+			const size_t vtxSize = hasColor ? vtxSizeWithColor : vtxSizeNoColor;
+			for (size_t i = 0u; i < vtxCnt; ++i)
+			{
+				uint8_t* const src = vertices + i * vtxSizeWithColor;
+				uint8_t* const dst = vertices + i * vtxSize;
+				uint32_t normalID;
+				memcpy(&normalID, src + 12, 4);
+				if (dst != src)
+					memmove(dst, src, vtxSize);
+				memcpy(dst + 12, quantizedNormals.data() + normalID, 4);
+			}
 
-			return SAssetBundle({ std::move(mesh) });
+			return SAssetBundle({ createMesh(vertices, vtxCnt, hasColor, _params) });
 		}
 
 		bool CSTLMeshFileLoader::isALoadableFileFormat(io::IReadFile* _file) const
@@ -197,26 +334,17 @@ namespace irr
 		}
 
 		//! Read 3d vector of floats
-		void CSTLMeshFileLoader::getNextVector(io::IReadFile* file, core::vectorSIMDf& vec, bool binary) const
+		void CSTLMeshFileLoader::getNextVector(io::IReadFile* file, core::vectorSIMDf& vec) const
 		{
-			if (binary)
-			{
-				file->read(&vec.X, 4);
-				file->read(&vec.Y, 4);
-				file->read(&vec.Z, 4);
-			}
-			else
-			{
-				goNextWord(file);
-				core::stringc tmp;
-
-				getNextToken(file, tmp);
-				sscanf(tmp.c_str(), "%f", &vec.X);
-				getNextToken(file, tmp);
-				sscanf(tmp.c_str(), "%f", &vec.Y);
-				getNextToken(file, tmp);
-				sscanf(tmp.c_str(), "%f", &vec.Z);
-			}
+			goNextWord(file);
+			core::stringc tmp;
+
+			getNextToken(file, tmp);
+			sscanf(tmp.c_str(), "%f", &vec.X);
+			getNextToken(file, tmp);
+			sscanf(tmp.c_str(), "%f", &vec.Y);
+			getNextToken(file, tmp);
+			sscanf(tmp.c_str(), "%f", &vec.Z);
 			vec.X = -vec.X;
 		}
 
@@ -37,7 +37,10 @@ private:
 	void goNextLine(io::IReadFile* file) const;
 
 	//! Read 3d vector of floats
-	void getNextVector(io::IReadFile* file, core::vectorSIMDf& vec, bool binary) const;
+	void getNextVector(io::IReadFile* file, core::vectorSIMDf& vec) const;
+
+	//! Binary STL is a fixed 50 byte record per triangle, so it gets read and unpacked in large blocks
+	asset::SAssetBundle loadBinary(io::IReadFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params);
 
 	template<typename aType>
 	static inline void performActionBasedOnOrientationSystem(aType& varToHandle, void (*performOnCertainOrientation)(aType& varToHandle))
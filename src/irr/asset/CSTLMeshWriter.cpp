@@ -62,14 +62,27 @@ bool CSTLMeshWriter::writeAsset(io::IWriteFile* _file, const SAssetWriteParams&
 
 namespace
 {
+//! Triangles are assembled into a staging block of this many records and written with a single call
+constexpr uint32_t STL_BLOCK_TRIS = 0x10000u;
+constexpr size_t STL_TRI_SIZE = 50u;
+
 template <class I>
-inline void writeFacesBinary(asset::ICPUMeshBuffer* buffer, const bool& noIndices, io::IWriteFile* file, asset::E_VERTEX_ATTRIBUTE_ID _colorVaid, const irr::asset::IAssetWriter::SAssetWriteParams& _params)
+inline void writeFacesBinary(asset::ICPUMeshBuffer* buffer, const bool& noIndices, io::IWriteFile* file, asset::E_VERTEX_ATTRIBUTE_ID _colorVaid, const irr::asset::IAssetWriter::SAssetWriteParams& _params, core::vector<uint8_t>& _block)
 {
     bool hasColor = buffer->getMeshDataAndFormat()->getMappedBuffer(_colorVaid);
     const asset::E_FORMAT colorType = buffer->getMeshDataAndFormat()->getAttribFormat(_colorVaid);
 
+    // the common formats get read straight from memory instead of going through getAttribute
+    const asset::E_VERTEX_ATTRIBUTE_ID posVaid = buffer->getPositionAttributeIx();
+    const asset::E_FORMAT posType = buffer->getMeshDataAndFormat()->getAttribFormat(posVaid);
+    const uint8_t* posPtr = (posType == asset::EF_R32G32B32_SFLOAT || posType == asset::EF_R32G32B32A32_SFLOAT) ? buffer->getAttribPointer(posVaid) : nullptr;
+    const size_t posStride = buffer->getMeshDataAndFormat()->getMappedBufferStride(posVaid);
+    const uint8_t* colorPtr = hasColor && (colorType == asset::EF_B8G8R8A8_UNORM || colorType == asset::EF_R8G8B8A8_UNORM) ? buffer->getAttribPointer(_colorVaid) : nullptr;
+    const size_t colorStride = hasColor ? buffer->getMeshDataAndFormat()->getMappedBufferStride(_colorVaid) : 0u;
+
     const uint32_t indexCount = buffer->getIndexCount();
-    for (uint32_t j = 0u; j < indexCount; j += 3u)
+    uint32_t blockTris = 0u;
+    for (uint32_t j = 0u; j+2u < indexCount; j += 3u)
     {
         I idx[3];
         for (uint32_t i = 0u; i < 3u; ++i)
@@ -82,14 +95,36 @@ inline void writeFacesBinary(asset::ICPUMeshBuffer* buffer, const bool& noIndice
 
         core::vectorSIMDf v[3];
         for (uint32_t i = 0u; i < 3u; ++i)
-            v[i] = buffer->getPosition(idx[i]);
+        {
+            if (posPtr)
+            {
+                v[i] = core::vectorSIMDf(0.f, 0.f, 0.f, 1.f);
+                memcpy(v[i].pointer, posPtr + idx[i] * posStride, 3u * sizeof(float));
+            }
+            else
+                v[i] = buffer->getPosition(idx[i]);
+        }
 
         uint16_t color = 0u;
-        if (hasColor)
+        if (colorPtr)
+        {
+            uint32_t res[3]{};
+            for (uint32_t i = 0u; i < 3u; ++i)
+            {
+                const uint8_t* c = colorPtr + idx[i] * colorStride;
+                for (uint32_t k = 0u; k < 3u; ++k)
+                    res[k] += c[k];
+            }
+            // RGB16 wants red first
+            if (colorType == asset::EF_B8G8R8A8_UNORM)
+                std::swap(res[0], res[2]);
+            color = video::RGB16(res[0]/3, res[1]/3, res[2]/3);
+        }
+        else if (hasColor)
         {
             if (asset::isIntegerFormat(colorType))
             {
-                uint32_t res[4];
+                uint32_t res[4]{};
                 for (uint32_t i = 0u; i < 3u; ++i)
                 {
                     uint32_t d[4];
@@ -107,7 +142,7 @@ inline void writeFacesBinary(asset::ICPUMeshBuffer* buffer, const bool& noIndice
                     buffer->getAttribute(d, _colorVaid, idx[i]);
                     res += d;
                 }
-                res /= 3.f;
+                res *= 255.f/3.f;
                 color = video::RGB16(res.X, res.Y, res.Z);
             }
         }
@@ -128,12 +163,20 @@ inline void writeFacesBinary(asset::ICPUMeshBuffer* buffer, const bool& noIndice
 		if (!(_params.flags & E_WRITER_FLAGS::EWF_MESH_IS_RIGHT_HANDED))
 			flipVectors();
 
-        file->write(&normal, 12);
-        file->write(&vertex1, 12);
-        file->write(&vertex2, 12);
-        file->write(&vertex3, 12);
-        file->write(&color, 2); // saving color using non-standard VisCAM/SolidView trick
+        uint8_t* record = _block.data() + blockTris * STL_TRI_SIZE;
+        memcpy(record, normal.pointer, 12);
+        memcpy(record + 12, vertex1.pointer, 12);
+        memcpy(record + 24, vertex2.pointer, 12);
+        memcpy(record + 36, vertex3.pointer, 12);
+        memcpy(record + 48, &color, 2); // saving color using non-standard VisCAM/SolidView trick
+        if (++blockTris == STL_BLOCK_TRIS)
+        {
+            file->write(_block.data(), blockTris * STL_TRI_SIZE);
+            blockTris = 0u;
+        }
     }
+    if (blockTris)
+        file->write(_block.data(), blockTris * STL_TRI_SIZE);
 }
 }
 
@@ -161,6 +204,7 @@ bool CSTLMeshWriter::writeMeshBinary(io::IWriteFile* file, const asset::ICPUMesh
 
 	// write mesh buffers
 
+	core::vector<uint8_t> block(STL_BLOCK_TRIS*STL_TRI_SIZE);
 	for (uint32_t i=0; i<mesh->getMeshBufferCount(); ++i)
 	{
 		asset::ICPUMeshBuffer* buffer = mesh->getMeshBuffer(i);
@@ -171,15 +215,15 @@ bool CSTLMeshWriter::writeMeshBinary(io::IWriteFile* file, const asset::ICPUMesh
                 type = asset::EIT_UNKNOWN;
 			if (type== asset::EIT_16BIT)
             {
-                writeFacesBinary<uint16_t>(buffer, false, file, asset::EVAI_ATTR1, _params);
+                writeFacesBinary<uint16_t>(buffer, false, file, asset::EVAI_ATTR1, _params, block);
             }
 			else if (type== asset::EIT_32BIT)
             {
-                writeFacesBinary<uint32_t>(buffer, false, file, asset::EVAI_ATTR1, _params);
+                writeFacesBinary<uint32_t>(buffer, false, file, asset::EVAI_ATTR1, _params, block);
             }
 			else
             {
-                writeFacesBinary<uint16_t>(buffer, true, file, asset::EVAI_ATTR1, _params); //template param doesn't matter if there's no indices
+                writeFacesBinary<uint32_t>(buffer, true, file, asset::EVAI_ATTR1, _params, block); //template param doesn't matter if there's no indices, but has to hold any vertex index
             }
 		}
 	}
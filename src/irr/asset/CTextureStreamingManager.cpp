@@ -0,0 +1,309 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "irr/asset/CTextureStreamingManager.h"
+
+#ifdef _IRR_COMPILE_WITH_KTX2_LOADER_
+
+#include <algorithm>
+#include <cfloat>
+
+#include "IReadFile.h"
+#include "os.h"
+#include "irr/asset/CImageLoaderKTX2.h"
+
+namespace irr
+{
+namespace asset
+{
+
+struct CTextureStreamingManager::CStreamedTexture::SKTX2Header : CImageLoaderKTX2::SHeader
+{
+};
+
+CTextureStreamingManager::CStreamedTexture::CStreamedTexture(const io::path& _filename) : m_filename(_filename), m_header(new SKTX2Header)
+{
+}
+
+CTextureStreamingManager::CStreamedTexture::~CStreamedTexture()
+{
+	for (auto level : m_levels)
+	if (level)
+		level->drop();
+	delete m_header;
+}
+
+
+CTextureStreamingManager::CTextureStreamingManager(core::smart_refctd_ptr<io::IFileSystem>&& _fileSystem, const SCreationParams& _params)
+	: m_fileSystem(std::move(_fileSystem)), m_params(_params)
+{
+	const uint32_t threadCount = std::max(m_params.threadCount, 1u);
+	m_workers.reserve(threadCount);
+	for (uint32_t i=0u; i<threadCount; i++)
+		m_workers.emplace_back(&CTextureStreamingManager::workerMain, this);
+}
+
+CTextureStreamingManager::~CTextureStreamingManager()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_queueMutex);
+		m_quit = true;
+		for (auto& request : m_requests)
+			request.file->drop();
+		m_requests.clear();
+	}
+	m_queueCondition.notify_all();
+	for (auto& worker : m_workers)
+		worker.join();
+
+	for (auto& result : m_results)
+	if (result.image)
+		result.image->drop();
+}
+
+core::smart_refctd_ptr<CTextureStreamingManager::CStreamedTexture> CTextureStreamingManager::addTexture(const io::path& _filename)
+{
+	io::IReadFile* file = m_fileSystem->createAndOpenFile(_filename);
+	if (!file)
+	{
+		os::Printer::log("Could not open texture to stream", _filename.c_str(), ELL_ERROR);
+		return nullptr;
+	}
+
+	core::smart_refctd_ptr<CStreamedTexture> texture(new CStreamedTexture(_filename), core::dont_grab);
+	auto& header = *texture->m_header;
+	if (!CImageLoaderKTX2::readHeader(file, header))
+	{
+		file->drop();
+		return nullptr;
+	}
+
+	texture->m_baseExtent = std::max(std::max(header.pixelWidth, header.pixelHeight), header.pixelDepth);
+	texture->m_levels.resize(header.levelCount, nullptr);
+	texture->m_levelSizes.resize(header.levelCount);
+	for (uint32_t i=0u; i<header.levelCount; i++)
+	{
+		const auto& entry = header.levels[i];
+		texture->m_levelSizes[i] = header.supercompressionScheme!=CImageLoaderKTX2::ESS_NONE ? entry.uncompressedByteLength:entry.byteLength;
+	}
+	texture->m_tailBase = header.levelCount-1u;
+	while (texture->m_tailBase && texture->getLevelExtent(texture->m_tailBase-1u)<=m_params.mipTailExtent)
+		texture->m_tailBase--;
+
+	// the mip tail is read straight away, smallest level first like the file stores them
+	for (uint32_t i=header.levelCount; i-- > texture->m_tailBase;)
+	{
+		CImageData* image = CImageLoaderKTX2::readLevel(file, header, i);
+		if (!image)
+		{
+			os::Printer::log("Could not read mip tail of texture", _filename.c_str(), ELL_ERROR);
+			file->drop();
+			return nullptr;
+		}
+		texture->m_levels[i] = image;
+		texture->m_residentBase = i;
+		m_residentBytes += texture->m_levelSizes[i];
+	}
+	file->drop();
+
+	texture->m_texture = core::smart_refctd_ptr<ICPUTexture>(ICPUTexture::create(texture->m_levels.begin()+texture->m_residentBase, texture->m_levels.end(), _filename.c_str(), header.type), core::dont_grab);
+	if (!texture->m_texture)
+	{
+		os::Printer::log("Could not create texture from mip tail", _filename.c_str(), ELL_ERROR);
+		return nullptr;
+	}
+	texture->m_lastUsedFrame = m_frame;
+
+	m_textures.push_back(texture);
+	return texture;
+}
+
+uint32_t CTextureStreamingManager::update()
+{
+	// take back the requests no thread has started yet, they get queued again below with this frame's priorities
+	core::vector<SLoadResult> results;
+	{
+		std::lock_guard<std::mutex> lock(m_queueMutex);
+		for (const auto& request : m_requests)
+		{
+			request.texture->m_loading = false;
+			m_residentBytes -= request.texture->m_levelSizes[request.level];
+			request.file->drop();
+		}
+		m_requests.clear();
+		results.swap(m_results);
+	}
+
+	for (const auto& result : results)
+	{
+		CStreamedTexture* texture = result.texture;
+		texture->m_loading = false;
+		if (!result.image)
+		{
+			os::Printer::log("Could not stream in texture level, the texture stays at its current resolution", texture->m_filename.c_str(), ELL_ERROR);
+			texture->m_failed = true;
+			m_residentBytes -= texture->m_levelSizes[result.level];
+			continue;
+		}
+		texture->m_levels[result.level] = result.image;
+		texture->m_residentBase = result.level;
+		texture->m_dirty = true;
+	}
+
+	// textures only the manager references anymore are done with
+	for (auto it=m_textures.begin(); it!=m_textures.end();)
+	{
+		CStreamedTexture* texture = it->get();
+		if (texture->getReferenceCount()>1 || texture->m_loading)
+		{
+			it++;
+			continue;
+		}
+		for (uint32_t i=texture->m_residentBase; i<texture->m_levels.size(); i++)
+			m_residentBytes -= texture->m_levelSizes[i];
+		it = m_textures.erase(it);
+	}
+
+	// the level each texture needs this frame, one level further is requested per texture and frame
+	core::vector<SLoadRequest> requests;
+	for (auto& texture : m_textures)
+	{
+		if (texture->m_requestedExtent>0.f)
+			texture->m_lastUsedFrame = m_frame;
+		texture->m_usedExtent = texture->m_requestedExtent;
+		texture->m_requestedExtent = 0.f;
+		if (texture->m_loading || texture->m_failed || !texture->m_residentBase)
+			continue;
+
+		const float undersampling = texture->m_usedExtent/static_cast<float>(texture->getLevelExtent(texture->m_residentBase));
+		if (undersampling>1.f)
+			requests.push_back({texture.get(), texture->m_residentBase-1u, undersampling, nullptr});
+	}
+	std::stable_sort(requests.begin(), requests.end(), [](const SLoadRequest& _a, const SLoadRequest& _b) { return _a.priority>_b.priority; });
+
+	// a lowered budget gets enforced first, then every request is given space by evicting levels less needed than it
+	while (m_residentBytes>m_params.memoryBudget)
+	{
+		CStreamedTexture* victim = findVictim(FLT_MAX, nullptr);
+		if (!victim)
+			break;
+		evictLevel(victim);
+	}
+	core::vector<SLoadRequest> queued;
+	for (const auto& request : requests)
+	{
+		const size_t size = request.texture->m_levelSizes[request.level];
+		while (m_residentBytes+size>m_params.memoryBudget)
+		{
+			CStreamedTexture* victim = findVictim(request.priority, request.texture);
+			if (!victim)
+				break;
+			evictLevel(victim);
+		}
+		if (m_residentBytes+size>m_params.memoryBudget)
+			continue;
+
+		io::IReadFile* file = m_fileSystem->createAndOpenFile(request.texture->m_filename);
+		if (!file)
+		{
+			os::Printer::log("Could not open texture to stream in its level, the texture stays at its current resolution", request.texture->m_filename.c_str(), ELL_ERROR);
+			request.texture->m_failed = true;
+			continue;
+		}
+		m_residentBytes += size;
+		request.texture->m_loading = true;
+		queued.push_back({request.texture, request.level, request.priority, file});
+	}
+
+	uint32_t changed = 0u;
+	for (auto& texture : m_textures)
+	{
+		if (!texture->m_dirty)
+			continue;
+		texture->m_dirty = false;
+
+		auto newTexture = core::smart_refctd_ptr<ICPUTexture>(ICPUTexture::create(texture->m_levels.begin()+texture->m_residentBase, texture->m_levels.end(), texture->m_filename.c_str(), texture->m_header->type), core::dont_grab);
+		if (!newTexture)
+			continue;
+		texture->m_texture = std::move(newTexture);
+		texture->m_version++;
+		changed++;
+	}
+
+	if (queued.size())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_queueMutex);
+			m_requests.assign(queued.rbegin(), queued.rend());
+		}
+		m_queueCondition.notify_all();
+	}
+
+	m_frame++;
+	return changed;
+}
+
+void CTextureStreamingManager::workerMain()
+{
+	for (;;)
+	{
+		SLoadRequest request;
+		{
+			std::unique_lock<std::mutex> lock(m_queueMutex);
+			m_queueCondition.wait(lock, [this]() { return m_quit || !m_requests.empty(); });
+			if (m_quit)
+				return;
+			request = m_requests.back();
+			m_requests.pop_back();
+		}
+
+		CImageData* image = CImageLoaderKTX2::readLevel(request.file, *request.texture->m_header, request.level);
+		request.file->drop();
+
+		std::lock_guard<std::mutex> lock(m_queueMutex);
+		m_results.push_back({request.texture, request.level, image});
+	}
+}
+
+float CTextureStreamingManager::getEvictionCost(const CStreamedTexture* _texture) const
+{
+	if (_texture->m_lastUsedFrame!=m_frame)
+		return 0.f;
+	return _texture->m_usedExtent/static_cast<float>(_texture->getLevelExtent(_texture->m_residentBase+1u));
+}
+
+CTextureStreamingManager::CStreamedTexture* CTextureStreamingManager::findVictim(float _priority, const CStreamedTexture* _requester) const
+{
+	CStreamedTexture* victim = nullptr;
+	float victimCost = 0.f;
+	for (auto& texture : m_textures)
+	{
+		if (texture.get()==_requester || texture->m_loading || texture->m_residentBase>=texture->m_tailBase)
+			continue;
+
+		const float cost = getEvictionCost(texture.get());
+		if (cost>=_priority)
+			continue;
+		if (!victim || texture->m_lastUsedFrame<victim->m_lastUsedFrame || (texture->m_lastUsedFrame==victim->m_lastUsedFrame && cost<victimCost))
+		{
+			victim = texture.get();
+			victimCost = cost;
+		}
+	}
+	return victim;
+}
+
+void CTextureStreamingManager::evictLevel(CStreamedTexture* _texture)
+{
+	const uint32_t level = _texture->m_residentBase++;
+	_texture->m_levels[level]->drop();
+	_texture->m_levels[level] = nullptr;
+	m_residentBytes -= _texture->m_levelSizes[level];
+	_texture->m_dirty = true;
+}
+
+} // end namespace asset
+} // end namespace irr
+
+#endif
@@ -18,7 +18,12 @@ SAssetBundle IAssetLoader::IAssetLoaderOverride::findCachedAsset(const std::stri
 
     core::vector<SAssetBundle> found = m_manager->findAssets(inSearchKey, inAssetTypes);
     if (!found.size())
+    {
+        for (uint32_t i = 0u; inAssetTypes && inAssetTypes[i] != (IAsset::E_TYPE)0u; ++i)
+            m_manager->recordCacheMiss(inAssetTypes[i]);
         return handleSearchFail(inSearchKey, ctx, hierarchyLevel);
+    }
+    m_manager->recordCacheHits(found);
     return chooseRelevantFromFound(found, ctx, hierarchyLevel);
 }
 
@@ -26,6 +26,15 @@
 #ifdef _IRR_COMPILE_WITH_DDS_LOADER_
 #include "irr/asset/CImageLoaderDDS.h"
 #endif
+#ifdef _IRR_COMPILE_WITH_KTX2_LOADER_
+#include "irr/asset/CImageLoaderKTX2.h"
+#endif
+#ifdef _IRR_COMPILE_WITH_HDR_LOADER_
+#include "irr/asset/CImageLoaderHDR.h"
+#endif
+#ifdef _IRR_COMPILE_WITH_EXR_LOADER_
+#include "irr/asset/CImageLoaderOpenEXR.h"
+#endif
 
 #ifdef _IRR_COMPILE_WITH_JPG_LOADER_
 #include "irr/asset/CImageLoaderJPG.h"
@@ -55,6 +64,13 @@
 #include "irr/asset/CImageWriterTGA.h"
 #endif
 
+#ifdef _IRR_COMPILE_WITH_DDS_WRITER_
+#include "irr/asset/CImageWriterDDS.h"
+#endif
+#ifdef _IRR_COMPILE_WITH_KTX2_WRITER_
+#include "irr/asset/CImageWriterKTX2.h"
+#endif
+
 #ifdef _IRR_COMPILE_WITH_JPG_WRITER_
 #include "irr/asset/CImageWriterJPG.h"
 #endif
@@ -91,6 +107,122 @@ const IMeshManipulator* IAssetManager::getMeshManipulator() const
     return m_meshManipulator.get();
 }
 
+size_t IAssetManager::getCachedSize(const SAssetBundle& _bundle)
+{
+    size_t size = 0ull;
+    auto contents = _bundle.getContents();
+    for (auto it = contents.first; it != contents.second; ++it)
+        if (!(*it)->isADummyObjectForCache())
+            size += (*it)->conservativeSizeEstimate();
+    return size;
+}
+
+void IAssetManager::recordCacheHits(const core::vector<SAssetBundle>& _found) const
+{
+    for (const auto& bundle : _found)
+    {
+        SCacheUsage& usage = m_cacheUsage[IAsset::typeFlagToIndex(bundle.getAssetType())];
+        usage.hits++;
+
+        std::lock_guard<std::mutex> lock(usage.mutex);
+        usage.lastUse[bundle.m_contents.get()] = m_cacheClock++;
+    }
+}
+
+void IAssetManager::enforceAssetCacheBudget(uint32_t _typeIx)
+{
+    IRR_PROFILE_ZONE("IAssetManager::enforceAssetCacheBudget");
+    SCacheUsage& usage = m_cacheUsage[_typeIx];
+    std::unique_lock<std::mutex> lock(usage.mutex);
+    if (!usage.budget.maxBytes)
+        return;
+
+    AssetCacheType* cache = m_assetCache[_typeIx];
+    size_t count = 0u;
+    cache->outputAll(count, nullptr);
+    core::vector<AssetCacheType::MutablePairType> entries(count);
+    cache->outputAll(count, entries.data());
+    entries.resize(count);
+
+    struct SCandidate
+    {
+        AssetCacheType::MutablePairType* entry;
+        size_t size;
+        uint64_t lastUse;
+    };
+    core::vector<SCandidate> candidates;
+    core::unordered_map<const void*,uint64_t> lastUse;
+    size_t resident = 0ull;
+    for (auto& entry : entries)
+    {
+        const SAssetBundle& bundle = entry.second;
+        const size_t size = getCachedSize(bundle);
+        resident += size;
+
+        // bundles which were inserted into the cache before counting started are as good as unused
+        auto found = usage.lastUse.find(bundle.m_contents.get());
+        const uint64_t used = found != usage.lastUse.end() ? found->second : 0ull;
+        lastUse[bundle.m_contents.get()] = used;
+        if (!size)
+            continue;
+
+        // the contents are held by the cache and by `entries`, the assets only by the contents
+        bool onlyCached = bundle.m_contents->getReferenceCount() == 2;
+        auto contents = bundle.getContents();
+        for (auto it = contents.first; onlyCached && it != contents.second; ++it)
+        {
+            // the reference of the buffer registry does not count, it lets go of evicted buffers on prune()
+            const bool registered = (*it)->getAssetType() == IAsset::ET_BUFFER && m_bufferDeduplicator->isRegistered(static_cast<const ICPUBuffer*>(it->get()));
+            onlyCached = (*it)->getReferenceCount() == (registered ? 2 : 1);
+        }
+        if (onlyCached)
+            candidates.push_back({&entry, size, used});
+    }
+    // also forgets bundles which were removed from the cache some other way
+    usage.lastUse = std::move(lastUse);
+
+    bool evicted = false;
+    if (resident > usage.budget.maxBytes)
+    {
+        const uint64_t now = m_cacheClock.load();
+        if (usage.budget.policy == ECEP_COST_AWARE)
+            std::sort(candidates.begin(), candidates.end(), [now](const SCandidate& a, const SCandidate& b) { return double(a.size)*double(now-a.lastUse) > double(b.size)*double(now-b.lastUse); });
+        else
+            std::sort(candidates.begin(), candidates.end(), [](const SCandidate& a, const SCandidate& b) { return a.lastUse < b.lastUse; });
+
+        for (auto it = candidates.begin(); it != candidates.end() && resident > usage.budget.maxBytes; ++it)
+        {
+            SAssetBundle& bundle = it->entry->second;
+            if (usage.budget.demoteInsteadOfRemove)
+            {
+                auto contents = bundle.getContents();
+                for (auto asset = contents.first; asset != contents.second; ++asset)
+                    if (!(*asset)->isADummyObjectForCache())
+                        (*asset)->convertToDummyObject();
+                usage.demotions++;
+                evicted = true;
+            }
+            else
+            {
+                if (!cache->removeObject(bundle, it->entry->first))
+                    continue;
+                usage.lastUse.erase(bundle.m_contents.get());
+                usage.evictions++;
+                evicted = true;
+            }
+            resident -= it->size;
+        }
+    }
+    usage.residentBytes = resident;
+    lock.unlock();
+
+    // the destructors of the evicted assets run once the snapshot lets go of them, without holding up the type's other users
+    entries.clear();
+    // and buffers they used might only be referenced by the buffer registry now
+    if (evicted)
+        m_bufferDeduplicator->prune();
+}
+
 
 void IAssetManager::addLoadersAndWriters()
 {
@@ -112,6 +244,15 @@ void IAssetManager::addLoadersAndWriters()
 #ifdef _IRR_COMPILE_WITH_DDS_LOADER_
 	addAssetLoader(core::make_smart_refctd_ptr<asset::CImageLoaderDDS>());
 #endif
+#ifdef _IRR_COMPILE_WITH_KTX2_LOADER_
+	addAssetLoader(core::make_smart_refctd_ptr<asset::CImageLoaderKTX2>());
+#endif
+#ifdef _IRR_COMPILE_WITH_HDR_LOADER_
+	addAssetLoader(core::make_smart_refctd_ptr<asset::CImageLoaderHDR>());
+#endif
+#ifdef _IRR_COMPILE_WITH_EXR_LOADER_
+	addAssetLoader(core::make_smart_refctd_ptr<asset::CImageLoaderOpenEXR>());
+#endif
 #ifdef _IRR_COMPILE_WITH_JPG_LOADER_
 	addAssetLoader(core::make_smart_refctd_ptr<asset::CImageLoaderJPG>());
 #endif
@@ -133,6 +274,12 @@ void IAssetManager::addLoadersAndWriters()
 #ifdef _IRR_COMPILE_WITH_TGA_WRITER_
 	addAssetWriter(core::make_smart_refctd_ptr<asset::CImageWriterTGA>());
 #endif
+#ifdef _IRR_COMPILE_WITH_DDS_WRITER_
+	addAssetWriter(core::make_smart_refctd_ptr<asset::CImageWriterDDS>());
+#endif
+#ifdef _IRR_COMPILE_WITH_KTX2_WRITER_
+	addAssetWriter(core::make_smart_refctd_ptr<asset::CImageWriterKTX2>());
+#endif
 #ifdef _IRR_COMPILE_WITH_JPG_WRITER_
 	addAssetWriter(core::make_smart_refctd_ptr<asset::CImageWriterJPG>());
 #endif
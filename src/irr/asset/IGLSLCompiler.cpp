@@ -4,18 +4,146 @@
 #include "irr/asset/ICPUShader.h"
 #include "irr/asset/shadercUtils.h"
 
+#include "os.h"
+
 namespace irr { namespace asset
 {
 
+namespace
+{
+//! Lets shaderc resolve includes through IIncludeHandler (and so its include cache)
+class CShadercIncluder : public shaderc::CompileOptions::IncluderInterface
+{
+    struct SResult
+    {
+        shaderc_include_result result;
+        std::string name;
+        std::string contents;
+    };
+
+    const IIncludeHandler* m_inclHandler;
+
+public:
+    CShadercIncluder(const IIncludeHandler* _inclHandler) : m_inclHandler(_inclHandler) {}
+
+    shaderc_include_result* GetInclude(const char* _requestedSource, shaderc_include_type _type, const char* _requestingSource, size_t _includeDepth) override
+    {
+        SResult* res = new SResult;
+        if (_type == shaderc_include_type_relative)
+        {
+            std::string dir = _requestingSource;
+            const size_t lastSlash = dir.find_last_of("/\\");
+            dir = lastSlash==std::string::npos ? std::string():dir.substr(0u, lastSlash+1u);
+            res->contents = m_inclHandler->getIncludeRelative(_requestedSource, dir);
+            res->name = dir+_requestedSource;
+        }
+        if (res->contents.empty())
+        {
+            res->contents = m_inclHandler->getIncludeStandard(_requestedSource);
+            res->name = _requestedSource;
+        }
+        // empty source name tells shaderc the include failed, contents are the error message then
+        if (res->contents.empty())
+        {
+            res->name.clear();
+            res->contents = std::string("Could not find include ")+_requestedSource;
+        }
+
+        res->result.source_name = res->name.c_str();
+        res->result.source_name_length = res->name.size();
+        res->result.content = res->contents.c_str();
+        res->result.content_length = res->contents.size();
+        res->result.user_data = res;
+        return &res->result;
+    }
+
+    void ReleaseInclude(shaderc_include_result* _result) override
+    {
+        delete static_cast<SResult*>(_result->user_data);
+    }
+};
+}
+
 ICPUShader* IGLSLCompiler::createShaderFromGLSL(const char* _glslCode, E_SHADER_STAGE _stage, const char* _entryPoint, bool _debug, const char* _compilationId) const
 {
     shaderc::Compiler comp;
     shaderc::CompileOptions options;
     if (_debug)
         options.SetGenerateDebugInfo();
+    if (m_inclHandler)
+        options.SetIncluder(std::make_unique<CShadercIncluder>(m_inclHandler.get()));
     const shaderc_shader_kind stage = _stage==ESS_UNKNOWN ? shaderc_glsl_infer_from_source : ESStoShadercEnum(_stage);
     shaderc::SpvCompilationResult res = comp.CompileGlslToSpv(_glslCode, strlen(_glslCode), stage, _compilationId ? _compilationId : "", _entryPoint, options);
     return new ICPUShader(res.cbegin(), std::distance(res.cbegin(), res.cend())*sizeof(uint32_t));
 }
 
+core::vector<core::smart_refctd_ptr<ICPUShader>> IGLSLCompiler::createShadersFromGLSL(const char* _glslCode, const SShaderPermutation* _begin, const SShaderPermutation* _end, const char* _entryPoint, bool _debug, const char* _compilationId, uint32_t _threadCount) const
+{
+    const size_t permutationCount = std::distance(_begin, _end);
+    core::vector<core::smart_refctd_ptr<ICPUShader>> retval(permutationCount);
+
+    // dedupe permutations, define order does not matter to the preprocessor (except for redefinitions which are an error anyway)
+    core::vector<uint32_t> uniqueIx(permutationCount);
+    core::vector<const SShaderPermutation*> uniquePermutations;
+    {
+        core::unordered_map<std::string,uint32_t> keyToUnique;
+        core::vector<std::pair<std::string,std::string>> sortedDefines;
+        for (size_t i=0u; i<permutationCount; i++)
+        {
+            const SShaderPermutation& perm = _begin[i];
+            sortedDefines = perm.defines;
+            std::sort(sortedDefines.begin(), sortedDefines.end());
+
+            std::string key = std::to_string(perm.stage);
+            for (const auto& def : sortedDefines)
+            {
+                key += '\0';
+                key += def.first;
+                key += '\0';
+                key += def.second;
+            }
+
+            auto found = keyToUnique.insert({std::move(key),static_cast<uint32_t>(uniquePermutations.size())});
+            if (found.second)
+                uniquePermutations.push_back(&perm);
+            uniqueIx[i] = found.first->second;
+        }
+    }
+
+    // options with everything but the macros are shared by all variants
+    shaderc::CompileOptions baseOptions;
+    if (_debug)
+        baseOptions.SetGenerateDebugInfo();
+    const size_t codeLen = strlen(_glslCode);
+    const char* compilationId = _compilationId ? _compilationId : "";
+
+    core::vector<core::smart_refctd_ptr<ICPUShader>> uniqueShaders(uniquePermutations.size());
+    core::parallel_for(0u, uniquePermutations.size(), [&](size_t i)
+        {
+            const SShaderPermutation& perm = *uniquePermutations[i];
+            // shaderc::Compiler is not meant to be shared across threads
+            shaderc::Compiler comp;
+            shaderc::CompileOptions options(baseOptions);
+            // includer does not get copied along with the options, each compilation needs its own
+            if (m_inclHandler)
+                options.SetIncluder(std::make_unique<CShadercIncluder>(m_inclHandler.get()));
+            for (const auto& def : perm.defines)
+                options.AddMacroDefinition(def.first, def.second);
+
+            const shaderc_shader_kind stage = perm.stage==ESS_UNKNOWN ? shaderc_glsl_infer_from_source : ESStoShadercEnum(perm.stage);
+            shaderc::SpvCompilationResult res = comp.CompileGlslToSpv(_glslCode, codeLen, stage, compilationId, _entryPoint, options);
+            if (res.GetCompilationStatus() != shaderc_compilation_status_success)
+            {
+                os::Printer::log(res.GetErrorMessage(), ELL_ERROR);
+                return;
+            }
+            uniqueShaders[i] = core::make_smart_refctd_ptr<ICPUShader>(res.cbegin(), std::distance(res.cbegin(), res.cend())*sizeof(uint32_t));
+        }, _threadCount);
+
+    for (size_t i=0u; i<permutationCount; i++)
+        retval[i] = uniqueShaders[uniqueIx[i]];
+
+    return retval;
+}
+
 }}
\ No newline at end of file
@@ -285,6 +285,14 @@ void convertColor(E_FORMAT _sfmt, E_FORMAT _dfmt, const void* _srcPix[4], void*
     case EF_BC2_SRGB_BLOCK: return impl::convertColor_RTimpl<EF_BC2_SRGB_BLOCK>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
     case EF_BC3_UNORM_BLOCK: return impl::convertColor_RTimpl<EF_BC3_UNORM_BLOCK>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
     case EF_BC3_SRGB_BLOCK: return impl::convertColor_RTimpl<EF_BC3_SRGB_BLOCK>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
+    case EF_BC4_UNORM_BLOCK: return impl::convertColor_RTimpl<EF_BC4_UNORM_BLOCK>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
+    case EF_BC4_SNORM_BLOCK: return impl::convertColor_RTimpl<EF_BC4_SNORM_BLOCK>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
+    case EF_BC5_UNORM_BLOCK: return impl::convertColor_RTimpl<EF_BC5_UNORM_BLOCK>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
+    case EF_BC5_SNORM_BLOCK: return impl::convertColor_RTimpl<EF_BC5_SNORM_BLOCK>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
+    case EF_BC6H_UFLOAT_BLOCK: return impl::convertColor_RTimpl<EF_BC6H_UFLOAT_BLOCK>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
+    case EF_BC6H_SFLOAT_BLOCK: return impl::convertColor_RTimpl<EF_BC6H_SFLOAT_BLOCK>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
+    case EF_BC7_UNORM_BLOCK: return impl::convertColor_RTimpl<EF_BC7_UNORM_BLOCK>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
+    case EF_BC7_SRGB_BLOCK: return impl::convertColor_RTimpl<EF_BC7_SRGB_BLOCK>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
     case EF_G8_B8_R8_3PLANE_420_UNORM: return impl::convertColor_RTimpl<EF_G8_B8_R8_3PLANE_420_UNORM>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
     case EF_G8_B8R8_2PLANE_420_UNORM: return impl::convertColor_RTimpl<EF_G8_B8R8_2PLANE_420_UNORM>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
     case EF_G8_B8_R8_3PLANE_422_UNORM: return impl::convertColor_RTimpl<EF_G8_B8_R8_3PLANE_422_UNORM>(_dfmt, _srcPix, _dstPix, _pixOrBlockCnt, _imgSize,swizzle);
@@ -0,0 +1,1142 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "irr/asset/format/encodeBlocks.h"
+
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+
+#include "irr/asset/format/decodePixels.h"
+#include "irr/core/parallel/parallel_for.h"
+
+namespace irr { namespace video
+{
+namespace
+{
+    // all encoders work on texels scaled to [0,255] in the color space the block stores them in
+    typedef float texel_t[4];
+
+    //! Little endian counterpart of impl::SBlockBitReader
+    class SBlockBitWriter
+    {
+            uint64_t bits[2];
+            uint32_t pos;
+        public:
+            SBlockBitWriter() : pos(0u) { bits[0] = bits[1] = 0ull; }
+
+            //! Writes at most 16 bits
+            inline void write(uint32_t _value, uint32_t _count)
+            {
+                if (!_count)
+                    return;
+                const uint64_t value = static_cast<uint64_t>(_value)&((1ull<<_count)-1ull);
+                const uint32_t word = pos>>6u;
+                const uint32_t bit = pos&63u;
+                bits[word] |= value<<bit;
+                if (word==0u && bit+_count>64u)
+                    bits[1] |= value>>(64u-bit);
+                pos += _count;
+            }
+
+            inline void store(void* _block) const { memcpy(_block, bits, sizeof(bits)); }
+    };
+
+    inline uint32_t getRefinementPasses(E_BLOCK_ENCODE_QUALITY _quality)
+    {
+        return _quality==EBEQ_FAST ? 0u:(_quality==EBEQ_NORMAL ? 1u:3u);
+    }
+
+    //! Mean and direction of largest variance of the texels `_ix[0.._count)`, over channels [_firstChannel,_firstChannel+_channels)
+    /** Power iteration on the covariance matrix, the axis is 0 when all the texels are the same.
+    @returns Sum of squared distances of the texels from the fitted line.*/
+    float computePrincipalAxis(const texel_t* _texels, const uint8_t* _ix, uint32_t _count, uint32_t _firstChannel, uint32_t _channels, float _mean[4], float _axis[4], uint32_t _iterations=8u)
+    {
+        for (uint32_t c=0u; c<4u; c++)
+            _mean[c] = _axis[c] = 0.f;
+        for (uint32_t i=0u; i<_count; i++)
+        for (uint32_t c=0u; c<_channels; c++)
+            _mean[c] += _texels[_ix[i]][_firstChannel+c];
+        for (uint32_t c=0u; c<_channels; c++)
+            _mean[c] /= float(_count);
+
+        float cov[4][4] = {};
+        for (uint32_t i=0u; i<_count; i++)
+        {
+            float d[4];
+            for (uint32_t c=0u; c<_channels; c++)
+                d[c] = _texels[_ix[i]][_firstChannel+c]-_mean[c];
+            for (uint32_t r=0u; r<_channels; r++)
+            for (uint32_t c=r; c<_channels; c++)
+                cov[r][c] += d[r]*d[c];
+        }
+        float variance = 0.f;
+        uint32_t largest = 0u;
+        for (uint32_t r=0u; r<_channels; r++)
+        {
+            variance += cov[r][r];
+            if (cov[r][r]>cov[largest][largest])
+                largest = r;
+            for (uint32_t c=0u; c<r; c++)
+                cov[r][c] = cov[c][r];
+        }
+        if (variance<=FLT_EPSILON)
+            return 0.f;
+
+        // the row of the channel with the largest variance is a decent start and never orthogonal to the answer
+        float v[4];
+        for (uint32_t c=0u; c<_channels; c++)
+            v[c] = cov[largest][c];
+        float eigenvalue = 0.f;
+        for (uint32_t iter=0u; iter<_iterations; iter++)
+        {
+            float w[4] = {};
+            for (uint32_t r=0u; r<_channels; r++)
+            for (uint32_t c=0u; c<_channels; c++)
+                w[r] += cov[r][c]*v[c];
+            float len = 0.f;
+            for (uint32_t c=0u; c<_channels; c++)
+                len += w[c]*w[c];
+            len = std::sqrt(len);
+            if (len<=FLT_EPSILON)
+                break;
+            for (uint32_t c=0u; c<_channels; c++)
+                v[c] = w[c]/len;
+            eigenvalue = len;
+        }
+        float len = 0.f;
+        for (uint32_t c=0u; c<_channels; c++)
+            len += v[c]*v[c];
+        len = std::sqrt(len);
+        if (len<=FLT_EPSILON)
+            return variance;
+        for (uint32_t c=0u; c<_channels; c++)
+            _axis[c] = v[c]/len;
+        return std::max(variance-eigenvalue, 0.f);
+    }
+
+    //! Endpoints at the extreme projections of the texels onto the principal axis, clamped to [0,255]
+    void computeAxisEndpoints(const texel_t* _texels, const uint8_t* _ix, uint32_t _count, uint32_t _firstChannel, uint32_t _channels, float _endpoints[2][4])
+    {
+        float mean[4], axis[4];
+        computePrincipalAxis(_texels, _ix, _count, _firstChannel, _channels, mean, axis);
+        float tMin = FLT_MAX, tMax = -FLT_MAX;
+        for (uint32_t i=0u; i<_count; i++)
+        {
+            float t = 0.f;
+            for (uint32_t c=0u; c<_channels; c++)
+                t += (_texels[_ix[i]][_firstChannel+c]-mean[c])*axis[c];
+            tMin = std::min(tMin, t);
+            tMax = std::max(tMax, t);
+        }
+        for (uint32_t c=0u; c<_channels; c++)
+        {
+            _endpoints[0][c] = core::clamp(mean[c]+tMin*axis[c], 0.f, 255.f);
+            _endpoints[1][c] = core::clamp(mean[c]+tMax*axis[c], 0.f, 255.f);
+        }
+    }
+
+    //! Least squares endpoints for texels already assigned interpolation weights in [0,1], false if the system is singular
+    bool solveEndpoints(const texel_t* _texels, const uint8_t* _ix, const float* _weights, uint32_t _count, uint32_t _firstChannel, uint32_t _channels, float _endpoints[2][4])
+    {
+        float a = 0.f, b = 0.f, c = 0.f;
+        float x0[4] = {}, x1[4] = {};
+        for (uint32_t i=0u; i<_count; i++)
+        {
+            const float w = _weights[i];
+            const float iw = 1.f-w;
+            a += iw*iw;
+            b += iw*w;
+            c += w*w;
+            for (uint32_t ch=0u; ch<_channels; ch++)
+            {
+                x0[ch] += iw*_texels[_ix[i]][_firstChannel+ch];
+                x1[ch] += w*_texels[_ix[i]][_firstChannel+ch];
+            }
+        }
+        const float det = a*c-b*b;
+        if (std::abs(det)<=FLT_EPSILON)
+            return false;
+        for (uint32_t ch=0u; ch<_channels; ch++)
+        {
+            _endpoints[0][ch] = core::clamp((c*x0[ch]-b*x1[ch])/det, 0.f, 255.f);
+            _endpoints[1][ch] = core::clamp((a*x1[ch]-b*x0[ch])/det, 0.f, 255.f);
+        }
+        return true;
+    }
+
+
+    // BC1
+    struct SBC1Block
+    {
+        uint16_t color[2];
+        uint8_t indices[16];
+        float error;
+    };
+
+    inline uint16_t quantizeBC1Endpoint(const float _color[3])
+    {
+        const uint32_t r = static_cast<uint32_t>(_color[0]*31.f/255.f+0.5f);
+        const uint32_t g = static_cast<uint32_t>(_color[1]*63.f/255.f+0.5f);
+        const uint32_t b = static_cast<uint32_t>(_color[2]*31.f/255.f+0.5f);
+        return (std::min(r,31u)<<11u)|(std::min(g,63u)<<5u)|std::min(b,31u);
+    }
+
+    //! Picks the closest palette entry for every texel of `_ix`, the palette is built exactly like decodeBC1Block does
+    void evaluateBC1(const texel_t* _texels, const uint8_t* _ix, uint32_t _count, bool _threeColor, SBC1Block& _block)
+    {
+        uint8_t palette[4][4];
+        const uint32_t e0 = impl::unpackBC1Endpoint(_block.color[0]);
+        const uint32_t e1 = impl::unpackBC1Endpoint(_block.color[1]);
+        memcpy(palette[0], &e0, 4u);
+        memcpy(palette[1], &e1, 4u);
+        for (uint32_t c=0u; c<3u; c++)
+        {
+            if (_threeColor)
+                palette[2][c] = (palette[0][c]+palette[1][c]+1u)/2u;
+            else
+            {
+                palette[2][c] = (2u*palette[0][c]+palette[1][c]+1u)/3u;
+                palette[3][c] = (palette[0][c]+2u*palette[1][c]+1u)/3u;
+            }
+        }
+        const uint32_t paletteSize = _threeColor ? 3u:4u;
+
+        _block.error = 0.f;
+        for (uint32_t i=0u; i<_count; i++)
+        {
+            const float* texel = _texels[_ix[i]];
+            float best = FLT_MAX;
+            for (uint32_t p=0u; p<paletteSize; p++)
+            {
+                float err = 0.f;
+                for (uint32_t c=0u; c<3u; c++)
+                {
+                    const float d = texel[c]-float(palette[p][c]);
+                    err += d*d;
+                }
+                if (err<best)
+                {
+                    best = err;
+                    _block.indices[_ix[i]] = p;
+                }
+            }
+            _block.error += best;
+        }
+    }
+
+    void fitBC1(const texel_t* _texels, const uint8_t* _ix, uint32_t _count, bool _threeColor, E_BLOCK_ENCODE_QUALITY _quality, SBC1Block& _block)
+    {
+        float endpoints[2][4];
+        computeAxisEndpoints(_texels, _ix, _count, 0u, 3u, endpoints);
+        _block.color[0] = quantizeBC1Endpoint(endpoints[0]);
+        _block.color[1] = quantizeBC1Endpoint(endpoints[1]);
+        evaluateBC1(_texels, _ix, _count, _threeColor, _block);
+
+        const float fourColorWeights[4] = {0.f, 1.f, 1.f/3.f, 2.f/3.f};
+        const float threeColorWeights[3] = {0.f, 1.f, 0.5f};
+        const float* paletteWeights = _threeColor ? threeColorWeights:fourColorWeights;
+        for (uint32_t pass=0u; pass<getRefinementPasses(_quality); pass++)
+        {
+            float weights[16];
+            for (uint32_t i=0u; i<_count; i++)
+                weights[i] = paletteWeights[_block.indices[_ix[i]]];
+            if (!solveEndpoints(_texels, _ix, weights, _count, 0u, 3u, endpoints))
+                break;
+
+            SBC1Block candidate = _block;
+            candidate.color[0] = quantizeBC1Endpoint(endpoints[0]);
+            candidate.color[1] = quantizeBC1Endpoint(endpoints[1]);
+            evaluateBC1(_texels, _ix, _count, _threeColor, candidate);
+            if (candidate.error>=_block.error)
+                break;
+            _block = candidate;
+        }
+
+        if (_quality<EBEQ_BEST)
+            return;
+        // nudge every 565 component by one step for as long as it helps
+        const uint32_t shifts[3] = {11u, 5u, 0u};
+        const uint32_t masks[3] = {31u, 63u, 31u};
+        for (bool improved=true; improved && _block.error>0.f;)
+        {
+            improved = false;
+            for (uint32_t e=0u; e<2u; e++)
+            for (uint32_t c=0u; c<3u; c++)
+            for (int32_t step=-1; step<=1; step+=2)
+            {
+                const int32_t value = int32_t((_block.color[e]>>shifts[c])&masks[c])+step;
+                if (value<0 || value>int32_t(masks[c]))
+                    continue;
+                SBC1Block candidate = _block;
+                candidate.color[e] = (candidate.color[e]&~(masks[c]<<shifts[c]))|(uint32_t(value)<<shifts[c]);
+                evaluateBC1(_texels, _ix, _count, _threeColor, candidate);
+                if (candidate.error<_block.error)
+                {
+                    _block = candidate;
+                    improved = true;
+                }
+            }
+        }
+    }
+
+    //! Orders the endpoints the way the palette mode requires and packs the block
+    void packBC1(SBC1Block _block, bool _threeColor, uint8_t _output[8])
+    {
+        const bool swap = _threeColor ? (_block.color[0]>_block.color[1]):(_block.color[0]<_block.color[1]);
+        if (swap)
+        {
+            std::swap(_block.color[0], _block.color[1]);
+            // 0<->1 always, 2<->3 only when 3 is not the transparent index
+            for (auto& index : _block.indices)
+            {
+                if (index<2u || !_threeColor)
+                    index ^= 1u;
+            }
+        }
+        // equal endpoints would switch a four color block to three colors, where index 3 means transparent
+        if (!_threeColor && _block.color[0]==_block.color[1])
+        {
+            for (auto& index : _block.indices)
+                index = 0u;
+        }
+
+        uint32_t lut = 0u;
+        for (uint32_t i=0u; i<16u; i++)
+            lut |= uint32_t(_block.indices[i])<<(2u*i);
+        memcpy(_output, _block.color, 4u);
+        memcpy(_output+4, &lut, 4u);
+    }
+
+    //! Color part of BC1, BC2 and BC3, the last two always decode four colors so `_allowTransparent` must be false for them
+    void encodeBC1Block(const texel_t _texels[16], uint8_t _output[8], bool _allowTransparent, E_BLOCK_ENCODE_QUALITY _quality)
+    {
+        uint8_t opaque[16];
+        uint32_t opaqueCount = 0u;
+        for (uint32_t i=0u; i<16u; i++)
+        {
+            if (!_allowTransparent || _texels[i][3]>=127.5f)
+                opaque[opaqueCount++] = i;
+        }
+
+        SBC1Block block;
+        std::fill(block.indices, block.indices+16, 3u);
+        if (!opaqueCount)
+        {
+            block.color[0] = block.color[1] = 0u;
+            packBC1(block, true, _output);
+            return;
+        }
+
+        const bool needsThreeColor = opaqueCount<16u;
+        fitBC1(_texels, opaque, opaqueCount, needsThreeColor, _quality, block);
+        bool threeColor = needsThreeColor;
+        // the 3 color palette has the midpoint exactly and sometimes beats 4 colors on opaque blocks too
+        if (!needsThreeColor && _allowTransparent && _quality==EBEQ_BEST && block.error>0.f)
+        {
+            SBC1Block candidate = block;
+            fitBC1(_texels, opaque, opaqueCount, true, _quality, candidate);
+            if (candidate.error<block.error)
+            {
+                block = candidate;
+                threeColor = true;
+            }
+        }
+        packBC1(block, threeColor, _output);
+    }
+
+
+    // BC4, also the alpha of BC3
+    struct SBC4Block
+    {
+        uint8_t endpoints[2];
+        uint8_t indices[16];
+        float error;
+    };
+
+    //! Assigns indices against the palette decodeBC4Block builds, the endpoint order selects between 8 and 6 interpolated values
+    void evaluateBC4(const float _values[16], SBC4Block& _block)
+    {
+        const uint32_t a0 = _block.endpoints[0];
+        const uint32_t a1 = _block.endpoints[1];
+        uint32_t palette[8] = {a0, a1};
+        if (a0>a1)
+        {
+            for (uint32_t i=1u; i<7u; i++)
+                palette[i+1u] = ((7u-i)*a0+i*a1+3u)/7u;
+        }
+        else
+        {
+            for (uint32_t i=1u; i<5u; i++)
+                palette[i+1u] = ((5u-i)*a0+i*a1+2u)/5u;
+            palette[6] = 0u;
+            palette[7] = 0xffu;
+        }
+
+        _block.error = 0.f;
+        for (uint32_t i=0u; i<16u; i++)
+        {
+            float best = FLT_MAX;
+            for (uint32_t p=0u; p<8u; p++)
+            {
+                const float d = _values[i]-float(palette[p]);
+                if (d*d<best)
+                {
+                    best = d*d;
+                    _block.indices[i] = p;
+                }
+            }
+            _block.error += best;
+        }
+    }
+
+    inline uint8_t roundToByte(float _value)
+    {
+        return static_cast<uint8_t>(core::clamp(_value, 0.f, 255.f)+0.5f);
+    }
+
+    void encodeBC4Block(const float _values[16], uint8_t _output[8], E_BLOCK_ENCODE_QUALITY _quality)
+    {
+        const float minValue = *std::min_element(_values, _values+16);
+        const float maxValue = *std::max_element(_values, _values+16);
+
+        SBC4Block block;
+        block.endpoints[0] = roundToByte(maxValue);
+        block.endpoints[1] = roundToByte(minValue);
+        evaluateBC4(_values, block);
+
+        if (_quality>EBEQ_FAST && block.error>0.f)
+        {
+            // interpolation weights of the 8 value palette by index
+            const float weights[8] = {0.f, 1.f, 1.f/7.f, 2.f/7.f, 3.f/7.f, 4.f/7.f, 5.f/7.f, 6.f/7.f};
+            texel_t texels[16];
+            uint8_t ix[16];
+            for (uint32_t i=0u; i<16u; i++)
+            {
+                texels[i][0] = _values[i];
+                ix[i] = i;
+            }
+            for (uint32_t pass=0u; pass<getRefinementPasses(_quality) && block.endpoints[0]>block.endpoints[1]; pass++)
+            {
+                float w[16], endpoints[2][4];
+                for (uint32_t i=0u; i<16u; i++)
+                    w[i] = weights[block.indices[i]];
+                if (!solveEndpoints(texels, ix, w, 16u, 0u, 1u, endpoints))
+                    break;
+                SBC4Block candidate;
+                candidate.endpoints[0] = roundToByte(endpoints[0][0]);
+                candidate.endpoints[1] = roundToByte(endpoints[1][0]);
+                if (candidate.endpoints[0]<=candidate.endpoints[1])
+                    break;
+                evaluateBC4(_values, candidate);
+                if (candidate.error>=block.error)
+                    break;
+                block = candidate;
+            }
+
+            // 6 value palette spans only the texels which 0 and 255 do not cover exactly
+            float innerMin = 255.f, innerMax = 0.f;
+            for (uint32_t i=0u; i<16u; i++)
+            {
+                if (_values[i]<0.5f || _values[i]>=254.5f)
+                    continue;
+                innerMin = std::min(innerMin, _values[i]);
+                innerMax = std::max(innerMax, _values[i]);
+            }
+            SBC4Block candidate;
+            candidate.endpoints[0] = roundToByte(std::min(innerMin, innerMax));
+            candidate.endpoints[1] = roundToByte(innerMax);
+            evaluateBC4(_values, candidate);
+            if (candidate.error<block.error)
+                block = candidate;
+        }
+
+        if (_quality==EBEQ_BEST)
+        {
+            for (bool improved=true; improved && block.error>0.f;)
+            {
+                improved = false;
+                for (uint32_t e=0u; e<2u; e++)
+                for (int32_t step=-2; step<=2; step++)
+                {
+                    const int32_t value = int32_t(block.endpoints[e])+step;
+                    if (!step || value<0 || value>255)
+                        continue;
+                    SBC4Block candidate = block;
+                    candidate.endpoints[e] = value;
+                    // keep the palette mode, flipping it here would just be a worse version of the other candidate
+                    if ((candidate.endpoints[0]>candidate.endpoints[1])!=(block.endpoints[0]>block.endpoints[1]))
+                        continue;
+                    evaluateBC4(_values, candidate);
+                    if (candidate.error<block.error)
+                    {
+                        block = candidate;
+                        improved = true;
+                    }
+                }
+            }
+        }
+
+        uint64_t lut = 0ull;
+        for (uint32_t i=0u; i<16u; i++)
+            lut |= uint64_t(block.indices[i])<<(3u*i);
+        _output[0] = block.endpoints[0];
+        _output[1] = block.endpoints[1];
+        memcpy(_output+2, &lut, 6u);
+    }
+
+
+    // BC7
+    struct SBPTCMode
+    {
+        uint8_t subsets, partitionBits, rotationBits, colorBits, alphaBits, endpointPBits, sharedPBits, indexBits, secondaryIndexBits;
+    };
+    // same as the decoder's table minus the index selection bit, mode 4 is never produced
+    const SBPTCMode BPTCModes[8] = {
+        {3,4,0,4,0,1,0,3,0},
+        {2,6,0,6,0,0,1,3,0},
+        {3,6,0,5,0,0,0,2,0},
+        {2,6,0,7,0,1,0,2,0},
+        {1,0,2,5,6,0,0,2,3},
+        {1,0,2,7,8,0,0,2,2},
+        {1,0,0,7,7,1,0,4,0},
+        {2,6,0,5,5,1,0,2,0}
+    };
+
+    //! Endpoints of a single subset (or of the separate color and alpha of modes 4 and 5)
+    struct SBPTCEndpoints
+    {
+        uint8_t quantized[2][4];
+        uint8_t pBits[2];
+    };
+
+    struct SBPTCBlock
+    {
+        uint32_t mode;
+        uint32_t partition;
+        uint32_t rotation;
+        SBPTCEndpoints endpoints[3];
+        uint8_t indices[16];
+        uint8_t secondaryIndices[16];
+        float error;
+    };
+
+    inline uint32_t expandBPTCBits(uint32_t _value, uint32_t _bits)
+    {
+        return (_value<<(8u-_bits))|(_value>>(2u*_bits-8u));
+    }
+
+    //! Closest value of `_bits` bits (not counting the p-bit) which expands to `_value`
+    uint8_t quantizeBPTCChannel(float _value, uint32_t _bits, bool _hasPBit, uint32_t _pBit)
+    {
+        const uint32_t totalBits = _bits+(_hasPBit ? 1u:0u);
+        const int32_t maxValue = (1<<_bits)-1;
+        float guess = _value*float((1u<<totalBits)-1u)/255.f;
+        if (_hasPBit)
+            guess = (guess-float(_pBit))*0.5f;
+        const int32_t center = static_cast<int32_t>(guess+0.5f);
+
+        uint8_t best = 0u;
+        float bestError = FLT_MAX;
+        for (int32_t q=center-1; q<=center+1; q++)
+        {
+            const int32_t clamped = core::clamp(q, 0, maxValue);
+            const uint32_t raw = _hasPBit ? ((uint32_t(clamped)<<1u)|_pBit):uint32_t(clamped);
+            const float err = std::abs(float(expandBPTCBits(raw, totalBits))-_value);
+            if (err<bestError)
+            {
+                bestError = err;
+                best = clamped;
+            }
+        }
+        return best;
+    }
+
+    //! Everything needed to fit one set of endpoints, modes 4 and 5 fit color and alpha as two of these
+    struct SBPTCFit
+    {
+        const texel_t* texels;
+        const uint8_t* ix;
+        uint32_t count;
+        uint32_t firstChannel;
+        uint32_t channels;
+        uint32_t colorBits;
+        uint32_t alphaBits;
+        bool endpointPBits;
+        bool sharedPBit;
+        uint32_t indexBits;
+    };
+
+    //! Expands quantized endpoints and assigns every texel the closest interpolated value, `_indices` is indexed by texel
+    float evaluateBPTC(const SBPTCFit& _fit, const SBPTCEndpoints& _endpoints, uint8_t _indices[16])
+    {
+        const bool hasPBits = _fit.endpointPBits || _fit.sharedPBit;
+        uint32_t expanded[2][4];
+        for (uint32_t e=0u; e<2u; e++)
+        for (uint32_t c=_fit.firstChannel; c<_fit.firstChannel+_fit.channels; c++)
+        {
+            const uint32_t bits = c==3u ? _fit.alphaBits:_fit.colorBits;
+            const uint32_t raw = hasPBits ? ((uint32_t(_endpoints.quantized[e][c])<<1u)|_endpoints.pBits[e]):_endpoints.quantized[e][c];
+            expanded[e][c] = expandBPTCBits(raw, bits+(hasPBits ? 1u:0u));
+        }
+
+        const uint8_t* weights = impl::getBPTCWeights(_fit.indexBits);
+        const uint32_t paletteSize = 1u<<_fit.indexBits;
+        float palette[16][4];
+        for (uint32_t p=0u; p<paletteSize; p++)
+        for (uint32_t c=_fit.firstChannel; c<_fit.firstChannel+_fit.channels; c++)
+            palette[p][c] = float((expanded[0][c]*(64u-weights[p])+expanded[1][c]*weights[p]+32u)>>6u);
+
+        float error = 0.f;
+        for (uint32_t i=0u; i<_fit.count; i++)
+        {
+            const float* texel = _fit.texels[_fit.ix[i]];
+            float best = FLT_MAX;
+            for (uint32_t p=0u; p<paletteSize; p++)
+            {
+                float err = 0.f;
+                for (uint32_t c=_fit.firstChannel; c<_fit.firstChannel+_fit.channels; c++)
+                {
+                    const float d = texel[c]-palette[p][c];
+                    err += d*d;
+                }
+                if (err<best)
+                {
+                    best = err;
+                    _indices[_fit.ix[i]] = p;
+                }
+            }
+            error += best;
+        }
+        return error;
+    }
+
+    //! Quantizes float endpoints trying every allowed p-bit combination, keeps the best in `_endpoints`
+    float quantizeBPTCEndpoints(const SBPTCFit& _fit, const float _values[2][4], SBPTCEndpoints& _endpoints, uint8_t _indices[16])
+    {
+        const uint32_t combinations = _fit.endpointPBits ? 4u:(_fit.sharedPBit ? 2u:1u);
+        float bestError = FLT_MAX;
+        for (uint32_t combo=0u; combo<combinations; combo++)
+        {
+            SBPTCEndpoints candidate = _endpoints;
+            candidate.pBits[0] = combo&1u;
+            candidate.pBits[1] = _fit.endpointPBits ? (combo>>1u):candidate.pBits[0];
+            for (uint32_t e=0u; e<2u; e++)
+            for (uint32_t c=_fit.firstChannel; c<_fit.firstChannel+_fit.channels; c++)
+                candidate.quantized[e][c] = quantizeBPTCChannel(_values[e][c-_fit.firstChannel], c==3u ? _fit.alphaBits:_fit.colorBits, combinations>1u, candidate.pBits[e]);
+
+            uint8_t indices[16];
+            const float error = evaluateBPTC(_fit, candidate, indices);
+            if (error<bestError)
+            {
+                bestError = error;
+                _endpoints = candidate;
+                for (uint32_t i=0u; i<_fit.count; i++)
+                    _indices[_fit.ix[i]] = indices[_fit.ix[i]];
+            }
+        }
+        return bestError;
+    }
+
+    float fitBPTCEndpoints(const SBPTCFit& _fit, E_BLOCK_ENCODE_QUALITY _quality, SBPTCEndpoints& _endpoints, uint8_t _indices[16])
+    {
+        float values[2][4];
+        computeAxisEndpoints(_fit.texels, _fit.ix, _fit.count, _fit.firstChannel, _fit.channels, values);
+        float error = quantizeBPTCEndpoints(_fit, values, _endpoints, _indices);
+
+        const uint8_t* weights = impl::getBPTCWeights(_fit.indexBits);
+        for (uint32_t pass=0u; pass<getRefinementPasses(_quality) && error>0.f; pass++)
+        {
+            float w[16];
+            for (uint32_t i=0u; i<_fit.count; i++)
+                w[i] = weights[_indices[_fit.ix[i]]]/64.f;
+            if (!solveEndpoints(_fit.texels, _fit.ix, w, _fit.count, _fit.firstChannel, _fit.channels, values))
+                break;
+            SBPTCEndpoints candidate = _endpoints;
+            uint8_t indices[16];
+            const float candidateError = quantizeBPTCEndpoints(_fit, values, candidate, indices);
+            if (candidateError>=error)
+                break;
+            error = candidateError;
+            _endpoints = candidate;
+            for (uint32_t i=0u; i<_fit.count; i++)
+                _indices[_fit.ix[i]] = indices[_fit.ix[i]];
+        }
+
+        if (_quality<EBEQ_BEST)
+            return error;
+        for (bool improved=true; improved && error>0.f;)
+        {
+            improved = false;
+            for (uint32_t e=0u; e<2u; e++)
+            for (uint32_t c=_fit.firstChannel; c<_fit.firstChannel+_fit.channels; c++)
+            for (int32_t step=-1; step<=1; step+=2)
+            {
+                const int32_t value = int32_t(_endpoints.quantized[e][c])+step;
+                if (value<0 || value>=(1<<(c==3u ? _fit.alphaBits:_fit.colorBits)))
+                    continue;
+                SBPTCEndpoints candidate = _endpoints;
+                candidate.quantized[e][c] = value;
+                uint8_t indices[16];
+                const float candidateError = evaluateBPTC(_fit, candidate, indices);
+                if (candidateError<error)
+                {
+                    error = candidateError;
+                    _endpoints = candidate;
+                    for (uint32_t i=0u; i<_fit.count; i++)
+                        _indices[_fit.ix[i]] = indices[_fit.ix[i]];
+                    improved = true;
+                }
+            }
+        }
+        return error;
+    }
+
+    //! Texels of every subset of a partition, `_ix` receives them grouped by subset
+    void gatherBPTCSubsets(uint32_t _subsets, uint32_t _partition, uint8_t _ix[16], uint32_t _counts[3])
+    {
+        _counts[0] = _counts[1] = _counts[2] = 0u;
+        uint8_t subsetOf[16];
+        for (uint32_t i=0u; i<16u; i++)
+            _counts[subsetOf[i] = impl::getBPTCSubset(_subsets, _partition, i)]++;
+        uint32_t offsets[3] = {0u, _counts[0], _counts[0]+_counts[1]};
+        for (uint32_t i=0u; i<16u; i++)
+            _ix[offsets[subsetOf[i]]++] = i;
+    }
+
+    //! Partitions sorted by how well each of their subsets fits a line, only the first `_candidateCount` get returned
+    uint32_t rankBPTCPartitions(const texel_t _texels[16], uint32_t _subsets, uint32_t _partitionCount, uint32_t _channels, uint32_t* _candidates, uint32_t _candidateCount)
+    {
+        float scores[64];
+        uint32_t order[64];
+        for (uint32_t p=0u; p<_partitionCount; p++)
+        {
+            uint8_t ix[16];
+            uint32_t counts[3];
+            gatherBPTCSubsets(_subsets, p, ix, counts);
+            scores[p] = 0.f;
+            for (uint32_t s=0u, offset=0u; s<_subsets; offset+=counts[s++])
+            {
+                // a rough axis is plenty to tell good partitions from bad ones
+                float mean[4], axis[4];
+                scores[p] += computePrincipalAxis(_texels, ix+offset, counts[s], 0u, _channels, mean, axis, 3u);
+            }
+            order[p] = p;
+        }
+        _candidateCount = std::min(_candidateCount, _partitionCount);
+        std::partial_sort(order, order+_candidateCount, order+_partitionCount, [&scores](uint32_t a, uint32_t b) { return scores[a]<scores[b]; });
+        memcpy(_candidates, order, _candidateCount*sizeof(uint32_t));
+        return _candidateCount;
+    }
+
+    //! Swaps endpoints where needed so the most significant index bit of every anchor texel is 0, and writes the block
+    void packBPTC(SBPTCBlock _block, uint8_t _output[16])
+    {
+        const SBPTCMode& mode = BPTCModes[_block.mode];
+        const uint32_t maxIndex = (1u<<mode.indexBits)-1u;
+        for (uint32_t s=0u; s<mode.subsets; s++)
+        {
+            uint32_t anchor = 0u;
+            if (s==1u)
+                anchor = mode.subsets==2u ? impl::BPTCAnchors2[_block.partition]:impl::BPTCAnchors3[0][_block.partition];
+            else if (s==2u)
+                anchor = impl::BPTCAnchors3[1][_block.partition];
+            if (!(_block.indices[anchor]>>(mode.indexBits-1u)))
+                continue;
+
+            auto& endpoints = _block.endpoints[s];
+            // with separate alpha indices only the color endpoints belong to these indices
+            for (uint32_t c=0u; c<(mode.secondaryIndexBits ? 3u:4u); c++)
+                std::swap(endpoints.quantized[0][c], endpoints.quantized[1][c]);
+            std::swap(endpoints.pBits[0], endpoints.pBits[1]);
+            for (uint32_t i=0u; i<16u; i++)
+            {
+                if (impl::getBPTCSubset(mode.subsets, _block.partition, i)==s)
+                    _block.indices[i] = maxIndex-_block.indices[i];
+            }
+        }
+        if (mode.secondaryIndexBits && (_block.secondaryIndices[0]>>(mode.secondaryIndexBits-1u)))
+        {
+            std::swap(_block.endpoints[0].quantized[0][3], _block.endpoints[0].quantized[1][3]);
+            for (auto& index : _block.secondaryIndices)
+                index = (1u<<mode.secondaryIndexBits)-1u-index;
+        }
+
+        SBlockBitWriter bits;
+        bits.write(1u<<_block.mode, _block.mode+1u);
+        bits.write(_block.partition, mode.partitionBits);
+        bits.write(_block.rotation, mode.rotationBits);
+        for (uint32_t c=0u; c<3u; c++)
+        for (uint32_t s=0u; s<mode.subsets; s++)
+        for (uint32_t e=0u; e<2u; e++)
+            bits.write(_block.endpoints[s].quantized[e][c], mode.colorBits);
+        if (mode.alphaBits)
+        for (uint32_t s=0u; s<mode.subsets; s++)
+        for (uint32_t e=0u; e<2u; e++)
+            bits.write(_block.endpoints[s].quantized[e][3], mode.alphaBits);
+        for (uint32_t s=0u; s<mode.subsets; s++)
+        {
+            if (mode.endpointPBits)
+            {
+                bits.write(_block.endpoints[s].pBits[0], 1u);
+                bits.write(_block.endpoints[s].pBits[1], 1u);
+            }
+            else if (mode.sharedPBits)
+                bits.write(_block.endpoints[s].pBits[0], 1u);
+        }
+        for (uint32_t i=0u; i<16u; i++)
+            bits.write(_block.indices[i], mode.indexBits-(impl::isBPTCAnchor(mode.subsets, _block.partition, i) ? 1u:0u));
+        if (mode.secondaryIndexBits)
+        for (uint32_t i=0u; i<16u; i++)
+            bits.write(_block.secondaryIndices[i], mode.secondaryIndexBits-(i ? 0u:1u));
+        bits.store(_output);
+    }
+
+    //! Fits one of the single-index modes (all but 4 and 5) for a given partition
+    void fitBPTCMode(const texel_t _texels[16], uint32_t _mode, uint32_t _partition, E_BLOCK_ENCODE_QUALITY _quality, SBPTCBlock& _block)
+    {
+        const SBPTCMode& mode = BPTCModes[_mode];
+        _block.mode = _mode;
+        _block.partition = _partition;
+        _block.rotation = 0u;
+        _block.error = 0.f;
+
+        uint8_t ix[16];
+        uint32_t counts[3];
+        gatherBPTCSubsets(mode.subsets, _partition, ix, counts);
+        for (uint32_t s=0u, offset=0u; s<mode.subsets; offset+=counts[s++])
+        {
+            // modes without alpha decode it as 255, callers only pick them for opaque blocks
+            const SBPTCFit fit = {_texels, ix+offset, counts[s], 0u, mode.alphaBits ? 4u:3u, mode.colorBits, mode.alphaBits, mode.endpointPBits!=0u, mode.sharedPBits!=0u, mode.indexBits};
+            for (uint32_t e=0u; e<2u; e++)
+                _block.endpoints[s].quantized[e][3] = 0u;
+            _block.error += fitBPTCEndpoints(fit, _quality, _block.endpoints[s], _block.indices);
+        }
+    }
+
+    //! Mode 5, color and alpha get their own endpoints and indices, `_rotation` swaps alpha with one of the color channels
+    void fitBPTCMode5(const texel_t _texels[16], uint32_t _rotation, E_BLOCK_ENCODE_QUALITY _quality, SBPTCBlock& _block)
+    {
+        const SBPTCMode& mode = BPTCModes[5];
+        texel_t rotated[16];
+        memcpy(rotated, _texels, sizeof(rotated));
+        if (_rotation)
+        for (auto& texel : rotated)
+            std::swap(texel[3], texel[_rotation-1u]);
+
+        uint8_t ix[16];
+        for (uint32_t i=0u; i<16u; i++)
+            ix[i] = i;
+        _block.mode = 5u;
+        _block.partition = 0u;
+        _block.rotation = _rotation;
+        const SBPTCFit colorFit = {rotated, ix, 16u, 0u, 3u, mode.colorBits, mode.alphaBits, false, false, mode.indexBits};
+        const SBPTCFit alphaFit = {rotated, ix, 16u, 3u, 1u, mode.colorBits, mode.alphaBits, false, false, mode.secondaryIndexBits};
+        _block.error = fitBPTCEndpoints(colorFit, _quality, _block.endpoints[0], _block.indices);
+        _block.error += fitBPTCEndpoints(alphaFit, _quality, _block.endpoints[0], _block.secondaryIndices);
+    }
+
+    void encodeBC7Block(const texel_t _texels[16], uint8_t _output[16], E_BLOCK_ENCODE_QUALITY _quality)
+    {
+        bool opaque = true;
+        for (uint32_t i=0u; i<16u; i++)
+            opaque = opaque && _texels[i][3]>=254.5f;
+
+        SBPTCBlock best;
+        fitBPTCMode(_texels, 6u, 0u, _quality, best);
+
+        auto tryBlock = [&best](const SBPTCBlock& _candidate) -> void
+        {
+            if (_candidate.error<best.error)
+                best = _candidate;
+        };
+        // modes 1 and 3 split the texels the same way, so they share the ranking of the partitions
+        uint32_t twoSubsetCandidates[4];
+        uint32_t twoSubsetCandidateCount = 0u;
+        auto tryPartitionedMode = [&](uint32_t _mode, uint32_t _candidateCount) -> void
+        {
+            const SBPTCMode& mode = BPTCModes[_mode];
+            uint32_t candidates[4];
+            uint32_t count;
+            if ((_mode==1u || _mode==3u) && twoSubsetCandidateCount)
+            {
+                count = twoSubsetCandidateCount;
+                memcpy(candidates, twoSubsetCandidates, sizeof(candidates));
+            }
+            else
+                count = rankBPTCPartitions(_texels, mode.subsets, 1u<<mode.partitionBits, mode.alphaBits ? 4u:3u, candidates, _candidateCount);
+            if (_mode==1u || _mode==3u)
+            {
+                twoSubsetCandidateCount = count;
+                memcpy(twoSubsetCandidates, candidates, sizeof(candidates));
+            }
+
+            for (uint32_t i=0u; i<count && best.error>0.f; i++)
+            {
+                SBPTCBlock candidate;
+                fitBPTCMode(_texels, _mode, candidates[i], _quality, candidate);
+                tryBlock(candidate);
+            }
+        };
+
+        if (_quality>EBEQ_FAST && best.error>0.f)
+        {
+            const uint32_t candidateCount = _quality==EBEQ_BEST ? 4u:1u;
+            if (opaque)
+            {
+                tryPartitionedMode(1u, candidateCount);
+                tryPartitionedMode(3u, candidateCount);
+                if (_quality==EBEQ_BEST)
+                {
+                    tryPartitionedMode(0u, candidateCount);
+                    tryPartitionedMode(2u, candidateCount);
+                }
+            }
+            else
+            {
+                for (uint32_t rotation=0u; rotation<(_quality==EBEQ_BEST ? 4u:1u) && best.error>0.f; rotation++)
+                {
+                    SBPTCBlock candidate;
+                    fitBPTCMode5(_texels, rotation, _quality, candidate);
+                    tryBlock(candidate);
+                }
+                tryPartitionedMode(7u, candidateCount);
+            }
+        }
+        packBPTC(best, _output);
+    }
+
+    //! Converts decoded texels to the [0,255] space of the format, sRGB formats get encoded to sRGB first
+    void prepareTexels(const double _input[16][4], bool _sRGB, texel_t _output[16])
+    {
+        for (uint32_t i=0u; i<16u; i++)
+        {
+            double texel[4];
+            for (uint32_t c=0u; c<4u; c++)
+                texel[c] = core::clamp(_input[i][c], 0., 1.);
+            if (_sRGB)
+                impl::lin2SRGB(texel);
+            for (uint32_t c=0u; c<4u; c++)
+                _output[i][c] = static_cast<float>(texel[c]*255.);
+        }
+    }
+}
+
+bool isBlockEncodable(asset::E_FORMAT _fmt)
+{
+    switch (_fmt)
+    {
+        case asset::EF_BC1_RGB_UNORM_BLOCK:
+        case asset::EF_BC1_RGB_SRGB_BLOCK:
+        case asset::EF_BC1_RGBA_UNORM_BLOCK:
+        case asset::EF_BC1_RGBA_SRGB_BLOCK:
+        case asset::EF_BC2_UNORM_BLOCK:
+        case asset::EF_BC2_SRGB_BLOCK:
+        case asset::EF_BC3_UNORM_BLOCK:
+        case asset::EF_BC3_SRGB_BLOCK:
+        case asset::EF_BC4_UNORM_BLOCK:
+        case asset::EF_BC5_UNORM_BLOCK:
+        case asset::EF_BC7_UNORM_BLOCK:
+        case asset::EF_BC7_SRGB_BLOCK:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool encodeBlock(asset::E_FORMAT _fmt, const double _texels[16][4], void* _output, E_BLOCK_ENCODE_QUALITY _quality)
+{
+    if (!isBlockEncodable(_fmt))
+        return false;
+
+    texel_t texels[16];
+    prepareTexels(_texels, asset::isSRGBFormat(_fmt), texels);
+    uint8_t* output = reinterpret_cast<uint8_t*>(_output);
+    switch (_fmt)
+    {
+        case asset::EF_BC1_RGB_UNORM_BLOCK:
+        case asset::EF_BC1_RGB_SRGB_BLOCK:
+            encodeBC1Block(texels, output, false, _quality);
+            break;
+        case asset::EF_BC1_RGBA_UNORM_BLOCK:
+        case asset::EF_BC1_RGBA_SRGB_BLOCK:
+            encodeBC1Block(texels, output, true, _quality);
+            break;
+        case asset::EF_BC2_UNORM_BLOCK:
+        case asset::EF_BC2_SRGB_BLOCK:
+            for (uint32_t i=0u; i<16u; i+=2u)
+                output[i>>1u] = uint8_t(texels[i][3]/17.f+0.5f)|(uint8_t(texels[i+1u][3]/17.f+0.5f)<<4u);
+            encodeBC1Block(texels, output+8, false, _quality);
+            break;
+        case asset::EF_BC3_UNORM_BLOCK:
+        case asset::EF_BC3_SRGB_BLOCK:
+        {
+            float alpha[16];
+            for (uint32_t i=0u; i<16u; i++)
+                alpha[i] = texels[i][3];
+            encodeBC4Block(alpha, output, _quality);
+            encodeBC1Block(texels, output+8, false, _quality);
+            break;
+        }
+        case asset::EF_BC4_UNORM_BLOCK:
+        case asset::EF_BC5_UNORM_BLOCK:
+            for (uint32_t c=0u; c<(_fmt==asset::EF_BC5_UNORM_BLOCK ? 2u:1u); c++)
+            {
+                float values[16];
+                for (uint32_t i=0u; i<16u; i++)
+                    values[i] = texels[i][c];
+                encodeBC4Block(values, output+8u*c, _quality);
+            }
+            break;
+        default:
+            encodeBC7Block(texels, output, _quality);
+            break;
+    }
+    return true;
+}
+
+}
+}
+
+namespace irr { namespace asset
+{
+namespace
+{
+    inline uint32_t getBlockRowsInRange(const CImageData* _image)
+    {
+        const auto size = _image->getSize();
+        return ((size.Y+3u)/4u)*size.Z;
+    }
+
+    //! Checks every range can be read and compressed, and creates the (uninitialized) compressed ranges
+    bool createCompressedRanges(const CImageData* const* _images, uint32_t _count, E_FORMAT _fmt, CImageData** _output)
+    {
+        if (!video::isBlockEncodable(_fmt))
+            return false;
+        for (uint32_t i=0u; i<_count; i++)
+        {
+            const CImageData* image = _images[i];
+            const E_FORMAT srcFmt = image->getColorFormat();
+            if (isPlanarFormat(srcFmt) || isIntegerFormat(srcFmt) || (image->getOffset()[0]&3u) || (image->getOffset()[1]&3u))
+                return false;
+            const auto srcBlock = getBlockDimensions(srcFmt);
+            if (isBlockCompressionFormat(srcFmt) && (srcBlock[0]!=4u || srcBlock[1]!=4u))
+                return false;
+        }
+        for (uint32_t i=0u; i<_count; i++)
+        {
+            const CImageData* image = _images[i];
+            _output[i] = new CImageData(nullptr, image->getSliceMin(), image->getSliceMax(), image->getSupposedMipLevel(), _fmt, 1u);
+        }
+        return true;
+    }
+
+    //! Fetches the 4x4 texels of one block, clamping reads to the range so ragged edge blocks repeat their last row and column
+    void gatherBlockTexels(const CImageData* _image, uint32_t _blockX, uint32_t _blockY, uint32_t _z, double _texels[16][4])
+    {
+        const E_FORMAT fmt = _image->getColorFormat();
+        const auto size = _image->getSize();
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(_image->getData());
+        if (isBlockCompressionFormat(fmt))
+        {
+            const uint32_t blocksX = (size.X+3u)/4u;
+            const uint32_t blocksY = (size.Y+3u)/4u;
+            const size_t blockIx = (size_t(_z)*blocksY+_blockY)*blocksX+_blockX;
+            video::decodeBlock(fmt, data+blockIx*getTexelOrBlockBytesize(fmt), _texels);
+            return;
+        }
+
+        const size_t pitch = _image->getPitchIncludingAlignment();
+        const uint32_t texelSize = getTexelOrBlockBytesize(fmt);
+        for (uint32_t y=0u; y<4u; y++)
+        for (uint32_t x=0u; x<4u; x++)
+        {
+            const uint32_t srcX = std::min(_blockX*4u+x, size.X-1u);
+            const uint32_t srcY = std::min(_blockY*4u+y, size.Y-1u);
+            const void* pix[4] = {data+(size_t(_z)*size.Y+srcY)*pitch+size_t(srcX)*texelSize, nullptr, nullptr, nullptr};
+            double* texel = _texels[4u*y+x];
+            texel[0] = texel[1] = texel[2] = 0.;
+            texel[3] = 1.;
+            video::decodePixels<double>(fmt, pix, texel, 0u, 0u);
+        }
+    }
+
+    //! Encodes all the ranges at once, block rows of every range are handed out to the threads from a single pool
+    bool compressRanges(const CImageData* const* _images, CImageData* const* _output, uint32_t _count, video::E_BLOCK_ENCODE_QUALITY _quality, uint32_t _threadCount)
+    {
+        core::vector<size_t> firstRow(_count+1u, 0u);
+        for (uint32_t i=0u; i<_count; i++)
+        {
+            // reject formats the runtime decode does not know before any thread starts
+            double texels[16][4];
+            const void* pix[4] = {_images[i]->getData(), nullptr, nullptr, nullptr};
+            if (!isBlockCompressionFormat(_images[i]->getColorFormat()) && !video::decodePixels<double>(_images[i]->getColorFormat(), pix, texels[0], 0u, 0u))
+                return false;
+            firstRow[i+1u] = firstRow[i]+getBlockRowsInRange(_images[i]);
+        }
+
+        core::parallel_for_chunked(0u, firstRow.back(), 1u, [&](size_t rowBegin, size_t rowEnd, uint32_t) -> void
+        {
+            for (size_t row=rowBegin; row<rowEnd; row++)
+            {
+                const uint32_t rangeIx = static_cast<uint32_t>(std::upper_bound(firstRow.begin(), firstRow.end(), row)-firstRow.begin())-1u;
+                const CImageData* image = _images[rangeIx];
+                CImageData* output = _output[rangeIx];
+                const auto size = image->getSize();
+                const uint32_t blocksX = (size.X+3u)/4u;
+                const uint32_t blocksY = (size.Y+3u)/4u;
+                const uint32_t localRow = static_cast<uint32_t>(row-firstRow[rangeIx]);
+                const uint32_t blockY = localRow%blocksY;
+                const uint32_t z = localRow/blocksY;
+
+                const uint32_t blockSize = getTexelOrBlockBytesize(output->getColorFormat());
+                uint8_t* dst = reinterpret_cast<uint8_t*>(output->getData())+size_t(localRow)*blocksX*blockSize;
+                double texels[16][4];
+                for (uint32_t blockX=0u; blockX<blocksX; blockX++, dst+=blockSize)
+                {
+                    gatherBlockTexels(image, blockX, blockY, z, texels);
+                    video::encodeBlock(output->getColorFormat(), texels, dst, _quality);
+                }
+            }
+        }, _threadCount);
+        return true;
+    }
+}
+
+CImageData* createBlockCompressedImage(const CImageData* _image, E_FORMAT _fmt, video::E_BLOCK_ENCODE_QUALITY _quality, uint32_t _threadCount)
+{
+    if (!_image)
+        return nullptr;
+
+    CImageData* output = nullptr;
+    if (!createCompressedRanges(&_image, 1u, _fmt, &output))
+        return nullptr;
+    if (!compressRanges(&_image, &output, 1u, _quality, _threadCount))
+    {
+        output->drop();
+        return nullptr;
+    }
+    return output;
+}
+
+ICPUTexture* createBlockCompressedTexture(const ICPUTexture* _texture, E_FORMAT _fmt, video::E_BLOCK_ENCODE_QUALITY _quality, uint32_t _threadCount, const std::string& _newName)
+{
+    if (!_texture)
+        return nullptr;
+
+    const auto& ranges = _texture->getRanges();
+    core::vector<CImageData*> output(ranges.size(), nullptr);
+    if (!createCompressedRanges(ranges.data(), static_cast<uint32_t>(ranges.size()), _fmt, output.data()))
+        return nullptr;
+
+    ICPUTexture* retval = nullptr;
+    if (compressRanges(ranges.data(), output.data(), static_cast<uint32_t>(ranges.size()), _quality, _threadCount))
+        retval = ICPUTexture::create(output, _newName.empty() ? _texture->getSourceFilename():_newName, _texture->getType());
+    for (auto image : output)
+        image->drop();
+    return retval;
+}
+
+}
+}
@@ -0,0 +1,360 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "irr/asset/format/generateMipMaps.h"
+
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+
+#include "irr/asset/format/decodePixels.h"
+#include "irr/asset/format/encodePixels.h"
+#include "irr/core/parallel/parallel_for.h"
+
+namespace irr { namespace asset
+{
+namespace
+{
+    //! Level kept as linear RGBA floats, texel (x,y,z) starts at ((z*size[1]+y)*size[0]+x)*4
+    struct SFloatLevel
+    {
+        uint32_t size[3];
+        core::vector<float> texels;
+
+        inline void resize(const uint32_t _size[3])
+        {
+            std::copy(_size, _size+3, size);
+            texels.resize(size_t(size[0])*size[1]*size[2]*4u);
+        }
+    };
+
+    //! Weights of every output texel along one axis, all have `width` taps so the inner loop has a fixed length
+    struct SAxisKernel
+    {
+        uint32_t width;
+        core::vector<uint32_t> indices;
+        core::vector<float> weights;
+    };
+
+    inline double sinc(double _x)
+    {
+        if (std::abs(_x)<1e-6)
+            return 1.0;
+        _x *= core::PI<double>();
+        return std::sin(_x)/_x;
+    }
+
+    //! Zeroth order modified Bessel function of the first kind, the series converges quickly for the small arguments Kaiser windows use
+    inline double besselI0(double _x)
+    {
+        double sum = 1.0, term = 1.0;
+        const double halfSq = _x*_x*0.25;
+        for (uint32_t k=1u; k<32u && term>sum*1e-12; k++)
+        {
+            term *= halfSq/double(k*k);
+            sum += term;
+        }
+        return sum;
+    }
+
+    //! Radius of the filter in texels of the level being made
+    inline double getFilterSupport(E_MIP_MAP_FILTER _filter)
+    {
+        switch (_filter)
+        {
+            case EMMF_KAISER:
+            case EMMF_LANCZOS:
+                return 3.0;
+            default:
+                return 0.5;
+        }
+    }
+
+    inline double evaluateFilter(E_MIP_MAP_FILTER _filter, double _x)
+    {
+        const double support = getFilterSupport(_filter);
+        if (std::abs(_x)>=support)
+            return 0.0;
+        switch (_filter)
+        {
+            case EMMF_KAISER:
+            {
+                constexpr double alpha = 4.0;
+                const double t = _x/support;
+                return sinc(_x)*besselI0(alpha*std::sqrt(1.0-t*t))/besselI0(alpha);
+            }
+            case EMMF_LANCZOS:
+                return sinc(_x)*sinc(_x/support);
+            default:
+                return 1.0;
+        }
+    }
+
+    SAxisKernel createAxisKernel(E_MIP_MAP_FILTER _filter, uint32_t _srcSize, uint32_t _dstSize)
+    {
+        SAxisKernel kernel;
+        const double scale = double(_srcSize)/double(_dstSize);
+        const double radius = getFilterSupport(_filter)*scale;
+        kernel.width = static_cast<uint32_t>(std::ceil(radius*2.0))+1u;
+        kernel.indices.resize(size_t(_dstSize)*kernel.width);
+        kernel.weights.resize(size_t(_dstSize)*kernel.width);
+
+        for (uint32_t i=0u; i<_dstSize; i++)
+        {
+            const double center = (i+0.5)*scale;
+            const int32_t first = static_cast<int32_t>(std::floor(center-radius));
+            uint32_t* indices = kernel.indices.data()+size_t(i)*kernel.width;
+            float* weights = kernel.weights.data()+size_t(i)*kernel.width;
+
+            double total = 0.0;
+            for (uint32_t k=0u; k<kernel.width; k++)
+            {
+                const int32_t src = first+static_cast<int32_t>(k);
+                double w;
+                if (_filter==EMMF_BOX)
+                {
+                    // exact coverage of the source texel by the footprint, so odd sizes weight the shared texel by half
+                    const double lo = std::max(double(src), center-scale*0.5);
+                    const double hi = std::min(double(src+1), center+scale*0.5);
+                    w = std::max(hi-lo, 0.0);
+                }
+                else
+                    w = evaluateFilter(_filter, (src+0.5-center)/scale);
+                // clamp to edge
+                indices[k] = static_cast<uint32_t>(core::clamp<int32_t>(src, 0, int32_t(_srcSize)-1));
+                weights[k] = static_cast<float>(w);
+                total += w;
+            }
+            for (uint32_t k=0u; k<kernel.width; k++)
+                weights[k] = static_cast<float>(weights[k]/total);
+        }
+        return kernel;
+    }
+
+    //! Filters `_src` along `_axis` into `_dst` which has to be already sized, lines of texels along the axis are split among the threads
+    void filterAxis(const SFloatLevel& _src, SFloatLevel& _dst, uint32_t _axis, const SAxisKernel& _kernel, uint32_t _threadCount)
+    {
+        const size_t srcStride[3] = {4u, size_t(_src.size[0])*4u, size_t(_src.size[0])*_src.size[1]*4u};
+        const size_t dstStride[3] = {4u, size_t(_dst.size[0])*4u, size_t(_dst.size[0])*_dst.size[1]*4u};
+        const uint32_t a0 = _axis==0u ? 1u:0u;
+        const uint32_t a1 = _axis==2u ? 1u:2u;
+        const size_t lineCount = size_t(_dst.size[a0])*_dst.size[a1];
+        const uint32_t dstLength = _dst.size[_axis];
+
+        // aim for a few thousand taps per chunk so small levels do not drown in scheduling overhead
+        const size_t grain = std::max<size_t>(1u, 4096u/(size_t(dstLength)*_kernel.width));
+        core::parallel_for_chunked(0u, lineCount, grain, [&](size_t lineBegin, size_t lineEnd, uint32_t) -> void
+        {
+            for (size_t line=lineBegin; line<lineEnd; line++)
+            {
+                const size_t c0 = line%_dst.size[a0];
+                const size_t c1 = line/_dst.size[a0];
+                const float* srcLine = _src.texels.data()+c0*srcStride[a0]+c1*srcStride[a1];
+                float* dstLine = _dst.texels.data()+c0*dstStride[a0]+c1*dstStride[a1];
+                for (uint32_t i=0u; i<dstLength; i++)
+                {
+                    const uint32_t* indices = _kernel.indices.data()+size_t(i)*_kernel.width;
+                    const float* weights = _kernel.weights.data()+size_t(i)*_kernel.width;
+                    float sum[4] = {0.f, 0.f, 0.f, 0.f};
+                    for (uint32_t k=0u; k<_kernel.width; k++)
+                    {
+                        const float* texel = srcLine+indices[k]*srcStride[_axis];
+                        for (uint32_t c=0u; c<4u; c++)
+                            sum[c] += texel[c]*weights[k];
+                    }
+                    std::copy(sum, sum+4, dstLine+i*dstStride[_axis]);
+                }
+            }
+        }, _threadCount);
+    }
+
+    inline double getCoverage(const float* _texels, size_t _texelCount, float _alphaRef, float _scale)
+    {
+        size_t covered = 0u;
+        for (size_t i=0u; i<_texelCount; i++)
+            covered += (_texels[i*4u+3u]*_scale>_alphaRef) ? 1u:0u;
+        return double(covered)/double(_texelCount);
+    }
+
+    //! Scale for the alpha of one layer which brings its coverage closest to `_target`
+    float findAlphaScale(const float* _texels, size_t _texelCount, float _alphaRef, double _target)
+    {
+        float lo = 0.f, hi = 4.f;
+        float best = 1.f;
+        double bestError = std::abs(getCoverage(_texels, _texelCount, _alphaRef, 1.f)-_target);
+        for (uint32_t i=0u; i<12u; i++)
+        {
+            const float mid = (lo+hi)*0.5f;
+            const double coverage = getCoverage(_texels, _texelCount, _alphaRef, mid);
+            const double error = std::abs(coverage-_target);
+            if (error<bestError)
+            {
+                bestError = error;
+                best = mid;
+            }
+            if (coverage<_target)
+                lo = mid;
+            else if (coverage>_target)
+                hi = mid;
+            else
+                break;
+        }
+        return best;
+    }
+
+    void decodeLevel(const CImageData* _image, SFloatLevel& _output, uint32_t _threadCount)
+    {
+        const auto size = _image->getSize();
+        const uint32_t dims[3] = {size.X, size.Y, size.Z};
+        _output.resize(dims);
+
+        const E_FORMAT fmt = _image->getColorFormat();
+        const size_t pitch = _image->getPitchIncludingAlignment();
+        const uint32_t texelSize = getTexelOrBlockBytesize(fmt);
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(_image->getData());
+        core::parallel_for_chunked(0u, size_t(size.Y)*size.Z, 16u, [&](size_t rowBegin, size_t rowEnd, uint32_t) -> void
+        {
+            for (size_t row=rowBegin; row<rowEnd; row++)
+            {
+                const uint8_t* src = data+row*pitch;
+                float* dst = _output.texels.data()+row*size.X*4u;
+                for (uint32_t x=0u; x<size.X; x++, src+=texelSize, dst+=4u)
+                {
+                    double texel[4] = {0., 0., 0., 1.};
+                    const void* pix[4] = {src, nullptr, nullptr, nullptr};
+                    video::decodePixels<double>(fmt, pix, texel, 0u, 0u);
+                    std::copy(texel, texel+4, dst);
+                }
+            }
+        }, _threadCount);
+    }
+
+    void encodeLevel(const SFloatLevel& _level, const float* _alphaScales, uint32_t _texelsPerLayer, CImageData* _output, uint32_t _threadCount)
+    {
+        const E_FORMAT fmt = _output->getColorFormat();
+        // the encoders neither clamp nor check the sign, and the sinc based filters overshoot
+        const double minValue = isSignedFormat(fmt) ? (isNormalizedFormat(fmt) ? -1.0:-DBL_MAX):0.0;
+        const double maxValue = isNormalizedFormat(fmt) ? 1.0:DBL_MAX;
+
+        const size_t pitch = _output->getPitchIncludingAlignment();
+        const uint32_t texelSize = getTexelOrBlockBytesize(fmt);
+        uint8_t* data = reinterpret_cast<uint8_t*>(_output->getData());
+        const uint32_t width = _level.size[0];
+        core::parallel_for_chunked(0u, size_t(_level.size[1])*_level.size[2], 16u, [&](size_t rowBegin, size_t rowEnd, uint32_t) -> void
+        {
+            for (size_t row=rowBegin; row<rowEnd; row++)
+            {
+                uint8_t* dst = data+row*pitch;
+                const float* src = _level.texels.data()+row*width*4u;
+                const float alphaScale = _alphaScales ? _alphaScales[(row*width)/_texelsPerLayer]:1.f;
+                for (uint32_t x=0u; x<width; x++, src+=4u, dst+=texelSize)
+                {
+                    double texel[4];
+                    for (uint32_t c=0u; c<4u; c++)
+                        texel[c] = core::clamp<double>(src[c], minValue, maxValue);
+                    texel[3] = core::clamp<double>(src[3]*alphaScale, minValue, maxValue);
+                    video::encodePixels<double>(fmt, dst, texel);
+                }
+            }
+        }, _threadCount);
+    }
+}
+
+ICPUTexture* createMipMappedTexture(const ICPUTexture* _texture, const SMipMapGenerationParams& _params, const std::string& _newName)
+{
+    if (!_texture)
+        return nullptr;
+
+    const auto baseRange = _texture->getMipMap(0u);
+    if (baseRange.second-baseRange.first!=1 || (*baseRange.first)->getSupposedMipLevel()!=0u)
+        return nullptr;
+    CImageData* base = *baseRange.first;
+    const uint32_t* offset = base->getSliceMin();
+    const uint32_t* size = base->getSliceMax();
+    if (offset[0]||offset[1]||offset[2] || !std::equal(size, size+3, _texture->getSize()))
+        return nullptr;
+
+    const E_FORMAT fmt = base->getColorFormat();
+    if (isBlockCompressionFormat(fmt) || isPlanarFormat(fmt) || isIntegerFormat(fmt))
+        return nullptr;
+    {
+        // reject formats the runtime decode or encode does not know before any thread starts
+        double texel[4] = {0., 0., 0., 1.};
+        const void* pix[4] = {base->getData(), nullptr, nullptr, nullptr};
+        uint64_t scratch[4] = {0ull, 0ull, 0ull, 0ull};
+        if (!base->getData() || !video::decodePixels<double>(fmt, pix, texel, 0u, 0u) || !video::encodePixels<double>(fmt, scratch, texel))
+            return nullptr;
+    }
+
+    // same as ICPUTexture::establishMinBaseLevelSize, the remaining dimensions are layers
+    const uint32_t mipDimensions[video::ITexture::ETT_COUNT] = {1u,2u,3u,1u,2u,2u,2u};
+    const uint32_t dimCount = mipDimensions[_texture->getType()];
+
+    uint32_t levelCount = 1u;
+    for (uint32_t d=0u; d<dimCount; d++)
+        levelCount = std::max(levelCount, core::findMSB(size[d])+1u);
+    if (_params.levelCount)
+        levelCount = std::min(levelCount, _params.levelCount);
+
+    const bool preserveCoverage = _params.alphaCoverageReference>0.f && _params.alphaCoverageReference<1.f;
+    const uint32_t layerCount = dimCount==3u ? 1u:size[dimCount];
+    core::vector<double> baseCoverage;
+    core::vector<float> alphaScales;
+
+    SFloatLevel current, tmp[2];
+    decodeLevel(base, current, _params.threadCount);
+    if (preserveCoverage)
+    {
+        const size_t texelsPerLayer = current.texels.size()/4u/layerCount;
+        for (uint32_t l=0u; l<layerCount; l++)
+            baseCoverage.push_back(getCoverage(current.texels.data()+l*texelsPerLayer*4u, texelsPerLayer, _params.alphaCoverageReference, 1.f));
+        alphaScales.resize(layerCount);
+    }
+
+    core::vector<CImageData*> ranges = {base};
+    for (uint32_t level=1u; level<levelCount; level++)
+    {
+        // filter one axis at a time, ping-ponging between the temporaries and ending up back in `current`
+        SFloatLevel* src = &current;
+        uint32_t pass = 0u;
+        for (uint32_t d=0u; d<dimCount; d++)
+        {
+            uint32_t dstSize[3];
+            std::copy(src->size, src->size+3, dstSize);
+            dstSize[d] = std::max(src->size[d]>>1u, 1u);
+            if (dstSize[d]==src->size[d])
+                continue;
+
+            SFloatLevel& dst = tmp[pass&1u];
+            dst.resize(dstSize);
+            filterAxis(*src, dst, d, createAxisKernel(_params.filter, src->size[d], dstSize[d]), _params.threadCount);
+            src = &dst;
+            pass++;
+        }
+        if (src!=&current)
+            std::swap(current, *src);
+
+        const uint32_t texelsPerLayer = static_cast<uint32_t>(current.texels.size()/4u/layerCount);
+        if (preserveCoverage)
+        {
+            core::parallel_for(0u, layerCount, [&](size_t l) -> void
+            {
+                alphaScales[l] = findAlphaScale(current.texels.data()+l*texelsPerLayer*4u, texelsPerLayer, _params.alphaCoverageReference, baseCoverage[l]);
+            }, _params.threadCount);
+        }
+
+        const uint32_t minCoord[3] = {0u, 0u, 0u};
+        CImageData* output = new CImageData(nullptr, minCoord, current.size, level, fmt, 1u);
+        encodeLevel(current, preserveCoverage ? alphaScales.data():nullptr, texelsPerLayer, output, _params.threadCount);
+        ranges.push_back(output);
+    }
+
+    ICPUTexture* retval = ICPUTexture::create(ranges, _newName.empty() ? _texture->getSourceFilename():_newName, _texture->getType());
+    for (size_t i=1u; i<ranges.size(); i++)
+        ranges[i]->drop();
+    return retval;
+}
+
+}
+}
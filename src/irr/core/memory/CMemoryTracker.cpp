@@ -0,0 +1,230 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "irr/core/memory/CMemoryTracker.h"
+#include "irr/macros.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+namespace irr
+{
+namespace core
+{
+
+namespace
+{
+	thread_local E_MEMORY_TAG CurrentTag = EMT_UNTAGGED;
+
+	struct STagCounters
+	{
+		std::atomic<uint64_t> liveBytes;
+		std::atomic<uint64_t> peakBytes;
+		std::atomic<uint64_t> liveAllocations;
+		std::atomic<uint64_t> allocationCount;
+		std::atomic<uint64_t> allocatedBytes;
+		std::atomic<uint64_t> freeCount;
+	};
+
+	struct SAllocationRecord
+	{
+		size_t size;
+		E_MEMORY_TAG tag;
+	};
+
+	//! the live allocations, split by address so threads rarely wait on each other
+	struct SShard
+	{
+		std::mutex mutex;
+		// std::allocator on purpose, the tracker must not allocate through the macros it is behind
+		std::unordered_map<const void*,SAllocationRecord> allocations;
+	};
+	constexpr uint32_t ShardCount = 64u;
+
+	struct STrackerState
+	{
+		STagCounters tags[EMT_COUNT] = {};
+		SShard shards[ShardCount];
+
+		inline SShard& getShard(const void* _addr)
+		{
+			// the lowest bits are the same for all aligned allocations
+			const size_t addr = reinterpret_cast<size_t>(_addr);
+			return shards[((addr>>4u)^(addr>>12u))%ShardCount];
+		}
+	};
+
+	//! never destroyed, memory can still get freed while static objects are destroyed at exit
+	STrackerState& getState()
+	{
+		static STrackerState* state = new STrackerState();
+		return *state;
+	}
+
+	inline uint64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+}
+
+void* tracked_aligned_malloc(size_t size, size_t alignment) noexcept
+{
+	void* retval = _IRR_UNTRACKED_ALIGNED_MALLOC(size,alignment);
+	if (!retval)
+		return nullptr;
+
+	STrackerState& state = getState();
+	const E_MEMORY_TAG tag = CurrentTag;
+	{
+		SShard& shard = state.getShard(retval);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		try
+		{
+			shard.allocations[retval] = {size,tag};
+		}
+		catch (const std::bad_alloc&)
+		{
+			// the allocation itself succeeded, it just won't be counted
+			return retval;
+		}
+	}
+
+	STagCounters& counters = state.tags[tag];
+	const uint64_t live = counters.liveBytes.fetch_add(size,std::memory_order_relaxed)+size;
+	uint64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+	while (live>peak && !counters.peakBytes.compare_exchange_weak(peak,live,std::memory_order_relaxed)) {}
+	counters.liveAllocations.fetch_add(1ull,std::memory_order_relaxed);
+	counters.allocationCount.fetch_add(1ull,std::memory_order_relaxed);
+	counters.allocatedBytes.fetch_add(size,std::memory_order_relaxed);
+	return retval;
+}
+
+void tracked_aligned_free(void* addr) noexcept
+{
+	if (!addr)
+		return;
+
+	STrackerState& state = getState();
+	SAllocationRecord record;
+	bool found = false;
+	{
+		SShard& shard = state.getShard(addr);
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		auto it = shard.allocations.find(addr);
+		if (it!=shard.allocations.end())
+		{
+			record = it->second;
+			shard.allocations.erase(it);
+			found = true;
+		}
+	}
+
+	if (found)
+	{
+		STagCounters& counters = state.tags[record.tag];
+		counters.liveBytes.fetch_sub(record.size,std::memory_order_relaxed);
+		counters.liveAllocations.fetch_sub(1ull,std::memory_order_relaxed);
+		counters.freeCount.fetch_add(1ull,std::memory_order_relaxed);
+	}
+	_IRR_UNTRACKED_ALIGNED_FREE(addr);
+}
+
+E_MEMORY_TAG CMemoryTracker::setCurrentTag(E_MEMORY_TAG _tag)
+{
+	_IRR_DEBUG_BREAK_IF(_tag>=EMT_COUNT);
+	const E_MEMORY_TAG previous = CurrentTag;
+	CurrentTag = _tag;
+	return previous;
+}
+
+E_MEMORY_TAG CMemoryTracker::getCurrentTag()
+{
+	return CurrentTag;
+}
+
+const char* CMemoryTracker::getTagName(E_MEMORY_TAG _tag)
+{
+	switch (_tag)
+	{
+		case EMT_UNTAGGED:
+			return "Untagged";
+		case EMT_ASSET_CACHE:
+			return "Asset Cache";
+		case EMT_ASSET_LOADER:
+			return "Asset Loaders";
+		case EMT_CPU_BUFFER:
+			return "CPU Buffers";
+		case EMT_IMAGE:
+			return "Images";
+		case EMT_SCENE:
+			return "Scene";
+		case EMT_ADDRESS_ALLOCATOR:
+			return "Address Allocators";
+		case EMT_USER_0:
+			return "User 0";
+		case EMT_USER_1:
+			return "User 1";
+		case EMT_USER_2:
+			return "User 2";
+		case EMT_USER_3:
+			return "User 3";
+		default:
+			return "Invalid";
+	}
+}
+
+CMemoryTracker::SSnapshot CMemoryTracker::getSnapshot()
+{
+	SSnapshot retval;
+	retval.time = now();
+
+	STrackerState& state = getState();
+	for (uint32_t i=0u; i<EMT_COUNT; i++)
+	{
+		const STagCounters& counters = state.tags[i];
+		STagStatistics& stats = retval.tags[i];
+		stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+		stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+		stats.liveAllocations = counters.liveAllocations.load(std::memory_order_relaxed);
+		stats.allocationCount = counters.allocationCount.load(std::memory_order_relaxed);
+		stats.allocatedBytes = counters.allocatedBytes.load(std::memory_order_relaxed);
+		stats.freeCount = counters.freeCount.load(std::memory_order_relaxed);
+	}
+	return retval;
+}
+
+CMemoryTracker::SDifference CMemoryTracker::diff(const SSnapshot& _earlier, const SSnapshot& _later)
+{
+	SDifference retval;
+	retval.duration = _later.time-_earlier.time;
+
+	const double seconds = double(retval.duration)*1e-9;
+	for (uint32_t i=0u; i<EMT_COUNT; i++)
+	{
+		const STagStatistics& a = _earlier.tags[i];
+		const STagStatistics& b = _later.tags[i];
+		STagDifference& d = retval.tags[i];
+		d.liveBytes = int64_t(b.liveBytes)-int64_t(a.liveBytes);
+		d.liveAllocations = int64_t(b.liveAllocations)-int64_t(a.liveAllocations);
+		d.allocationCount = b.allocationCount-a.allocationCount;
+		d.allocatedBytes = b.allocatedBytes-a.allocatedBytes;
+		d.freeCount = b.freeCount-a.freeCount;
+		d.allocationsPerSecond = seconds>0.0 ? double(d.allocationCount)/seconds:0.0;
+		d.bytesPerSecond = seconds>0.0 ? double(d.allocatedBytes)/seconds:0.0;
+	}
+	return retval;
+}
+
+void CMemoryTracker::resetPeaks()
+{
+	STrackerState& state = getState();
+	for (uint32_t i=0u; i<EMT_COUNT; i++)
+		state.tags[i].peakBytes.store(state.tags[i].liveBytes.load(std::memory_order_relaxed),std::memory_order_relaxed);
+}
+
+} // end namespace core
+} // end namespace irr
@@ -0,0 +1,122 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "irr/core/parallel/CThreadPool.h"
+
+#include <algorithm>
+
+namespace irr
+{
+namespace core
+{
+
+CThreadPool::CThreadPool(uint32_t _workerCount) : m_exit(false)
+{
+	m_workers.reserve(_workerCount);
+	for (uint32_t i=0u; i<_workerCount; i++)
+		m_workers.emplace_back(&CThreadPool::workerLoop,this);
+}
+
+CThreadPool::~CThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_exit = true;
+	}
+	m_jobAvailable.notify_all();
+	for (auto& worker : m_workers)
+		worker.join();
+}
+
+CThreadPool& CThreadPool::getGlobal()
+{
+	// never destroyed, joining threads while static objects get destroyed at exit is asking for trouble
+	static CThreadPool* pool = new CThreadPool(getDefaultThreadCount()-1u);
+	return *pool;
+}
+
+void CThreadPool::run(uint32_t _helperCount, void (*_func)(void*,uint32_t), void* _context)
+{
+	_helperCount = std::min(_helperCount,getWorkerCount());
+	if (!_helperCount)
+	{
+		_func(_context,0u);
+		return;
+	}
+
+	SJob job = {_func,_context,_helperCount,0u,0u,nullptr};
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.push_back(&job);
+	}
+	if (_helperCount<getWorkerCount())
+	{
+		for (uint32_t i=0u; i<_helperCount; i++)
+			m_jobAvailable.notify_one();
+	}
+	else
+		m_jobAvailable.notify_all();
+
+	std::exception_ptr exception;
+	try
+	{
+		_func(_context,0u);
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		// no more workers may join once the calling thread is done, the ones which did are waited for
+		auto found = std::find(m_jobs.begin(),m_jobs.end(),&job);
+		if (found!=m_jobs.end())
+			m_jobs.erase(found);
+		if (exception && !job.exception)
+			job.exception = exception;
+		m_jobFinished.wait(lock,[&job]() -> bool { return job.finished==job.joined; });
+	}
+	if (job.exception)
+		std::rethrow_exception(job.exception);
+}
+
+void CThreadPool::workerLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_jobAvailable.wait(lock,[this]() -> bool { return m_exit||!m_jobs.empty(); });
+		if (m_exit)
+			return;
+
+		SJob* job = m_jobs.front();
+		const uint32_t threadIx = ++job->joined;
+		if (job->joined==job->helperCount)
+			m_jobs.pop_front();
+
+		lock.unlock();
+		std::exception_ptr exception;
+		try
+		{
+			job->func(job->context,threadIx);
+		}
+		catch (...)
+		{
+			// an exception escaping the worker would terminate the program, the calling thread rethrows it instead
+			exception = std::current_exception();
+		}
+		lock.lock();
+
+		if (exception && !job->exception)
+			job->exception = exception;
+
+		// the job lives on the stack of the thread which ran it, it must not be touched after the calling thread could have seen this
+		if (++job->finished==job->joined)
+			m_jobFinished.notify_all();
+	}
+}
+
+} // end namespace core
+} // end namespace irr
@@ -0,0 +1,238 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "irr/scene/CDynamicAABBTree.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	inline core::aabbox3df unionBox(const core::aabbox3df& _a, const core::aabbox3df& _b)
+	{
+		core::aabbox3df retval(_a);
+		retval.addInternalBox(_b);
+		return retval;
+	}
+
+	//! Half the surface area, what the cost of visiting a node is proportional to
+	inline float surfaceArea(const core::aabbox3df& _box)
+	{
+		const core::vector3df extent = _box.MaxEdge-_box.MinEdge;
+		return extent.X*extent.Y+extent.Y*extent.Z+extent.Z*extent.X;
+	}
+}
+
+CDynamicAABBTree::proxy_t CDynamicAABBTree::createProxy(const core::aabbox3df& _box, void* _userData)
+{
+	const uint32_t leaf = allocateNode();
+	SNode& node = m_nodes[leaf];
+	const core::vector3df margin(m_margin);
+	node.box = core::aabbox3df(_box.MinEdge-margin, _box.MaxEdge+margin);
+	node.userData = _userData;
+	node.children[0] = node.children[1] = invalid_proxy;
+	node.height = 0u;
+	insertLeaf(leaf);
+	m_proxyCount++;
+	return leaf;
+}
+
+void CDynamicAABBTree::destroyProxy(proxy_t _proxy)
+{
+	removeLeaf(_proxy);
+	freeNode(_proxy);
+	m_proxyCount--;
+}
+
+bool CDynamicAABBTree::moveProxy(proxy_t _proxy, const core::aabbox3df& _box)
+{
+	if (_box.isFullInside(m_nodes[_proxy].box))
+		return false;
+
+	removeLeaf(_proxy);
+	const core::vector3df margin(m_margin);
+	m_nodes[_proxy].box = core::aabbox3df(_box.MinEdge-margin, _box.MaxEdge+margin);
+	insertLeaf(_proxy);
+	return true;
+}
+
+void CDynamicAABBTree::clear()
+{
+	m_nodes.clear();
+	m_root = invalid_proxy;
+	m_freeList = invalid_proxy;
+	m_proxyCount = 0u;
+}
+
+uint32_t CDynamicAABBTree::allocateNode()
+{
+	if (m_freeList==invalid_proxy)
+	{
+		m_nodes.emplace_back();
+		return static_cast<uint32_t>(m_nodes.size()-1u);
+	}
+
+	const uint32_t index = m_freeList;
+	m_freeList = m_nodes[index].parent;
+	return index;
+}
+
+void CDynamicAABBTree::freeNode(uint32_t _index)
+{
+	m_nodes[_index].parent = m_freeList;
+	m_nodes[_index].height = invalid_proxy;
+	m_freeList = _index;
+}
+
+void CDynamicAABBTree::insertLeaf(uint32_t _leaf)
+{
+	if (m_root==invalid_proxy)
+	{
+		m_root = _leaf;
+		m_nodes[_leaf].parent = invalid_proxy;
+		return;
+	}
+
+	// walk down to the sibling which makes the tree's total surface area grow the least,
+	// every node on the way grows by the same amount no matter which child gets picked
+	const core::aabbox3df leafBox = m_nodes[_leaf].box;
+	uint32_t sibling = m_root;
+	while (!m_nodes[sibling].isLeaf())
+	{
+		const SNode& node = m_nodes[sibling];
+		const float combinedArea = surfaceArea(unionBox(node.box,leafBox));
+		const float siblingCost = 2.f*combinedArea;
+		const float inheritanceCost = 2.f*(combinedArea-surfaceArea(node.box));
+
+		float childCost[2];
+		for (uint32_t i=0u; i<2u; i++)
+		{
+			const SNode& child = m_nodes[node.children[i]];
+			childCost[i] = surfaceArea(unionBox(child.box,leafBox))+inheritanceCost;
+			if (!child.isLeaf())
+				childCost[i] -= surfaceArea(child.box);
+		}
+
+		if (siblingCost<childCost[0] && siblingCost<childCost[1])
+			break;
+		sibling = node.children[childCost[0]<childCost[1] ? 0u:1u];
+	}
+
+	// allocating can move the nodes, so no references are kept across it
+	const uint32_t newParent = allocateNode();
+	const uint32_t oldParent = m_nodes[sibling].parent;
+	{
+		SNode& node = m_nodes[newParent];
+		node.box = unionBox(m_nodes[sibling].box,leafBox);
+		node.userData = nullptr;
+		node.parent = oldParent;
+		node.children[0] = sibling;
+		node.children[1] = _leaf;
+		node.height = m_nodes[sibling].height+1u;
+	}
+	if (oldParent!=invalid_proxy)
+	{
+		auto& children = m_nodes[oldParent].children;
+		children[children[0]==sibling ? 0u:1u] = newParent;
+	}
+	else
+		m_root = newParent;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[_leaf].parent = newParent;
+
+	refitAncestors(_leaf);
+}
+
+void CDynamicAABBTree::removeLeaf(uint32_t _leaf)
+{
+	if (_leaf==m_root)
+	{
+		m_root = invalid_proxy;
+		return;
+	}
+
+	// the leaf's parent goes away and the leaf's sibling takes its place
+	const uint32_t parent = m_nodes[_leaf].parent;
+	const uint32_t grandParent = m_nodes[parent].parent;
+	const auto& parentChildren = m_nodes[parent].children;
+	const uint32_t sibling = parentChildren[parentChildren[0]==_leaf ? 1u:0u];
+
+	m_nodes[sibling].parent = grandParent;
+	if (grandParent!=invalid_proxy)
+	{
+		auto& children = m_nodes[grandParent].children;
+		children[children[0]==parent ? 0u:1u] = sibling;
+	}
+	else
+		m_root = sibling;
+	freeNode(parent);
+
+	refitAncestors(sibling);
+}
+
+void CDynamicAABBTree::refitAncestors(uint32_t _index)
+{
+	for (uint32_t index=m_nodes[_index].parent; index!=invalid_proxy; index=m_nodes[index].parent)
+	{
+		index = balance(index);
+
+		SNode& node = m_nodes[index];
+		const SNode& child0 = m_nodes[node.children[0]];
+		const SNode& child1 = m_nodes[node.children[1]];
+		node.box = unionBox(child0.box,child1.box);
+		node.height = std::max(child0.height,child1.height)+1u;
+	}
+}
+
+uint32_t CDynamicAABBTree::balance(uint32_t _index)
+{
+	SNode& a = m_nodes[_index];
+	if (a.isLeaf() || a.height<2u)
+		return _index;
+
+	// the taller child moves up to where `a` was and `a` takes the place of the taller grandchild's shorter sibling
+	const int32_t heightDifference = int32_t(m_nodes[a.children[1]].height)-int32_t(m_nodes[a.children[0]].height);
+	if (heightDifference>=-1 && heightDifference<=1)
+		return _index;
+	const uint32_t tall = heightDifference>0 ? 1u:0u;
+	const uint32_t other = tall^1u;
+
+	const uint32_t upIndex = a.children[tall];
+	SNode& up = m_nodes[upIndex];
+	const uint32_t grandChildren[2] = {up.children[0],up.children[1]};
+
+	up.children[0] = _index;
+	up.parent = a.parent;
+	a.parent = upIndex;
+	if (up.parent!=invalid_proxy)
+	{
+		auto& children = m_nodes[up.parent].children;
+		children[children[0]==_index ? 0u:1u] = upIndex;
+	}
+	else
+		m_root = upIndex;
+
+	// the taller grandchild stays under `up`, the other one goes under `a`
+	const uint32_t keep = m_nodes[grandChildren[0]].height>m_nodes[grandChildren[1]].height ? 0u:1u;
+	const uint32_t moved = grandChildren[keep^1u];
+	up.children[1] = grandChildren[keep];
+	a.children[tall] = moved;
+	m_nodes[moved].parent = _index;
+
+	const SNode& aShort = m_nodes[a.children[other]];
+	const SNode& aMoved = m_nodes[moved];
+	a.box = unionBox(aShort.box,aMoved.box);
+	a.height = std::max(aShort.height,aMoved.height)+1u;
+
+	const SNode& upKept = m_nodes[grandChildren[keep]];
+	up.box = unionBox(a.box,upKept.box);
+	up.height = std::max(a.height,upKept.height)+1u;
+
+	return upIndex;
+}
+
+} // end namespace scene
+} // end namespace irr
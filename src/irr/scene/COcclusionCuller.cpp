@@ -0,0 +1,342 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "irr/scene/COcclusionCuller.h"
+
+#include <cfloat>
+#include <cmath>
+
+#include "irr/asset/ICPUMeshBuffer.h"
+#include "irr/core/parallel/parallel_for.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	//! Smallest clip space w of a vertex which gets rasterized, or of a box corner which can be occluded
+	constexpr float MinW = 1e-5f;
+	//! Triangles reaching further than this many pixels off the buffer are skipped, as float edge functions get too imprecise
+	constexpr float GuardBand = 8192.f;
+
+	inline void transformToClip(const float* _m, const float* _in, float* _out)
+	{
+		for (uint32_t i=0u; i<4u; i++)
+			_out[i] = _m[i*4u]*_in[0]+_m[i*4u+1u]*_in[1]+_m[i*4u+2u]*_in[2]+_m[i*4u+3u];
+	}
+}
+
+COcclusionCuller::COcclusionCuller(uint32_t _width, uint32_t _height, uint32_t _threadCount) : m_threadCount(_threadCount)
+{
+	m_tilesX = std::max((_width+TileSize-1u)/TileSize, 1u);
+	m_tilesY = std::max((_height+TileSize-1u)/TileSize, 1u);
+	m_width = m_tilesX*TileSize;
+	m_height = m_tilesY*TileSize;
+	m_depth.resize(size_t(m_width)*m_height, 0.f);
+	m_blockDepth.resize(size_t(m_width/BlockSize)*(m_height/BlockSize), 0.f);
+	m_tileBins.resize(m_tilesX*m_tilesY);
+	std::fill_n(m_viewProjection, 16u, 0.f);
+}
+
+COcclusionCuller::occluder_t COcclusionCuller::addOccluder(const asset::ICPUMeshBuffer* _meshbuffer, const core::matrix3x4SIMD& _worldTransform)
+{
+	if (!_meshbuffer || _meshbuffer->getPrimitiveType()!=asset::EPT_TRIANGLES)
+		return invalid_occluder;
+
+	const uint32_t vertexCount = static_cast<uint32_t>(_meshbuffer->calcVertexCount());
+	core::vector<core::vectorSIMDf> positions(vertexCount);
+	for (uint32_t i=0u; i<vertexCount; i++)
+		positions[i] = _meshbuffer->getPosition(i);
+
+	const uint32_t indexCount = static_cast<uint32_t>(_meshbuffer->getIndexCount());
+	core::vector<uint32_t> indices(indexCount);
+	for (uint32_t i=0u; i<indexCount; i++)
+		indices[i] = _meshbuffer->getIndexValue(i);
+
+	return addOccluder(positions.data(), vertexCount, indices.data(), indexCount, _worldTransform);
+}
+
+COcclusionCuller::occluder_t COcclusionCuller::addOccluder(const core::vectorSIMDf* _positions, uint32_t _vertexCount, const uint32_t* _indices, uint32_t _indexCount, const core::matrix3x4SIMD& _worldTransform)
+{
+	_indexCount -= _indexCount%3u;
+	if (!_indexCount)
+		return invalid_occluder;
+	for (uint32_t i=0u; i<_indexCount; i++)
+	if (_indices[i]>=_vertexCount)
+		return invalid_occluder;
+
+	occluder_t occluder;
+	if (m_freeOccluders.size())
+	{
+		occluder = m_freeOccluders.back();
+		m_freeOccluders.pop_back();
+	}
+	else
+	{
+		occluder = static_cast<occluder_t>(m_occluders.size());
+		m_occluders.emplace_back();
+	}
+
+	auto& entry = m_occluders[occluder];
+	entry.positions.assign(_positions, _positions+_vertexCount);
+	for (auto& position : entry.positions)
+		position.w = 1.f;
+	entry.indices.assign(_indices, _indices+_indexCount);
+	entry.worldTransform = _worldTransform;
+	return occluder;
+}
+
+void COcclusionCuller::removeOccluder(occluder_t _occluder)
+{
+	auto& entry = m_occluders[_occluder];
+	// empty occluders get skipped by render()
+	entry.positions.clear();
+	entry.indices.clear();
+	m_freeOccluders.push_back(_occluder);
+}
+
+void COcclusionCuller::render(const core::matrix4SIMD& _viewProjection)
+{
+	for (uint32_t i=0u; i<4u; i++)
+	for (uint32_t j=0u; j<4u; j++)
+		m_viewProjection[i*4u+j] = _viewProjection(i,j);
+
+	// transform and set up the triangles of every occluder, each thread appending to its own list,
+	// there can be no more threads than the pool has workers plus the calling thread so no more lists are needed
+	uint32_t threadCount = m_threadCount ? m_threadCount:core::getDefaultThreadCount();
+	threadCount = std::min(threadCount, core::CThreadPool::getGlobal().getWorkerCount()+1u);
+	m_threadTriangles.resize(threadCount);
+	for (auto& triangles : m_threadTriangles)
+		triangles.clear();
+	core::parallel_for_chunked(0u, m_occluders.size(), 1u, [&](size_t _begin, size_t _end, uint32_t _threadIx) -> void
+	{
+		for (size_t i=_begin; i<_end; i++)
+		{
+			const auto& occluder = m_occluders[i];
+			if (occluder.indices.empty())
+				continue;
+
+			const core::matrix4SIMD clipTransform = core::concatenateBFollowedByA(_viewProjection, core::matrix4SIMD(occluder.worldTransform));
+			float clipRows[16];
+			for (uint32_t r=0u; r<4u; r++)
+			for (uint32_t c=0u; c<4u; c++)
+				clipRows[r*4u+c] = clipTransform(r,c);
+			setupTriangles(occluder, clipRows, m_threadTriangles[_threadIx]);
+		}
+	}, threadCount);
+
+	// bin the triangles into the tiles they overlap
+	m_triangles.clear();
+	for (const auto& triangles : m_threadTriangles)
+		m_triangles.insert(m_triangles.end(), triangles.begin(), triangles.end());
+	for (auto& bin : m_tileBins)
+		bin.clear();
+	for (uint32_t i=0u; i<m_triangles.size(); i++)
+	{
+		const auto& triangle = m_triangles[i];
+		const uint32_t maxTileX = (triangle.maxX-1)/TileSize;
+		const uint32_t maxTileY = (triangle.maxY-1)/TileSize;
+		for (uint32_t y=triangle.minY/TileSize; y<=maxTileY; y++)
+		for (uint32_t x=triangle.minX/TileSize; x<=maxTileX; x++)
+			m_tileBins[y*m_tilesX+x].push_back(i);
+	}
+
+	// every tile only writes its own pixels and blocks
+	core::parallel_for(0u, m_tileBins.size(), [this](size_t _tile) -> void { rasterizeTile(static_cast<uint32_t>(_tile)); }, threadCount);
+}
+
+void COcclusionCuller::setupTriangles(const SOccluder& _occluder, const float* _clipTransform, core::vector<STriangle>& _out) const
+{
+	// screen space x, y and 1/w of every vertex, w is negative for vertices which are too close, behind the camera or outside the guard band
+	core::vector<core::vectorSIMDf> screen(_occluder.positions.size());
+	const float halfWidth = 0.5f*float(m_width), halfHeight = 0.5f*float(m_height);
+	for (size_t i=0u; i<screen.size(); i++)
+	{
+		float clip[4];
+		transformToClip(_clipTransform, _occluder.positions[i].pointer, clip);
+		if (clip[3]<MinW)
+		{
+			screen[i].w = -1.f;
+			continue;
+		}
+		const float invW = 1.f/clip[3];
+		screen[i].set((clip[0]*invW+1.f)*halfWidth, (1.f-clip[1]*invW)*halfHeight, invW, 1.f);
+		if (std::abs(screen[i].x-halfWidth)>GuardBand || std::abs(screen[i].y-halfHeight)>GuardBand)
+			screen[i].w = -1.f;
+	}
+
+	for (size_t i=0u; i<_occluder.indices.size(); i+=3u)
+	{
+		const core::vectorSIMDf* v[3] = {&screen[_occluder.indices[i]], &screen[_occluder.indices[i+1u]], &screen[_occluder.indices[i+2u]]};
+		if (v[0]->w<0.f || v[1]->w<0.f || v[2]->w<0.f)
+			continue;
+
+		STriangle triangle;
+		const float minX = std::min(std::min(v[0]->x, v[1]->x), v[2]->x);
+		const float maxX = std::max(std::max(v[0]->x, v[1]->x), v[2]->x);
+		const float minY = std::min(std::min(v[0]->y, v[1]->y), v[2]->y);
+		const float maxY = std::max(std::max(v[0]->y, v[1]->y), v[2]->y);
+		// pixel centers x+0.5 within the bounds
+		triangle.minX = static_cast<int32_t>(std::max(std::floor(minX+0.5f), 0.f));
+		triangle.minY = static_cast<int32_t>(std::max(std::floor(minY+0.5f), 0.f));
+		triangle.maxX = static_cast<int32_t>(std::min(std::floor(maxX+0.5f), float(m_width)));
+		triangle.maxY = static_cast<int32_t>(std::min(std::floor(maxY+0.5f), float(m_height)));
+		if (triangle.minX>=triangle.maxX || triangle.minY>=triangle.maxY)
+			continue;
+
+		const float area = (v[1]->x-v[0]->x)*(v[2]->y-v[0]->y)-(v[2]->x-v[0]->x)*(v[1]->y-v[0]->y);
+		if (std::abs(area)<1e-6f)
+			continue;
+		const float orientation = area>0.f ? 1.f:-1.f;
+		for (uint32_t e=0u; e<3u; e++)
+		{
+			const core::vectorSIMDf& a = *v[e];
+			const core::vectorSIMDf& b = *v[(e+1u)%3u];
+			triangle.edgeA[e] = (a.y-b.y)*orientation;
+			triangle.edgeB[e] = (b.x-a.x)*orientation;
+			triangle.edgeC[e] = (a.x*b.y-b.x*a.y)*orientation;
+		}
+
+		const float dz1 = v[1]->z-v[0]->z, dz2 = v[2]->z-v[0]->z;
+		triangle.depthA = (dz1*(v[2]->y-v[0]->y)-dz2*(v[1]->y-v[0]->y))/area;
+		triangle.depthB = (dz2*(v[1]->x-v[0]->x)-dz1*(v[2]->x-v[0]->x))/area;
+		// the plane at the pixel center minus how much it can drop within half a pixel
+		triangle.depthC = v[0]->z-triangle.depthA*v[0]->x-triangle.depthB*v[0]->y-0.5f*(std::abs(triangle.depthA)+std::abs(triangle.depthB));
+		_out.push_back(triangle);
+	}
+}
+
+void COcclusionCuller::rasterizeTile(uint32_t _tile)
+{
+	const int32_t tileX0 = (_tile%m_tilesX)*TileSize;
+	const int32_t tileY0 = (_tile/m_tilesX)*TileSize;
+	const int32_t tileX1 = tileX0+TileSize;
+	const int32_t tileY1 = tileY0+TileSize;
+
+	for (int32_t y=tileY0; y<tileY1; y++)
+		std::fill_n(m_depth.data()+size_t(y)*m_width+tileX0, TileSize, 0.f);
+
+	for (const uint32_t index : m_tileBins[_tile])
+	{
+		const STriangle& triangle = m_triangles[index];
+		// rows are walked in groups of 4 pixels starting at a multiple of 4, the edge functions reject the extra pixels
+		const int32_t x0 = std::max(triangle.minX, tileX0)&~0x3;
+		const int32_t x1 = std::min(triangle.maxX, tileX1);
+		const int32_t y0 = std::max(triangle.minY, tileY0);
+		const int32_t y1 = std::min(triangle.maxY, tileY1);
+		for (int32_t y=y0; y<y1; y++)
+		{
+			const float centerY = float(y)+0.5f;
+			float rowEdge[3];
+			for (uint32_t e=0u; e<3u; e++)
+				rowEdge[e] = triangle.edgeB[e]*centerY+triangle.edgeC[e];
+			const float rowDepth = triangle.depthB*centerY+triangle.depthC;
+			float* depthRow = m_depth.data()+size_t(y)*m_width;
+#ifdef __IRR_COMPILE_WITH_X86_SIMD_
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 depthA = _mm_set1_ps(triangle.depthA);
+			const __m128 depthRowValue = _mm_set1_ps(rowDepth);
+			__m128 edgeA[3], edgeRow[3];
+			for (uint32_t e=0u; e<3u; e++)
+			{
+				edgeA[e] = _mm_set1_ps(triangle.edgeA[e]);
+				edgeRow[e] = _mm_set1_ps(rowEdge[e]);
+			}
+			for (int32_t x=x0; x<x1; x+=4)
+			{
+				const float baseX = float(x)+0.5f;
+				const __m128 centerX = _mm_setr_ps(baseX, baseX+1.f, baseX+2.f, baseX+3.f);
+				__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[0], centerX), edgeRow[0]), zero);
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[1], centerX), edgeRow[1]), zero));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeA[2], centerX), edgeRow[2]), zero));
+				if (!_mm_movemask_ps(inside))
+					continue;
+
+				const __m128 depth = _mm_add_ps(_mm_mul_ps(depthA, centerX), depthRowValue);
+				const __m128 previous = _mm_load_ps(depthRow+x);
+				_mm_store_ps(depthRow+x, _mm_blendv_ps(previous, _mm_max_ps(previous, depth), inside));
+			}
+#else
+			for (int32_t x=x0; x<x1; x++)
+			{
+				const float centerX = float(x)+0.5f;
+				if (triangle.edgeA[0]*centerX+rowEdge[0]<0.f || triangle.edgeA[1]*centerX+rowEdge[1]<0.f || triangle.edgeA[2]*centerX+rowEdge[2]<0.f)
+					continue;
+				depthRow[x] = std::max(depthRow[x], triangle.depthA*centerX+rowDepth);
+			}
+#endif
+		}
+	}
+
+	// farthest depth of every block of the tile
+	const uint32_t blocksPerRow = m_width/BlockSize;
+	for (int32_t by=tileY0; by<tileY1; by+=BlockSize)
+	for (int32_t bx=tileX0; bx<tileX1; bx+=BlockSize)
+	{
+		float farthest = m_depth[size_t(by)*m_width+bx];
+		for (uint32_t y=0u; y<BlockSize; y++)
+		{
+			const float* row = m_depth.data()+size_t(by+y)*m_width+bx;
+			for (uint32_t x=0u; x<BlockSize; x++)
+				farthest = std::min(farthest, row[x]);
+		}
+		m_blockDepth[(by/BlockSize)*blocksPerRow+bx/BlockSize] = farthest;
+	}
+}
+
+bool COcclusionCuller::isOccluded(const core::aabbox3df& _box) const
+{
+	// screen rectangle of the corners and 1/w of the nearest one, a box reaching behind the near plane is never occluded
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, nearest = 0.f;
+	const float halfWidth = 0.5f*float(m_width), halfHeight = 0.5f*float(m_height);
+	for (uint32_t i=0u; i<8u; i++)
+	{
+		const float corner[3] = {i&0x1u ? _box.MaxEdge.X:_box.MinEdge.X, i&0x2u ? _box.MaxEdge.Y:_box.MinEdge.Y, i&0x4u ? _box.MaxEdge.Z:_box.MinEdge.Z};
+		float clip[4];
+		transformToClip(m_viewProjection, corner, clip);
+		if (clip[3]<MinW)
+			return false;
+		const float invW = 1.f/clip[3];
+		const float x = (clip[0]*invW+1.f)*halfWidth;
+		const float y = (1.f-clip[1]*invW)*halfHeight;
+		minX = std::min(minX, x);
+		maxX = std::max(maxX, x);
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+		nearest = std::max(nearest, invW);
+	}
+
+	// every pixel the rectangle touches
+	const int32_t x0 = static_cast<int32_t>(std::max(std::floor(minX), 0.f));
+	const int32_t y0 = static_cast<int32_t>(std::max(std::floor(minY), 0.f));
+	const int32_t x1 = static_cast<int32_t>(std::min(std::floor(maxX)+1.f, float(m_width)));
+	const int32_t y1 = static_cast<int32_t>(std::min(std::floor(maxY)+1.f, float(m_height)));
+	if (x0>=x1 || y0>=y1)
+		return false;
+
+	const uint32_t blocksPerRow = m_width/BlockSize;
+	for (int32_t by=y0-y0%int32_t(BlockSize); by<y1; by+=BlockSize)
+	for (int32_t bx=x0-x0%int32_t(BlockSize); bx<x1; bx+=BlockSize)
+	{
+		if (m_blockDepth[(by/BlockSize)*blocksPerRow+bx/BlockSize]>nearest)
+			continue;
+
+		// some pixel of the block is not in front of the box, which only matters if the rectangle reaches it
+		const int32_t px0 = std::max(bx, x0), px1 = std::min<int32_t>(bx+BlockSize, x1);
+		const int32_t py0 = std::max(by, y0), py1 = std::min<int32_t>(by+BlockSize, y1);
+		for (int32_t y=py0; y<py1; y++)
+		{
+			const float* row = m_depth.data()+size_t(y)*m_width;
+			for (int32_t x=px0; x<px1; x++)
+			if (row[x]<=nearest)
+				return false;
+		}
+	}
+	return true;
+}
+
+} // end namespace scene
+} // end namespace irr
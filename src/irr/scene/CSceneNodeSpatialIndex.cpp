@@ -0,0 +1,127 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "irr/scene/CSceneNodeSpatialIndex.h"
+
+#include <algorithm>
+
+namespace irr
+{
+namespace scene
+{
+
+void ISceneNode::queueSpatialIndexUpdate()
+{
+	std::lock_guard<std::mutex> lock(SpatialIndex->m_dirtyNodesMutex);
+	SpatialIndexDirty = true;
+	SpatialIndex->m_dirtyNodes.push_back(this);
+}
+
+
+CSceneNodeSpatialIndex::~CSceneNodeSpatialIndex()
+{
+	clear();
+}
+
+bool CSceneNodeSpatialIndex::addNode(ISceneNode* _node)
+{
+	if (_node->SpatialIndex)
+		return false;
+
+	_node->grab();
+	_node->SpatialIndex = this;
+	_node->SpatialIndexEntry = m_entries.size();
+	_node->SpatialIndexDirty = false;
+	m_entries.push_back({_node,m_tree.createProxy(_node->getTransformedBoundingBox(),_node),m_frustumMark});
+	return true;
+}
+
+bool CSceneNodeSpatialIndex::removeNode(ISceneNode* _node)
+{
+	if (_node->SpatialIndex!=this)
+		return false;
+
+	if (_node->SpatialIndexDirty)
+		m_dirtyNodes.erase(std::find(m_dirtyNodes.begin(),m_dirtyNodes.end(),_node));
+
+	const size_t index = _node->SpatialIndexEntry;
+	m_tree.destroyProxy(m_entries[index].proxy);
+	if (index+1u!=m_entries.size())
+	{
+		m_entries[index] = m_entries.back();
+		m_entries[index].node->SpatialIndexEntry = index;
+	}
+	m_entries.pop_back();
+
+	_node->SpatialIndex = nullptr;
+	_node->SpatialIndexDirty = false;
+	_node->drop();
+	return true;
+}
+
+void CSceneNodeSpatialIndex::clear()
+{
+	for (auto& entry : m_entries)
+	{
+		entry.node->SpatialIndex = nullptr;
+		entry.node->SpatialIndexDirty = false;
+		entry.node->drop();
+	}
+	m_entries.clear();
+	m_dirtyNodes.clear();
+	m_tree.clear();
+}
+
+void CSceneNodeSpatialIndex::moveEntry(SEntry& _entry)
+{
+	m_tree.moveProxy(_entry.proxy,_entry.node->getTransformedBoundingBox());
+	// it might have moved into the frustum, so it counts as marked until the next markFrustum()
+	_entry.frustumMark = m_frustumMark;
+}
+
+void CSceneNodeSpatialIndex::updateNode(ISceneNode* _node)
+{
+	if (_node->SpatialIndex!=this)
+		return;
+
+	moveEntry(m_entries[_node->SpatialIndexEntry]);
+}
+
+uint32_t CSceneNodeSpatialIndex::update()
+{
+	const uint32_t updatedCount = m_dirtyNodes.size();
+	for (auto node : m_dirtyNodes)
+	{
+		node->SpatialIndexDirty = false;
+		moveEntry(m_entries[node->SpatialIndexEntry]);
+	}
+	m_dirtyNodes.clear();
+	return updatedCount;
+}
+
+uint32_t CSceneNodeSpatialIndex::markFrustum(const SViewFrustum& _frustum)
+{
+	m_frustumMark++;
+	uint32_t markedCount = 0u;
+	m_tree.queryFrustum(_frustum,[&](CDynamicAABBTree::proxy_t _proxy) -> bool
+	{
+		m_entries[getNode(_proxy)->SpatialIndexEntry].frustumMark = m_frustumMark;
+		markedCount++;
+		return true;
+	});
+	return markedCount;
+}
+
+void CSceneNodeSpatialIndex::getVisibleNodes(const SViewFrustum& _frustum, core::vector<ISceneNode*>& _out) const
+{
+	queryFrustum(_frustum,[&_out](ISceneNode* _node) -> bool
+	{
+		if (_node->isTrulyVisible())
+			_out.push_back(_node);
+		return true;
+	});
+}
+
+} // end namespace scene
+} // end namespace irr
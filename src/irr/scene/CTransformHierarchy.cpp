@@ -0,0 +1,202 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "irr/scene/CTransformHierarchy.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "irr/core/parallel/parallel_for.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	//! Nodes updated per parallel task, a multiple of 64 so every bitset word is only written by one thread
+	constexpr size_t UpdateGrainWords = 16u;
+	//! Levels with fewer nodes than this are updated on the calling thread, handing them to the thread pool costs more than it saves
+	constexpr size_t ParallelMinWords = 64u;
+
+	inline uint32_t countTrailingZeros(uint64_t _bits)
+	{
+#if defined(_MSC_VER)
+		unsigned long retval;
+		_BitScanForward64(&retval, _bits);
+		return retval;
+#else
+		return __builtin_ctzll(_bits);
+#endif
+	}
+}
+
+CTransformHierarchy::node_t CTransformHierarchy::addNode(node_t _parent, const core::matrix3x4SIMD& _localTransform)
+{
+	node_t node;
+	if (m_freeSlots.size())
+	{
+		node = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		node = static_cast<node_t>(m_slots.size());
+		m_slots.emplace_back();
+	}
+
+	uint32_t level = 0u;
+	uint32_t parentIndex = invalid_node;
+	if (_parent!=invalid_node)
+	{
+		level = m_slots[_parent].level+1u;
+		parentIndex = m_slots[_parent].index;
+	}
+	if (level>=m_levels.size())
+		m_levels.resize(level+1u);
+
+	m_slots[node] = {_parent, level, m_levels[level].append(node, parentIndex, _localTransform)};
+	return node;
+}
+
+void CTransformHierarchy::removeNode(node_t _node)
+{
+	auto& slot = m_slots[_node];
+	m_levels[slot.level].nodes[slot.index] = invalid_node;
+	slot.level = invalid_node;
+	m_removedSlots.push_back(_node);
+	// the children are made roots by rebuildLevels(), the slot is not reused until then
+	m_layoutStale = true;
+}
+
+bool CTransformHierarchy::setParent(node_t _node, node_t _parent)
+{
+	if (m_slots[_node].parent==_parent)
+		return true;
+	for (node_t ancestor=_parent; ancestor!=invalid_node; ancestor=m_slots[ancestor].parent)
+	if (ancestor==_node)
+		return false;
+
+	m_slots[_node].parent = _parent;
+	m_layoutStale = true;
+	return true;
+}
+
+uint32_t CTransformHierarchy::update()
+{
+	if (m_layoutStale)
+		rebuildLevels();
+
+	std::atomic<uint32_t> updatedCount(0u);
+	const SLevel* parentLevel = nullptr;
+	for (auto& level : m_levels)
+	{
+		const size_t wordCount = level.dirty.size();
+		const uint32_t nodeCount = static_cast<uint32_t>(level.nodes.size());
+		auto updateWords = [&](size_t _begin, size_t _end, uint32_t) -> void
+		{
+			uint32_t count = 0u;
+			for (size_t w=_begin; w<_end; w++)
+			{
+				uint64_t recompute = level.dirty[w];
+				if (parentLevel)
+				{
+					const uint32_t end = std::min<uint32_t>(nodeCount, (w+1u)*64u);
+					for (uint32_t i=w*64u; i<end; i++)
+					{
+						const uint32_t parent = level.parents[i];
+						recompute |= ((parentLevel->updated[parent>>6u]>>(parent&63u))&0x1ull)<<(i&63u);
+					}
+				}
+				level.dirty[w] = 0ull;
+				level.updated[w] = recompute;
+
+				for (uint64_t bits=recompute; bits; bits&=bits-1ull)
+				{
+					const uint32_t i = w*64u+countTrailingZeros(bits);
+					if (parentLevel)
+						level.worldTransforms[i] = core::concatenateBFollowedByA(parentLevel->worldTransforms[level.parents[i]], level.localTransforms[i]);
+					else
+						level.worldTransforms[i] = level.localTransforms[i];
+					count++;
+				}
+			}
+			updatedCount += count;
+		};
+		if (wordCount<ParallelMinWords || m_threadCount==1u)
+			updateWords(0u, wordCount, 0u);
+		else
+			core::parallel_for_chunked(0u, wordCount, UpdateGrainWords, updateWords, m_threadCount);
+		parentLevel = &level;
+	}
+	return updatedCount;
+}
+
+void CTransformHierarchy::rebuildLevels()
+{
+	m_layoutStale = false;
+	for (auto& slot : m_slots)
+	if (slot.level!=invalid_node && slot.parent!=invalid_node && m_slots[slot.parent].level==invalid_node)
+		slot.parent = invalid_node;
+	m_freeSlots.insert(m_freeSlots.end(), m_removedSlots.begin(), m_removedSlots.end());
+	m_removedSlots.clear();
+
+	// depth of every node, walking up to the first ancestor whose depth is known
+	constexpr uint32_t unknown = invalid_node;
+	core::vector<uint32_t> depths(m_slots.size(), unknown);
+	core::vector<node_t> chain;
+	uint32_t levelCount = 0u;
+	for (node_t node=0u; node<m_slots.size(); node++)
+	{
+		if (m_slots[node].level==invalid_node || depths[node]!=unknown)
+			continue;
+		node_t ancestor = node;
+		while (ancestor!=invalid_node && depths[ancestor]==unknown)
+		{
+			chain.push_back(ancestor);
+			ancestor = m_slots[ancestor].parent;
+		}
+		uint32_t depth = ancestor!=invalid_node ? depths[ancestor]+1u:0u;
+		for (auto it=chain.rbegin(); it!=chain.rend(); it++)
+			depths[*it] = depth++;
+		levelCount = std::max(levelCount, depth);
+		chain.clear();
+	}
+
+	core::vector<core::vector<node_t> > nodesByDepth(levelCount);
+	for (const auto& oldLevel : m_levels)
+	for (const node_t node : oldLevel.nodes)
+	if (node!=invalid_node)
+		nodesByDepth[depths[node]].push_back(node);
+
+	// a level's nodes are sorted by their parent's new index, which keeps siblings together,
+	// every node gets marked dirty by SLevel::append() so the next update recomputes all of them
+	core::vector<SLevel> levels(levelCount);
+	core::vector<std::pair<uint32_t,node_t> > order;
+	for (uint32_t l=0u; l<levelCount; l++)
+	{
+		order.clear();
+		for (const node_t node : nodesByDepth[l])
+		{
+			const node_t parent = m_slots[node].parent;
+			order.emplace_back(parent!=invalid_node ? m_slots[parent].index:invalid_node, node);
+		}
+		std::stable_sort(order.begin(), order.end(), [](const std::pair<uint32_t,node_t>& _a, const std::pair<uint32_t,node_t>& _b) { return _a.first<_b.first; });
+
+		// the slots of this level keep pointing into the old levels until all of it is copied
+		auto& level = levels[l];
+		for (const auto& entry : order)
+		{
+			auto& slot = m_slots[entry.second];
+			slot.index = level.append(entry.second, entry.first, m_levels[slot.level].localTransforms[slot.index]);
+		}
+		for (const auto& entry : order)
+			m_slots[entry.second].level = l;
+	}
+	m_levels.swap(levels);
+}
+
+} // end namespace scene
+} // end namespace irr
@@ -0,0 +1,195 @@
+// Copyright (C) 2019 DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "IrrlichtBaW" Engine.
+// For conditions of distribution and use, see LICENSE.md
+
+#include "irr/system/CProfiler.h"
+
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <cstdio>
+
+#include "IWriteFile.h"
+
+namespace irr
+{
+namespace system
+{
+
+std::atomic_bool CProfiler::s_enabled(false);
+
+namespace
+{
+	const std::chrono::steady_clock::time_point Epoch = std::chrono::steady_clock::now();
+
+	inline uint64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-Epoch).count();
+	}
+
+	struct SThreadZones
+	{
+		//! row of the thread in the trace
+		uint32_t threadIx;
+		//! only ever contended by forEachZone_impl() and clear()
+		std::mutex mutex;
+		core::vector<CProfiler::SZone> zones;
+		//! zones which began and have not ended yet, only touched by the owning thread
+		core::vector<CProfiler::SZone> open;
+	};
+
+	//! every buffer any thread recorded into, and the ones of exited threads waiting for a new owner
+	struct SRegistry
+	{
+		std::mutex mutex;
+		core::vector<std::unique_ptr<SThreadZones> > threads;
+		core::vector<SThreadZones*> unowned;
+	};
+	SRegistry& getRegistry()
+	{
+		static SRegistry registry;
+		return registry;
+	}
+
+	//! hands the buffer of the thread over to the registry when the thread exits
+	struct SThreadHandle
+	{
+		~SThreadHandle()
+		{
+			if (!zones)
+				return;
+
+			SRegistry& registry = getRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			zones->open.clear();
+			registry.unowned.push_back(zones);
+		}
+
+		SThreadZones* zones = nullptr;
+	};
+	thread_local SThreadHandle ThreadHandle;
+
+	SThreadZones& getThreadZones()
+	{
+		if (!ThreadHandle.zones)
+		{
+			SRegistry& registry = getRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			if (registry.unowned.size())
+			{
+				ThreadHandle.zones = registry.unowned.back();
+				registry.unowned.pop_back();
+			}
+			else
+			{
+				registry.threads.emplace_back(new SThreadZones());
+				ThreadHandle.zones = registry.threads.back().get();
+				ThreadHandle.zones->threadIx = static_cast<uint32_t>(registry.threads.size()-1u);
+			}
+		}
+		return *ThreadHandle.zones;
+	}
+
+	void appendJSONString(std::string& _out, const char* _str)
+	{
+		_out += '"';
+		for (; *_str; _str++)
+		{
+			const char c = *_str;
+			if (c=='"' || c=='\\')
+			{
+				_out += '\\';
+				_out += c;
+			}
+			else if (static_cast<unsigned char>(c)<0x20u)
+			{
+				char escaped[8];
+				snprintf(escaped,sizeof(escaped),"\\u%04x",static_cast<uint32_t>(c));
+				_out += escaped;
+			}
+			else
+				_out += c;
+		}
+		_out += '"';
+	}
+}
+
+void CProfiler::beginZone(const char* _name)
+{
+	SThreadZones& zones = getThreadZones();
+	zones.open.push_back({_name,now(),0ull,static_cast<uint32_t>(zones.open.size())});
+}
+
+void CProfiler::endZone()
+{
+	SThreadZones& zones = getThreadZones();
+	_IRR_DEBUG_BREAK_IF(zones.open.empty());
+	if (zones.open.empty())
+		return;
+
+	SZone zone = zones.open.back();
+	zones.open.pop_back();
+	zone.end = now();
+
+	std::lock_guard<std::mutex> lock(zones.mutex);
+	zones.zones.push_back(zone);
+}
+
+void CProfiler::forEachZone_impl(void (*_func)(void*,uint32_t,const SZone&), void* _data)
+{
+	SRegistry& registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (auto& thread : registry.threads)
+	{
+		std::lock_guard<std::mutex> threadLock(thread->mutex);
+		for (const auto& zone : thread->zones)
+			_func(_data,thread->threadIx,zone);
+	}
+}
+
+void CProfiler::clear()
+{
+	SRegistry& registry = getRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	for (auto& thread : registry.threads)
+	{
+		std::lock_guard<std::mutex> threadLock(thread->mutex);
+		thread->zones.clear();
+	}
+}
+
+std::string CProfiler::getChromeTrace()
+{
+	std::string json = "{\"traceEvents\":[";
+	bool first = true;
+	forEachZone([&](uint32_t _threadIx, const SZone& _zone) -> void
+	{
+		if (!first)
+			json += ',';
+		first = false;
+
+		// complete events, with the begin and the duration in microseconds
+		json += "\n{\"name\":";
+		appendJSONString(json,_zone.name);
+		const uint64_t duration = _zone.end-_zone.begin;
+		char fields[128];
+		snprintf(fields,sizeof(fields),",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%llu.%03u,\"dur\":%llu.%03u}",_threadIx,
+			static_cast<unsigned long long>(_zone.begin/1000ull),static_cast<uint32_t>(_zone.begin%1000ull),
+			static_cast<unsigned long long>(duration/1000ull),static_cast<uint32_t>(duration%1000ull));
+		json += fields;
+	});
+	json += "\n],\"displayTimeUnit\":\"ns\"}\n";
+	return json;
+}
+
+bool CProfiler::writeChromeTrace(io::IWriteFile* _file)
+{
+	if (!_file)
+		return false;
+
+	const std::string json = getChromeTrace();
+	return _file->write(json.data(),static_cast<uint32_t>(json.size()))==static_cast<int32_t>(json.size());
+}
+
+} // end namespace system
+} // end namespace irr
@@ -23,11 +23,12 @@
 #include <vector>
 #include <cstdlib>
 #include <chrono>
+#include <utility>
 
 #include "print.h"
 
 // Usage: convert2BAW [-i [list of input files delimited with spaces]] [-o [list of output files delimited with spaces]]
-//			[-rel <dir>] [-pwd <password>] [-optmesh <{ error metric settings threes delimited with commas }>]
+//			[-rel <dir>] [-pwd <password>] [-optmesh <{ error metric settings threes delimited with commas }>] [-texmips [filter]] [-texbc <format> [quality]] [-texktx2]
 // Options:
 // -i [list of input files]
 // -o [list of output files]
@@ -43,9 +44,20 @@
 //	Settings must be enclosed with curly (i.e. {}) braces and grouped in threes. Threes must be delimited with commas. Order of threes is irrelevant.
 //	Elements of each group of three must be delimited with spaces and must come with strict order: atrribute-id epsilon cmp-method
 //	Attribute-id must be integer in range [0; 15]. Epsilon is floating point number. Cmp-method must be single character and one of: A - angles, Q - quaternions, P - positions (lower-case chars are also accepted)
+// -texmips [filter]
+//	Generates the full mip chain of every texture used by the meshes and writes it as a .dds file next to the original, the output meshes then reference the .dds files.
+//	Filter is one of: box (default), kaiser, lanczos. Combined with -texbc the mips are generated before the compression and end up in the same .dds file.
+//	Uncompressed textures in formats DDS cannot store (like 24 bit RGB) are left as they were, combine with -texbc for those.
+// -texbc <format> [quality]
+//	Block compresses every texture used by the meshes and writes it as a .dds file next to the original, the output meshes then reference the .dds files.
+//	Format is one of: bc1 (opaque), bc1a (1 bit alpha), bc2, bc3, bc4, bc5, bc7. sRGB textures stay sRGB where the format allows it.
+//	Quality is one of: fast, normal (default), best. Textures which already are block compressed are left as they are.
+// -texktx2
+//	Writes the textures processed by -texmips or -texbc as zlib supercompressed .ktx2 files instead of .dds, which CTextureStreamingManager can stream in level by level.
+//	On its own it converts every texture used by the meshes to .ktx2 as it is.
 
 //Example:
-//	convert2BAW -i somefile.obj someotherfile.x -o f1.baw f2.baw -rel /home/me/assets/ -pwd deadbeefbaadf00d0badcafefeeee997 -optmesh { 0 0.02 P, 3 0.003 A }
+//	convert2BAW -i somefile.obj someotherfile.x -o f1.baw f2.baw -rel /home/me/assets/ -pwd deadbeefbaadf00d0badcafefeeee997 -optmesh { 0 0.02 P, 3 0.003 A } -texmips kaiser -texbc bc7 best
 
 
 using namespace irr;
@@ -62,6 +74,18 @@ static bool checkHex(const char* _str);
 static void hexStrToIntegers(const char* _input, unsigned char* _out);
 static uint8_t hexCharToUint8(char _c);
 static bool optMesh(scene::ICPUMesh* _mesh, const scene::IMeshManipulator* _manip, const scene::IMeshManipulator::SErrorMetric* _errMetrics);
+//! Original textures paired with their replacements (null if processing failed), so textures shared by meshes get processed once
+using ProcessedTextureCache = std::vector<std::pair<core::smart_refctd_ptr<asset::ICPUTexture>, core::smart_refctd_ptr<asset::ICPUTexture>>>;
+struct STextureProcessing
+{
+	bool generateMips = false;
+	asset::E_MIP_MAP_FILTER mipFilter = asset::EMMF_BOX;
+	asset::E_FORMAT blockFormat = asset::EF_UNKNOWN;
+	video::E_BLOCK_ENCODE_QUALITY blockQuality = video::EBEQ_NORMAL;
+	bool writeKTX2 = false;
+};
+static asset::E_FORMAT getBlockFormat(const char* _name);
+static void processTextures(scene::ICPUMesh* _mesh, const STextureProcessing& _processing, asset::IAssetManager* _am, ProcessedTextureCache& _cache);
 
 int main(int _optCnt, char** _options)
 {
@@ -88,6 +112,8 @@ int main(int _optCnt, char** _options)
 	bool usePwd = 0;
 	bool optimizeMesh = 0;
 	bool printInfo = 0;
+	STextureProcessing texProcessing;
+	ProcessedTextureCache processedTextures;
 	scene::CBAWMeshWriter::WriteProperties properties;
 	scene::IMeshManipulator::SErrorMetric errMetrics[16];
 
@@ -131,6 +157,45 @@ int main(int _optCnt, char** _options)
 				properties.relPath = _options[idx];
 				continue;
 			}
+			else if (core::equalsIgnoreCase("texmips", _options[idx]+1))
+			{
+				gatherWhat = EGT_UNDEFINED;
+				texProcessing.generateMips = true;
+				if (idx+1 != _optCnt)
+				{
+					if (core::equalsIgnoreCase("box", _options[idx+1]))
+						texProcessing.mipFilter = asset::EMMF_BOX, ++idx;
+					else if (core::equalsIgnoreCase("kaiser", _options[idx+1]))
+						texProcessing.mipFilter = asset::EMMF_KAISER, ++idx;
+					else if (core::equalsIgnoreCase("lanczos", _options[idx+1]))
+						texProcessing.mipFilter = asset::EMMF_LANCZOS, ++idx;
+				}
+				continue;
+			}
+			else if (idx+1 != _optCnt && core::equalsIgnoreCase("texbc", _options[idx]+1))
+			{
+				++idx;
+				gatherWhat = EGT_UNDEFINED;
+				texProcessing.blockFormat = getBlockFormat(_options[idx]);
+				if (texProcessing.blockFormat == asset::EF_UNKNOWN)
+					printf("Unknown block compression format \"%s\"! Ignored - textures not compressed.\n", _options[idx]);
+				if (idx+1 != _optCnt)
+				{
+					if (core::equalsIgnoreCase("fast", _options[idx+1]))
+						texProcessing.blockQuality = video::EBEQ_FAST, ++idx;
+					else if (core::equalsIgnoreCase("normal", _options[idx+1]))
+						texProcessing.blockQuality = video::EBEQ_NORMAL, ++idx;
+					else if (core::equalsIgnoreCase("best", _options[idx+1]))
+						texProcessing.blockQuality = video::EBEQ_BEST, ++idx;
+				}
+				continue;
+			}
+			else if (core::equalsIgnoreCase("texktx2", _options[idx]+1))
+			{
+				gatherWhat = EGT_UNDEFINED;
+				texProcessing.writeKTX2 = true;
+				continue;
+			}
 			else if (core::equalsIgnoreCase("info", _options[idx]+1))
 			{
 				gatherWhat = EGT_UNDEFINED;
@@ -247,6 +312,9 @@ int main(int _optCnt, char** _options)
 			continue;
 		}
 
+        if (texProcessing.generateMips || texProcessing.blockFormat != asset::EF_UNKNOWN || texProcessing.writeKTX2)
+            processTextures(inmesh, texProcessing, device->getAssetManager(), processedTextures);
+
         if (printInfo)
         {
             printf("%s INFO:\n", inNames[i]);
@@ -364,3 +432,81 @@ static bool optMesh(scene::ICPUMesh* _mesh, const scene::IMeshManipulator* _mani
         return _optMesh<scene::SCPUMesh, scene::ICPUMeshBuffer>(m, _manip, _errMetrics);
     return false;
 }
+
+static asset::E_FORMAT getBlockFormat(const char* _name)
+{
+	const std::pair<const char*, asset::E_FORMAT> formats[] = {
+		{"bc1", asset::EF_BC1_RGB_UNORM_BLOCK},
+		{"bc1a", asset::EF_BC1_RGBA_UNORM_BLOCK},
+		{"bc2", asset::EF_BC2_UNORM_BLOCK},
+		{"bc3", asset::EF_BC3_UNORM_BLOCK},
+		{"bc4", asset::EF_BC4_UNORM_BLOCK},
+		{"bc5", asset::EF_BC5_UNORM_BLOCK},
+		{"bc7", asset::EF_BC7_UNORM_BLOCK}
+	};
+	for (const auto& f : formats)
+		if (core::equalsIgnoreCase(f.first, _name))
+			return f.second;
+	return asset::EF_UNKNOWN;
+}
+
+static asset::E_FORMAT getSRGBVariant(asset::E_FORMAT _fmt)
+{
+	switch (_fmt)
+	{
+	case asset::EF_BC1_RGB_UNORM_BLOCK: return asset::EF_BC1_RGB_SRGB_BLOCK;
+	case asset::EF_BC1_RGBA_UNORM_BLOCK: return asset::EF_BC1_RGBA_SRGB_BLOCK;
+	case asset::EF_BC2_UNORM_BLOCK: return asset::EF_BC2_SRGB_BLOCK;
+	case asset::EF_BC3_UNORM_BLOCK: return asset::EF_BC3_SRGB_BLOCK;
+	case asset::EF_BC7_UNORM_BLOCK: return asset::EF_BC7_SRGB_BLOCK;
+	default: return _fmt;
+	}
+}
+
+static void processTextures(scene::ICPUMesh* _mesh, const STextureProcessing& _processing, asset::IAssetManager* _am, ProcessedTextureCache& _cache)
+{
+	for (size_t i = 0u; i < _mesh->getMeshBufferCount(); ++i)
+	{
+		auto& material = _mesh->getMeshBuffer(i)->getMaterial();
+		for (uint32_t t = 0u; t < _IRR_MATERIAL_MAX_TEXTURES_; ++t)
+		{
+			asset::ICPUTexture* tex = material.getTexture(t);
+			if (!tex || asset::isBlockCompressionFormat(tex->getColorFormat()))
+				continue;
+
+			auto found = std::find_if(_cache.begin(), _cache.end(), [tex](const ProcessedTextureCache::value_type& _entry) { return _entry.first.get() == tex; });
+			if (found == _cache.end())
+			{
+				std::string name = tex->getSourceFilename();
+				name = name.substr(0u, name.find_last_of('.')) + (_processing.writeKTX2 ? ".ktx2" : ".dds");
+
+				core::smart_refctd_ptr<asset::ICPUTexture> processed(tex);
+				if (_processing.generateMips)
+				{
+					asset::SMipMapGenerationParams params;
+					params.filter = _processing.mipFilter;
+					processed = core::smart_refctd_ptr<asset::ICPUTexture>(asset::createMipMappedTexture(tex, params, name), core::dont_grab);
+					if (!processed)
+						printf("Could not generate mip maps of texture %s. Left as it was.\n", tex->getSourceFilename().c_str());
+				}
+				if (processed && _processing.blockFormat != asset::EF_UNKNOWN)
+				{
+					const asset::E_FORMAT fmt = asset::isSRGBFormat(tex->getColorFormat()) ? getSRGBVariant(_processing.blockFormat) : _processing.blockFormat;
+					processed = core::smart_refctd_ptr<asset::ICPUTexture>(asset::createBlockCompressedTexture(processed.get(), fmt, _processing.blockQuality, 0u, name), core::dont_grab);
+					if (!processed)
+						printf("Could not compress texture %s. Left as it was.\n", tex->getSourceFilename().c_str());
+				}
+				const asset::E_WRITER_FLAGS writeFlags = _processing.writeKTX2 ? asset::EWF_COMPRESSED : asset::EWF_NONE;
+				if (processed && !_am->writeAsset(name, asset::IAssetWriter::SAssetWriteParams(processed.get(), writeFlags)))
+				{
+					printf("Could not write texture %s. Left as it was.\n", name.c_str());
+					processed = nullptr;
+				}
+				_cache.emplace_back(core::smart_refctd_ptr<asset::ICPUTexture>(tex), std::move(processed));
+				found = _cache.end()-1;
+			}
+			if (found->second)
+				material.setTexture(t, core::smart_refctd_ptr<asset::ICPUTexture>(found->second));
+		}
+	}
+}